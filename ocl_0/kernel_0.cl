@@ -0,0 +1,106 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Kernels for characterization of device.
+ * Memory kernels go through whole buffer in loop with stride of global
+ * range, so neighbour work-items access neighbour elements.
+ *
+ ***************************************************************************/
+
+// kernel without work, only launch is measured
+__kernel void empty_kernel()
+{
+}
+
+// **************************************************************************
+// kernel for reading of buffer, sum is stored only when it is impossible value,
+// so compiler can not remove reading
+__kernel void read_global( __global const float4 *t_src, __global float *t_dst, uint t_len )
+{
+    size_t global_idx = get_global_id( 0 );
+    size_t global_size = get_global_size( 0 );
+
+    float4 l_sum = ( float4 )( 0.0f );
+    for ( size_t i = global_idx; i < t_len; i += global_size )
+    {
+        l_sum += t_src[ i ];
+    }
+
+    if ( l_sum.x + l_sum.y + l_sum.z + l_sum.w == -1.0f ) t_dst[ global_idx ] = l_sum.x;
+}
+
+// **************************************************************************
+// kernel for writing of buffer
+__kernel void write_global( __global float4 *t_dst, uint t_len, float t_value )
+{
+    size_t global_idx = get_global_id( 0 );
+    size_t global_size = get_global_size( 0 );
+
+    for ( size_t i = global_idx; i < t_len; i += global_size )
+    {
+        t_dst[ i ] = ( float4 )( t_value );
+    }
+}
+
+// **************************************************************************
+// kernel for copy of buffer
+__kernel void copy_global( __global const float4 *t_src, __global float4 *t_dst, uint t_len )
+{
+    size_t global_idx = get_global_id( 0 );
+    size_t global_size = get_global_size( 0 );
+
+    for ( size_t i = global_idx; i < t_len; i += global_size )
+    {
+        t_dst[ i ] = t_src[ i ];
+    }
+}
+
+// **************************************************************************
+// kernel for float throughput, 8 independent chains of float4 multiply-add,
+// 64 operations in every iteration
+__kernel void float_mad( __global float *t_dst, float t_mult, float t_add, int t_iters )
+{
+    size_t global_idx = get_global_id( 0 );
+
+    float4 l_a = ( float4 )( ( float ) global_idx ), l_b = l_a + 1, l_c = l_a + 2, l_d = l_a + 3;
+    float4 l_e = l_a + 4, l_f = l_a + 5, l_g = l_a + 6, l_h = l_a + 7;
+    float4 l_mult = ( float4 )( t_mult ), l_add = ( float4 )( t_add );
+    for ( int i = 0; i < t_iters; i++ )
+    {
+        l_a = mad( l_a, l_mult, l_add ); l_b = mad( l_b, l_mult, l_add );
+        l_c = mad( l_c, l_mult, l_add ); l_d = mad( l_d, l_mult, l_add );
+        l_e = mad( l_e, l_mult, l_add ); l_f = mad( l_f, l_mult, l_add );
+        l_g = mad( l_g, l_mult, l_add ); l_h = mad( l_h, l_mult, l_add );
+    }
+
+    float4 l_sum = l_a + l_b + l_c + l_d + l_e + l_f + l_g + l_h;
+    t_dst[ global_idx ] = l_sum.x + l_sum.y + l_sum.z + l_sum.w;
+}
+
+// **************************************************************************
+// kernel for integer throughput, the same as float_mad, unsigned overflow is defined
+__kernel void int_mad( __global uint *t_dst, uint t_mult, uint t_add, int t_iters )
+{
+    size_t global_idx = get_global_id( 0 );
+
+    uint4 l_a = ( uint4 )( ( uint ) global_idx ), l_b = l_a + 1, l_c = l_a + 2, l_d = l_a + 3;
+    uint4 l_e = l_a + 4, l_f = l_a + 5, l_g = l_a + 6, l_h = l_a + 7;
+    for ( int i = 0; i < t_iters; i++ )
+    {
+        l_a = l_a * t_mult + t_add; l_b = l_b * t_mult + t_add;
+        l_c = l_c * t_mult + t_add; l_d = l_d * t_mult + t_add;
+        l_e = l_e * t_mult + t_add; l_f = l_f * t_mult + t_add;
+        l_g = l_g * t_mult + t_add; l_h = l_h * t_mult + t_add;
+    }
+
+    uint4 l_sum = l_a + l_b + l_c + l_d + l_e + l_f + l_g + l_h;
+    t_dst[ global_idx ] = l_sum.x + l_sum.y + l_sum.z + l_sum.w;
+}
@@ -1,6 +1,6 @@
 /** *************************************************************************
  *
- * Demo program for teaching the course 
+ * Demo program for teaching the course
  * Computer Architectures and Parallel Systems.
  *
  * GPU Programming using OpenCL
@@ -9,24 +9,362 @@
  * petr.olivka@vsb.cz
  * https:/poli.cs.vsb.cz/edu/apps
  *
- * This demo program is used the only for verification of installed 
- * compilers and OpenCL files. 
- * 
+ * This demo program is used the only for verification of installed
+ * compilers and OpenCL files.
+ *
+ * With option -c device is characterized: bandwidth of global memory,
+ * SVM throughput, launch latency, transfers between host and device
+ * and compute throughput. Results are saved into profile for other tools.
+ *
+ * With option -k resources of all kernels in SPIR-V file are reported
+ * with estimated occupancy and recommended work-group sizes.
+ *
  ***************************************************************************/
 
+#include <cstdlib>
+#include <cstring>
 #include <ostream>
 #include <unistd.h>
 #include <iostream>
+#include <chrono>
+#include <vector>
 
-#include <CL/opencl.hpp> 
+#include <CL/opencl.hpp>
 
 #include "ocl_utils.h"
+#include "ocl_bench.h"
+#include "ocl_profile.h"
+#include "ocl_kernel_report.h"
+
+#define KERNEL_SPV      "kernel_0.spv"
+
+// **************************************************************************
+// milliseconds from t_start
+double ms_from( std::chrono::steady_clock::time_point t_start )
+{
+    return std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - t_start ).count();
+}
+
+// **************************************************************************
+// global range for memory kernels, work-items loop over buffer
+cl::NDRange memory_range( size_t t_len )
+{
+    size_t l_cu = cl::Device::getDefault().getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >();
+    size_t l_items = std::min( t_len, std::max< size_t >( 1, l_cu ) * 8192 );
+    return cl::NDRange( ( l_items + 255 ) / 256 * 256 );
+}
+
+// **************************************************************************
+// bandwidth of global memory: read, write and copy by kernels
+void measure_memory( OCLDeviceProfile &t_profile, OCLBench &t_bench, cl::Program &t_program, size_t t_bytes )
+{
+    cl_int l_err;
+
+    cl_uint l_len = t_bytes / sizeof( cl_float4 );
+    cl::Buffer l_src( cl::Context::getDefault(), CL_MEM_READ_WRITE, t_bytes, nullptr, &l_err );  CL_ERR_E( l_err );
+    cl::Buffer l_dst( cl::Context::getDefault(), CL_MEM_READ_WRITE, t_bytes, nullptr, &l_err );  CL_ERR_E( l_err );
+    cl::NDRange l_global = memory_range( l_len );
+
+    cl::Kernel l_kern_write( t_program, "write_global", &l_err );               CL_ERR_E( l_err );
+    l_err = l_kern_write.setArg( 0, l_src );                                    CL_ERR_E( l_err );
+    l_err = l_kern_write.setArg( 1, l_len );                                    CL_ERR_E( l_err );
+    l_err = l_kern_write.setArg( 2, 1.0f );                                     CL_ERR_E( l_err );
+    l_err = t_bench.run( "write_global", l_kern_write, l_len, 1, l_global, cl::NullRange, l_len, t_bytes );  CL_ERR_E( l_err );
+    t_profile.m_write_gbps = t_bench.results().back().gbps();
+
+    cl::Kernel l_kern_read( t_program, "read_global", &l_err );                 CL_ERR_E( l_err );
+    l_err = l_kern_read.setArg( 0, l_src );                                     CL_ERR_E( l_err );
+    l_err = l_kern_read.setArg( 1, l_dst );                                     CL_ERR_E( l_err );
+    l_err = l_kern_read.setArg( 2, l_len );                                     CL_ERR_E( l_err );
+    l_err = t_bench.run( "read_global", l_kern_read, l_len, 1, l_global, cl::NullRange, l_len, t_bytes );  CL_ERR_E( l_err );
+    t_profile.m_read_gbps = t_bench.results().back().gbps();
+
+    cl::Kernel l_kern_copy( t_program, "copy_global", &l_err );                 CL_ERR_E( l_err );
+    l_err = l_kern_copy.setArg( 0, l_src );                                     CL_ERR_E( l_err );
+    l_err = l_kern_copy.setArg( 1, l_dst );                                     CL_ERR_E( l_err );
+    l_err = l_kern_copy.setArg( 2, l_len );                                     CL_ERR_E( l_err );
+    l_err = t_bench.run( "copy_global", l_kern_copy, l_len, 1, l_global, cl::NullRange, l_len, 2 * t_bytes );  CL_ERR_E( l_err );
+    t_profile.m_copy_gbps = t_bench.results().back().gbps();
+}
+
+// **************************************************************************
+// result of host reading, store keeps the loop from being optimized out
+static volatile cl_ulong s_svm_sink;
 
-int main()
+// SVM round trip: host writes input, kernel copies it, host reads output,
+// coarse-grained SVM must be mapped for host
+double svm_round_trip( cl::Kernel &t_kern_copy, float *t_src, float *t_dst, size_t t_bytes, bool t_map )
 {
     cl_int l_err;
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+    cl_uint l_len = t_bytes / sizeof( cl_float4 );
+    // bytes copied by kernel, rest of buffer is not touched
+    size_t l_bytes = ( size_t ) l_len * sizeof( cl_float4 );
+    double l_best = 0;
 
-    l_err = ocl_init( 2, 0 );                                                   CL_ERR_E( l_err );
+    l_err = t_kern_copy.setArg( 0, t_src );                                     CL_ERR_E( l_err );
+    l_err = t_kern_copy.setArg( 1, t_dst );                                     CL_ERR_E( l_err );
+    l_err = t_kern_copy.setArg( 2, l_len );                                     CL_ERR_E( l_err );
+    t_kern_copy.setSVMPointers( { t_src, t_dst } );
+
+    for ( int r = 0; r < 4; r++ )
+    {
+        auto l_start = std::chrono::steady_clock::now();
+
+        if ( t_map ) { l_err = defQueue.enqueueMapSVM( t_src, CL_TRUE, CL_MAP_WRITE, l_bytes );  CL_ERR_E( l_err ); }
+        memset( t_src, r, l_bytes );
+        if ( t_map ) { l_err = defQueue.enqueueUnmapSVM( t_src );               CL_ERR_E( l_err ); }
+
+        l_err = defQueue.enqueueNDRangeKernel( t_kern_copy, cl::NullRange, memory_range( l_len ), cl::NullRange );  CL_ERR_E( l_err );
+        l_err = defQueue.finish();                                              CL_ERR_E( l_err );
+
+        if ( t_map ) { l_err = defQueue.enqueueMapSVM( t_dst, CL_TRUE, CL_MAP_READ, l_bytes );  CL_ERR_E( l_err ); }
+        // plain integer sum of 64-bit words, only its result is volatile
+        const cl_ulong *l_words = ( const cl_ulong * ) t_dst;
+        cl_ulong l_sum = 0;
+        for ( size_t i = 0; i < l_bytes / sizeof( cl_ulong ); i++ )
+        {
+            l_sum += l_words[ i ];
+        }
+        s_svm_sink = l_sum;
+        if ( t_map ) { l_err = defQueue.enqueueUnmapSVM( t_dst );               CL_ERR_E( l_err ); }
+        l_err = defQueue.finish();                                              CL_ERR_E( l_err );
+
+        // the first run only allocates pages
+        double l_gbps = 4.0 * l_bytes / ms_from( l_start ) / 1e6;
+        if ( r > 0 ) l_best = std::max( l_best, l_gbps );
+    }
+    return l_best;
+}
+
+// **************************************************************************
+// SVM throughput, coarse-grained and fine-grained when device supports it
+void measure_svm( OCLDeviceProfile &t_profile, cl::Program &t_program, size_t t_bytes )
+{
+    cl_int l_err;
+    cl::Context l_context = cl::Context::getDefault();
+    cl::Kernel l_kern_copy( t_program, "copy_global", &l_err );                 CL_ERR_E( l_err );
+
+    for ( bool l_fine : { false, true } )
+    {
+        cl_device_svm_capabilities l_caps = cl::Device::getDefault().getInfo< CL_DEVICE_SVM_CAPABILITIES >();
+        if ( l_fine && ( l_caps & CL_DEVICE_SVM_FINE_GRAIN_BUFFER ) == 0 )
+        {
+            std::cout << "Fine-grained SVM is not supported by device." << std::endl;
+            continue;
+        }
+
+        cl_svm_mem_flags l_flags = CL_MEM_READ_WRITE | ( l_fine ? CL_MEM_SVM_FINE_GRAIN_BUFFER : 0 );
+        float *l_src = ( float * ) clSVMAlloc( l_context(), l_flags, t_bytes, 0 );
+        float *l_dst = ( float * ) clSVMAlloc( l_context(), l_flags, t_bytes, 0 );
+        if ( l_src && l_dst )
+        {
+            double l_gbps = svm_round_trip( l_kern_copy, l_src, l_dst, t_bytes, !l_fine );
+            ( l_fine ? t_profile.m_svm_fine_gbps : t_profile.m_svm_coarse_gbps ) = l_gbps;
+        }
+        else
+        {
+            std::cerr << "Unable to allocate SVM!" << std::endl;
+        }
+        if ( l_src ) clSVMFree( l_context(), l_src );
+        if ( l_dst ) clSVMFree( l_context(), l_dst );
+    }
+}
+
+// **************************************************************************
+// launch latency of empty kernel
+void measure_launch( OCLDeviceProfile &t_profile, cl::Program &t_program )
+{
+    cl_int l_err;
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+    cl::Kernel l_kern_empty( t_program, "empty_kernel", &l_err );               CL_ERR_E( l_err );
+
+    const int l_count = 1000;
+    for ( int w = 0; w < 10; w++ )
+    {
+        l_err = defQueue.enqueueNDRangeKernel( l_kern_empty, cl::NullRange, cl::NDRange( 1 ), cl::NullRange );  CL_ERR_E( l_err );
+    }
+    l_err = defQueue.finish();                                                  CL_ERR_E( l_err );
+
+    // every launch waits, the whole round trip to device
+    auto l_start = std::chrono::steady_clock::now();
+    for ( int i = 0; i < l_count; i++ )
+    {
+        l_err = defQueue.enqueueNDRangeKernel( l_kern_empty, cl::NullRange, cl::NDRange( 1 ), cl::NullRange );  CL_ERR_E( l_err );
+        l_err = defQueue.finish();                                              CL_ERR_E( l_err );
+    }
+    t_profile.m_launch_finish_us = ms_from( l_start ) * 1000 / l_count;
+
+    // launches are queued, only one wait
+    l_start = std::chrono::steady_clock::now();
+    for ( int i = 0; i < l_count; i++ )
+    {
+        l_err = defQueue.enqueueNDRangeKernel( l_kern_empty, cl::NullRange, cl::NDRange( 1 ), cl::NullRange );  CL_ERR_E( l_err );
+    }
+    l_err = defQueue.finish();                                                  CL_ERR_E( l_err );
+    t_profile.m_launch_us = ms_from( l_start ) * 1000 / l_count;
+}
+
+// **************************************************************************
+// blocking copies between host and device, bandwidth in GB/s
+double copy_gbps( cl::Buffer &t_dev, void *t_host, size_t t_bytes, bool t_upload )
+{
+    cl_int l_err;
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+    double l_best = 0;
+
+    for ( int r = 0; r < 5; r++ )
+    {
+        auto l_start = std::chrono::steady_clock::now();
+        if ( t_upload )
+        {
+            l_err = defQueue.enqueueWriteBuffer( t_dev, CL_TRUE, 0, t_bytes, t_host );  CL_ERR_E( l_err );
+        }
+        else
+        {
+            l_err = defQueue.enqueueReadBuffer( t_dev, CL_TRUE, 0, t_bytes, t_host );   CL_ERR_E( l_err );
+        }
+        l_best = std::max( l_best, t_bytes / ms_from( l_start ) / 1e6 );
+    }
+    return l_best;
+}
+
+// **************************************************************************
+// transfers from pageable and from pinned host memory
+void measure_transfer( OCLDeviceProfile &t_profile, size_t t_bytes )
+{
+    cl_int l_err;
+    cl::Context l_context = cl::Context::getDefault();
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    cl::Buffer l_dev( l_context, CL_MEM_READ_WRITE, t_bytes, nullptr, &l_err ); CL_ERR_E( l_err );
+
+    std::vector< char > l_pageable( t_bytes, 1 );
+    t_profile.m_h2d_gbps = copy_gbps( l_dev, l_pageable.data(), t_bytes, true );
+    t_profile.m_d2h_gbps = copy_gbps( l_dev, l_pageable.data(), t_bytes, false );
+
+    // pinned memory allocated by OpenCL and mapped once
+    cl::Buffer l_pinned( l_context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, t_bytes, nullptr, &l_err );  CL_ERR_E( l_err );
+    void *l_host = defQueue.enqueueMapBuffer( l_pinned, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, t_bytes, nullptr, nullptr, &l_err );  CL_ERR_E( l_err );
+    memset( l_host, 1, t_bytes );
+    t_profile.m_h2d_pinned_gbps = copy_gbps( l_dev, l_host, t_bytes, true );
+    t_profile.m_d2h_pinned_gbps = copy_gbps( l_dev, l_host, t_bytes, false );
+    l_err = defQueue.enqueueUnmapMemObject( l_pinned, l_host );                 CL_ERR_E( l_err );
+    l_err = defQueue.finish();                                                  CL_ERR_E( l_err );
+}
+
+// **************************************************************************
+// float and integer multiply-add throughput
+void measure_compute( OCLDeviceProfile &t_profile, OCLBench &t_bench, cl::Program &t_program )
+{
+    cl_int l_err;
+
+    const size_t l_items = 256 * 1024;
+    const int l_iters = 256;
+    // 8 chains of 4 elements, multiply-add is 2 operations
+    const double l_ops = ( double ) l_items * l_iters * 8 * 4 * 2;
+
+    cl::Buffer l_dst( cl::Context::getDefault(), CL_MEM_READ_WRITE, l_items * sizeof( float ), nullptr, &l_err );  CL_ERR_E( l_err );
+
+    cl::Kernel l_kern_float( t_program, "float_mad", &l_err );                  CL_ERR_E( l_err );
+    l_err = l_kern_float.setArg( 0, l_dst );                                    CL_ERR_E( l_err );
+    l_err = l_kern_float.setArg( 1, 0.999f );                                   CL_ERR_E( l_err );
+    l_err = l_kern_float.setArg( 2, 0.001f );                                   CL_ERR_E( l_err );
+    l_err = l_kern_float.setArg( 3, l_iters );                                  CL_ERR_E( l_err );
+    l_err = t_bench.run( "float_mad", l_kern_float, l_items, 1, cl::NDRange( l_items ), cl::NullRange, l_items, l_items * sizeof( float ) );  CL_ERR_E( l_err );
+    t_profile.m_float_gflops = l_ops / t_bench.results().back().m_median_ms / 1e6;
+
+    cl::Kernel l_kern_int( t_program, "int_mad", &l_err );                      CL_ERR_E( l_err );
+    l_err = l_kern_int.setArg( 0, l_dst );                                      CL_ERR_E( l_err );
+    l_err = l_kern_int.setArg( 1, ( cl_uint ) 1664525 );                        CL_ERR_E( l_err );
+    l_err = l_kern_int.setArg( 2, ( cl_uint ) 1013904223 );                     CL_ERR_E( l_err );
+    l_err = l_kern_int.setArg( 3, l_iters );                                    CL_ERR_E( l_err );
+    l_err = t_bench.run( "int_mad", l_kern_int, l_items, 1, cl::NDRange( l_items ), cl::NullRange, l_items, l_items * sizeof( cl_uint ) );  CL_ERR_E( l_err );
+    t_profile.m_int_giops = l_ops / t_bench.results().back().m_median_ms / 1e6;
+}
+
+// **************************************************************************
+int main( int t_narg, char **t_args )
+{
+    bool l_characterize = false;
+    int l_device = 0;
+    size_t l_mbytes = 256;
+    const char *l_profile_name = "device_profile.json";
+    std::vector< const char * > l_report_names;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "cg:k:m:o:" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 'c': l_characterize = true; break;
+        case 'g': l_device = std::max( 0, atoi( optarg ) ); break;
+        case 'k': l_report_names.push_back( optarg ); break;
+        case 'm': l_mbytes = std::max( 1, atoi( optarg ) ); break;
+        case 'o': l_profile_name = optarg; break;
+        default:
+            std::cerr << "Usage: " << t_args[ 0 ] << " [-c] [-g device] [-k kernel.spv] [-m MB] [-o profile.json]" << std::endl;
+            std::cerr << "  -c  characterization of device" << std::endl;
+            std::cerr << "  -k  report of kernel resources, option can be repeated" << std::endl;
+            std::cerr << "  -m  size of buffers for bandwidth" << std::endl;
+            std::cerr << "  -o  file for profile of device" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    cl_int l_err;
+
+    l_err = ocl_init( 2, l_device );                                            CL_ERR_E( l_err );
 
     std::cout << "\nOpenCL 3.0 available, at least one Platform and one GPU Device detected." << std::endl;
+
+    for ( const char *l_report_name : l_report_names )
+    {
+        cl::Program l_report_program( ocl_load_program( l_report_name ) );
+        if ( l_report_program() == nullptr )
+        {
+            std::cerr << "Program " << l_report_name << " not built!" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+        std::cout << std::endl;
+        ocl_kernel_report( l_report_program, std::cout, l_report_name );
+    }
+
+    if ( !l_characterize ) return 0;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    // buffers must fit into one allocation
+    size_t l_bytes = l_mbytes * 1024 * 1024;
+    l_bytes = std::min< size_t >( l_bytes, cl::Device::getDefault().getInfo< CL_DEVICE_MAX_MEM_ALLOC_SIZE >() );
+    l_bytes = l_bytes / sizeof( cl_float4 ) * sizeof( cl_float4 );
+
+    std::cout << "\nCharacterization of device with buffers " << l_bytes / 1048576.0 << " MB.\n" << std::endl;
+
+    OCLDeviceProfile l_profile;
+    l_profile.m_device = cl::Device::getDefault().getInfo< CL_DEVICE_NAME >();
+
+    OCLBench l_bench( 2, 5 );
+
+    measure_memory( l_profile, l_bench, l_program, l_bytes );
+    measure_svm( l_profile, l_program, l_bytes );
+    measure_launch( l_profile, l_program );
+    measure_transfer( l_profile, l_bytes );
+    measure_compute( l_profile, l_bench, l_program );
+
+    std::cout << std::endl;
+    l_profile.print( std::cout );
+
+    if ( !l_profile.save( l_profile_name ) )
+    {
+        std::cerr << "Unable to write profile " << l_profile_name << "!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+    std::cout << "\nProfile saved into " << l_profile_name << "." << std::endl;
 }
@@ -0,0 +1,128 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_profile.cpp
+ * @brief Measured limits of device saved in JSON file.
+ *
+ * @details
+ * Source file for structure @ref OCLDeviceProfile.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "ocl_profile.h"
+
+// keys of JSON, units and members, one table for save, load and print
+static const struct
+{
+    const char *m_key;
+    const char *m_unit;
+    double OCLDeviceProfile::*m_value;
+}
+g_profile_fields[] =
+{
+    { "read_gbps",          "GB/s",     &OCLDeviceProfile::m_read_gbps },
+    { "write_gbps",         "GB/s",     &OCLDeviceProfile::m_write_gbps },
+    { "copy_gbps",          "GB/s",     &OCLDeviceProfile::m_copy_gbps },
+    { "svm_coarse_gbps",    "GB/s",     &OCLDeviceProfile::m_svm_coarse_gbps },
+    { "svm_fine_gbps",      "GB/s",     &OCLDeviceProfile::m_svm_fine_gbps },
+    { "launch_us",          "us",       &OCLDeviceProfile::m_launch_us },
+    { "launch_finish_us",   "us",       &OCLDeviceProfile::m_launch_finish_us },
+    { "h2d_gbps",           "GB/s",     &OCLDeviceProfile::m_h2d_gbps },
+    { "d2h_gbps",           "GB/s",     &OCLDeviceProfile::m_d2h_gbps },
+    { "h2d_pinned_gbps",    "GB/s",     &OCLDeviceProfile::m_h2d_pinned_gbps },
+    { "d2h_pinned_gbps",    "GB/s",     &OCLDeviceProfile::m_d2h_pinned_gbps },
+    { "float_gflops",       "GFLOP/s",  &OCLDeviceProfile::m_float_gflops },
+    { "int_giops",          "GIOP/s",   &OCLDeviceProfile::m_int_giops },
+};
+
+/// @copydoc OCLDeviceProfile::peak_gbps
+double OCLDeviceProfile::peak_gbps() const
+{
+    return std::max( { m_read_gbps, m_write_gbps, m_copy_gbps } );
+}
+
+/// @copydoc OCLDeviceProfile::save
+bool OCLDeviceProfile::save( const std::string &t_file_name ) const
+{
+    std::ofstream l_file( t_file_name );
+    if ( !l_file ) return false;
+
+    // quotes must not be in name of device
+    std::string l_device = m_device;
+    std::replace( l_device.begin(), l_device.end(), '"', '\'' );
+
+    l_file << std::fixed << std::setprecision( 3 );
+    l_file << "{" << std::endl;
+    l_file << "  \"device\": \"" << l_device << "\"";
+    for ( auto &l_field : g_profile_fields )
+    {
+        l_file << "," << std::endl << "  \"" << l_field.m_key << "\": " << this->*l_field.m_value;
+    }
+    l_file << std::endl << "}" << std::endl;
+
+    return l_file.good();
+}
+
+/// @copydoc OCLDeviceProfile::load
+bool OCLDeviceProfile::load( const std::string &t_file_name )
+{
+    std::ifstream l_file( t_file_name );
+    if ( !l_file ) return false;
+
+    std::stringstream l_ss;
+    l_ss << l_file.rdbuf();
+    std::string l_json = l_ss.str();
+
+    *this = OCLDeviceProfile();
+
+    // flat object written by save, value follows colon after key
+    size_t l_pos = l_json.find( "\"device\"" );
+    if ( l_pos != std::string::npos )
+    {
+        size_t l_begin = l_json.find( '"', l_json.find( ':', l_pos ) );
+        size_t l_end = l_json.find( '"', l_begin + 1 );
+        if ( l_begin != std::string::npos && l_end != std::string::npos )
+        {
+            m_device = l_json.substr( l_begin + 1, l_end - l_begin - 1 );
+        }
+    }
+    for ( auto &l_field : g_profile_fields )
+    {
+        l_pos = l_json.find( std::string( "\"" ) + l_field.m_key + "\"" );
+        if ( l_pos == std::string::npos ) continue;
+        l_pos = l_json.find( ':', l_pos );
+        if ( l_pos == std::string::npos ) continue;
+        this->*l_field.m_value = strtod( l_json.c_str() + l_pos + 1, nullptr );
+    }
+
+    return true;
+}
+
+/// @copydoc OCLDeviceProfile::print
+void OCLDeviceProfile::print( std::ostream &t_stream ) const
+{
+    t_stream << "Profile of device " << m_device << std::endl;
+    t_stream << std::fixed << std::setprecision( 3 );
+    for ( auto &l_field : g_profile_fields )
+    {
+        t_stream << "  " << std::left << std::setw( 20 ) << l_field.m_key << std::right
+                 << std::setw( 14 ) << this->*l_field.m_value << " " << l_field.m_unit << std::endl;
+    }
+}
@@ -0,0 +1,85 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course 
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Processing of big image in tiles.
+ * Kernels get only one tile with halo rows, both images have the same size.
+ * 
+ ***************************************************************************/
+
+#include "ocl_image.h"
+
+// kernel for BGR to BW conversion
+__kernel void convert_bgr_to_bw( __global OCLImage *t_ocl_bgr_img, __global OCLImage *t_ocl_bw_img )
+{
+    // get work-item position  
+    size_t global_idx = get_global_id( 0 );
+    size_t global_idy = get_global_id( 1 );
+
+    // verify work-item position
+    if ( global_idx >= t_ocl_bgr_img->m_size.x ) return;
+    if ( global_idy >= t_ocl_bgr_img->m_size.y ) return;
+
+    // get one point from image
+    uchar4 l_bgr = t_ocl_bgr_img->at4( global_idy, global_idx );
+
+    // convert BGR to BW: 10% Blue + 59% Green + 30% Red
+    uchar l_bw = l_bgr.x * 11 / 100 + l_bgr.y * 59 / 100 + l_bgr.z * 30 / 100;
+
+    // put point into image
+    t_ocl_bw_img->at1( global_idy, global_idx ) = l_bw;
+}
+
+// **************************************************************************
+// kernel for box blur of BGR image
+// Neighbourhood is limited by image, so tile needs t_radius halo rows.
+__kernel void blur_bgr( __global OCLImage *t_ocl_src_img, __global OCLImage *t_ocl_dst_img, int t_radius )
+{
+    // get work-item position  
+    int global_idx = get_global_id( 0 );
+    int global_idy = get_global_id( 1 );
+
+    int l_width = t_ocl_src_img->m_size.x;
+    int l_height = t_ocl_src_img->m_size.y;
+
+    // verify work-item position
+    if ( global_idx >= l_width ) return;
+    if ( global_idy >= l_height ) return;
+
+    // neighbourhood inside of image
+    int l_y0 = max( global_idy - t_radius, 0 );
+    int l_y1 = min( global_idy + t_radius, l_height - 1 );
+    int l_x0 = max( global_idx - t_radius, 0 );
+    int l_x1 = min( global_idx + t_radius, l_width - 1 );
+
+    // sum of all points
+    uint4 l_sum = { 0, 0, 0, 0 };
+    for ( int y = l_y0; y <= l_y1; y++ )
+    {
+        for ( int x = l_x0; x <= l_x1; x++ )
+        {
+            uchar4 l_bgr = t_ocl_src_img->at4( y, x );
+            l_sum.x += l_bgr.x;
+            l_sum.y += l_bgr.y;
+            l_sum.z += l_bgr.z;
+            l_sum.w += l_bgr.w;
+        }
+    }
+
+    uint l_count = ( l_y1 - l_y0 + 1 ) * ( l_x1 - l_x0 + 1 );
+
+    // put average into image
+    uchar4 l_avg;
+    l_avg.x = l_sum.x / l_count;
+    l_avg.y = l_sum.y / l_count;
+    l_avg.z = l_sum.z / l_count;
+    l_avg.w = l_sum.w / l_count;
+    t_ocl_dst_img->at4( global_idy, global_idx ) = l_avg;
+}
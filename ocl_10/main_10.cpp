@@ -0,0 +1,274 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Processing of image bigger than device memory.
+ * Raw BGRA image is mapped from file and processed in tiles,
+ * only a few tile buffers are allocated in SVM.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <unistd.h>
+#include <iostream>
+#include <math.h>
+#include <chrono>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_tiled.h"
+
+#define KERNEL_SPV      "kernel_10.spv"
+#define KERNEL_PREFIX   "tile_"
+
+// **************************************************************************
+// tile_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix tile_.
+// Function only sets arguments, kernel is enqueued by OCLTiledExec.
+//
+// Kernel for BGR to BW conversion
+// Kernel header from kernel*.cl:
+// __kernel void convert_bgr_to_bw(          __global OCLImage *t_ocl_bgr_img,
+//                                           __global OCLImage *t_ocl_bw_img )
+cl::Kernel &tile_convert_bgr_to_bw( cl::Program &t_program, OCLImage *t_ocl_bgr_img, OCLImage *t_ocl_bw_img )
+{
+    cl_int l_err;
+
+    // kernel is selected only once and used for all tiles
+    static cl::Kernel l_kern_convert_bgr_to_bw;
+    if ( l_kern_convert_bgr_to_bw() == nullptr )
+    {
+        // removing prefix tile_
+        std::string l_kern_name( __FUNCTION__ );
+        if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+        {
+            l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+        }
+
+        // select the kernel from opencl program
+        l_kern_convert_bgr_to_bw = cl::Kernel( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_C( l_err );
+    }
+
+    // set kernel arguments
+    l_err = l_kern_convert_bgr_to_bw.setArg( 0, t_ocl_bgr_img );                CL_ERR_C( l_err );
+    l_err = l_kern_convert_bgr_to_bw.setArg( 1, t_ocl_bw_img );                 CL_ERR_C( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_convert_bgr_to_bw.setSVMPointers( {
+            t_ocl_bgr_img,
+            t_ocl_bgr_img->m_data,
+            t_ocl_bw_img,
+            t_ocl_bw_img->m_data,
+            } );
+
+    return l_kern_convert_bgr_to_bw;
+}
+
+// **************************************************************************
+// tile_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix tile_.
+// Function only sets arguments, kernel is enqueued by OCLTiledExec.
+//
+// Kernel for box blur of BGR image
+// Kernel header from kernel*.cl:
+// __kernel void blur_bgr(                   __global OCLImage *t_ocl_src_img,
+//                                           __global OCLImage *t_ocl_dst_img,
+//                                           int t_radius )
+cl::Kernel &tile_blur_bgr( cl::Program &t_program, OCLImage *t_ocl_src_img, OCLImage *t_ocl_dst_img, int t_radius )
+{
+    cl_int l_err;
+
+    // kernel is selected only once and used for all tiles
+    static cl::Kernel l_kern_blur_bgr;
+    if ( l_kern_blur_bgr() == nullptr )
+    {
+        // removing prefix tile_
+        std::string l_kern_name( __FUNCTION__ );
+        if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+        {
+            l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+        }
+
+        // select the kernel from opencl program
+        l_kern_blur_bgr = cl::Kernel( t_program, l_kern_name.c_str(), &l_err ); CL_ERR_C( l_err );
+    }
+
+    // set kernel arguments
+    l_err = l_kern_blur_bgr.setArg( 0, t_ocl_src_img );                         CL_ERR_C( l_err );
+    l_err = l_kern_blur_bgr.setArg( 1, t_ocl_dst_img );                         CL_ERR_C( l_err );
+    l_err = l_kern_blur_bgr.setArg( 2, t_radius );                              CL_ERR_C( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_blur_bgr.setSVMPointers( {
+            t_ocl_src_img,
+            t_ocl_src_img->m_data,
+            t_ocl_dst_img,
+            t_ocl_dst_img->m_data,
+            } );
+
+    return l_kern_blur_bgr;
+}
+
+// **************************************************************************
+// Synthetic BGRA image written row by row into mapped file.
+bool generate_image( const char *t_filename, int t_width, int t_height )
+{
+    OCLMappedFile l_file( t_filename, ( size_t ) t_width * t_height * 4 );
+    if ( l_file.data() == nullptr ) return false;
+
+    size_t l_row_size = ( size_t ) t_width * 4;
+    for ( int y = 0; y < t_height; y++ )
+    {
+        unsigned char *l_row = l_file.data() + y * l_row_size;
+        for ( int x = 0; x < t_width; x++ )
+        {
+            // color gradient with stripes
+            l_row[ x * 4 + 0 ] = x * 255 / t_width;
+            l_row[ x * 4 + 1 ] = y * 255 / t_height;
+            l_row[ x * 4 + 2 ] = ( ( x / 64 + y / 64 ) % 2 ) * 255;
+            l_row[ x * 4 + 3 ] = 0;
+        }
+        // written rows are not needed in memory
+        if ( y % 256 == 255 )
+        {
+            l_file.release( ( y - 255 ) * l_row_size, 256 * l_row_size );
+        }
+    }
+    return true;
+}
+
+// **************************************************************************
+
+int main( int t_narg, char **t_args )
+{
+    int l_width = 16384;
+    int l_height = 16384;
+    int l_tile_rows = 0;
+    int l_buffers = 3;
+    int l_radius = 4;
+    bool l_blur = true;
+    bool l_generate = false;
+    int l_verbose = 1;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "s:t:b:k:r:gv" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 's':
+            if ( sscanf( optarg, "%dx%d", &l_width, &l_height ) != 2 || l_width <= 0 || l_height <= 0 )
+            {
+                std::cerr << "Wrong size '" << optarg << "'." << std::endl;
+                exit( EXIT_FAILURE );
+            }
+            break;
+        case 't': l_tile_rows = atoi( optarg ); break;
+        case 'b': l_buffers = std::max( 1, atoi( optarg ) ); break;
+        case 'k': l_blur = strcmp( optarg, "bw" ) != 0; break;
+        case 'r': l_radius = std::max( 0, atoi( optarg ) ); break;
+        case 'g': l_generate = true; break;
+        case 'v': l_verbose++; break;
+        default:
+            optind = t_narg;
+        }
+    }
+
+    if ( optind + 2 != t_narg )
+    {
+        std::cerr << "Usage: " << t_args[ 0 ] << " [-s WIDTHxHEIGHT] [-t rows] [-b buffers] [-k blur|bw] [-r radius] [-g] [-v] input.raw output.raw" << std::endl;
+        std::cerr << "  -s  size of raw BGRA input image" << std::endl;
+        std::cerr << "  -t  rows of one tile, default is derived from device limits" << std::endl;
+        std::cerr << "  -b  number of tile buffers in progress" << std::endl;
+        std::cerr << "  -k  kernel: box blur of BGRA image or conversion to BW image" << std::endl;
+        std::cerr << "  -r  radius of blur" << std::endl;
+        std::cerr << "  -g  generate synthetic input image" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    const char *l_in_name = t_args[ optind ];
+    const char *l_out_name = t_args[ optind + 1 ];
+
+    if ( l_generate )
+    {
+        std::cout << "Generating image " << l_width << "x" << l_height << " into '" << l_in_name << "'." << std::endl;
+        if ( !generate_image( l_in_name, l_width, l_height ) ) exit( EXIT_FAILURE );
+    }
+
+    cl_int l_err;
+
+    l_err = ocl_init( 1 );                                                      CL_ERR_E( l_err );
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "Program loaded.\n" << std::endl;
+
+    // input image mapped from file
+    OCLMappedFile l_in_file( l_in_name );
+    if ( l_in_file.data() == nullptr ) exit( EXIT_FAILURE );
+    if ( l_in_file.size() != ( size_t ) l_width * l_height * 4 )
+    {
+        std::cerr << "Size of '" << l_in_name << "' does not match image " << l_width << "x" << l_height << " BGRA." << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    // output image created in file
+    int l_out_elem = l_blur ? 4 : 1;
+    OCLMappedFile l_out_file( l_out_name, ( size_t ) l_width * l_height * l_out_elem );
+    if ( l_out_file.data() == nullptr ) exit( EXIT_FAILURE );
+
+    OCLHostImage l_in_img = { l_in_file.data(), l_width, l_height, 4, &l_in_file };
+    OCLHostImage l_out_img = { l_out_file.data(), l_width, l_height, l_out_elem, &l_out_file };
+
+    size_t l_max_alloc = cl::Device::getDefault().getInfo< CL_DEVICE_MAX_MEM_ALLOC_SIZE >();
+    size_t l_global_mem = cl::Device::getDefault().getInfo< CL_DEVICE_GLOBAL_MEM_SIZE >();
+    std::cout << "Image " << l_width << "x" << l_height << ": " << l_in_file.size() / 1024 / 1024 << " MB, "
+              << "device max. allocation " << l_max_alloc / 1024 / 1024 << " MB, "
+              << "global memory " << l_global_mem / 1024 / 1024 << " MB." << std::endl;
+
+    // blur needs neighbouring rows of tile
+    OCLTiledExec l_tiled( l_tile_rows, l_blur ? l_radius : 0, l_buffers );
+
+    auto l_start = std::chrono::steady_clock::now();
+
+    if ( l_blur )
+    {
+        l_err = l_tiled.run( l_in_img, l_out_img, [ & ] ( OCLImage *t_in, OCLImage *t_out ) -> cl::Kernel &
+                { return tile_blur_bgr( l_program, t_in, t_out, l_radius ); }, l_verbose );
+    }
+    else
+    {
+        l_err = l_tiled.run( l_in_img, l_out_img, [ & ] ( OCLImage *t_in, OCLImage *t_out ) -> cl::Kernel &
+                { return tile_convert_bgr_to_bw( l_program, t_in, t_out ); }, l_verbose );
+    }
+    CL_ERR_E( l_err );
+
+    auto l_end = std::chrono::steady_clock::now();
+    double l_ms = std::chrono::duration< double, std::milli >( l_end - l_start ).count();
+
+    std::cout << "\nTile rows:       " << l_tiled.tile_rows() << std::endl;
+    std::cout << "Peak SVM:        " << l_tiled.peak_bytes() / 1024 / 1024 << " MB" << std::endl;
+    std::cout << "Time:            " << l_ms << " ms" << std::endl;
+    std::cout << "Throughput:      " << l_in_file.size() / 1024.0 / 1024.0 / ( l_ms / 1000 ) << " MB/s" << std::endl;
+    std::cout << "Output written into '" << l_out_name << "'." << std::endl;
+}
@@ -0,0 +1,304 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_tiled.cpp
+ * @brief Out-of-core processing of big images in tiles.
+ *
+ * @details
+ * Source file for classes @ref OCLMappedFile and @ref OCLTiledExec.
+ *
+ ***************************************************************************/
+
+#include <iostream>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ocl_utils.h"
+#include "ocl_tiled.h"
+
+// limit of one tile buffer when tile size is not specified
+#define TILE_MAX_BYTES      ( 64 * 1024 * 1024 )
+
+/// @copydoc OCLMappedFile::OCLMappedFile
+OCLMappedFile::OCLMappedFile( const std::string &t_filename, size_t t_size ) :
+    m_fd( -1 ), m_data( nullptr ), m_size( 0 )
+{
+    if ( t_size > 0 )
+    {
+        // new output file
+        m_fd = open( t_filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+        if ( m_fd < 0 || ftruncate( m_fd, t_size ) != 0 )
+        {
+            std::cerr << "Unable to create file '" << t_filename << "'." << std::endl;
+            return;
+        }
+        m_size = t_size;
+    }
+    else
+    {
+        // existing input file
+        struct stat l_stat;
+        m_fd = open( t_filename.c_str(), O_RDONLY );
+        if ( m_fd < 0 || fstat( m_fd, &l_stat ) != 0 )
+        {
+            std::cerr << "Unable to open file '" << t_filename << "'." << std::endl;
+            return;
+        }
+        m_size = l_stat.st_size;
+    }
+
+    void *l_ptr = mmap( nullptr, m_size, t_size > 0 ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, m_fd, 0 );
+    if ( l_ptr == MAP_FAILED )
+    {
+        std::cerr << "Unable to map file '" << t_filename << "'." << std::endl;
+        return;
+    }
+
+    m_data = ( unsigned char * ) l_ptr;
+
+    // file is read and written sequentially
+    madvise( m_data, m_size, MADV_SEQUENTIAL );
+}
+
+/// @copydoc OCLMappedFile::~OCLMappedFile
+OCLMappedFile::~OCLMappedFile()
+{
+    if ( m_data )
+    {
+        munmap( m_data, m_size );
+    }
+    if ( m_fd >= 0 )
+    {
+        close( m_fd );
+    }
+}
+
+/// @copydoc OCLMappedFile::release
+void OCLMappedFile::release( size_t t_offset, size_t t_len )
+{
+    if ( m_data == nullptr ) return;
+
+    // only whole pages inside of range
+    size_t l_page = sysconf( _SC_PAGESIZE );
+    size_t l_first = ( t_offset + l_page - 1 ) / l_page * l_page;
+    size_t l_last = std::min( t_offset + t_len, m_size ) / l_page * l_page;
+
+    if ( l_first < l_last )
+    {
+        // pages of shared mapping are kept in file, only memory is released
+        madvise( m_data + l_first, l_last - l_first, MADV_DONTNEED );
+    }
+}
+
+/// @copydoc OCLTiledExec::OCLTiledExec
+OCLTiledExec::OCLTiledExec( int t_tile_rows, int t_halo, int t_buffers ) :
+    m_slots( std::max( 1, t_buffers ) ), m_tile_rows_req( t_tile_rows ), m_tile_rows( 0 ), m_halo( t_halo ), m_peak_bytes( 0 )
+{
+    cl_int l_err;
+
+    // upload, compute and download are in separate queues, so they can overlap
+    m_upload_queue = cl::CommandQueue( cl::Context::getDefault(), cl::Device::getDefault(), 0, &l_err );     CL_ERR_C( l_err );
+    m_compute_queue = cl::CommandQueue( cl::Context::getDefault(), cl::Device::getDefault(), 0, &l_err );    CL_ERR_C( l_err );
+    m_download_queue = cl::CommandQueue( cl::Context::getDefault(), cl::Device::getDefault(), 0, &l_err );   CL_ERR_C( l_err );
+
+    for ( auto &l_slot : m_slots )
+    {
+        l_slot.m_in_data = l_slot.m_out_data = nullptr;
+        l_slot.m_ocl_in_img = l_slot.m_ocl_out_img = nullptr;
+    }
+}
+
+/// @copydoc OCLTiledExec::~OCLTiledExec
+OCLTiledExec::~OCLTiledExec()
+{
+    deallocate();
+}
+
+/// @copydoc OCLTiledExec::allocate
+cl_int OCLTiledExec::allocate( const OCLHostImage &t_in, const OCLHostImage &t_out )
+{
+    deallocate();
+
+    size_t l_row_bytes = std::max( t_in.row_size(), t_out.row_size() );
+
+    m_tile_rows = m_tile_rows_req;
+    if ( m_tile_rows <= 0 )
+    {
+        // one tile buffer must not be bigger than max. allocation of device
+        size_t l_max_alloc = cl::Device::getDefault().getInfo< CL_DEVICE_MAX_MEM_ALLOC_SIZE >();
+        size_t l_limit = std::min< size_t >( l_max_alloc, TILE_MAX_BYTES );
+        m_tile_rows = ( int ) ( l_limit / l_row_bytes ) - 2 * m_halo;
+    }
+    m_tile_rows = std::max( 1, std::min( m_tile_rows, t_in.m_height ) );
+
+    size_t l_band_rows = m_tile_rows + 2 * m_halo;
+    m_peak_bytes = 0;
+
+    for ( auto &l_slot : m_slots )
+    {
+        l_slot.m_in_data = ocl_svm_malloc< unsigned char >( l_band_rows * t_in.row_size() );
+        l_slot.m_out_data = ocl_svm_malloc< unsigned char >( l_band_rows * t_out.row_size() );
+        l_slot.m_ocl_in_img = ocl_svm_malloc< OCLImage >();
+        l_slot.m_ocl_out_img = ocl_svm_malloc< OCLImage >();
+
+        if ( !l_slot.m_in_data || !l_slot.m_out_data || !l_slot.m_ocl_in_img || !l_slot.m_ocl_out_img )
+        {
+            std::cerr << "Unable to allocate tile buffers of " << l_band_rows << " rows!" << std::endl;
+            deallocate();
+            return CL_MEM_OBJECT_ALLOCATION_FAILURE;
+        }
+
+        m_peak_bytes += l_band_rows * ( t_in.row_size() + t_out.row_size() );
+    }
+
+    return CL_SUCCESS;
+}
+
+/// @copydoc OCLTiledExec::deallocate
+void OCLTiledExec::deallocate()
+{
+    for ( auto &l_slot : m_slots )
+    {
+        ocl_svm_free( l_slot.m_in_data );
+        ocl_svm_free( l_slot.m_out_data );
+        ocl_svm_free( l_slot.m_ocl_in_img );
+        ocl_svm_free( l_slot.m_ocl_out_img );
+        l_slot.m_in_data = l_slot.m_out_data = nullptr;
+        l_slot.m_ocl_in_img = l_slot.m_ocl_out_img = nullptr;
+        l_slot.m_done = cl::Event();
+    }
+}
+
+/// @copydoc OCLTiledExec::release
+void OCLTiledExec::release( TileSlot &t_slot, const OCLHostImage &t_in, const OCLHostImage &t_out )
+{
+    if ( t_slot.m_done() == nullptr ) return;
+
+    t_slot.m_done.wait();
+    t_slot.m_done = cl::Event();
+
+    // processed rows are not needed in memory
+    if ( t_in.m_file )
+    {
+        t_in.m_file->release( ( t_in.m_data - t_in.m_file->data() ) + t_slot.m_row_first * t_in.row_size(),
+                              ( size_t ) ( t_slot.m_row_last - t_slot.m_row_first ) * t_in.row_size() );
+    }
+    if ( t_out.m_file )
+    {
+        t_out.m_file->release( ( t_out.m_data - t_out.m_file->data() ) + t_slot.m_row_first * t_out.row_size(),
+                               ( size_t ) ( t_slot.m_row_last - t_slot.m_row_first ) * t_out.row_size() );
+    }
+}
+
+/// @copydoc OCLTiledExec::run
+cl_int OCLTiledExec::run( const OCLHostImage &t_in, const OCLHostImage &t_out, OCLTileKernel t_kernel, int t_verbose )
+{
+    cl_int l_err;
+
+    if ( t_in.m_width != t_out.m_width || t_in.m_height != t_out.m_height )
+    {
+        std::cerr << "Input and output image must have the same size!" << std::endl;
+        return CL_INVALID_VALUE;
+    }
+
+    l_err = allocate( t_in, t_out );                                            CL_ERR_R( l_err );
+
+    int l_height = t_in.m_height;
+    int l_tiles = ( l_height + m_tile_rows - 1 ) / m_tile_rows;
+
+    if ( t_verbose > 0 )
+    {
+        std::cout << "Tiles " << l_tiles << " x " << m_tile_rows << " rows, halo " << m_halo
+                  << " rows, " << m_slots.size() << " buffers, " << m_peak_bytes / 1024 / 1024 << " MB SVM." << std::endl;
+    }
+
+    // size of workgroup
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    int l_gr_size_x = ( t_in.m_width + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+
+    for ( int t = 0; t < l_tiles; t++ )
+    {
+        TileSlot &l_slot = m_slots[ t % m_slots.size() ];
+
+        // slot must be free, its previous tile downloaded
+        release( l_slot, t_in, t_out );
+
+        // tile rows and halo rows
+        int l_first = t * m_tile_rows;
+        int l_last = std::min( l_height, l_first + m_tile_rows );
+        int l_halo_top = std::min( m_halo, l_first );
+        int l_halo_bottom = std::min( m_halo, l_height - l_last );
+        int l_band_first = l_first - l_halo_top;
+        int l_band_rows = l_halo_top + ( l_last - l_first ) + l_halo_bottom;
+
+        l_slot.m_row_first = l_first;
+        l_slot.m_row_last = l_last;
+
+        // descriptors of whole band
+        l_slot.m_ocl_in_img->m_size.x = t_in.m_width;
+        l_slot.m_ocl_in_img->m_size.y = l_band_rows;
+        l_slot.m_ocl_in_img->m_data = l_slot.m_in_data;
+        l_slot.m_ocl_out_img->m_size.x = t_out.m_width;
+        l_slot.m_ocl_out_img->m_size.y = l_band_rows;
+        l_slot.m_ocl_out_img->m_data = l_slot.m_out_data;
+
+        // upload of band with halo
+        cl::Event l_upload;
+        l_err = m_upload_queue.enqueueMemcpySVM( l_slot.m_in_data, t_in.m_data + l_band_first * t_in.row_size(), CL_FALSE,
+                                                 l_band_rows * t_in.row_size(), nullptr, &l_upload );   CL_ERR_R( l_err );
+
+        // kernel only for rows of tile, halo rows are skipped using offset
+        cl::Kernel &l_kernel = t_kernel( l_slot.m_ocl_in_img, l_slot.m_ocl_out_img );
+        std::vector< cl::Event > l_wait_upload = { l_upload };
+        cl::Event l_compute;
+        int l_gr_size_y = ( ( l_last - l_first ) + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+        l_err = m_compute_queue.enqueueNDRangeKernel( l_kernel,
+                // offset
+                cl::NDRange( 0, l_halo_top ),
+                // global range
+                cl::NDRange( l_gr_size_x, l_gr_size_y ),
+                // work-group
+                cl::NDRange( l_wg_size_x, l_wg_size_y ),
+                &l_wait_upload, &l_compute );                                   CL_ERR_R( l_err );
+
+        // download of tile rows without halo
+        std::vector< cl::Event > l_wait_compute = { l_compute };
+        l_err = m_download_queue.enqueueMemcpySVM( t_out.m_data + l_first * t_out.row_size(),
+                                                   l_slot.m_out_data + l_halo_top * t_out.row_size(), CL_FALSE,
+                                                   ( l_last - l_first ) * t_out.row_size(),
+                                                   &l_wait_compute, &l_slot.m_done );           CL_ERR_R( l_err );
+
+        m_upload_queue.flush();
+        m_compute_queue.flush();
+        m_download_queue.flush();
+
+        if ( t_verbose > 1 )
+        {
+            std::cout << "Tile " << t << ": rows " << l_first << " - " << l_last - 1 << " submitted." << std::endl;
+        }
+    }
+
+    // the last tiles
+    for ( auto &l_slot : m_slots )
+    {
+        release( l_slot, t_in, t_out );
+    }
+
+    return CL_SUCCESS;
+}
@@ -0,0 +1,234 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * One image operation split across more devices.
+ * Image is blurred in more passes, bands of rows are processed by
+ * all GPUs (or sub-devices), halo rows are exchanged between passes.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <unistd.h>
+#include <iostream>
+#include <math.h>
+#include <chrono>
+
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/core_c.h>
+#include <opencv2/core/mat.hpp>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_svm_mat_allocator.h"
+#include "ocl_multi_dev.h"
+
+#define KERNEL_SPV      "kernel_11.spv"
+#define KERNEL_PREFIX   "part_"
+
+// **************************************************************************
+// part_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix part_.
+// Function only sets arguments, kernel is enqueued by OCLMultiDevice.
+//
+// Kernel for box blur of BGR image
+// Kernel header from kernel*.cl:
+// __kernel void blur_bgr(                   __global OCLImage *t_ocl_src_img,
+//                                           __global OCLImage *t_ocl_dst_img,
+//                                           int t_radius )
+cl::Kernel &part_blur_bgr( cl::Program &t_program, int t_device, OCLImage *t_ocl_src_img, OCLImage *t_ocl_dst_img, int t_radius )
+{
+    cl_int l_err;
+
+    // one kernel object for every device
+    static std::vector< cl::Kernel > l_kern_blur_bgr;
+    if ( ( int ) l_kern_blur_bgr.size() <= t_device )
+    {
+        l_kern_blur_bgr.resize( t_device + 1 );
+    }
+
+    cl::Kernel &l_kern = l_kern_blur_bgr[ t_device ];
+    if ( l_kern() == nullptr )
+    {
+        // removing prefix part_
+        std::string l_kern_name( __FUNCTION__ );
+        if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+        {
+            l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+        }
+
+        // select the kernel from opencl program
+        l_kern = cl::Kernel( t_program, l_kern_name.c_str(), &l_err );         CL_ERR_C( l_err );
+    }
+
+    // set kernel arguments
+    l_err = l_kern.setArg( 0, t_ocl_src_img );                                  CL_ERR_C( l_err );
+    l_err = l_kern.setArg( 1, t_ocl_dst_img );                                  CL_ERR_C( l_err );
+    l_err = l_kern.setArg( 2, t_radius );                                       CL_ERR_C( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern.setSVMPointers( {
+            t_ocl_src_img,
+            t_ocl_src_img->m_data,
+            t_ocl_dst_img,
+            t_ocl_dst_img->m_data,
+            } );
+
+    return l_kern;
+}
+
+// **************************************************************************
+#define IMG_SIZEX   7680
+#define IMG_SIZEY   4320
+
+int main( int t_narg, char **t_args )
+{
+    int l_devices = 0;
+    int l_sub_devices = 0;
+    int l_passes = 4;
+    int l_radius = 2;
+    int l_frames = 10;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "d:s:p:r:n:" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 'd': l_devices = std::max( 0, atoi( optarg ) ); break;
+        case 's': l_sub_devices = std::max( 0, atoi( optarg ) ); break;
+        case 'p': l_passes = std::max( 1, atoi( optarg ) ); break;
+        case 'r': l_radius = std::max( 0, atoi( optarg ) ); break;
+        case 'n': l_frames = std::max( 1, atoi( optarg ) ); break;
+        default:
+            std::cerr << "Usage: " << t_args[ 0 ] << " [-d devices] [-s sub-devices] [-p passes] [-r radius] [-n frames] [image]" << std::endl;
+            std::cerr << "  -d  max. number of GPUs, 0 - all GPUs of platform" << std::endl;
+            std::cerr << "  -s  split the first device into sub-devices instead of GPUs (PoCL)" << std::endl;
+            std::cerr << "  -p  number of blur passes, halo rows are exchanged between passes" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    // context with all devices instead of ocl_init
+    OCLMultiDevice l_multi( l_devices, l_sub_devices, 1 );
+
+    if ( !l_multi.ok() )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "Program loaded.\n" << std::endl;
+
+    // creating SVM allocator for cv::Mat
+    SVMMatAllocator svmallocator;
+    cv::Mat::setDefaultAllocator( &svmallocator );
+
+    // image loaded from file or synthetic image
+    cv::Mat l_cv_src_img;
+    if ( optind < t_narg )
+    {
+        l_cv_src_img = cv::imread( t_args[ optind ], cv::IMREAD_COLOR );
+        if ( l_cv_src_img.empty() )
+        {
+            std::cerr << "Unable to open image '" << t_args[ optind ] << "'." << std::endl;
+            exit( EXIT_FAILURE );
+        }
+        cv::cvtColor( l_cv_src_img, l_cv_src_img, cv::COLOR_BGR2BGRA );
+    }
+    else
+    {
+        l_cv_src_img.create( IMG_SIZEY, IMG_SIZEX, CV_8UC4 );
+        cv::randu( l_cv_src_img, cv::Scalar::all( 0 ), cv::Scalar::all( 255 ) );
+    }
+
+    // images are swapped after every pass
+    cv::Mat l_cv_a_img( l_cv_src_img.size(), CV_8UC4 );
+    cv::Mat l_cv_b_img( l_cv_src_img.size(), CV_8UC4 );
+    cv::Mat &l_cv_res_img = l_passes % 2 ? l_cv_b_img : l_cv_a_img;
+    cv::Mat l_cv_ref_img;
+
+    OCLImage *l_ocl_a_img = ocl_svm_malloc< OCLImage >();
+    l_ocl_a_img->m_size.x = l_cv_a_img.size().width;
+    l_ocl_a_img->m_size.y = l_cv_a_img.size().height;
+    l_ocl_a_img->m_data = l_cv_a_img.data;
+
+    OCLImage *l_ocl_b_img = ocl_svm_malloc< OCLImage >();
+    l_ocl_b_img->m_size.x = l_cv_b_img.size().width;
+    l_ocl_b_img->m_size.y = l_cv_b_img.size().height;
+    l_ocl_b_img->m_data = l_cv_b_img.data;
+
+    auto l_kernel = [ & ] ( int t_device, OCLImage *t_in, OCLImage *t_out ) -> cl::Kernel &
+            { return part_blur_bgr( l_program, t_device, t_in, t_out, l_radius ); };
+
+    std::cout << "Image " << l_cv_src_img.cols << "x" << l_cv_src_img.rows << ", " << l_passes << " passes, radius "
+              << l_radius << ", " << l_frames << " frames." << std::endl;
+
+    double l_single_ms = 0, l_multi_ms = 0;
+    cl_int l_err;
+
+    // reference on the first device only
+    l_multi.use_devices( 1 );
+    for ( int f = 0; f < l_frames; f++ )
+    {
+        l_cv_src_img.copyTo( l_cv_a_img );
+
+        auto l_start = std::chrono::steady_clock::now();
+        l_err = l_multi.run( l_ocl_a_img, l_ocl_b_img, l_kernel, 4, l_radius, l_passes );  CL_ERR_E( l_err );
+        l_single_ms += std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - l_start ).count();
+    }
+    l_cv_res_img.copyTo( l_cv_ref_img );
+
+    // all devices, split is learned from frame to frame
+    l_multi.use_devices( l_multi.devices() );
+    for ( int f = 0; f < l_frames; f++ )
+    {
+        l_cv_src_img.copyTo( l_cv_a_img );
+
+        auto l_start = std::chrono::steady_clock::now();
+        l_err = l_multi.run( l_ocl_a_img, l_ocl_b_img, l_kernel, 4, l_radius, l_passes );  CL_ERR_E( l_err );
+        l_multi_ms += std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - l_start ).count();
+
+        std::cout << "Frame " << std::setw( 3 ) << f << " ";
+        for ( int i = 0; i < l_multi.active(); i++ )
+        {
+            std::cout << " [" << i << "] " << std::setw( 5 ) << l_multi.rows( i ) << " rows "
+                      << std::setprecision( 2 ) << std::fixed << std::setw( 7 ) << l_multi.device_ms( i ) << " ms";
+        }
+        std::cout << std::endl;
+    }
+
+    // halo exchange must give the same result
+    double l_diff = cv::norm( l_cv_res_img, l_cv_ref_img, cv::NORM_INF );
+    std::cout << "\nMax. difference from single device: " << l_diff << std::endl;
+
+    std::cout << "Average frame time 1 device:   " << l_single_ms / l_frames << " ms" << std::endl;
+    std::cout << "Average frame time " << l_multi.active() << " devices:  " << l_multi_ms / l_frames << " ms" << std::endl;
+    std::cout << "Speedup:                       " << l_single_ms / l_multi_ms << std::endl;
+
+    ocl_svm_free( l_ocl_a_img );
+    ocl_svm_free( l_ocl_b_img );
+
+    cv::imshow( "Blurred Image", l_cv_res_img );
+    cv::waitKey( 0 );
+}
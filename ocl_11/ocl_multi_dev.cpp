@@ -0,0 +1,375 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_multi_dev.cpp
+ * @brief One kernel launch split across several OpenCL devices.
+ *
+ * @details
+ * Source file for class @ref OCLMultiDevice.
+ *
+ ***************************************************************************/
+
+#include <iostream>
+#include <algorithm>
+
+#include "ocl_utils.h"
+#include "ocl_multi_dev.h"
+
+// rows of band are multiple of work-group size
+#define WG_SIZE     16
+
+/// @copydoc OCLMultiDevice::OCLMultiDevice
+OCLMultiDevice::OCLMultiDevice( int t_devices, int t_sub_devices, int t_verbose ) :
+    m_active( 0 ), m_smoothing( 0.3 )
+{
+    cl_int l_err;
+
+    std::vector< cl::Platform > l_platforms;
+    l_err = cl::Platform::get( &l_platforms );                                  CL_ERR_C( l_err );
+
+    cl::Platform l_platform;
+    std::vector< cl::Device > l_devices;
+
+    for ( auto &p : l_platforms )
+    {
+        std::vector< cl::Device > l_plat_devices;
+
+        if ( t_sub_devices > 0 )
+        {
+            // the first device which can be split equally
+            p.getDevices( CL_DEVICE_TYPE_ALL, &l_plat_devices );
+            for ( auto &d : l_plat_devices )
+            {
+                if ( d.getInfo< CL_DEVICE_PARTITION_MAX_SUB_DEVICES >() < ( cl_uint ) t_sub_devices ) continue;
+
+                cl_uint l_units = d.getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >() / t_sub_devices;
+                cl_device_partition_property l_prop[] = { CL_DEVICE_PARTITION_EQUALLY, std::max< cl_uint >( 1, l_units ), 0 };
+                l_err = d.createSubDevices( l_prop, &l_devices );
+                if ( l_err == CL_SUCCESS )
+                {
+                    l_platform = p;
+                    break;
+                }
+                l_devices.clear();
+            }
+            if ( l_devices.size() > 0 ) break;
+        }
+        else
+        {
+            // platform with the most GPUs
+            p.getDevices( CL_DEVICE_TYPE_GPU, &l_plat_devices );
+            if ( l_plat_devices.size() > l_devices.size() )
+            {
+                l_platform = p;
+                l_devices = l_plat_devices;
+            }
+        }
+    }
+
+    if ( l_devices.size() == 0 )
+    {
+        std::cerr << ( t_sub_devices > 0 ? "No OpenCL device with sub-devices found!" : "No OpenCL GPU device found!" ) << std::endl;
+        return;
+    }
+
+    // equal split may create more sub-devices
+    int l_limit = t_sub_devices > 0 ? t_sub_devices : t_devices;
+    if ( t_devices > 0 ) l_limit = std::min( l_limit, t_devices );
+    if ( l_limit > 0 && ( int ) l_devices.size() > l_limit )
+    {
+        l_devices.resize( l_limit );
+    }
+
+    for ( auto &d : l_devices )
+    {
+        if ( ( d.getInfo< CL_DEVICE_SVM_CAPABILITIES >() & CL_DEVICE_SVM_COARSE_GRAIN_BUFFER ) == 0 )
+        {
+            std::cerr << "Share Virtual Memory (SVM) not supported by '" << d.getInfo< CL_DEVICE_NAME >() << "'!" << std::endl;
+            return;
+        }
+    }
+
+    // one context for all devices, SVM is shared
+    cl_context_properties l_prop[] = { CL_CONTEXT_PLATFORM, ( cl_context_properties ) l_platform(), 0 };
+    cl::Context l_context( l_devices, l_prop, nullptr, nullptr, &l_err );       CL_ERR_C( l_err );
+    if ( l_err != CL_SUCCESS ) return;
+
+    cl::Platform::setDefault( l_platform );
+    cl::Device::setDefault( l_devices[ 0 ] );
+    cl::Context::setDefault( l_context );
+
+    cl::CommandQueue l_def_queue( l_context, l_devices[ 0 ], 0, &l_err );        CL_ERR_C( l_err );
+    if ( l_err != CL_SUCCESS ) return;
+    cl::CommandQueue::setDefault( l_def_queue );
+
+    // initial estimate of throughput
+    double l_sum = 0;
+    bool l_ok = true;
+    m_parts.resize( l_devices.size() );
+    for ( size_t i = 0; i < l_devices.size(); i++ )
+    {
+        Part &l_part = m_parts[ i ];
+        l_part.m_device = l_devices[ i ];
+        l_part.m_queue = cl::CommandQueue( l_context, l_devices[ i ], CL_QUEUE_PROFILING_ENABLE, &l_err );   CL_ERR_C( l_err );
+        if ( l_err != CL_SUCCESS ) l_ok = false;
+        l_part.m_share = ( double ) l_devices[ i ].getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >() *
+                         std::max< cl_uint >( 1, l_devices[ i ].getInfo< CL_DEVICE_MAX_CLOCK_FREQUENCY >() );
+        l_sum += l_part.m_share;
+        l_part.m_row_first = l_part.m_row_last = 0;
+        l_part.m_halo_top = l_part.m_halo_bottom = 0;
+        l_part.m_ms = 0;
+
+        for ( int k = 0; k < 2; k++ )
+        {
+            l_part.m_ocl_img[ k ][ 0 ] = ocl_svm_malloc< OCLImage >();
+            l_part.m_ocl_img[ k ][ 1 ] = ocl_svm_malloc< OCLImage >();
+            if ( !l_part.m_ocl_img[ k ][ 0 ] || !l_part.m_ocl_img[ k ][ 1 ] ) l_ok = false;
+        }
+    }
+
+    if ( !l_ok )
+    {
+        std::cerr << "Unable to create queues and descriptors of devices!" << std::endl;
+        free_parts();
+        return;
+    }
+
+    for ( auto &l_part : m_parts )
+    {
+        l_part.m_share = l_sum > 0 ? l_part.m_share / l_sum : 1.0 / m_parts.size();
+    }
+
+    m_active = m_parts.size();
+
+    if ( t_verbose > 0 )
+    {
+        std::cout << "Context with " << m_parts.size() << " devices:" << std::endl;
+        for ( size_t i = 0; i < m_parts.size(); i++ )
+        {
+            std::cout << "  Device [" << i << "] " << m_parts[ i ].m_device.getInfo< CL_DEVICE_NAME >()
+                      << ", " << m_parts[ i ].m_device.getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >() << " CU, "
+                      << "initial share " << m_parts[ i ].m_share * 100 << "%" << std::endl;
+        }
+    }
+}
+
+/// @copydoc OCLMultiDevice::~OCLMultiDevice
+OCLMultiDevice::~OCLMultiDevice()
+{
+    free_parts();
+}
+
+// descriptors of all devices are released, no device remains
+void OCLMultiDevice::free_parts()
+{
+    for ( auto &l_part : m_parts )
+    {
+        if ( l_part.m_queue() ) l_part.m_queue.finish();
+        for ( int k = 0; k < 2; k++ )
+        {
+            ocl_svm_free( l_part.m_ocl_img[ k ][ 0 ] );
+            ocl_svm_free( l_part.m_ocl_img[ k ][ 1 ] );
+        }
+    }
+    m_parts.clear();
+    m_active = 0;
+}
+
+/// @copydoc OCLMultiDevice::use_devices
+void OCLMultiDevice::use_devices( int t_count )
+{
+    m_active = std::max( 1, std::min( t_count, ( int ) m_parts.size() ) );
+}
+
+/// @copydoc OCLMultiDevice::split
+void OCLMultiDevice::split( int t_rows, int t_halo )
+{
+    double l_sum = 0;
+    for ( int i = 0; i < m_active; i++ )
+    {
+        l_sum += m_parts[ i ].m_share;
+    }
+
+    // bands proportional to throughput, multiple of work-group rows
+    int l_first = 0;
+    for ( int i = 0; i < m_active; i++ )
+    {
+        Part &l_part = m_parts[ i ];
+        int l_rows = t_rows - l_first;
+        if ( i < m_active - 1 )
+        {
+            l_rows = ( int ) ( t_rows * l_part.m_share / l_sum + WG_SIZE / 2 ) / WG_SIZE * WG_SIZE;
+            // every remaining device gets at least one row of work-groups, if possible
+            int l_rest = ( m_active - 1 - i ) * WG_SIZE;
+            l_rows = std::max( std::min( WG_SIZE, t_rows - l_first ), std::min( l_rows, t_rows - l_first - l_rest ) );
+        }
+        l_part.m_row_first = l_first;
+        l_part.m_row_last = l_first + l_rows;
+        l_part.m_halo_top = std::min( t_halo, l_part.m_row_first );
+        l_part.m_halo_bottom = std::min( t_halo, t_rows - l_part.m_row_last );
+        l_first = l_part.m_row_last;
+    }
+}
+
+/// @copydoc OCLMultiDevice::update
+void OCLMultiDevice::update()
+{
+    // measured throughput in rows per ms
+    std::vector< double > l_speed( m_active, 0 );
+    double l_sum = 0;
+    for ( int i = 0; i < m_active; i++ )
+    {
+        if ( m_parts[ i ].m_ms <= 0 || m_parts[ i ].m_row_last == m_parts[ i ].m_row_first ) return;
+        l_speed[ i ] = rows( i ) / m_parts[ i ].m_ms;
+        l_sum += l_speed[ i ];
+    }
+
+    // all devices should finish at the same time
+    for ( int i = 0; i < m_active; i++ )
+    {
+        m_parts[ i ].m_share = ( 1 - m_smoothing ) * m_parts[ i ].m_share + m_smoothing * l_speed[ i ] / l_sum;
+    }
+}
+
+/// @copydoc OCLMultiDevice::run
+cl_int OCLMultiDevice::run( OCLImage *t_in, OCLImage *t_out, OCLPartKernel t_kernel, int t_elem_size, int t_halo, int t_passes )
+{
+    cl_int l_err;
+
+    if ( m_parts.empty() ) return CL_DEVICE_NOT_FOUND;
+
+    if ( t_in->m_size.x != t_out->m_size.x || t_in->m_size.y != t_out->m_size.y )
+    {
+        std::cerr << "Input and output image must have the same size!" << std::endl;
+        return CL_INVALID_VALUE;
+    }
+
+    int l_height = t_in->m_size.y;
+    size_t l_row_size = ( size_t ) t_in->m_size.x * t_elem_size;
+
+    split( l_height, t_halo );
+
+    // sub-views of both images for even and odd passes
+    for ( int i = 0; i < m_active; i++ )
+    {
+        Part &l_part = m_parts[ i ];
+        int l_band_first = l_part.m_row_first - l_part.m_halo_top;
+
+        for ( int k = 0; k < 2; k++ )
+        {
+            OCLImage *l_src = k == 0 ? t_in : t_out;
+            OCLImage *l_dst = k == 0 ? t_out : t_in;
+            OCLImage *l_ocl_in = l_part.m_ocl_img[ k ][ 0 ];
+            OCLImage *l_ocl_out = l_part.m_ocl_img[ k ][ 1 ];
+
+            l_ocl_in->m_size.x = l_src->m_size.x;
+            l_ocl_in->m_size.y = l_part.m_row_last + l_part.m_halo_bottom - l_band_first;
+            l_ocl_in->m_data1 = l_src->m_data1 + l_band_first * l_row_size;
+
+            // output ends with band, halo rows below belong to the next device
+            l_ocl_out->m_size.x = l_dst->m_size.x;
+            l_ocl_out->m_size.y = l_part.m_row_last - l_band_first;
+            l_ocl_out->m_data1 = l_dst->m_data1 + l_band_first * l_row_size;
+        }
+        l_part.m_ms = 0;
+    }
+
+    std::vector< cl::Event > l_prev_kernels( m_active );
+
+    for ( int p = 0; p < t_passes; p++ )
+    {
+        std::vector< cl::Event > l_kernels( m_active );
+
+        for ( int i = 0; i < m_active; i++ )
+        {
+            Part &l_part = m_parts[ i ];
+            OCLImage *l_ocl_in = l_part.m_ocl_img[ p % 2 ][ 0 ];
+            OCLImage *l_ocl_out = l_part.m_ocl_img[ p % 2 ][ 1 ];
+            int l_rows = l_part.m_row_last - l_part.m_row_first;
+            if ( l_rows == 0 ) continue;
+
+            if ( p == 0 )
+            {
+                // the whole band with halo to device, output is only written
+                std::vector< void * > l_ptrs = { l_ocl_in->m_data, l_ocl_out->m_data1 + l_part.m_halo_top * l_row_size };
+                std::vector< size_t > l_sizes = { l_ocl_in->m_size.y * l_row_size, l_rows * l_row_size };
+                l_err = l_part.m_queue.enqueueMigrateSVM( l_ptrs, l_sizes );    CL_ERR_R( l_err );
+            }
+            else if ( l_part.m_halo_top + l_part.m_halo_bottom > 0 )
+            {
+                // halo rows were computed by neighbours, they must be finished
+                std::vector< cl::Event > l_wait;
+                if ( i > 0 && l_prev_kernels[ i - 1 ]() ) l_wait.push_back( l_prev_kernels[ i - 1 ] );
+                if ( i < m_active - 1 && l_prev_kernels[ i + 1 ]() ) l_wait.push_back( l_prev_kernels[ i + 1 ] );
+
+                std::vector< void * > l_ptrs;
+                std::vector< size_t > l_sizes;
+                if ( l_part.m_halo_top > 0 )
+                {
+                    l_ptrs.push_back( l_ocl_in->m_data );
+                    l_sizes.push_back( l_part.m_halo_top * l_row_size );
+                }
+                if ( l_part.m_halo_bottom > 0 )
+                {
+                    l_ptrs.push_back( l_ocl_in->m_data1 + ( l_part.m_halo_top + l_rows ) * l_row_size );
+                    l_sizes.push_back( l_part.m_halo_bottom * l_row_size );
+                }
+                l_err = l_part.m_queue.enqueueMigrateSVM( l_ptrs, l_sizes, 0, &l_wait );     CL_ERR_R( l_err );
+            }
+
+            cl::Kernel &l_kernel = t_kernel( i, l_ocl_in, l_ocl_out );
+
+            // halo rows are skipped using offset
+            l_err = l_part.m_queue.enqueueNDRangeKernel( l_kernel,
+                    // offset
+                    cl::NDRange( 0, l_part.m_halo_top ),
+                    // global range
+                    cl::NDRange( ( l_ocl_in->m_size.x + WG_SIZE - 1 ) / WG_SIZE * WG_SIZE,
+                                 ( l_rows + WG_SIZE - 1 ) / WG_SIZE * WG_SIZE ),
+                    // work-group
+                    cl::NDRange( WG_SIZE, WG_SIZE ), nullptr, &l_kernels[ i ] ); CL_ERR_R( l_err );
+            l_part.m_queue.flush();
+        }
+
+        l_prev_kernels = l_kernels;
+    }
+
+    // result back to host and time of kernels
+    for ( int i = 0; i < m_active; i++ )
+    {
+        Part &l_part = m_parts[ i ];
+        int l_rows = l_part.m_row_last - l_part.m_row_first;
+        if ( l_rows == 0 ) continue;
+
+        OCLImage *l_ocl_res = l_part.m_ocl_img[ ( t_passes - 1 ) % 2 ][ 1 ];
+        std::vector< void * > l_ptrs = { l_ocl_res->m_data1 + l_part.m_halo_top * l_row_size };
+        std::vector< size_t > l_sizes = { l_rows * l_row_size };
+        l_err = l_part.m_queue.enqueueMigrateSVM( l_ptrs, l_sizes, CL_MIGRATE_MEM_OBJECT_HOST );   CL_ERR_R( l_err );
+    }
+
+    for ( int i = 0; i < m_active; i++ )
+    {
+        l_err = m_parts[ i ].m_queue.finish();                                  CL_ERR_R( l_err );
+        if ( l_prev_kernels[ i ]() )
+        {
+            // only the last pass is measured, passes are the same
+            m_parts[ i ].m_ms = ( l_prev_kernels[ i ].getProfilingInfo< CL_PROFILING_COMMAND_END >() -
+                                  l_prev_kernels[ i ].getProfilingInfo< CL_PROFILING_COMMAND_START >() ) / 1e6;
+        }
+    }
+
+    update();
+
+    return CL_SUCCESS;
+}
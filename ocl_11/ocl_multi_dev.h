@@ -0,0 +1,148 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_multi_dev.h
+ * @brief One kernel launch split across several OpenCL devices.
+ *
+ * @details
+ * Header file for class @ref OCLMultiDevice.
+ *
+ * All selected devices (GPUs of one platform, or sub-devices of one
+ * device, e.g. PoCL CPU) share one context, so SVM memory is
+ * accessible by all of them. Image is split into bands of rows,
+ * every device processes one band. Size of band is given by
+ * throughput of device, initially estimated from compute units
+ * and clock, later learned from measured times.
+ *
+ * Neighbourhood kernels need halo rows above and below the band.
+ * With more passes, halo rows are computed by neighbouring devices,
+ * so only halo rows are migrated between passes.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_MULTI_DEV_H
+#define __OCL_MULTI_DEV_H
+
+#include <vector>
+#include <functional>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_image.h"
+
+/**
+ * @brief Function which sets arguments of kernel for part of image.
+ *
+ * @details
+ * Input descriptor contains band of device with halo rows,
+ * output descriptor has the same coordinates, but it ends with the last
+ * row of band. So kernel must check its position against output image.
+ * Kernel must set also SVM pointers.
+*/
+using OCLPartKernel = std::function< cl::Kernel &( int t_device, OCLImage *t_ocl_in_img, OCLImage *t_ocl_out_img ) >;
+
+/**
+ * @anchor OCLMultiDevice
+ * @brief Context with several devices and split of 2D kernel launch between them.
+*/
+class OCLMultiDevice
+{
+public:
+    /**
+     * @brief Selection of devices and creation of shared context.
+     *
+     * @details
+     * Context is set as default, so @ref ocl_load_program, @ref ocl_svm_malloc
+     * and @ref SVMMatAllocator can be used as after @ref ocl_init.
+     * Default device is the first selected device.
+     * When no suitable device is found or context can not be created,
+     * error is printed, @ref ok is false and @ref run fails.
+     *
+     * @param t_devices Max. number of devices, 0 - all GPUs of platform with most GPUs.
+     * @param t_sub_devices Number of sub-devices created from the first device supporting partitioning, 0 - GPUs are used.
+     * @param t_verbose Print selected devices.
+    */
+    OCLMultiDevice( int t_devices = 0, int t_sub_devices = 0, int t_verbose = 0 );
+
+    /**
+     * @brief Deallocation of descriptors.
+    */
+    ~OCLMultiDevice();
+
+    OCLMultiDevice( const OCLMultiDevice & ) = delete;
+    OCLMultiDevice &operator=( const OCLMultiDevice & ) = delete;
+
+    /**
+     * @brief Processing of image by all active devices.
+     *
+     * @details
+     * With more passes kernel is repeated and images are swapped after
+     * every pass, so result of even number of passes is in t_in.
+     * Function waits for all devices.
+     *
+     * @param t_in Input image in SVM.
+     * @param t_out Output image in SVM, the same size as input.
+     * @param t_kernel Kernel for one device.
+     * @param t_elem_size Bytes per pixel of both images, 4 for uchar4, 1 for uchar.
+     * @param t_halo Number of halo rows above and below band.
+     * @param t_passes Number of passes.
+     * @return cl_int error code or CL_SUCCESS, CL_DEVICE_NOT_FOUND without devices.
+    */
+    cl_int run( OCLImage *t_in, OCLImage *t_out, OCLPartKernel t_kernel, int t_elem_size = 4, int t_halo = 0, int t_passes = 1 );
+
+    /// Devices were selected and context created.
+    bool ok() const { return !m_parts.empty(); }
+
+    /// Number of selected devices.
+    int devices() const { return m_parts.size(); }
+
+    /// Only the first t_count devices are used by @ref run.
+    void use_devices( int t_count );
+
+    /// Number of devices used by @ref run.
+    int active() const { return m_active; }
+
+    /// Selected device.
+    const cl::Device &device( int t_device ) const { return m_parts[ t_device ].m_device; }
+
+    /// Rows processed by device in the last run.
+    int rows( int t_device ) const { return m_parts[ t_device ].m_row_last - m_parts[ t_device ].m_row_first; }
+
+    /// Kernel time of device in one pass of the last run, in ms.
+    double device_ms( int t_device ) const { return m_parts[ t_device ].m_ms; }
+
+protected:
+    /// @cond
+    struct Part
+    {
+        cl::Device m_device;
+        cl::CommandQueue m_queue;
+        OCLImage *m_ocl_img[ 2 ][ 2 ];  // [ pass % 2 ][ in, out ]
+        double m_share;                 // part of rows for device
+        int m_row_first, m_row_last;    // band without halo
+        int m_halo_top, m_halo_bottom;
+        double m_ms;                    // time of kernel in the last pass
+    };
+
+    std::vector< Part > m_parts;
+    int m_active;
+    float m_smoothing;
+
+    void split( int t_rows, int t_halo );
+    void update();
+    void free_parts();
+    /// @endcond
+};
+
+#endif // __OCL_MULTI_DEV_H
@@ -0,0 +1,298 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * More host threads handle requests with images at the same time.
+ * Every thread has its own queue and clones of kernels,
+ * SVM buffers are reused from pool.
+ * For comparison, threads are serialized on one shared queue.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <unistd.h>
+#include <iostream>
+#include <iomanip>
+#include <math.h>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_threads.h"
+
+#define KERNEL_SPV      "kernel_12.spv"
+#define KERNEL_PREFIX   "gpu_"
+
+// **************************************************************************
+// Kernel is selected from runtime of thread or it is shared by all threads.
+struct KernelSource
+{
+    OCLThreadRuntime *m_runtime;                // per-thread kernels and queue, or nullptr
+    cl::Program *m_program;                     // shared kernels and default queue
+    std::mutex *m_mutex;                        // lock of shared queue
+};
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// BGR colors rotation.
+// Kernel header from kernel*.cl:
+//__kernel void rotate_bgr(            __global OCLImage *t_ocl_img )
+cl_int gpu_rotate_bgr( KernelSource &t_src, OCLImage *t_ocl_img )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // shared queue must be locked for setArg and enqueue
+    std::unique_lock< std::mutex > l_lock;
+    cl::Kernel l_kern_rotate_bgr;
+    cl::CommandQueue l_queue;
+    if ( t_src.m_runtime )
+    {
+        l_kern_rotate_bgr = t_src.m_runtime->kernel( l_kern_name );
+        l_queue = t_src.m_runtime->queue();
+    }
+    else
+    {
+        l_lock = std::unique_lock< std::mutex >( *t_src.m_mutex );
+        l_kern_rotate_bgr = cl::Kernel( *t_src.m_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+        l_queue = cl::CommandQueue::getDefault();
+    }
+
+    // set kernel arguments
+    l_err = l_kern_rotate_bgr.setArg( 0, t_ocl_img );                            CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_rotate_bgr.setSVMPointers( { t_ocl_img, t_ocl_img->m_data } );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    l_err = l_queue.enqueueNDRangeKernel( l_kern_rotate_bgr,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    return l_queue.finish();
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Kernel for BGR to BW conversion
+// Kernel header from kernel*.cl:
+// __kernel void convert_bgr_to_bw(          __global OCLImage *t_ocl_bgr_img,
+//                                           __global OCLImage *t_ocl_bw_img )
+cl_int gpu_convert_bgr_to_bw( KernelSource &t_src, OCLImage *t_ocl_bgr_img, OCLImage *t_ocl_bw_img )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // shared queue must be locked for setArg and enqueue
+    std::unique_lock< std::mutex > l_lock;
+    cl::Kernel l_kern_convert_bgr_to_bw;
+    cl::CommandQueue l_queue;
+    if ( t_src.m_runtime )
+    {
+        l_kern_convert_bgr_to_bw = t_src.m_runtime->kernel( l_kern_name );
+        l_queue = t_src.m_runtime->queue();
+    }
+    else
+    {
+        l_lock = std::unique_lock< std::mutex >( *t_src.m_mutex );
+        l_kern_convert_bgr_to_bw = cl::Kernel( *t_src.m_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+        l_queue = cl::CommandQueue::getDefault();
+    }
+
+    // set kernel arguments
+    l_err = l_kern_convert_bgr_to_bw.setArg( 0, t_ocl_bgr_img );                CL_ERR_R( l_err );
+    l_err = l_kern_convert_bgr_to_bw.setArg( 1, t_ocl_bw_img );                 CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_convert_bgr_to_bw.setSVMPointers( {
+            t_ocl_bgr_img,
+            t_ocl_bgr_img->m_data,
+            t_ocl_bw_img,
+            t_ocl_bw_img->m_data,
+            } );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_bgr_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_bgr_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    l_err = l_queue.enqueueNDRangeKernel( l_kern_convert_bgr_to_bw,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    return l_queue.finish();
+}
+
+// **************************************************************************
+// One request: image is copied into SVM, processed and released.
+void handle_request( KernelSource &t_src, OCLSVMPool &t_pool, const unsigned char *t_data, int t_width, int t_height )
+{
+    size_t l_pixels = ( size_t ) t_width * t_height;
+
+    OCLImage *l_ocl_bgr_img = t_pool.alloc< OCLImage >();
+    OCLImage *l_ocl_bw_img = t_pool.alloc< OCLImage >();
+    l_ocl_bgr_img->m_size.x = l_ocl_bw_img->m_size.x = t_width;
+    l_ocl_bgr_img->m_size.y = l_ocl_bw_img->m_size.y = t_height;
+    l_ocl_bgr_img->m_data = t_pool.alloc( l_pixels * 4 );
+    l_ocl_bw_img->m_data = t_pool.alloc( l_pixels );
+
+    memcpy( l_ocl_bgr_img->m_data, t_data, l_pixels * 4 );
+
+    gpu_rotate_bgr( t_src, l_ocl_bgr_img );
+    gpu_convert_bgr_to_bw( t_src, l_ocl_bgr_img, l_ocl_bw_img );
+
+    t_pool.free( l_ocl_bgr_img->m_data );
+    t_pool.free( l_ocl_bw_img->m_data );
+    t_pool.free( l_ocl_bgr_img );
+    t_pool.free( l_ocl_bw_img );
+}
+
+// **************************************************************************
+// Requests handled by t_threads threads, result is number of requests per second.
+double measure( KernelSource &t_src, OCLSVMPool &t_pool, int t_threads, int t_requests,
+                const unsigned char *t_data, int t_width, int t_height )
+{
+    auto l_start = std::chrono::steady_clock::now();
+
+    std::vector< std::thread > l_threads;
+    for ( int t = 0; t < t_threads; t++ )
+    {
+        // requests are divided equally
+        int l_count = t_requests / t_threads + ( t < t_requests % t_threads ? 1 : 0 );
+        l_threads.emplace_back( [ &, l_count ] ()
+        {
+            for ( int r = 0; r < l_count; r++ )
+            {
+                handle_request( t_src, t_pool, t_data, t_width, t_height );
+            }
+        } );
+    }
+
+    for ( auto &l_thread : l_threads )
+    {
+        l_thread.join();
+    }
+
+    double l_sec = std::chrono::duration< double >( std::chrono::steady_clock::now() - l_start ).count();
+    return t_requests / l_sec;
+}
+
+// **************************************************************************
+
+int main( int t_narg, char **t_args )
+{
+    int l_max_threads = std::max( 1U, std::thread::hardware_concurrency() );
+    int l_requests = 1000;
+    int l_width = 640;
+    int l_height = 480;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "t:n:s:" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 't': l_max_threads = std::max( 1, atoi( optarg ) ); break;
+        case 'n': l_requests = std::max( 1, atoi( optarg ) ); break;
+        case 's':
+            if ( sscanf( optarg, "%dx%d", &l_width, &l_height ) == 2 && l_width > 0 && l_height > 0 ) break;
+            [[fallthrough]];
+        default:
+            std::cerr << "Usage: " << t_args[ 0 ] << " [-t max_threads] [-n requests] [-s WIDTHxHEIGHT]" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    cl_int l_err;
+
+    l_err = ocl_init( 1 );                                                      CL_ERR_E( l_err );
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "Program loaded.\n" << std::endl;
+
+    // source image of requests
+    std::vector< unsigned char > l_src_data( ( size_t ) l_width * l_height * 4 );
+    for ( size_t i = 0; i < l_src_data.size(); i++ )
+    {
+        l_src_data[ i ] = i * 7 % 256;
+    }
+
+    OCLSVMPool l_pool;
+    std::mutex l_queue_mutex;
+
+    std::cout << "Requests " << l_requests << " with image " << l_width << "x" << l_height << "." << std::endl;
+    std::cout << std::setw( 8 ) << "threads" << std::setw( 20 ) << "shared [req/s]" << std::setw( 20 ) << "per-thread [req/s]" << std::endl;
+
+    for ( int t = 1; t <= l_max_threads; t *= 2 )
+    {
+        // all threads serialized on one queue
+        KernelSource l_shared = { nullptr, &l_program, &l_queue_mutex };
+        double l_shared_rps = measure( l_shared, l_pool, t, l_requests, l_src_data.data(), l_width, l_height );
+
+        // every thread with its own queue and kernels
+        OCLThreadRuntime l_runtime( l_program );
+        KernelSource l_own = { &l_runtime, &l_program, nullptr };
+        double l_own_rps = measure( l_own, l_pool, t, l_requests, l_src_data.data(), l_width, l_height );
+
+        std::cout << std::setw( 8 ) << t << std::fixed << std::setprecision( 1 )
+                  << std::setw( 20 ) << l_shared_rps << std::setw( 20 ) << l_own_rps << std::endl;
+    }
+
+    std::cout << "\nSVM pool: " << l_pool.allocs() << " allocations, " << l_pool.reuses() << " reused." << std::endl;
+}
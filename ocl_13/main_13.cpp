@@ -0,0 +1,313 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Many producer threads submit small image jobs.
+ * Jobs go through lock-free ring to one submitter thread, which enqueues
+ * them in batches. For comparison, every job locks shared queue and
+ * waits for its finish.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <unistd.h>
+#include <iostream>
+#include <iomanip>
+#include <math.h>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <future>
+#include <vector>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_submit.h"
+
+#define KERNEL_SPV      "kernel_13.spv"
+#define KERNEL_PREFIX   "gpu_"
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+// Kernel is only enqueued, caller waits. Only one thread may call it at a time.
+//
+// BGR colors rotation.
+// Kernel header from kernel*.cl:
+//__kernel void rotate_bgr(            __global OCLImage *t_ocl_img )
+cl_int gpu_rotate_bgr( cl::CommandQueue &t_queue, cl::Program &t_program, OCLImage *t_ocl_img )
+{
+    cl_int l_err;
+
+    // kernel is selected only once
+    static cl::Kernel l_kern_rotate_bgr;
+    if ( l_kern_rotate_bgr() == nullptr )
+    {
+        // removing prefix gpu_
+        std::string l_kern_name( __FUNCTION__ );
+        if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+        {
+            l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+        }
+
+        // select the kernel from opencl program
+        l_kern_rotate_bgr = cl::Kernel( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+    }
+
+    // set kernel arguments
+    l_err = l_kern_rotate_bgr.setArg( 0, t_ocl_img );                            CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_rotate_bgr.setSVMPointers( { t_ocl_img, t_ocl_img->m_data } );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    return t_queue.enqueueNDRangeKernel( l_kern_rotate_bgr,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+// Kernel is only enqueued, caller waits. Only one thread may call it at a time.
+//
+// Kernel for BGR to BW conversion
+// Kernel header from kernel*.cl:
+// __kernel void convert_bgr_to_bw(          __global OCLImage *t_ocl_bgr_img,
+//                                           __global OCLImage *t_ocl_bw_img )
+cl_int gpu_convert_bgr_to_bw( cl::CommandQueue &t_queue, cl::Program &t_program, OCLImage *t_ocl_bgr_img, OCLImage *t_ocl_bw_img )
+{
+    cl_int l_err;
+
+    // kernel is selected only once
+    static cl::Kernel l_kern_convert_bgr_to_bw;
+    if ( l_kern_convert_bgr_to_bw() == nullptr )
+    {
+        // removing prefix gpu_
+        std::string l_kern_name( __FUNCTION__ );
+        if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+        {
+            l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+        }
+
+        // select the kernel from opencl program
+        l_kern_convert_bgr_to_bw = cl::Kernel( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+    }
+
+    // set kernel arguments
+    l_err = l_kern_convert_bgr_to_bw.setArg( 0, t_ocl_bgr_img );                CL_ERR_R( l_err );
+    l_err = l_kern_convert_bgr_to_bw.setArg( 1, t_ocl_bw_img );                 CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_convert_bgr_to_bw.setSVMPointers( {
+            t_ocl_bgr_img,
+            t_ocl_bgr_img->m_data,
+            t_ocl_bw_img,
+            t_ocl_bw_img->m_data,
+            } );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_bgr_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_bgr_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    return t_queue.enqueueNDRangeKernel( l_kern_convert_bgr_to_bw,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );
+}
+
+// **************************************************************************
+// Images of one producer, every job in flight has its own slot.
+struct JobSlot
+{
+    OCLImage *m_ocl_bgr_img;
+    OCLImage *m_ocl_bw_img;
+    std::future< cl_int > m_done;
+};
+
+std::vector< JobSlot > create_slots( int t_count, int t_width, int t_height )
+{
+    std::vector< JobSlot > l_slots( t_count );
+    for ( auto &l_slot : l_slots )
+    {
+        l_slot.m_ocl_bgr_img = ocl_svm_malloc< OCLImage >();
+        l_slot.m_ocl_bw_img = ocl_svm_malloc< OCLImage >();
+        l_slot.m_ocl_bgr_img->m_size.x = l_slot.m_ocl_bw_img->m_size.x = t_width;
+        l_slot.m_ocl_bgr_img->m_size.y = l_slot.m_ocl_bw_img->m_size.y = t_height;
+        l_slot.m_ocl_bgr_img->m_data = ocl_svm_malloc< unsigned char >( ( size_t ) t_width * t_height * 4 );
+        l_slot.m_ocl_bw_img->m_data = ocl_svm_malloc< unsigned char >( ( size_t ) t_width * t_height );
+        memset( l_slot.m_ocl_bgr_img->m_data, 100, ( size_t ) t_width * t_height * 4 );
+    }
+    return l_slots;
+}
+
+void free_slots( std::vector< JobSlot > &t_slots )
+{
+    for ( auto &l_slot : t_slots )
+    {
+        ocl_svm_free( l_slot.m_ocl_bgr_img->m_data );
+        ocl_svm_free( l_slot.m_ocl_bw_img->m_data );
+        ocl_svm_free( l_slot.m_ocl_bgr_img );
+        ocl_svm_free( l_slot.m_ocl_bw_img );
+    }
+}
+
+// **************************************************************************
+
+int main( int t_narg, char **t_args )
+{
+    int l_producers = 8;
+    int l_jobs = 2000;
+    int l_in_flight = 8;
+    int l_batch = 32;
+    int l_size = 128;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "p:n:f:b:s:" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 'p': l_producers = std::max( 1, atoi( optarg ) ); break;
+        case 'n': l_jobs = std::max( 1, atoi( optarg ) ); break;
+        case 'f': l_in_flight = std::max( 1, atoi( optarg ) ); break;
+        case 'b': l_batch = std::max( 1, atoi( optarg ) ); break;
+        case 's': l_size = std::max( 1, atoi( optarg ) ); break;
+        default:
+            std::cerr << "Usage: " << t_args[ 0 ] << " [-p producers] [-n jobs] [-f in_flight] [-b batch] [-s image_size]" << std::endl;
+            std::cerr << "  -n  jobs of every producer" << std::endl;
+            std::cerr << "  -f  jobs of one producer in flight" << std::endl;
+            std::cerr << "  -b  max. jobs in one batch of submitter" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    cl_int l_err;
+
+    l_err = ocl_init( 1 );                                                      CL_ERR_E( l_err );
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "Program loaded.\n" << std::endl;
+
+    std::vector< std::vector< JobSlot > > l_slots;
+    for ( int p = 0; p < l_producers; p++ )
+    {
+        l_slots.push_back( create_slots( l_in_flight, l_size, l_size ) );
+    }
+
+    std::cout << l_producers << " producers, " << l_jobs << " jobs each, image " << l_size << "x" << l_size << "." << std::endl;
+
+    // every job locks default queue and waits for finish
+    std::mutex l_queue_mutex;
+    auto l_start = std::chrono::steady_clock::now();
+    {
+        std::vector< std::thread > l_threads;
+        for ( int p = 0; p < l_producers; p++ )
+        {
+            l_threads.emplace_back( [ &, p ] ()
+            {
+                cl::CommandQueue l_queue = cl::CommandQueue::getDefault();
+                for ( int j = 0; j < l_jobs; j++ )
+                {
+                    JobSlot &l_slot = l_slots[ p ][ j % l_in_flight ];
+                    std::lock_guard< std::mutex > l_lock( l_queue_mutex );
+                    gpu_rotate_bgr( l_queue, l_program, l_slot.m_ocl_bgr_img );
+                    gpu_convert_bgr_to_bw( l_queue, l_program, l_slot.m_ocl_bgr_img, l_slot.m_ocl_bw_img );
+                    l_queue.finish();
+                }
+            } );
+        }
+        for ( auto &l_thread : l_threads ) l_thread.join();
+    }
+    double l_mutex_sec = std::chrono::duration< double >( std::chrono::steady_clock::now() - l_start ).count();
+
+    // jobs through lock-free ring
+    OCLSubmitter l_submitter( 1024, l_batch );
+    l_start = std::chrono::steady_clock::now();
+    {
+        std::vector< std::thread > l_threads;
+        for ( int p = 0; p < l_producers; p++ )
+        {
+            l_threads.emplace_back( [ &, p ] ()
+            {
+                for ( int j = 0; j < l_jobs; j++ )
+                {
+                    JobSlot &l_slot = l_slots[ p ][ j % l_in_flight ];
+
+                    // slot is free when its previous job is done
+                    if ( l_slot.m_done.valid() && l_slot.m_done.get() != CL_SUCCESS )
+                    {
+                        std::cerr << "Job failed!" << std::endl;
+                    }
+
+                    OCLImage *l_bgr = l_slot.m_ocl_bgr_img;
+                    OCLImage *l_bw = l_slot.m_ocl_bw_img;
+                    l_slot.m_done = l_submitter.submit( [ &l_program, l_bgr, l_bw ] ( cl::CommandQueue &t_queue )
+                    {
+                        cl_int l_err = gpu_rotate_bgr( t_queue, l_program, l_bgr );               CL_ERR_R( l_err );
+                        return gpu_convert_bgr_to_bw( t_queue, l_program, l_bgr, l_bw );
+                    } );
+                }
+                for ( auto &l_slot : l_slots[ p ] )
+                {
+                    if ( l_slot.m_done.valid() ) l_slot.m_done.get();
+                }
+            } );
+        }
+        for ( auto &l_thread : l_threads ) l_thread.join();
+    }
+    double l_ring_sec = std::chrono::duration< double >( std::chrono::steady_clock::now() - l_start ).count();
+
+    OCLSubmitStats l_stats = l_submitter.stats();
+    int l_total = l_producers * l_jobs;
+
+    std::cout << std::fixed << std::setprecision( 1 );
+    std::cout << "\nShared queue with lock:  " << l_total / l_mutex_sec << " jobs/s" << std::endl;
+    std::cout << "Lock-free ring:          " << l_total / l_ring_sec << " jobs/s" << std::endl;
+    std::cout << "\nBatches:                 " << l_stats.m_batches << ", "
+              << ( double ) l_stats.m_jobs / std::max< size_t >( 1, l_stats.m_batches ) << " jobs per batch" << std::endl;
+    std::cout << "Ring depth:              avg " << l_stats.m_avg_depth << ", max " << l_stats.m_max_depth << std::endl;
+    std::cout << "Contention:              " << l_stats.m_retries << " CAS retries, " << l_stats.m_full << " waits on full ring" << std::endl;
+
+    for ( auto &l_prod_slots : l_slots )
+    {
+        free_slots( l_prod_slots );
+    }
+}
@@ -0,0 +1,290 @@
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course 
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_utils.h
+ * @brief OpenCL Utils for initialization, load program and SVM allocation.
+ * 
+ * @mainpage OpenCL Utils
+ *
+ * Main programming API:
+ *
+ * - @ref ocl_init -- @copybrief ocl_init
+ *
+ * - @ref ocl_load_program -- @copybrief ocl_load_program
+ *
+ * - @ref ocl_svm_malloc -- @copybrief ocl_svm_malloc
+ *
+ * - @ref ocl_svm_free -- @copybrief ocl_svm_free
+ * - @ref ocl_svm_add_reclaim -- @copybrief ocl_svm_add_reclaim
+ * - @ref ocl_svm_set_budget -- @copybrief ocl_svm_set_budget
+ *
+ * - @ref OCLImage -- @copybrief OCLImage
+ * 
+ * - @ref SVMMatAllocator -- @copybrief SVMMatAllocator
+ *
+ * - @ref OCLFrameRing -- @copybrief OCLFrameRing
+ *
+ * - @ref ocl_host_enqueue_ndrange -- @copybrief ocl_host_enqueue_ndrange
+ *
+ * - @ref OCLCoExec -- @copybrief OCLCoExec
+ *
+ * - @ref OCLTiledExec -- @copybrief OCLTiledExec
+ *
+ * - @ref OCLMultiDevice -- @copybrief OCLMultiDevice
+ *
+ * - @ref OCLThreadRuntime -- @copybrief OCLThreadRuntime
+ * - @ref OCLSVMPool -- @copybrief OCLSVMPool
+ *
+ * - @ref OCLSubmitter -- @copybrief OCLSubmitter
+ *
+ * - @ref OCLBatcher -- @copybrief OCLBatcher
+ *
+ * - @ref OCLServiceServer -- @copybrief OCLServiceServer
+ * - @ref OCLServiceClient -- @copybrief OCLServiceClient
+ *
+ * - @ref OCLScheduler -- @copybrief OCLScheduler
+ *
+ * - @ref OCLGraph -- @copybrief OCLGraph
+ *
+ * - @ref OCLExprImage -- @copybrief OCLExprImage
+ *
+ * - @ref OCLPrefetcher -- @copybrief OCLPrefetcher
+ *
+ * - @ref OCLStagingRing -- @copybrief OCLStagingRing
+ *
+ * - @ref SVMImage -- @copybrief SVMImage
+ * - @ref SVMImagePool -- @copybrief SVMImagePool
+ * - @ref launch -- @copybrief launch
+ * - @ref OCL_TRACE_SCOPE -- @copybrief OCL_TRACE_SCOPE
+ * - @ref ocl_metrics_write -- @copybrief ocl_metrics_write
+ *
+ * - @ref OCLBench -- @copybrief OCLBench
+ * - @ref OCLDeviceProfile -- @copybrief OCLDeviceProfile
+ * - @ref OCLRoofline -- @copybrief OCLRoofline
+ * - @ref ocl_memprof_report -- @copybrief ocl_memprof_report
+ * - @ref OCLCaptureFile -- @copybrief OCLCaptureFile
+ * - @ref ocl_kernel_report -- @copybrief ocl_kernel_report
+ *
+ * 
+ ***************************************************************************/
+
+#ifndef __OCL_UTILS_H
+#define __OCL_UTILS_H
+
+#include <atomic>
+#include <type_traits>
+
+#include <CL/opencl.hpp> 
+
+
+/**
+ * @name
+ * @brief Macros for checking OpenCL Errors. 
+ * @{
+*/
+#define CL_ERR_C( ERROR ) _CL_ERR( ERROR, ; )                                   //!< Display Error
+#define CL_ERR_R( ERROR ) _CL_ERR( ERROR, return ( ERROR ); )                   //!< Display Error and return
+#define CL_ERR_E( ERROR ) _CL_ERR( ERROR, exit( EXIT_FAILURE ); )               //!< Display Error and exit
+/// @} 
+
+// @cond 
+#define _STREAM_ERROR( STREAM, ERROR, FUNCTION, LINE )               \
+    _out_error( STREAM, ERROR, FUNCTION, LINE )
+
+#define _PRINT_ERROR( ERROR, FUNCTION, LINE )                        \
+    _STREAM_ERROR( std::cerr, ERROR, FUNCTION, LINE )
+
+#define _CL_ERR( ERROR, CMD ) { if ( ( ERROR ) != CL_SUCCESS ) { _PRINT_ERROR( ERROR, __FUNCTION__, __LINE__ ); CMD } }
+
+/* *
+ * @brief Function is used internally to print error code
+ * @param t_stream Output stream, usually cerr.
+ * @param t_error Some cl_error. 
+ * @param t_func_name Name of current function. 
+ * @param t_line_num Line number in source code. 
+*/
+void _out_error( std::ostream &t_stream, int t_error, std::string t_func_name, int t_line_num );
+// @endcond
+
+
+/**
+ * @anchor ocl_init
+ * @brief OpenCL initialization.
+ * 
+ * @details
+ * Function detect OpenCL environment. 
+ * It detects how many Platforms are available and how many Devices 
+ * are on the individual Platforms. 
+ * The first Platform with GPU type Device is set as default. 
+ * Environment variable OCL_DEVICE_TYPE=CPU selects CPU devices instead, e.g. PoCL.
+ *
+ * When some GPU Device was found, then is created default Context and
+ * default Queue. 
+ *
+ * After OpenCL initialization is available:
+ * - cl::Platform::getDefault();
+ * - cl::Device::getDefault();
+ * - cl::Context::getDefault();
+ * - cl::CommandQueue::getDefault();
+ *
+ * @param t_verbose Verbose mode of OpenCL initialization.
+ * @param t_gpu_dev_index Index of selected GPU device, default 0
+ * @return cl_int error code or CL_SUCCESS.
+*/
+cl_int ocl_init( int t_verbose = 0, int t_gpu_dev_index = 0 );
+
+
+/**
+ * @anchor ocl_load_program
+ * @brief Function for loading program with kernels. 
+ * @param t_kernel_filename File name with SPIRV code. 
+ * @return Instance of cl::Program
+ *
+ * Resources of built kernels are reported by OCL_KERNEL_REPORT, see @ref ocl_kernel_report.
+*/
+cl::Program ocl_load_program( const std::string t_kernel_filename );
+
+/// @cond
+// opt-in hook of built programs, set by kernel report in ocl_kernel_report.cpp
+extern void ( *g_ocl_program_hook )( const cl::Program &t_program, const std::string &t_file_name );
+/// @endcond
+
+
+/**
+ * @brief Always-on counters of SVM allocations, exported by @ref ocl_metrics.h.
+*/
+struct OCLSVMCounters
+{
+    std::atomic< unsigned long long > m_allocs{ 0 };        ///< Calls of @ref ocl_svm_malloc.
+    std::atomic< unsigned long long > m_alloc_bytes{ 0 };   ///< Bytes allocated by @ref ocl_svm_malloc.
+    std::atomic< unsigned long long > m_frees{ 0 };         ///< Calls of @ref ocl_svm_free.
+    std::atomic< long long > m_live_bytes{ 0 };             ///< Bytes of @ref ocl_svm_malloc in SVM now.
+    std::atomic< unsigned long long > m_failures{ 0 };      ///< Allocations returning nullptr.
+    std::atomic< unsigned long long > m_mat_bytes{ 0 };     ///< Bytes allocated by @ref SVMMatAllocator.
+    std::atomic< long long > m_mat_live_bytes{ 0 };         ///< Bytes of cv::Mat in SVM now.
+};
+
+/// @cond
+extern OCLSVMCounters g_ocl_svm_counters;
+
+// opt-in hooks of SVM allocations, set by memory profiler in ocl_memprof.cpp
+struct OCLSVMHooks
+{
+    void ( *m_alloc )( void *t_ptr, size_t t_size );
+    void ( *m_free )( void *t_ptr );
+};
+extern OCLSVMHooks g_ocl_svm_hooks;
+
+// sizes of live allocations for m_live_bytes, ocl_svm_free gets only pointer
+void ocl_svm_track_alloc( void *t_ptr, size_t t_size );
+void ocl_svm_track_free( void *t_ptr );
+/// @endcond
+
+/**
+ * @brief Handler releasing SVM memory of its owner, like std::new_handler.
+ * @param t_owner Owner registered by @ref ocl_svm_add_reclaim.
+ * @param t_size Bytes, which should be released.
+ * @return true when some memory was released.
+*/
+typedef bool ( *OCLSVMReclaim )( void *t_owner, size_t t_size );
+
+/**
+ * @anchor ocl_svm_add_reclaim
+ * @brief Handler is called by @ref ocl_svm_malloc, when device has no free memory or budget is exceeded.
+ *
+ * @details
+ * Allocation is repeated while some handler releases memory, e.g. cached
+ * or idle images of @ref SVMImagePool. Handler must not allocate SVM memory.
+*/
+void ocl_svm_add_reclaim( void *t_owner, OCLSVMReclaim t_reclaim );
+
+/// Handler of t_owner is removed.
+void ocl_svm_remove_reclaim( void *t_owner );
+
+/// All handlers are called, true when some of them released memory.
+bool ocl_svm_reclaim( size_t t_size );
+
+/**
+ * @anchor ocl_svm_set_budget
+ * @brief Budget of SVM allocated by @ref ocl_svm_malloc in whole process, 0 - no budget.
+ *
+ * @details
+ * Initial budget is environment variable OCL_SVM_BUDGET in MB. When new
+ * allocation does not fit into budget, reclaim handlers are called
+ * until it fits. Budget is soft, when nothing can be released, memory
+ * is allocated over budget. New lower budget releases memory immediately.
+*/
+void ocl_svm_set_budget( size_t t_budget );
+
+/// Current budget in bytes, 0 - no budget.
+size_t ocl_svm_budget();
+
+/// Reclaim handlers are called until t_size more bytes fit into budget.
+void ocl_svm_fit_budget( size_t t_size );
+
+/**
+ * @anchor ocl_svm_malloc
+ * @brief Function for easy SVM memory allocation. 
+ * @param T data type, void allocates bytes.
+ * @param t_size number of allocated elements.
+ * @param t_flags SVM flags, e.g. CL_MEM_SVM_FINE_GRAIN_BUFFER for concurrent access of host and device.
+ * @return pointer to allocated SVM memory. 
+*/
+template< typename T >
+T* ocl_svm_malloc( size_t t_size = 1, cl_svm_mem_flags t_flags = CL_MEM_READ_WRITE ) 
+{
+    auto l_context = cl::Context::getDefault();
+    if ( l_context() == nullptr ) 
+    { 
+        return nullptr; 
+    }
+    // void has no size, its elements are bytes
+    size_t l_bytes = t_size * sizeof( typename std::conditional< std::is_void< T >::value, char, T >::type );
+    ocl_svm_fit_budget( l_bytes );
+    T *l_ptr = (T*) clSVMAlloc( l_context(), t_flags, l_bytes, 0 );
+    while ( l_ptr == nullptr && l_bytes > 0 && ocl_svm_reclaim( l_bytes ) )
+    {
+        l_ptr = (T*) clSVMAlloc( l_context(), t_flags, l_bytes, 0 );
+    }
+    if ( l_ptr == nullptr )
+    {
+        g_ocl_svm_counters.m_failures.fetch_add( 1, std::memory_order_relaxed );
+        return nullptr;
+    }
+    g_ocl_svm_counters.m_allocs.fetch_add( 1, std::memory_order_relaxed );
+    g_ocl_svm_counters.m_alloc_bytes.fetch_add( l_bytes, std::memory_order_relaxed );
+    ocl_svm_track_alloc( l_ptr, l_bytes );
+    if ( g_ocl_svm_hooks.m_alloc ) g_ocl_svm_hooks.m_alloc( l_ptr, l_bytes );
+    return l_ptr;
+}
+
+/**
+ * @anchor ocl_svm_free
+ * @brief Function for SVM memory deallocation. 
+ * @param t_ptr Pointer to SVM memory. 
+*/
+inline void ocl_svm_free( void *t_ptr ) 
+{
+    auto l_context = cl::Context::getDefault();
+    if ( l_context() == nullptr ) 
+    { 
+        return; 
+    }
+    if ( t_ptr ) g_ocl_svm_counters.m_frees.fetch_add( 1, std::memory_order_relaxed );
+    if ( t_ptr ) ocl_svm_track_free( t_ptr );
+    if ( t_ptr && g_ocl_svm_hooks.m_free ) g_ocl_svm_hooks.m_free( t_ptr );
+    clSVMFree( l_context(), t_ptr );
+}
+
+#endif // __OCL_UTILS_H
+
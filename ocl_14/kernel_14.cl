@@ -0,0 +1,215 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course 
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Many small images processed by one kernel launch.
+ * Kernels for one image and batched kernels for comparison.
+ * 
+ ***************************************************************************/
+
+#include "ocl_image.h"
+
+// kernel for BGR color rotation
+__kernel void rotate_bgr( __global OCLImage *t_ocl_img )
+{
+    // get work-item position  
+    size_t global_idx = get_global_id( 0 );
+    size_t global_idy = get_global_id( 1 );
+
+    // verify work-item position
+    if ( global_idx >= t_ocl_img->m_size.x ) return;
+    if ( global_idy >= t_ocl_img->m_size.y ) return;
+
+    // get one point from image
+    uchar4 l_bgr = t_ocl_img->at4( global_idy, global_idx );
+
+    // rotate colors
+    uchar4 l_bgr_rot;
+    l_bgr_rot.x = l_bgr.y;
+    l_bgr_rot.y = l_bgr.z;
+    l_bgr_rot.z = l_bgr.x;
+
+    // put point into image
+    t_ocl_img->at4( global_idy, global_idx ) = l_bgr_rot;
+}
+
+// **************************************************************************
+// kernel for BGR to BW conversion
+__kernel void convert_bgr_to_bw( __global OCLImage *t_ocl_bgr_img, __global OCLImage *t_ocl_bw_img )
+{
+    // get work-item position  
+    size_t global_idx = get_global_id( 0 );
+    size_t global_idy = get_global_id( 1 );
+
+    // verify work-item position
+    if ( global_idx >= t_ocl_bgr_img->m_size.x ) return;
+    if ( global_idy >= t_ocl_bgr_img->m_size.y ) return;
+
+    // get one point from image
+    uchar4 l_bgr = t_ocl_bgr_img->at4( global_idy, global_idx );
+
+    // convert BGR to BW: 10% Blue + 59% Green + 30% Red
+    //uchar l_bw = l_bgr.x * 0.11f + l_bgr.y * 0.59f + l_bgr.z * 0.30f;
+    uchar l_bw = l_bgr.x * 11 / 100 + l_bgr.y * 59 / 100 + l_bgr.z * 30 / 100;
+
+    // put point into image
+    t_ocl_bw_img->at1( global_idy, global_idx ) = l_bw;
+}
+
+// **************************************************************************
+// kernel for inserting image into image
+__kernel void insert_image( __global OCLImage *t_ocl_big_img, __global OCLImage *t_ocl_small_img, int2 t_position )
+{
+    // get work-item position, small image
+    size_t global_idx = get_global_id( 0 );
+    size_t global_idy = get_global_id( 1 );
+
+    // verify work-item position, small image
+    if ( global_idx >= t_ocl_small_img->m_size.x ) return;
+    if ( global_idy >= t_ocl_small_img->m_size.y ) return;
+
+    // position in big image
+    int l_bx = t_position.x + global_idx;
+    int l_by = t_position.y + global_idy;
+
+    // position verification for big image
+    if ( l_bx < 0 || l_bx >= t_ocl_big_img->m_size.x ) return;
+    if ( l_by < 0 || l_by >= t_ocl_big_img->m_size.y ) return;
+
+    // two corresponding points from big and small image
+    uchar4 l_bg_bgr = t_ocl_big_img->at4( l_by, l_bx );
+    uchar4 l_fg_bgr = t_ocl_small_img->at4( global_idy, global_idx );
+
+    uchar4 l_out_bgr = { 0, 0, 0, 255 };
+    // transparency calculation
+    l_out_bgr.x = l_fg_bgr.x * l_fg_bgr.w / 255 + l_bg_bgr.x * ( 255 - l_fg_bgr.w ) / 255;
+    l_out_bgr.y = l_fg_bgr.y * l_fg_bgr.w / 255 + l_bg_bgr.y * ( 255 - l_fg_bgr.w ) / 255;
+    l_out_bgr.z = l_fg_bgr.z * l_fg_bgr.w / 255 + l_bg_bgr.z * ( 255 - l_fg_bgr.w ) / 255;
+
+    // store result into big image
+    t_ocl_big_img->at4( l_by, l_bx ) = l_out_bgr;
+}
+
+// **************************************************************************
+// Batched kernels: 1D NDRange over all pixels of all images in batch.
+// Image of work-item is found in prefix sum of pixel counts,
+// t_prefix[ i ] is the first pixel of image i, t_prefix[ t_count ] is number of all pixels.
+
+// index of image for global pixel index, binary search
+uint batch_image( __global uint *t_prefix, uint t_count, uint t_pixel )
+{
+    uint l_lo = 0, l_hi = t_count;
+    while ( l_hi - l_lo > 1 )
+    {
+        uint l_mid = ( l_lo + l_hi ) / 2;
+        if ( t_prefix[ l_mid ] <= t_pixel ) l_lo = l_mid;
+        else l_hi = l_mid;
+    }
+    return l_lo;
+}
+
+// **************************************************************************
+// batched kernel for BGR color rotation
+__kernel void rotate_bgr_batch( __global OCLImage *t_ocl_imgs, __global uint *t_prefix, uint t_count )
+{
+    // get work-item position
+    uint global_id = get_global_id( 0 );
+
+    // verify work-item position
+    if ( global_id >= t_prefix[ t_count ] ) return;
+
+    // image and position in image
+    uint l_img = batch_image( t_prefix, t_count, global_id );
+    uint l_pixel = global_id - t_prefix[ l_img ];
+    __global OCLImage *l_ocl_img = &t_ocl_imgs[ l_img ];
+    int l_y = l_pixel / l_ocl_img->m_size.x;
+    int l_x = l_pixel % l_ocl_img->m_size.x;
+
+    // get one point from image
+    uchar4 l_bgr = l_ocl_img->at4( l_y, l_x );
+
+    // rotate colors
+    uchar4 l_bgr_rot;
+    l_bgr_rot.x = l_bgr.y;
+    l_bgr_rot.y = l_bgr.z;
+    l_bgr_rot.z = l_bgr.x;
+
+    // put point into image
+    l_ocl_img->at4( l_y, l_x ) = l_bgr_rot;
+}
+
+// **************************************************************************
+// batched kernel for BGR to BW conversion
+__kernel void convert_bgr_to_bw_batch( __global OCLImage *t_ocl_bgr_imgs, __global OCLImage *t_ocl_bw_imgs,
+                                       __global uint *t_prefix, uint t_count )
+{
+    // get work-item position
+    uint global_id = get_global_id( 0 );
+
+    // verify work-item position
+    if ( global_id >= t_prefix[ t_count ] ) return;
+
+    // image and position in image
+    uint l_img = batch_image( t_prefix, t_count, global_id );
+    uint l_pixel = global_id - t_prefix[ l_img ];
+    int l_y = l_pixel / t_ocl_bgr_imgs[ l_img ].m_size.x;
+    int l_x = l_pixel % t_ocl_bgr_imgs[ l_img ].m_size.x;
+
+    // get one point from image
+    uchar4 l_bgr = t_ocl_bgr_imgs[ l_img ].at4( l_y, l_x );
+
+    // convert BGR to BW: 10% Blue + 59% Green + 30% Red
+    uchar l_bw = l_bgr.x * 11 / 100 + l_bgr.y * 59 / 100 + l_bgr.z * 30 / 100;
+
+    // put point into image
+    t_ocl_bw_imgs[ l_img ].at1( l_y, l_x ) = l_bw;
+}
+
+// **************************************************************************
+// batched kernel for inserting small images into big images
+// Small images inserted into the same big image should not overlap.
+__kernel void insert_image_batch( __global OCLImage *t_ocl_small_imgs, __global OCLImage *t_ocl_big_imgs,
+                                  __global int2 *t_positions, __global uint *t_prefix, uint t_count )
+{
+    // get work-item position
+    uint global_id = get_global_id( 0 );
+
+    // verify work-item position
+    if ( global_id >= t_prefix[ t_count ] ) return;
+
+    // image and position in small image
+    uint l_img = batch_image( t_prefix, t_count, global_id );
+    uint l_pixel = global_id - t_prefix[ l_img ];
+    __global OCLImage *l_ocl_small_img = &t_ocl_small_imgs[ l_img ];
+    __global OCLImage *l_ocl_big_img = &t_ocl_big_imgs[ l_img ];
+    int l_sy = l_pixel / l_ocl_small_img->m_size.x;
+    int l_sx = l_pixel % l_ocl_small_img->m_size.x;
+
+    // position in big image
+    int l_bx = t_positions[ l_img ].x + l_sx;
+    int l_by = t_positions[ l_img ].y + l_sy;
+
+    // position verification for big image
+    if ( l_bx < 0 || l_bx >= l_ocl_big_img->m_size.x ) return;
+    if ( l_by < 0 || l_by >= l_ocl_big_img->m_size.y ) return;
+
+    // two corresponding points from big and small image
+    uchar4 l_bg_bgr = l_ocl_big_img->at4( l_by, l_bx );
+    uchar4 l_fg_bgr = l_ocl_small_img->at4( l_sy, l_sx );
+
+    uchar4 l_out_bgr = { 0, 0, 0, 255 };
+    // transparency calculation
+    l_out_bgr.x = l_fg_bgr.x * l_fg_bgr.w / 255 + l_bg_bgr.x * ( 255 - l_fg_bgr.w ) / 255;
+    l_out_bgr.y = l_fg_bgr.y * l_fg_bgr.w / 255 + l_bg_bgr.y * ( 255 - l_fg_bgr.w ) / 255;
+    l_out_bgr.z = l_fg_bgr.z * l_fg_bgr.w / 255 + l_bg_bgr.z * ( 255 - l_fg_bgr.w ) / 255;
+
+    // store result into big image
+    l_ocl_big_img->at4( l_by, l_bx ) = l_out_bgr;
+}
@@ -0,0 +1,551 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Many small images processed by one kernel launch.
+ * Images are gathered into batches by OCLBatcher, batched kernels
+ * process all pixels of all images in one 1D NDRange.
+ * The same images are processed by one launch per image for comparison.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <unistd.h>
+#include <iostream>
+#include <iomanip>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/core_c.h>
+#include <opencv2/core/mat.hpp>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_svm_mat_allocator.h"
+#include "ocl_batch.h"
+
+#define KERNEL_SPV      "kernel_14.spv"
+#define KERNEL_PREFIX   "gpu_"
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// BGR colors rotation.
+// Kernel header from kernel*.cl:
+//__kernel void rotate_bgr(            __global OCLImage *t_ocl_img )
+cl_int gpu_rotate_bgr( cl::Program &t_program, OCLImage *t_ocl_img )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_rotate_bgr( t_program, l_kern_name.c_str(), &l_err );      CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_rotate_bgr.setArg( 0, t_ocl_img );                            CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_rotate_bgr.setSVMPointers( { t_ocl_img, t_ocl_img->m_data } );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_rotate_bgr,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    // waiting for completion
+    return defQueue.finish();
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Kernel for BGR to BW conversion
+// Kernel header from kernel*.cl:
+// __kernel void convert_bgr_to_bw(          __global OCLImage *t_ocl_bgr_img,
+//                                           __global OCLImage *t_ocl_bw_img )
+cl_int gpu_convert_bgr_to_bw( cl::Program &t_program, OCLImage *t_ocl_bgr_img, OCLImage *t_ocl_bw_img )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_convert_bgr_to_bw( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_convert_bgr_to_bw.setArg( 0, t_ocl_bgr_img );                CL_ERR_R( l_err );
+    l_err = l_kern_convert_bgr_to_bw.setArg( 1, t_ocl_bw_img );                 CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_convert_bgr_to_bw.setSVMPointers( {
+            t_ocl_bgr_img,
+            t_ocl_bgr_img->m_data,
+            t_ocl_bw_img,
+            t_ocl_bw_img->m_data,
+            } );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_bgr_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_bgr_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_convert_bgr_to_bw,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    // waiting for completion
+    return defQueue.finish();
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Kernel for inserting image into image
+// Kernel header from kernel*.cl:
+// __kernel void insert_image(               __global OCLImage *t_ocl_big_img,
+//                                           __global OCLImage *t_ocl_small_img,
+//                                           int2 t_position )
+cl_int gpu_insert_image( cl::Program &t_program, OCLImage *t_ocl_big_img,
+                                                 OCLImage *t_ocl_small_img,
+                                                 cl_int2 t_position )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_insert_image( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_insert_image.setArg( 0, t_ocl_big_img );                     CL_ERR_R( l_err );
+    l_err = l_kern_insert_image.setArg( 1, t_ocl_small_img );                   CL_ERR_R( l_err );
+    l_err = l_kern_insert_image.setArg( 2, t_position );                        CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_insert_image.setSVMPointers( {
+            t_ocl_big_img,
+            t_ocl_big_img->m_data,
+            t_ocl_small_img,
+            t_ocl_small_img->m_data,
+            } );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_small_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_small_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_insert_image,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    // waiting for completion
+    return defQueue.finish();
+}
+
+// **************************************************************************
+// Launch of batched kernel over all pixels of batch.
+cl_int gpu_launch_batch( cl::Kernel &t_kernel, OCLBatch &t_batch )
+{
+    cl_int l_err;
+
+    // list of SVM pointers for data synchronization
+    t_kernel.setSVMPointers( t_batch.m_svm_ptrs );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // 1D range over all pixels
+    int l_wg_size = 256;
+    int l_gr_size = ( t_batch.pixels() + ( l_wg_size - 1 ) ) / l_wg_size * l_wg_size;
+
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( t_kernel,
+            // offset
+            cl::NDRange( 0 ),
+            // global range
+            cl::NDRange( l_gr_size ),
+            // work-group
+            cl::NDRange( l_wg_size ) );                                         CL_ERR_R( l_err );
+
+    // waiting for completion
+    return defQueue.finish();
+}
+
+// **************************************************************************
+// gpu_ function for batched kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// BGR colors rotation of batch.
+// Kernel header from kernel*.cl:
+// __kernel void rotate_bgr_batch(           __global OCLImage *t_ocl_imgs,
+//                                           __global uint *t_prefix,
+//                                           uint t_count )
+cl_int gpu_rotate_bgr_batch( cl::Program &t_program, OCLBatch &t_batch )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_rotate_bgr_batch( t_program, l_kern_name.c_str(), &l_err );   CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_rotate_bgr_batch.setArg( 0, t_batch.m_ocl_src_imgs );        CL_ERR_R( l_err );
+    l_err = l_kern_rotate_bgr_batch.setArg( 1, t_batch.m_prefix );              CL_ERR_R( l_err );
+    l_err = l_kern_rotate_bgr_batch.setArg( 2, t_batch.m_count );               CL_ERR_R( l_err );
+
+    return gpu_launch_batch( l_kern_rotate_bgr_batch, t_batch );
+}
+
+// **************************************************************************
+// gpu_ function for batched kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// BGR to BW conversion of batch.
+// Kernel header from kernel*.cl:
+// __kernel void convert_bgr_to_bw_batch(    __global OCLImage *t_ocl_bgr_imgs,
+//                                           __global OCLImage *t_ocl_bw_imgs,
+//                                           __global uint *t_prefix,
+//                                           uint t_count )
+cl_int gpu_convert_bgr_to_bw_batch( cl::Program &t_program, OCLBatch &t_batch )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_convert_bgr_to_bw_batch( t_program, l_kern_name.c_str(), &l_err );    CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_convert_bgr_to_bw_batch.setArg( 0, t_batch.m_ocl_src_imgs ); CL_ERR_R( l_err );
+    l_err = l_kern_convert_bgr_to_bw_batch.setArg( 1, t_batch.m_ocl_dst_imgs ); CL_ERR_R( l_err );
+    l_err = l_kern_convert_bgr_to_bw_batch.setArg( 2, t_batch.m_prefix );       CL_ERR_R( l_err );
+    l_err = l_kern_convert_bgr_to_bw_batch.setArg( 3, t_batch.m_count );        CL_ERR_R( l_err );
+
+    return gpu_launch_batch( l_kern_convert_bgr_to_bw_batch, t_batch );
+}
+
+// **************************************************************************
+// gpu_ function for batched kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Inserting of small images into big images.
+// Kernel header from kernel*.cl:
+// __kernel void insert_image_batch(         __global OCLImage *t_ocl_small_imgs,
+//                                           __global OCLImage *t_ocl_big_imgs,
+//                                           __global int2 *t_positions,
+//                                           __global uint *t_prefix,
+//                                           uint t_count )
+cl_int gpu_insert_image_batch( cl::Program &t_program, OCLBatch &t_batch )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_insert_image_batch( t_program, l_kern_name.c_str(), &l_err ); CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_insert_image_batch.setArg( 0, t_batch.m_ocl_src_imgs );      CL_ERR_R( l_err );
+    l_err = l_kern_insert_image_batch.setArg( 1, t_batch.m_ocl_dst_imgs );      CL_ERR_R( l_err );
+    l_err = l_kern_insert_image_batch.setArg( 2, t_batch.m_positions );         CL_ERR_R( l_err );
+    l_err = l_kern_insert_image_batch.setArg( 3, t_batch.m_prefix );            CL_ERR_R( l_err );
+    l_err = l_kern_insert_image_batch.setArg( 4, t_batch.m_count );             CL_ERR_R( l_err );
+
+    return gpu_launch_batch( l_kern_insert_image_batch, t_batch );
+}
+
+// **************************************************************************
+// Small image in cv::Mat and its descriptor.
+struct SmallImage
+{
+    cv::Mat m_cv_img;
+    OCLImage *m_ocl_img;
+};
+
+SmallImage create_small( cv::Size t_size, int t_type )
+{
+    SmallImage l_img;
+    l_img.m_cv_img.create( t_size, t_type );
+    l_img.m_ocl_img = ocl_svm_malloc< OCLImage >();
+    l_img.m_ocl_img->m_size.x = t_size.width;
+    l_img.m_ocl_img->m_size.y = t_size.height;
+    l_img.m_ocl_img->m_data = l_img.m_cv_img.data;
+    return l_img;
+}
+
+// Max. difference of two sets of images.
+double compare( std::vector< SmallImage > &t_a, std::vector< SmallImage > &t_b )
+{
+    double l_diff = 0;
+    for ( size_t i = 0; i < t_a.size(); i++ )
+    {
+        l_diff = std::max( l_diff, cv::norm( t_a[ i ].m_cv_img, t_b[ i ].m_cv_img, cv::NORM_INF ) );
+    }
+    return l_diff;
+}
+
+// Time from t_start in ms.
+double elapsed_ms( std::chrono::steady_clock::time_point t_start )
+{
+    return std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - t_start ).count();
+}
+
+// **************************************************************************
+
+int main( int t_narg, char **t_args )
+{
+    int l_count = 500;
+    int l_max_size = 128;
+    int l_max_batch = 256;
+    double l_latency = 1.0;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "n:s:b:l:" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 'n': l_count = std::max( 1, atoi( optarg ) ); break;
+        case 's': l_max_size = std::max( 16, atoi( optarg ) ); break;
+        case 'b': l_max_batch = std::max( 1, atoi( optarg ) ); break;
+        case 'l': l_latency = atof( optarg ); break;
+        default:
+            std::cerr << "Usage: " << t_args[ 0 ] << " [-n images] [-s max_size] [-b max_batch] [-l latency_ms]" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    cl_int l_err;
+
+    l_err = ocl_init( 1 );                                                      CL_ERR_E( l_err );
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "Program loaded.\n" << std::endl;
+
+    // creating SVM allocator for cv::Mat
+    SVMMatAllocator svmallocator;
+    cv::Mat::setDefaultAllocator( &svmallocator );
+
+    // small images of random size, two copies for single and batched launches
+    std::vector< SmallImage > l_single_bgr, l_single_bw, l_batch_bgr, l_batch_bw;
+    srand( 1 );
+    for ( int i = 0; i < l_count; i++ )
+    {
+        cv::Size l_size( 16 + rand() % ( l_max_size - 15 ), 16 + rand() % ( l_max_size - 15 ) );
+        l_single_bgr.push_back( create_small( l_size, CV_8UC4 ) );
+        l_single_bw.push_back( create_small( l_size, CV_8UC1 ) );
+        l_batch_bgr.push_back( create_small( l_size, CV_8UC4 ) );
+        l_batch_bw.push_back( create_small( l_size, CV_8UC1 ) );
+
+        cv::randu( l_single_bgr[ i ].m_cv_img, cv::Scalar::all( 0 ), cv::Scalar::all( 255 ) );
+        l_single_bgr[ i ].m_cv_img.copyTo( l_batch_bgr[ i ].m_cv_img );
+    }
+
+    // background for sprites, sprites do not overlap
+    int l_cols = 32;
+    cv::Mat l_cv_single_bg( ( l_count + l_cols - 1 ) / l_cols * l_max_size, l_cols * l_max_size, CV_8UC4 );
+    cv::Mat l_cv_batch_bg( l_cv_single_bg.size(), CV_8UC4 );
+    l_cv_single_bg.setTo( cv::Scalar( 50, 100, 150, 0 ) );
+    l_cv_batch_bg.setTo( cv::Scalar( 50, 100, 150, 0 ) );
+
+    OCLImage *l_ocl_single_bg = ocl_svm_malloc< OCLImage >();
+    l_ocl_single_bg->m_size.x = l_cv_single_bg.cols;
+    l_ocl_single_bg->m_size.y = l_cv_single_bg.rows;
+    l_ocl_single_bg->m_data = l_cv_single_bg.data;
+
+    OCLImage *l_ocl_batch_bg = ocl_svm_malloc< OCLImage >();
+    l_ocl_batch_bg->m_size.x = l_cv_batch_bg.cols;
+    l_ocl_batch_bg->m_size.y = l_cv_batch_bg.rows;
+    l_ocl_batch_bg->m_data = l_cv_batch_bg.data;
+
+    auto l_position = [ & ] ( int i ) { cl_int2 l_pos; l_pos.s[ 0 ] = i % l_cols * l_max_size; l_pos.s[ 1 ] = i / l_cols * l_max_size; return l_pos; };
+
+    std::cout << l_count << " images up to " << l_max_size << "x" << l_max_size << ", batch up to "
+              << l_max_batch << " images or " << l_latency << " ms." << std::endl;
+
+    // one launch per image
+    auto l_start = std::chrono::steady_clock::now();
+    for ( int i = 0; i < l_count; i++ )
+    {
+        gpu_rotate_bgr( l_program, l_single_bgr[ i ].m_ocl_img );
+    }
+    double l_single_rotate_ms = elapsed_ms( l_start );
+
+    l_start = std::chrono::steady_clock::now();
+    for ( int i = 0; i < l_count; i++ )
+    {
+        gpu_convert_bgr_to_bw( l_program, l_single_bgr[ i ].m_ocl_img, l_single_bw[ i ].m_ocl_img );
+    }
+    double l_single_bw_ms = elapsed_ms( l_start );
+
+    l_start = std::chrono::steady_clock::now();
+    for ( int i = 0; i < l_count; i++ )
+    {
+        gpu_insert_image( l_program, l_ocl_single_bg, l_single_bgr[ i ].m_ocl_img, l_position( i ) );
+    }
+    double l_single_insert_ms = elapsed_ms( l_start );
+
+    // batched launches
+    size_t l_batches = 0;
+    double l_batch_rotate_ms, l_batch_bw_ms, l_batch_insert_ms;
+    {
+        OCLBatcher l_batcher( [ & ] ( OCLBatch &t_batch ) { return gpu_rotate_bgr_batch( l_program, t_batch ); },
+                              l_max_batch, 1 << 22, l_latency );
+        l_start = std::chrono::steady_clock::now();
+        std::shared_future< cl_int > l_done;
+        for ( int i = 0; i < l_count; i++ )
+        {
+            l_done = l_batcher.add( l_batch_bgr[ i ].m_ocl_img );
+        }
+        l_err = l_batcher.flush();                                              CL_ERR_E( l_err );
+        l_done.wait();
+        l_batch_rotate_ms = elapsed_ms( l_start );
+        l_batches += l_batcher.batches();
+    }
+    {
+        OCLBatcher l_batcher( [ & ] ( OCLBatch &t_batch ) { return gpu_convert_bgr_to_bw_batch( l_program, t_batch ); },
+                              l_max_batch, 1 << 22, l_latency );
+        l_start = std::chrono::steady_clock::now();
+        std::shared_future< cl_int > l_done;
+        for ( int i = 0; i < l_count; i++ )
+        {
+            l_done = l_batcher.add( l_batch_bgr[ i ].m_ocl_img, l_batch_bw[ i ].m_ocl_img );
+        }
+        l_err = l_batcher.flush();                                              CL_ERR_E( l_err );
+        l_done.wait();
+        l_batch_bw_ms = elapsed_ms( l_start );
+        l_batches += l_batcher.batches();
+    }
+    {
+        OCLBatcher l_batcher( [ & ] ( OCLBatch &t_batch ) { return gpu_insert_image_batch( l_program, t_batch ); },
+                              l_max_batch, 1 << 22, l_latency );
+        l_start = std::chrono::steady_clock::now();
+        std::shared_future< cl_int > l_done;
+        for ( int i = 0; i < l_count; i++ )
+        {
+            l_done = l_batcher.add( l_batch_bgr[ i ].m_ocl_img, l_ocl_batch_bg, l_position( i ) );
+        }
+        l_err = l_batcher.flush();                                              CL_ERR_E( l_err );
+        l_done.wait();
+        l_batch_insert_ms = elapsed_ms( l_start );
+        l_batches += l_batcher.batches();
+    }
+
+    std::cout << std::fixed << std::setprecision( 2 );
+    std::cout << "\n" << std::setw( 20 ) << "kernel" << std::setw( 14 ) << "single [ms]" << std::setw( 14 ) << "batched [ms]" << std::endl;
+    std::cout << std::setw( 20 ) << "rotate_bgr" << std::setw( 14 ) << l_single_rotate_ms << std::setw( 14 ) << l_batch_rotate_ms << std::endl;
+    std::cout << std::setw( 20 ) << "convert_bgr_to_bw" << std::setw( 14 ) << l_single_bw_ms << std::setw( 14 ) << l_batch_bw_ms << std::endl;
+    std::cout << std::setw( 20 ) << "insert_image" << std::setw( 14 ) << l_single_insert_ms << std::setw( 14 ) << l_batch_insert_ms << std::endl;
+    std::cout << "\nBatches: " << l_batches << std::endl;
+
+    // batched kernels must give the same results
+    double l_diff = std::max( compare( l_single_bgr, l_batch_bgr ), compare( l_single_bw, l_batch_bw ) );
+    l_diff = std::max( l_diff, cv::norm( l_cv_single_bg, l_cv_batch_bg, cv::NORM_INF ) );
+    std::cout << "Max. difference of results: " << l_diff << std::endl;
+
+    for ( auto *l_set : { &l_single_bgr, &l_single_bw, &l_batch_bgr, &l_batch_bw } )
+    {
+        for ( auto &l_img : *l_set ) ocl_svm_free( l_img.m_ocl_img );
+    }
+    ocl_svm_free( l_ocl_single_bg );
+    ocl_svm_free( l_ocl_batch_bg );
+
+    cv::imshow( "Batched Sprites", l_cv_batch_bg );
+    cv::waitKey( 0 );
+}
@@ -0,0 +1,186 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_batch.cpp
+ * @brief Many small images processed by one kernel launch.
+ *
+ * @details
+ * Source file for class @ref OCLBatcher.
+ *
+ ***************************************************************************/
+
+#include <iostream>
+
+#include "ocl_utils.h"
+#include "ocl_batch.h"
+
+/// @copydoc OCLBatcher::OCLBatcher
+OCLBatcher::OCLBatcher( OCLBatchLaunch t_launch, int t_max_images, size_t t_max_pixels, double t_max_latency_ms ) :
+    m_launch( t_launch ), m_max_images( std::max( 1, t_max_images ) ), m_max_pixels( t_max_pixels ),
+    m_max_latency( t_max_latency_ms ), m_pending_pixels( 0 ), m_batches( 0 ), m_images( 0 ), m_error( CL_SUCCESS ), m_force( false ), m_stop( false )
+{
+    // arrays for the biggest batch
+    m_batch.m_count = 0;
+    m_batch.m_ocl_src_imgs = ocl_svm_malloc< OCLImage >( m_max_images );
+    m_batch.m_ocl_dst_imgs = ocl_svm_malloc< OCLImage >( m_max_images );
+    m_batch.m_positions = ocl_svm_malloc< cl_int2 >( m_max_images );
+    m_batch.m_prefix = ocl_svm_malloc< cl_uint >( m_max_images + 1 );
+
+    if ( !m_batch.m_ocl_src_imgs || !m_batch.m_ocl_dst_imgs || !m_batch.m_positions || !m_batch.m_prefix )
+    {
+        std::cerr << "Unable to allocate batch of " << m_max_images << " images!" << std::endl;
+        // batcher stays without thread, every call returns error
+        m_error = CL_OUT_OF_RESOURCES;
+        return;
+    }
+
+    m_future = m_promise.get_future().share();
+    m_thread = std::thread( &OCLBatcher::run, this );
+}
+
+/// @copydoc OCLBatcher::~OCLBatcher
+OCLBatcher::~OCLBatcher()
+{
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        m_stop = true;
+        m_cond.notify_one();
+    }
+    if ( m_thread.joinable() ) m_thread.join();
+
+    ocl_svm_free( m_batch.m_ocl_src_imgs );
+    ocl_svm_free( m_batch.m_ocl_dst_imgs );
+    ocl_svm_free( m_batch.m_positions );
+    ocl_svm_free( m_batch.m_prefix );
+}
+
+/// @copydoc OCLBatcher::add
+std::shared_future< cl_int > OCLBatcher::add( const OCLImage *t_src, const OCLImage *t_dst, cl_int2 t_position )
+{
+    if ( m_error != CL_SUCCESS )
+    {
+        std::promise< cl_int > l_failed;
+        l_failed.set_value( m_error );
+        return l_failed.get_future().share();
+    }
+
+    std::unique_lock< std::mutex > l_lock( m_mutex );
+
+    // batch is full, it must be taken by launching thread
+    m_space_cond.wait( l_lock, [ this ] { return m_pending.size() < m_max_images; } );
+
+    if ( m_pending.empty() )
+    {
+        m_first_time = std::chrono::steady_clock::now();
+    }
+
+    Item l_item;
+    l_item.m_src = *t_src;
+    l_item.m_dst = t_dst ? *t_dst : *t_src;
+    l_item.m_position = t_position;
+    m_pending.push_back( l_item );
+    m_pending_pixels += ( size_t ) t_src->m_size.x * t_src->m_size.y;
+
+    // launching thread waits for the first image or for full batch
+    if ( m_pending.size() == 1 || m_pending.size() >= m_max_images || m_pending_pixels >= m_max_pixels )
+    {
+        m_cond.notify_one();
+    }
+
+    return m_future;
+}
+
+/// @copydoc OCLBatcher::flush
+cl_int OCLBatcher::flush()
+{
+    if ( m_error != CL_SUCCESS ) return m_error;
+
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+    m_force = true;
+    m_cond.notify_one();
+    return CL_SUCCESS;
+}
+
+/// @copydoc OCLBatcher::run
+void OCLBatcher::run()
+{
+    std::unique_lock< std::mutex > l_lock( m_mutex );
+
+    for ( ;; )
+    {
+        if ( m_pending.empty() )
+        {
+            m_force = false;
+            if ( m_stop ) break;
+            m_cond.wait( l_lock );
+            continue;
+        }
+
+        // budget of batch
+        auto l_deadline = m_first_time + std::chrono::duration_cast< std::chrono::steady_clock::duration >( m_max_latency );
+        bool l_full = m_pending.size() >= m_max_images || m_pending_pixels >= m_max_pixels;
+        if ( !l_full && !m_force && !m_stop && std::chrono::steady_clock::now() < l_deadline )
+        {
+            m_cond.wait_until( l_lock, l_deadline );
+            continue;
+        }
+
+        // pending images are taken, new images go into the next batch
+        std::vector< Item > l_items;
+        l_items.swap( m_pending );
+        m_pending_pixels = 0;
+        m_force = false;
+        std::promise< cl_int > l_promise( std::move( m_promise ) );
+        m_promise = std::promise< cl_int >();
+        m_future = m_promise.get_future().share();
+        m_space_cond.notify_all();
+
+        l_lock.unlock();
+        launch( l_items, l_promise );
+        l_lock.lock();
+    }
+}
+
+/// @copydoc OCLBatcher::launch
+void OCLBatcher::launch( std::vector< Item > &t_items, std::promise< cl_int > &t_promise )
+{
+    // descriptors and prefix sum of pixels
+    m_batch.m_count = t_items.size();
+    m_batch.m_svm_ptrs.clear();
+    m_batch.m_svm_ptrs.push_back( m_batch.m_ocl_src_imgs );
+    m_batch.m_svm_ptrs.push_back( m_batch.m_ocl_dst_imgs );
+    m_batch.m_svm_ptrs.push_back( m_batch.m_positions );
+    m_batch.m_svm_ptrs.push_back( m_batch.m_prefix );
+
+    m_batch.m_prefix[ 0 ] = 0;
+    for ( size_t i = 0; i < t_items.size(); i++ )
+    {
+        m_batch.m_ocl_src_imgs[ i ] = t_items[ i ].m_src;
+        m_batch.m_ocl_dst_imgs[ i ] = t_items[ i ].m_dst;
+        m_batch.m_positions[ i ] = t_items[ i ].m_position;
+        m_batch.m_prefix[ i + 1 ] = m_batch.m_prefix[ i ] + t_items[ i ].m_src.m_size.x * t_items[ i ].m_src.m_size.y;
+        m_batch.m_svm_ptrs.push_back( t_items[ i ].m_src.m_data );
+        if ( t_items[ i ].m_dst.m_data != t_items[ i ].m_src.m_data )
+        {
+            m_batch.m_svm_ptrs.push_back( t_items[ i ].m_dst.m_data );
+        }
+    }
+
+    cl_int l_err = m_launch( m_batch );                                         CL_ERR_C( l_err );
+
+    m_batches++;
+    m_images += t_items.size();
+
+    t_promise.set_value( l_err );
+}
@@ -0,0 +1,382 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Long-running image processing service.
+ * Server initializes OpenCL and loads program only once and handles
+ * requests of clients over Unix domain socket. Images are in shared
+ * memory of client, they are not sent through socket.
+ * With option -c program is load generator measuring latency and
+ * throughput of server.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <unistd.h>
+#include <signal.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <math.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_threads.h"
+#include "ocl_service.h"
+
+#define KERNEL_SPV      "kernel_15.spv"
+#define KERNEL_PREFIX   "gpu_"
+
+// operations of server
+#define OP_ROTATE_BGR       1       // in-place
+#define OP_BGR_TO_BW        2       // BGR source, BW destination
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// BGR colors rotation.
+// Kernel header from kernel*.cl:
+//__kernel void rotate_bgr(            __global OCLImage *t_ocl_img )
+cl_int gpu_rotate_bgr( OCLThreadRuntime &t_runtime, OCLImage *t_ocl_img )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // kernel and queue of connection thread
+    cl::Kernel &l_kern_rotate_bgr = t_runtime.kernel( l_kern_name );
+    cl::CommandQueue &l_queue = t_runtime.queue();
+
+    // set kernel arguments
+    l_err = l_kern_rotate_bgr.setArg( 0, t_ocl_img );                            CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_rotate_bgr.setSVMPointers( { t_ocl_img, t_ocl_img->m_data } );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    l_err = l_queue.enqueueNDRangeKernel( l_kern_rotate_bgr,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    return l_queue.finish();
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Kernel for BGR to BW conversion
+// Kernel header from kernel*.cl:
+// __kernel void convert_bgr_to_bw(          __global OCLImage *t_ocl_bgr_img,
+//                                           __global OCLImage *t_ocl_bw_img )
+cl_int gpu_convert_bgr_to_bw( OCLThreadRuntime &t_runtime, OCLImage *t_ocl_bgr_img, OCLImage *t_ocl_bw_img )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // kernel and queue of connection thread
+    cl::Kernel &l_kern_convert_bgr_to_bw = t_runtime.kernel( l_kern_name );
+    cl::CommandQueue &l_queue = t_runtime.queue();
+
+    // set kernel arguments
+    l_err = l_kern_convert_bgr_to_bw.setArg( 0, t_ocl_bgr_img );                CL_ERR_R( l_err );
+    l_err = l_kern_convert_bgr_to_bw.setArg( 1, t_ocl_bw_img );                 CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_convert_bgr_to_bw.setSVMPointers( {
+            t_ocl_bgr_img,
+            t_ocl_bgr_img->m_data,
+            t_ocl_bw_img,
+            t_ocl_bw_img->m_data,
+            } );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_bgr_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_bgr_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    l_err = l_queue.enqueueNDRangeKernel( l_kern_convert_bgr_to_bw,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    return l_queue.finish();
+}
+
+// **************************************************************************
+// Server stopped by signal.
+OCLServiceServer *g_server = nullptr;
+
+void stop_server( int )
+{
+    if ( g_server ) g_server->stop();
+}
+
+int run_server( const std::string &t_path )
+{
+    cl_int l_err;
+
+    l_err = ocl_init( 1 );                                                      CL_ERR_E( l_err );
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "Program loaded.\n" << std::endl;
+
+    OCLThreadRuntime l_runtime( l_program );
+    OCLServiceServer *l_server_ptr = nullptr;
+
+    // request of client is handled in its connection thread
+    auto l_handler = [ & ] ( OCLServiceJob &t_job ) -> cl_int
+    {
+        size_t l_pixels = ( size_t ) t_job.m_width * t_job.m_height;
+        if ( l_pixels == 0 || t_job.m_src_size < l_pixels * 4 ) return CL_INVALID_VALUE;
+
+        OCLSVMPool &l_pool = l_server_ptr->pool();
+        OCLImage *l_ocl_src_img = l_pool.alloc< OCLImage >();
+        OCLImage *l_ocl_dst_img = l_pool.alloc< OCLImage >();
+        if ( !l_ocl_src_img || !l_ocl_dst_img )
+        {
+            l_pool.free( l_ocl_src_img );
+            l_pool.free( l_ocl_dst_img );
+            return CL_OUT_OF_RESOURCES;
+        }
+        l_ocl_src_img->m_size.x = l_ocl_dst_img->m_size.x = t_job.m_width;
+        l_ocl_src_img->m_size.y = l_ocl_dst_img->m_size.y = t_job.m_height;
+        l_ocl_src_img->m_data = t_job.m_src;
+        l_ocl_dst_img->m_data = t_job.m_dst;
+
+        cl_int l_ret;
+        switch ( t_job.m_op )
+        {
+        case OP_ROTATE_BGR:
+            l_ret = gpu_rotate_bgr( l_runtime, l_ocl_src_img );
+            break;
+        case OP_BGR_TO_BW:
+            l_ret = t_job.m_dst_size < l_pixels || t_job.m_dst == t_job.m_src ? CL_INVALID_VALUE
+                  : gpu_convert_bgr_to_bw( l_runtime, l_ocl_src_img, l_ocl_dst_img );
+            break;
+        default:
+            l_ret = CL_INVALID_OPERATION;
+        }
+
+        l_pool.free( l_ocl_src_img );
+        l_pool.free( l_ocl_dst_img );
+        return l_ret;
+    };
+
+    OCLServiceServer l_server( l_handler, t_path );
+    l_server_ptr = &l_server;
+
+    g_server = &l_server;
+    signal( SIGINT, stop_server );
+    signal( SIGTERM, stop_server );
+
+    std::cout << "Server listens on " << t_path << ", images are "
+              << ( l_server.zero_copy() ? "used directly (fine-grain system SVM)." : "copied into SVM." ) << std::endl;
+
+    int l_ret = l_server.serve();
+    g_server = nullptr;
+
+    std::cout << "\nServer stopped after " << l_server.requests() << " requests, "
+              << l_runtime.threads() << " connection threads." << std::endl;
+    std::cout << "SVM pool: " << l_server.pool().allocs() << " allocations, " << l_server.pool().reuses() << " reused." << std::endl;
+
+    return l_ret;
+}
+
+// **************************************************************************
+// Load generator, every client thread has its own connection.
+int run_clients( const std::string &t_path, int t_clients, int t_requests, int t_op, int t_width, int t_height )
+{
+    size_t l_pixels = ( size_t ) t_width * t_height;
+    size_t l_src_size = l_pixels * 4;
+    size_t l_dst_size = t_op == OP_BGR_TO_BW ? l_pixels : 0;
+
+    std::vector< std::vector< double > > l_latency( t_clients );
+    std::vector< double > l_server_ms( t_clients, 0 );
+    std::vector< int > l_errors( t_clients, 0 );
+    std::atomic< int > l_zero_copy( 0 );
+
+    auto l_start = std::chrono::steady_clock::now();
+
+    std::vector< std::thread > l_threads;
+    for ( int c = 0; c < t_clients; c++ )
+    {
+        l_threads.emplace_back( [ &, c ] ()
+        {
+            OCLServiceClient l_client;
+            if ( l_client.connect( t_path ) < 0 || l_client.attach( l_src_size + l_dst_size ) < 0 )
+            {
+                perror( t_path.c_str() );
+                l_errors[ c ] = t_requests;
+                return;
+            }
+
+            unsigned char *l_src = l_client.data();
+            unsigned char *l_dst = l_src + l_src_size;
+            for ( size_t i = 0; i < l_src_size; i++ )
+            {
+                l_src[ i ] = ( i * 7 + c ) % 256;
+            }
+
+            for ( int r = 0; r < t_requests; r++ )
+            {
+                OCLServiceReply l_reply;
+                auto l_req_start = std::chrono::steady_clock::now();
+                int l_ret = l_client.request( t_op, t_width, t_height, 0, l_src_size, l_src_size, l_dst_size, l_reply );
+                l_latency[ c ].push_back( std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - l_req_start ).count() );
+
+                if ( l_ret < 0 || l_reply.m_status != CL_SUCCESS )
+                {
+                    l_errors[ c ]++;
+                    if ( l_ret < 0 ) break;
+                    continue;
+                }
+                l_server_ms[ c ] += l_reply.m_server_ms;
+                l_zero_copy = l_reply.m_zero_copy;
+
+                // result of the first request is verified
+                if ( r == 0 && t_op == OP_BGR_TO_BW )
+                {
+                    for ( size_t i = 0; i < l_pixels; i++ )
+                    {
+                        unsigned char *l_bgr = l_src + i * 4;
+                        if ( l_dst[ i ] != ( unsigned char ) ( l_bgr[ 0 ] * 11 / 100 + l_bgr[ 1 ] * 59 / 100 + l_bgr[ 2 ] * 30 / 100 ) )
+                        {
+                            l_errors[ c ]++;
+                            break;
+                        }
+                    }
+                }
+            }
+        } );
+    }
+
+    for ( auto &l_thread : l_threads )
+    {
+        l_thread.join();
+    }
+
+    double l_sec = std::chrono::duration< double >( std::chrono::steady_clock::now() - l_start ).count();
+
+    std::vector< double > l_all;
+    double l_server_sum = 0;
+    int l_error_sum = 0;
+    for ( int c = 0; c < t_clients; c++ )
+    {
+        l_all.insert( l_all.end(), l_latency[ c ].begin(), l_latency[ c ].end() );
+        l_server_sum += l_server_ms[ c ];
+        l_error_sum += l_errors[ c ];
+    }
+    if ( l_all.empty() )
+    {
+        std::cerr << "No request done!" << std::endl;
+        return -1;
+    }
+    std::sort( l_all.begin(), l_all.end() );
+
+    auto l_percentile = [ & ] ( double t_p ) { return l_all[ std::min( l_all.size() - 1, ( size_t ) ( t_p * l_all.size() ) ) ]; };
+
+    std::cout << "Clients " << t_clients << ", requests " << l_all.size() << ", image " << t_width << "x" << t_height
+              << ", " << ( l_zero_copy ? "zero-copy" : "copy" ) << " server." << std::endl;
+    std::cout << std::fixed << std::setprecision( 3 );
+    std::cout << "Throughput: " << std::setprecision( 1 ) << l_all.size() / l_sec << " req/s" << std::setprecision( 3 ) << std::endl;
+    std::cout << "Latency [ms]: p50 " << l_percentile( 0.50 ) << ", p95 " << l_percentile( 0.95 )
+              << ", p99 " << l_percentile( 0.99 ) << ", max " << l_all.back() << std::endl;
+    std::cout << "Time in server [ms]: avg " << l_server_sum / l_all.size() << std::endl;
+    std::cout << "Errors: " << l_error_sum << std::endl;
+
+    return l_error_sum ? -1 : 0;
+}
+
+// **************************************************************************
+
+int main( int t_narg, char **t_args )
+{
+    std::string l_path( OCL_SERVICE_SOCKET );
+    bool l_client = false;
+    int l_clients = 4;
+    int l_requests = 1000;
+    int l_op = OP_BGR_TO_BW;
+    int l_width = 640;
+    int l_height = 480;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "S:ct:n:o:s:" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 'S': l_path = optarg; break;
+        case 'c': l_client = true; break;
+        case 't': l_clients = std::max( 1, atoi( optarg ) ); break;
+        case 'n': l_requests = std::max( 1, atoi( optarg ) ); break;
+        case 'o':
+            if ( !strcmp( optarg, "rotate" ) ) { l_op = OP_ROTATE_BGR; break; }
+            if ( !strcmp( optarg, "bw" ) ) { l_op = OP_BGR_TO_BW; break; }
+            [[fallthrough]];
+        case 's':
+            if ( l_opt == 's' && sscanf( optarg, "%dx%d", &l_width, &l_height ) == 2 && l_width > 0 && l_height > 0 ) break;
+            [[fallthrough]];
+        default:
+            std::cerr << "Usage: " << t_args[ 0 ] << " [-S socket]                 server" << std::endl;
+            std::cerr << "       " << t_args[ 0 ] << " -c [-S socket] [-t clients] [-n requests] [-o rotate|bw] [-s WIDTHxHEIGHT]" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    int l_ret = l_client ? run_clients( l_path, l_clients, l_requests, l_op, l_width, l_height )
+                         : run_server( l_path );
+
+    return l_ret < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,416 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_service.cpp
+ * @brief Image processing service over Unix domain socket.
+ *
+ * @details
+ * Source file for classes @ref OCLServiceServer and @ref OCLServiceClient.
+ *
+ ***************************************************************************/
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+
+#include "ocl_utils.h"
+#include "ocl_service.h"
+
+// message with optional file descriptor
+static int send_message( int t_sock, const void *t_data, size_t t_size, int t_pass_fd = -1 )
+{
+    struct iovec l_iov = { ( void * ) t_data, t_size };
+    struct msghdr l_msg = {};
+    l_msg.msg_iov = &l_iov;
+    l_msg.msg_iovlen = 1;
+
+    char l_cbuf[ CMSG_SPACE( sizeof( int ) ) ] = {};
+    if ( t_pass_fd >= 0 )
+    {
+        l_msg.msg_control = l_cbuf;
+        l_msg.msg_controllen = sizeof( l_cbuf );
+        struct cmsghdr *l_cmsg = CMSG_FIRSTHDR( &l_msg );
+        l_cmsg->cmsg_level = SOL_SOCKET;
+        l_cmsg->cmsg_type = SCM_RIGHTS;
+        l_cmsg->cmsg_len = CMSG_LEN( sizeof( int ) );
+        memcpy( CMSG_DATA( l_cmsg ), &t_pass_fd, sizeof( int ) );
+    }
+
+    return sendmsg( t_sock, &l_msg, MSG_NOSIGNAL ) == ( ssize_t ) t_size ? 0 : -1;
+}
+
+// message of exact size, received file descriptor is stored into t_recv_fd
+static int recv_message( int t_sock, void *t_data, size_t t_size, int *t_recv_fd = nullptr )
+{
+    struct iovec l_iov = { t_data, t_size };
+    struct msghdr l_msg = {};
+    l_msg.msg_iov = &l_iov;
+    l_msg.msg_iovlen = 1;
+
+    char l_cbuf[ CMSG_SPACE( sizeof( int ) ) ];
+    l_msg.msg_control = l_cbuf;
+    l_msg.msg_controllen = sizeof( l_cbuf );
+
+    ssize_t l_len = recvmsg( t_sock, &l_msg, MSG_CMSG_CLOEXEC );
+
+    int l_fd = -1;
+    for ( struct cmsghdr *l_cmsg = CMSG_FIRSTHDR( &l_msg ); l_len > 0 && l_cmsg; l_cmsg = CMSG_NXTHDR( &l_msg, l_cmsg ) )
+    {
+        if ( l_cmsg->cmsg_level == SOL_SOCKET && l_cmsg->cmsg_type == SCM_RIGHTS )
+        {
+            memcpy( &l_fd, CMSG_DATA( l_cmsg ), sizeof( int ) );
+        }
+    }
+
+    // truncated message or control data is error
+    bool l_truncated = l_len > 0 && ( l_msg.msg_flags & ( MSG_TRUNC | MSG_CTRUNC ) );
+
+    // unexpected descriptor must not leak
+    if ( l_fd >= 0 && ( !t_recv_fd || l_truncated ) )
+    {
+        close( l_fd );
+        l_fd = -1;
+    }
+    if ( t_recv_fd ) *t_recv_fd = l_fd;
+
+    return l_len == ( ssize_t ) t_size && !l_truncated ? 0 : -1;
+}
+
+// region must be inside shared memory
+static bool in_shm( uint64_t t_offset, uint64_t t_size, size_t t_shm_size )
+{
+    return t_size <= t_shm_size && t_offset <= t_shm_size - t_size;
+}
+
+/// @copydoc OCLServiceServer::OCLServiceServer
+OCLServiceServer::OCLServiceServer( OCLServiceHandler t_handler, const std::string &t_path ) :
+    m_handler( t_handler ), m_path( t_path ), m_fd( -1 ), m_stop( false ), m_requests( 0 )
+{
+    // any host memory, also memory of other process mapped here, is usable by kernels
+    cl_device_svm_capabilities l_caps = cl::Device::getDefault().getInfo< CL_DEVICE_SVM_CAPABILITIES >();
+    m_zero_copy = ( l_caps & CL_DEVICE_SVM_FINE_GRAIN_SYSTEM ) != 0;
+}
+
+/// @copydoc OCLServiceServer::~OCLServiceServer
+OCLServiceServer::~OCLServiceServer()
+{
+    m_stop = true;
+    reap( true );
+    if ( m_fd >= 0 )
+    {
+        close( m_fd );
+        unlink( m_path.c_str() );
+    }
+}
+
+/// @copydoc OCLServiceServer::serve
+int OCLServiceServer::serve()
+{
+    struct sockaddr_un l_addr = {};
+    l_addr.sun_family = AF_UNIX;
+    if ( m_path.size() >= sizeof( l_addr.sun_path ) )
+    {
+        std::cerr << "Socket path " << m_path << " is too long!" << std::endl;
+        return -1;
+    }
+    strcpy( l_addr.sun_path, m_path.c_str() );
+
+    // packets keep boundaries of messages
+    m_fd = socket( AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0 );
+    if ( m_fd < 0 )
+    {
+        perror( "socket" );
+        return -1;
+    }
+
+    unlink( m_path.c_str() );
+    if ( bind( m_fd, ( struct sockaddr * ) &l_addr, sizeof( l_addr ) ) < 0 || listen( m_fd, 16 ) < 0 )
+    {
+        perror( m_path.c_str() );
+        close( m_fd );
+        m_fd = -1;
+        return -1;
+    }
+
+    while ( !m_stop )
+    {
+        // timeout for check of stop
+        struct pollfd l_poll = { m_fd, POLLIN, 0 };
+        if ( poll( &l_poll, 1, 100 ) <= 0 ) continue;
+
+        int l_client = accept4( m_fd, nullptr, nullptr, SOCK_CLOEXEC );
+        if ( l_client < 0 ) continue;
+
+        std::unique_ptr< Connection > l_conn( new Connection );
+        l_conn->m_fd = l_client;
+        l_conn->m_done = false;
+        Connection *l_ptr = l_conn.get();
+        {
+            std::lock_guard< std::mutex > l_lock( m_mutex );
+            m_connections.push_back( std::move( l_conn ) );
+        }
+        l_ptr->m_thread = std::thread( &OCLServiceServer::handle, this, l_ptr );
+
+        reap( false );
+    }
+
+    reap( true );
+
+    close( m_fd );
+    unlink( m_path.c_str() );
+    m_fd = -1;
+
+    return 0;
+}
+
+/// @copydoc OCLServiceServer::reap
+void OCLServiceServer::reap( bool t_all )
+{
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+
+    for ( auto l_it = m_connections.begin(); l_it != m_connections.end(); )
+    {
+        Connection &l_conn = **l_it;
+        if ( !t_all && !l_conn.m_done )
+        {
+            ++l_it;
+            continue;
+        }
+
+        // blocked receive is interrupted, descriptor is closed only after join
+        if ( !l_conn.m_done ) shutdown( l_conn.m_fd, SHUT_RDWR );
+        if ( l_conn.m_thread.joinable() ) l_conn.m_thread.join();
+        close( l_conn.m_fd );
+        l_it = m_connections.erase( l_it );
+    }
+}
+
+/// @copydoc OCLServiceServer::handle
+void OCLServiceServer::handle( Connection *t_conn )
+{
+    unsigned char *l_shm = nullptr;
+    size_t l_shm_size = 0;
+
+    OCLServiceRequest l_req;
+    int l_recv_fd;
+    while ( !m_stop && recv_message( t_conn->m_fd, &l_req, sizeof( l_req ), &l_recv_fd ) == 0 )
+    {
+        if ( l_req.m_magic != OCL_SERVICE_MAGIC )
+        {
+            if ( l_recv_fd >= 0 ) close( l_recv_fd );
+            break;
+        }
+
+        OCLServiceReply l_reply = {};
+        l_reply.m_magic = OCL_SERVICE_MAGIC;
+        l_reply.m_id = l_req.m_id;
+        l_reply.m_zero_copy = m_zero_copy;
+
+        if ( l_req.m_op == OCL_SERVICE_ATTACH )
+        {
+            // new shared memory of client replaces the previous one
+            if ( l_shm ) munmap( l_shm, l_shm_size );
+            l_shm = nullptr;
+            l_shm_size = 0;
+
+            // size must be sealed, shrinking of mapped memory would kill server by SIGBUS
+            int l_seals = l_recv_fd >= 0 ? fcntl( l_recv_fd, F_GET_SEALS ) : -1;
+            bool l_sealed = l_seals >= 0 && ( l_seals & ( F_SEAL_SHRINK | F_SEAL_GROW ) ) == ( F_SEAL_SHRINK | F_SEAL_GROW );
+
+            struct stat l_stat;
+            if ( l_sealed && fstat( l_recv_fd, &l_stat ) == 0 && l_stat.st_size > 0 )
+            {
+                void *l_map = mmap( nullptr, l_stat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, l_recv_fd, 0 );
+                if ( l_map != MAP_FAILED )
+                {
+                    l_shm = ( unsigned char * ) l_map;
+                    l_shm_size = l_stat.st_size;
+                }
+            }
+            l_reply.m_status = l_shm ? CL_SUCCESS : CL_OUT_OF_HOST_MEMORY;
+        }
+        else
+        {
+            l_reply.m_status = process( l_req, l_shm, l_shm_size, l_reply );
+        }
+
+        // mapping is kept, descriptor is not needed
+        if ( l_recv_fd >= 0 ) close( l_recv_fd );
+
+        if ( send_message( t_conn->m_fd, &l_reply, sizeof( l_reply ) ) < 0 ) break;
+    }
+
+    if ( l_shm ) munmap( l_shm, l_shm_size );
+    t_conn->m_done = true;
+}
+
+/// @copydoc OCLServiceServer::process
+int OCLServiceServer::process( OCLServiceRequest &t_req, unsigned char *t_shm, size_t t_shm_size, OCLServiceReply &t_reply )
+{
+    auto l_start = std::chrono::steady_clock::now();
+
+    if ( !t_shm || !in_shm( t_req.m_src_offset, t_req.m_src_size, t_shm_size ) ||
+         !in_shm( t_req.m_dst_offset, t_req.m_dst_size, t_shm_size ) )
+    {
+        return CL_INVALID_VALUE;
+    }
+
+    OCLServiceJob l_job;
+    l_job.m_op = t_req.m_op;
+    l_job.m_width = t_req.m_width;
+    l_job.m_height = t_req.m_height;
+    l_job.m_src_size = t_req.m_src_size;
+    l_job.m_dst_size = t_req.m_dst_size ? t_req.m_dst_size : t_req.m_src_size;
+
+    cl_int l_status;
+    if ( m_zero_copy )
+    {
+        // kernels work in memory of client
+        l_job.m_src = t_shm + t_req.m_src_offset;
+        l_job.m_dst = t_req.m_dst_size ? t_shm + t_req.m_dst_offset : l_job.m_src;
+        l_status = m_handler( l_job );
+    }
+    else
+    {
+        // images are copied into SVM and result back
+        l_job.m_src = m_pool.alloc( t_req.m_src_size );
+        l_job.m_dst = t_req.m_dst_size ? m_pool.alloc( t_req.m_dst_size ) : l_job.m_src;
+        if ( l_job.m_src && l_job.m_dst )
+        {
+            memcpy( l_job.m_src, t_shm + t_req.m_src_offset, t_req.m_src_size );
+            l_status = m_handler( l_job );
+            if ( l_status == CL_SUCCESS )
+            {
+                unsigned char *l_dst = t_req.m_dst_size ? t_shm + t_req.m_dst_offset : t_shm + t_req.m_src_offset;
+                memcpy( l_dst, l_job.m_dst, l_job.m_dst_size );
+            }
+        }
+        else
+        {
+            l_status = CL_OUT_OF_RESOURCES;
+        }
+        if ( l_job.m_dst != l_job.m_src ) m_pool.free( l_job.m_dst );
+        m_pool.free( l_job.m_src );
+    }
+
+    m_requests++;
+    t_reply.m_server_ms = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - l_start ).count();
+
+    return l_status;
+}
+
+/// @copydoc OCLServiceClient::~OCLServiceClient
+OCLServiceClient::~OCLServiceClient()
+{
+    if ( m_shm ) munmap( m_shm, m_shm_size );
+    if ( m_fd >= 0 ) close( m_fd );
+}
+
+/// @copydoc OCLServiceClient::connect
+int OCLServiceClient::connect( const std::string &t_path )
+{
+    struct sockaddr_un l_addr = {};
+    l_addr.sun_family = AF_UNIX;
+    if ( t_path.size() >= sizeof( l_addr.sun_path ) )
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy( l_addr.sun_path, t_path.c_str() );
+
+    m_fd = socket( AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0 );
+    if ( m_fd < 0 ) return -1;
+
+    if ( ::connect( m_fd, ( struct sockaddr * ) &l_addr, sizeof( l_addr ) ) < 0 )
+    {
+        close( m_fd );
+        m_fd = -1;
+        return -1;
+    }
+
+    return 0;
+}
+
+/// @copydoc OCLServiceClient::attach
+int OCLServiceClient::attach( size_t t_size )
+{
+    int l_memfd = memfd_create( "ocl_service", MFD_CLOEXEC | MFD_ALLOW_SEALING );
+    if ( l_memfd < 0 ) return -1;
+
+    // server accepts only memory with sealed size
+    void *l_map = MAP_FAILED;
+    if ( ftruncate( l_memfd, t_size ) == 0 && fcntl( l_memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW ) == 0 )
+    {
+        l_map = mmap( nullptr, t_size, PROT_READ | PROT_WRITE, MAP_SHARED, l_memfd, 0 );
+    }
+    if ( l_map == MAP_FAILED )
+    {
+        close( l_memfd );
+        return -1;
+    }
+
+    if ( m_shm ) munmap( m_shm, m_shm_size );
+    m_shm = ( unsigned char * ) l_map;
+    m_shm_size = t_size;
+
+    // server maps the same memory
+    OCLServiceRequest l_req = {};
+    l_req.m_magic = OCL_SERVICE_MAGIC;
+    l_req.m_op = OCL_SERVICE_ATTACH;
+    l_req.m_id = m_next_id++;
+
+    OCLServiceReply l_reply;
+    int l_ret = send_message( m_fd, &l_req, sizeof( l_req ), l_memfd );
+    close( l_memfd );
+    if ( l_ret == 0 ) l_ret = recv_message( m_fd, &l_reply, sizeof( l_reply ) );
+
+    if ( l_ret < 0 ) return -1;
+    if ( l_reply.m_status != CL_SUCCESS )
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    return 0;
+}
+
+/// @copydoc OCLServiceClient::request
+int OCLServiceClient::request( uint32_t t_op, uint32_t t_width, uint32_t t_height,
+                               size_t t_src_offset, size_t t_src_size, size_t t_dst_offset, size_t t_dst_size,
+                               OCLServiceReply &t_reply )
+{
+    OCLServiceRequest l_req;
+    l_req.m_magic = OCL_SERVICE_MAGIC;
+    l_req.m_op = t_op;
+    l_req.m_id = m_next_id++;
+    l_req.m_width = t_width;
+    l_req.m_height = t_height;
+    l_req.m_src_offset = t_src_offset;
+    l_req.m_src_size = t_src_size;
+    l_req.m_dst_offset = t_dst_offset;
+    l_req.m_dst_size = t_dst_size;
+
+    if ( send_message( m_fd, &l_req, sizeof( l_req ) ) < 0 ) return -1;
+    if ( recv_message( m_fd, &t_reply, sizeof( t_reply ) ) < 0 ) return -1;
+
+    return t_reply.m_magic == OCL_SERVICE_MAGIC && t_reply.m_id == l_req.m_id ? 0 : -1;
+}
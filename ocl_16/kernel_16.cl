@@ -0,0 +1,87 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course 
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Short preview kernel and long bulk kernel scheduled by priority.
+ * Kernels use global id with offset, so NDRange can be split into chunks.
+ * 
+ ***************************************************************************/
+
+#include "ocl_image.h"
+
+// kernel for BGR color rotation
+__kernel void rotate_bgr( __global OCLImage *t_ocl_img )
+{
+    // get work-item position  
+    size_t global_idx = get_global_id( 0 );
+    size_t global_idy = get_global_id( 1 );
+
+    // verify work-item position
+    if ( global_idx >= t_ocl_img->m_size.x ) return;
+    if ( global_idy >= t_ocl_img->m_size.y ) return;
+
+    // get one point from image
+    uchar4 l_bgr = t_ocl_img->at4( global_idy, global_idx );
+
+    // rotate colors
+    uchar4 l_bgr_rot;
+    l_bgr_rot.x = l_bgr.y;
+    l_bgr_rot.y = l_bgr.z;
+    l_bgr_rot.z = l_bgr.x;
+
+    // put point into image
+    t_ocl_img->at4( global_idy, global_idx ) = l_bgr_rot;
+}
+
+// **************************************************************************
+// kernel for box blur of BGR image
+__kernel void blur_bgr( __global OCLImage *t_ocl_src_img, __global OCLImage *t_ocl_dst_img, int t_radius )
+{
+    // get work-item position  
+    int global_idx = get_global_id( 0 );
+    int global_idy = get_global_id( 1 );
+
+    // verify work-item position
+    if ( global_idx >= t_ocl_dst_img->m_size.x ) return;
+    if ( global_idy >= t_ocl_dst_img->m_size.y ) return;
+
+    int l_width = t_ocl_src_img->m_size.x;
+    int l_height = t_ocl_src_img->m_size.y;
+
+    // neighbourhood inside of image
+    int l_y0 = max( global_idy - t_radius, 0 );
+    int l_y1 = min( global_idy + t_radius, l_height - 1 );
+    int l_x0 = max( global_idx - t_radius, 0 );
+    int l_x1 = min( global_idx + t_radius, l_width - 1 );
+
+    // sum of all points
+    uint4 l_sum = { 0, 0, 0, 0 };
+    for ( int y = l_y0; y <= l_y1; y++ )
+    {
+        for ( int x = l_x0; x <= l_x1; x++ )
+        {
+            uchar4 l_bgr = t_ocl_src_img->at4( y, x );
+            l_sum.x += l_bgr.x;
+            l_sum.y += l_bgr.y;
+            l_sum.z += l_bgr.z;
+            l_sum.w += l_bgr.w;
+        }
+    }
+
+    uint l_count = ( l_y1 - l_y0 + 1 ) * ( l_x1 - l_x0 + 1 );
+
+    // put average into image
+    uchar4 l_avg;
+    l_avg.x = l_sum.x / l_count;
+    l_avg.y = l_sum.y / l_count;
+    l_avg.z = l_sum.z / l_count;
+    l_avg.w = l_sum.w / l_count;
+    t_ocl_dst_img->at4( global_idy, global_idx ) = l_avg;
+}
@@ -0,0 +1,297 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Interactive previews and bulk jobs on one device.
+ * Small preview kernels are launched periodically with deadline,
+ * big blur kernels are launched all the time in background.
+ * Latency of previews is measured in FIFO order, with priority classes
+ * and with priority classes and bulk NDRange split into chunks.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <unistd.h>
+#include <iostream>
+#include <iomanip>
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_sched.h"
+
+#define KERNEL_SPV      "kernel_16.spv"
+#define KERNEL_PREFIX   "gpu_"
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// BGR colors rotation, launch is only submitted into scheduler.
+// Kernel header from kernel*.cl:
+//__kernel void rotate_bgr(            __global OCLImage *t_ocl_img )
+std::future< cl_int > gpu_rotate_bgr( OCLScheduler &t_sched, cl::Program &t_program, OCLImage *t_ocl_img,
+                                      int t_priority, double t_deadline_ms )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_rotate_bgr( t_program, l_kern_name.c_str(), &l_err );     CL_ERR_C( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_rotate_bgr.setArg( 0, t_ocl_img );                            CL_ERR_C( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_rotate_bgr.setSVMPointers( { t_ocl_img, t_ocl_img->m_data } );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // scheduler enqueues kernel later
+    return t_sched.submit( l_kern_rotate_bgr,
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ),
+            t_priority, t_deadline_ms );
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Box blur, launch is only submitted into scheduler.
+// Kernel header from kernel*.cl:
+// __kernel void blur_bgr(                   __global OCLImage *t_ocl_src_img,
+//                                           __global OCLImage *t_ocl_dst_img,
+//                                           int t_radius )
+std::future< cl_int > gpu_blur_bgr( OCLScheduler &t_sched, cl::Program &t_program, OCLImage *t_ocl_src_img,
+                                    OCLImage *t_ocl_dst_img, int t_radius, int t_priority )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_blur_bgr( t_program, l_kern_name.c_str(), &l_err );       CL_ERR_C( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_blur_bgr.setArg( 0, t_ocl_src_img );                         CL_ERR_C( l_err );
+    l_err = l_kern_blur_bgr.setArg( 1, t_ocl_dst_img );                         CL_ERR_C( l_err );
+    l_err = l_kern_blur_bgr.setArg( 2, t_radius );                              CL_ERR_C( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_blur_bgr.setSVMPointers( {
+            t_ocl_src_img,
+            t_ocl_src_img->m_data,
+            t_ocl_dst_img,
+            t_ocl_dst_img->m_data,
+            } );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_dst_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_dst_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // scheduler enqueues kernel later, maybe in more chunks
+    return t_sched.submit( l_kern_blur_bgr,
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ),
+            t_priority );
+}
+
+// **************************************************************************
+// Image with data in SVM.
+OCLImage *create_image( int t_width, int t_height )
+{
+    OCLImage *l_ocl_img = ocl_svm_malloc< OCLImage >();
+    unsigned char *l_data = ocl_svm_malloc< unsigned char >( ( size_t ) t_width * t_height * 4 );
+    if ( !l_ocl_img || !l_data )
+    {
+        std::cerr << "Unable to allocate image " << t_width << "x" << t_height << "!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+    for ( size_t i = 0; i < ( size_t ) t_width * t_height * 4; i++ )
+    {
+        l_data[ i ] = i * 7 % 256;
+    }
+    l_ocl_img->m_size.x = t_width;
+    l_ocl_img->m_size.y = t_height;
+    l_ocl_img->m_data = l_data;
+    return l_ocl_img;
+}
+
+void release_image( OCLImage *t_ocl_img )
+{
+    ocl_svm_free( t_ocl_img->m_data );
+    ocl_svm_free( t_ocl_img );
+}
+
+// **************************************************************************
+
+int main( int t_narg, char **t_args )
+{
+    int l_preview_width = 320, l_preview_height = 240;
+    int l_bulk_width = 2048, l_bulk_height = 2048;
+    int l_radius = 8;
+    int l_previews = 200;
+    double l_period_ms = 5;
+    double l_deadline_ms = 10;
+    size_t l_chunk_items = 1 << 18;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "s:b:r:n:p:d:c:" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 's':
+            if ( sscanf( optarg, "%dx%d", &l_preview_width, &l_preview_height ) == 2 && l_preview_width > 0 && l_preview_height > 0 ) break;
+            goto usage;
+        case 'b':
+            if ( sscanf( optarg, "%dx%d", &l_bulk_width, &l_bulk_height ) == 2 && l_bulk_width > 0 && l_bulk_height > 0 ) break;
+            goto usage;
+        case 'r': l_radius = std::max( 0, atoi( optarg ) ); break;
+        case 'n': l_previews = std::max( 1, atoi( optarg ) ); break;
+        case 'p': l_period_ms = std::max( 0.0, atof( optarg ) ); break;
+        case 'd': l_deadline_ms = std::max( 0.0, atof( optarg ) ); break;
+        case 'c': l_chunk_items = std::max( 1, atoi( optarg ) ); break;
+        default:
+        usage:
+            std::cerr << "Usage: " << t_args[ 0 ] << " [-s preview WxH] [-b bulk WxH] [-r radius] [-n previews]"
+                      << " [-p period_ms] [-d deadline_ms] [-c chunk_items]" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    cl_int l_err;
+
+    l_err = ocl_init( 1 );                                                      CL_ERR_E( l_err );
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "Program loaded.\n" << std::endl;
+
+    OCLImage *l_ocl_preview_img = create_image( l_preview_width, l_preview_height );
+    OCLImage *l_ocl_bulk_src_img = create_image( l_bulk_width, l_bulk_height );
+    OCLImage *l_ocl_bulk_dst_img = create_image( l_bulk_width, l_bulk_height );
+
+    std::cout << l_previews << " previews " << l_preview_width << "x" << l_preview_height << " every " << l_period_ms
+              << " ms with deadline " << l_deadline_ms << " ms, bulk blur " << l_bulk_width << "x" << l_bulk_height
+              << " radius " << l_radius << ".\n" << std::endl;
+
+    std::cout << std::setw( 20 ) << "mode" << std::setw( 12 ) << "class" << std::setw( 8 ) << "jobs"
+              << std::setw( 10 ) << "p50 [ms]" << std::setw( 10 ) << "p95 [ms]" << std::setw( 10 ) << "p99 [ms]"
+              << std::setw( 10 ) << "max [ms]" << std::setw( 8 ) << "missed" << std::setw( 8 ) << "chunks" << std::endl;
+
+    struct Mode
+    {
+        const char *m_name;
+        bool m_fifo;                // classes are ignored
+        size_t m_chunk_items;       // 0 without splitting
+    };
+    Mode l_modes[] = {
+        { "FIFO", true, 0 },
+        { "priority", false, 0 },
+        { "priority+chunks", false, l_chunk_items },
+    };
+
+    for ( Mode &l_mode : l_modes )
+    {
+        OCLScheduler l_sched( l_mode.m_chunk_items, l_mode.m_fifo );
+
+        int l_preview_class = OCL_PRIO_INTERACTIVE;
+        int l_bulk_class = OCL_PRIO_BATCH;
+
+        // bulk jobs keep device busy, two of them are always waiting
+        std::atomic< bool > l_stop( false );
+        std::thread l_bulk( [ & ] ()
+        {
+            std::future< cl_int > l_prev = gpu_blur_bgr( l_sched, l_program, l_ocl_bulk_src_img, l_ocl_bulk_dst_img, l_radius, l_bulk_class );
+            while ( !l_stop )
+            {
+                std::future< cl_int > l_next = gpu_blur_bgr( l_sched, l_program, l_ocl_bulk_src_img, l_ocl_bulk_dst_img, l_radius, l_bulk_class );
+                l_prev.get();
+                l_prev = std::move( l_next );
+            }
+            l_prev.get();
+        } );
+
+        // periodic previews
+        std::vector< std::future< cl_int > > l_results;
+        auto l_next_time = std::chrono::steady_clock::now();
+        for ( int i = 0; i < l_previews; i++ )
+        {
+            l_next_time += std::chrono::duration_cast< std::chrono::steady_clock::duration >( std::chrono::duration< double, std::milli >( l_period_ms ) );
+            std::this_thread::sleep_until( l_next_time );
+            l_results.push_back( gpu_rotate_bgr( l_sched, l_program, l_ocl_preview_img, l_preview_class, l_deadline_ms ) );
+        }
+        for ( auto &l_result : l_results )
+        {
+            l_err = l_result.get();                                             CL_ERR_C( l_err );
+        }
+
+        l_stop = true;
+        l_bulk.join();
+
+        for ( int p = 0; p < OCL_PRIO_COUNT; p++ )
+        {
+            OCLSchedStats l_stats = l_sched.stats( p );
+            if ( l_stats.m_jobs == 0 ) continue;
+
+            const char *l_class_names[] = { "interactive", "normal", "batch" };
+            std::cout << std::setw( 20 ) << l_mode.m_name << std::setw( 12 ) << l_class_names[ p ] << std::setw( 8 ) << l_stats.m_jobs
+                      << std::fixed << std::setprecision( 2 )
+                      << std::setw( 10 ) << l_stats.m_p50 << std::setw( 10 ) << l_stats.m_p95 << std::setw( 10 ) << l_stats.m_p99
+                      << std::setw( 10 ) << l_stats.m_max << std::setw( 8 ) << l_stats.m_missed << std::setw( 8 ) << l_sched.chunks() << std::endl;
+        }
+    }
+
+    release_image( l_ocl_preview_img );
+    release_image( l_ocl_bulk_src_img );
+    release_image( l_ocl_bulk_dst_img );
+}
@@ -0,0 +1,226 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_sched.cpp
+ * @brief Priority and deadline scheduling of kernel launches.
+ *
+ * @details
+ * Source file for class @ref OCLScheduler.
+ *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <iostream>
+
+#include "ocl_utils.h"
+#include "ocl_sched.h"
+
+/// @copydoc OCLScheduler::OCLScheduler
+OCLScheduler::OCLScheduler( size_t t_chunk_items, bool t_fifo ) :
+    m_chunk_items( t_chunk_items ), m_fifo( t_fifo ), m_seq( 0 ), m_chunks( 0 ), m_stop( false )
+{
+    cl_int l_err;
+
+    // only scheduler uses this queue, so it holds at most one chunk
+    m_queue = cl::CommandQueue( cl::Context::getDefault(), cl::Device::getDefault(), 0, &l_err );  CL_ERR_C( l_err );
+
+    reset_stats();
+
+    m_thread = std::thread( &OCLScheduler::run, this );
+}
+
+/// @copydoc OCLScheduler::~OCLScheduler
+OCLScheduler::~OCLScheduler()
+{
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        m_stop = true;
+        m_cond.notify_one();
+    }
+    m_thread.join();
+}
+
+/// @copydoc OCLScheduler::submit
+std::future< cl_int > OCLScheduler::submit( const cl::Kernel &t_kernel, const cl::NDRange &t_global, const cl::NDRange &t_local,
+                                            int t_priority, double t_deadline_ms )
+{
+    std::unique_ptr< Job > l_job( new Job );
+    l_job->m_kernel = t_kernel;
+    l_job->m_global = t_global;
+    l_job->m_local = t_local;
+    l_job->m_next = 0;
+    l_job->m_submit = Clock::now();
+    l_job->m_deadline = t_deadline_ms > 0
+        ? l_job->m_submit + std::chrono::duration_cast< Clock::duration >( std::chrono::duration< double, std::milli >( t_deadline_ms ) )
+        : Clock::time_point::max();
+
+    std::future< cl_int > l_future = l_job->m_promise.get_future();
+
+    int l_priority = std::min( std::max( t_priority, 0 ), OCL_PRIO_COUNT - 1 );
+
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+    l_job->m_seq = m_seq++;
+    m_ready[ l_priority ].push_back( std::move( l_job ) );
+    m_cond.notify_one();
+
+    return l_future;
+}
+
+/// @copydoc OCLScheduler::select
+OCLScheduler::Job *OCLScheduler::select( int &t_priority )
+{
+    if ( m_fifo )
+    {
+        // the oldest launch of all classes, lists are ordered by submission
+        Job *l_oldest = nullptr;
+        for ( int p = 0; p < OCL_PRIO_COUNT; p++ )
+        {
+            if ( m_ready[ p ].empty() ) continue;
+            if ( l_oldest && l_oldest->m_seq < m_ready[ p ].front()->m_seq ) continue;
+            l_oldest = m_ready[ p ].front().get();
+            t_priority = p;
+        }
+        return l_oldest;
+    }
+
+    for ( int p = 0; p < OCL_PRIO_COUNT; p++ )
+    {
+        if ( m_ready[ p ].empty() ) continue;
+
+        // the earliest deadline first, then FIFO
+        auto l_best = std::min_element( m_ready[ p ].begin(), m_ready[ p ].end(),
+            [] ( const std::unique_ptr< Job > &t_a, const std::unique_ptr< Job > &t_b )
+            {
+                if ( t_a->m_deadline != t_b->m_deadline ) return t_a->m_deadline < t_b->m_deadline;
+                return t_a->m_seq < t_b->m_seq;
+            } );
+
+        t_priority = p;
+        return l_best->get();
+    }
+    return nullptr;
+}
+
+/// @copydoc OCLScheduler::launch_chunk
+cl_int OCLScheduler::launch_chunk( Job &t_job )
+{
+    // the last dimension is split: rows of 2D range, items of 1D range
+    size_t l_dims = t_job.m_global.dimensions();
+    size_t l_split = l_dims - 1;
+    const size_t *l_global = t_job.m_global;
+    size_t l_local = t_job.m_local.dimensions() ? ( ( const size_t * ) t_job.m_local )[ l_split ] : 1;
+    size_t l_total = l_global[ l_split ];
+
+    size_t l_count = l_total - t_job.m_next;
+    if ( m_chunk_items > 0 )
+    {
+        // work-items in one row (1D: one item) and chunk as multiple of work-group
+        size_t l_row_items = l_dims > 1 ? l_global[ 0 ] : 1;
+        size_t l_rows = std::max< size_t >( 1, m_chunk_items / l_row_items ) / l_local * l_local;
+        l_count = std::min( l_count, std::max( l_rows, l_local ) );
+    }
+
+    cl::NDRange l_offset, l_range;
+    if ( l_dims == 1 )
+    {
+        l_offset = cl::NDRange( t_job.m_next );
+        l_range = cl::NDRange( l_count );
+    }
+    else
+    {
+        l_offset = cl::NDRange( 0, t_job.m_next );
+        l_range = cl::NDRange( l_global[ 0 ], l_count );
+    }
+
+    cl_int l_err = m_queue.enqueueNDRangeKernel( t_job.m_kernel, l_offset, l_range, t_job.m_local );  CL_ERR_R( l_err );
+
+    t_job.m_next += l_count;
+    m_chunks++;
+
+    // next selection is done after this chunk, so urgent launch waits only for one chunk
+    return m_queue.finish();
+}
+
+/// @copydoc OCLScheduler::run
+void OCLScheduler::run()
+{
+    std::unique_lock< std::mutex > l_lock( m_mutex );
+
+    for ( ;; )
+    {
+        int l_priority;
+        Job *l_job = select( l_priority );
+        if ( l_job == nullptr )
+        {
+            if ( m_stop ) break;
+            m_cond.wait( l_lock );
+            continue;
+        }
+
+        // job stays in list, submit can add more urgent launch during chunk
+        l_lock.unlock();
+        cl_int l_err = launch_chunk( *l_job );
+        l_lock.lock();
+
+        size_t l_dims = l_job->m_global.dimensions();
+        if ( l_err == CL_SUCCESS && l_job->m_next < ( ( const size_t * ) l_job->m_global )[ l_dims - 1 ] ) continue;
+
+        // finished or failed launch is removed
+        auto l_now = Clock::now();
+        m_latency[ l_priority ].push_back( std::chrono::duration< double, std::milli >( l_now - l_job->m_submit ).count() );
+        if ( l_now > l_job->m_deadline ) m_missed[ l_priority ]++;
+
+        l_job->m_promise.set_value( l_err );
+
+        auto &l_list = m_ready[ l_priority ];
+        l_list.erase( std::find_if( l_list.begin(), l_list.end(),
+                      [ l_job ] ( const std::unique_ptr< Job > &t_ptr ) { return t_ptr.get() == l_job; } ) );
+    }
+}
+
+/// @copydoc OCLScheduler::stats
+OCLSchedStats OCLScheduler::stats( int t_priority )
+{
+    std::vector< double > l_sorted;
+    OCLSchedStats l_stats = {};
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        l_sorted = m_latency[ t_priority ];
+        l_stats.m_missed = m_missed[ t_priority ];
+    }
+
+    l_stats.m_jobs = l_sorted.size();
+    if ( l_sorted.empty() ) return l_stats;
+
+    std::sort( l_sorted.begin(), l_sorted.end() );
+    auto l_percentile = [ & ] ( double t_p ) { return l_sorted[ std::min( l_sorted.size() - 1, ( size_t ) ( t_p * l_sorted.size() ) ) ]; };
+    l_stats.m_p50 = l_percentile( 0.50 );
+    l_stats.m_p95 = l_percentile( 0.95 );
+    l_stats.m_p99 = l_percentile( 0.99 );
+    l_stats.m_max = l_sorted.back();
+
+    return l_stats;
+}
+
+/// @copydoc OCLScheduler::reset_stats
+void OCLScheduler::reset_stats()
+{
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+    for ( int p = 0; p < OCL_PRIO_COUNT; p++ )
+    {
+        m_latency[ p ].clear();
+        m_missed[ p ] = 0;
+    }
+    m_chunks = 0;
+}
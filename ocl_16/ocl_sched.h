@@ -0,0 +1,157 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_sched.h
+ * @brief Priority and deadline scheduling of kernel launches.
+ *
+ * @details
+ * Header file for class @ref OCLScheduler.
+ *
+ * In one FIFO queue a short interactive kernel waits for all bulk kernels
+ * enqueued before it. Scheduler keeps launches in its own lists by
+ * priority class and deadline and enqueues them one by one. A big NDRange
+ * is split into chunks of rows, so an urgent launch waits at most
+ * for one chunk.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_SCHED_H
+#define __OCL_SCHED_H
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+#include <CL/opencl.hpp>
+
+/**
+ * @brief Priority classes, lower value is more urgent.
+*/
+enum OCLPriority
+{
+    OCL_PRIO_INTERACTIVE = 0,       ///< Previews, short deadline.
+    OCL_PRIO_NORMAL,                ///< Common work.
+    OCL_PRIO_BATCH,                 ///< Bulk jobs, only throughput matters.
+    OCL_PRIO_COUNT
+};
+
+/**
+ * @brief Statistics of one priority class.
+*/
+struct OCLSchedStats
+{
+    size_t m_jobs;              ///< Finished launches.
+    size_t m_missed;            ///< Launches finished after deadline.
+    double m_p50;               ///< Median of latency in ms.
+    double m_p95;               ///< 95th percentile of latency in ms.
+    double m_p99;               ///< 99th percentile of latency in ms.
+    double m_max;               ///< Max. latency in ms.
+};
+
+/**
+ * @anchor OCLScheduler
+ * @brief Launches of kernels ordered by priority class and deadline.
+ *
+ * @details
+ * The most urgent class is always served first, inside class launch
+ * with the earliest deadline (then the oldest one) is selected.
+ * Selection is done again after every chunk.
+ * Kernel must use global ids including offset, it is not shared
+ * with other launches until its future is ready.
+*/
+class OCLScheduler
+{
+public:
+    /**
+     * @brief Scheduler with its own queue in default context.
+     * @param t_chunk_items Approx. number of work-items in chunk, 0 disables splitting.
+     * @param t_fifo Launches in order of submission, classes and deadlines are only
+     *               used in statistics. It is reference for comparison.
+    */
+    explicit OCLScheduler( size_t t_chunk_items = 1 << 18, bool t_fifo = false );
+
+    /**
+     * @brief All launches are done, thread is joined.
+    */
+    ~OCLScheduler();
+
+    OCLScheduler( const OCLScheduler & ) = delete;
+    OCLScheduler &operator=( const OCLScheduler & ) = delete;
+
+    /**
+     * @brief Launch of kernel with arguments already set.
+     * @param t_kernel Kernel with arguments and SVM pointers.
+     * @param t_global Global range, 1D or 2D.
+     * @param t_local Work-group size.
+     * @param t_priority Class from @ref OCLPriority.
+     * @param t_deadline_ms Deadline from now in ms, 0 without deadline.
+     * @return Future with result of launch.
+    */
+    std::future< cl_int > submit( const cl::Kernel &t_kernel, const cl::NDRange &t_global, const cl::NDRange &t_local,
+                                  int t_priority = OCL_PRIO_NORMAL, double t_deadline_ms = 0 );
+
+    /**
+     * @brief Statistics of priority class.
+    */
+    OCLSchedStats stats( int t_priority );
+
+    /**
+     * @brief All statistics are cleared.
+    */
+    void reset_stats();
+
+    /// Number of enqueued chunks.
+    size_t chunks() const { return m_chunks; }
+
+protected:
+    /// @cond
+    using Clock = std::chrono::steady_clock;
+
+    struct Job
+    {
+        cl::Kernel m_kernel;
+        cl::NDRange m_global;
+        cl::NDRange m_local;
+        size_t m_next;                      // the first not launched row (1D: item)
+        Clock::time_point m_submit;
+        Clock::time_point m_deadline;
+        unsigned long m_seq;
+        std::promise< cl_int > m_promise;
+    };
+
+    size_t m_chunk_items;
+    bool m_fifo;
+    cl::CommandQueue m_queue;
+    std::vector< std::unique_ptr< Job > > m_ready[ OCL_PRIO_COUNT ];
+    std::vector< double > m_latency[ OCL_PRIO_COUNT ];
+    size_t m_missed[ OCL_PRIO_COUNT ];
+    unsigned long m_seq;
+    std::atomic< size_t > m_chunks;
+    bool m_stop;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::thread m_thread;
+
+    void run();
+    Job *select( int &t_priority );
+    cl_int launch_chunk( Job &t_job );
+    /// @endcond
+};
+
+#endif // __OCL_SCHED_H
@@ -0,0 +1,357 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Image pipeline from demo ocl_5 declared as graph.
+ * Chessboard and dots are independent, they are created on more queues
+ * at the same time, insertion waits for them only by events.
+ * Buffer of intermediate dot is reused by the next dot.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <unistd.h>
+#include <iostream>
+#include <iomanip>
+#include <math.h>
+#include <chrono>
+
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/core_c.h>
+#include <opencv2/core/mat.hpp>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_svm_mat_allocator.h"
+#include "ocl_graph.h"
+
+#define KERNEL_SPV      "kernel_17.spv"
+#define KERNEL_PREFIX   "gpu_"
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Kernel for creating chessboard in t_node.m_out[ 0 ].
+// Kernel header from kernel*.cl:
+// __kernel void create_chessboard(          __global OCLImage *t_ocl_img,
+//                                                    int t_sq_size )
+cl_int gpu_create_chessboard( cl::Program &t_program, OCLGraphNode &t_node,
+                                                      int t_sq_size )
+{
+    cl_int l_err;
+    OCLImage *t_ocl_img = t_node.m_out[ 0 ];
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_create_chessboard( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_create_chessboard.setArg( 0, t_ocl_img );                    CL_ERR_R( l_err );
+    l_err = l_kern_create_chessboard.setArg( 1, t_sq_size );                    CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_create_chessboard.setSVMPointers( {
+            t_ocl_img,
+            t_ocl_img->m_data,
+            } );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution after dependencies, without waiting
+    l_err = t_node.m_queue.enqueueNDRangeKernel( l_kern_create_chessboard,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ),
+            &t_node.m_wait, &t_node.m_event );                                  CL_ERR_R( l_err );
+
+    return CL_SUCCESS;
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Kernel for creating dot image with alpha channel in t_node.m_out[ 0 ].
+// Kernel header from kernel*.cl:
+// __kernel void create_transparent_dot(          __global OCLImage *t_ocl_img,
+//                                                         uchar4 t_color )
+cl_int gpu_create_transparent_dot( cl::Program &t_program, OCLGraphNode &t_node,
+                                                           cl_uchar4 t_color )
+{
+    cl_int l_err;
+    OCLImage *t_ocl_img = t_node.m_out[ 0 ];
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_transparent_dot( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_transparent_dot.setArg( 0, t_ocl_img );                      CL_ERR_R( l_err );
+    l_err = l_kern_transparent_dot.setArg( 1, t_color );                        CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_transparent_dot.setSVMPointers( {
+            t_ocl_img,
+            t_ocl_img->m_data,
+            } );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution after dependencies, without waiting
+    l_err = t_node.m_queue.enqueueNDRangeKernel( l_kern_transparent_dot,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ),
+            &t_node.m_wait, &t_node.m_event );                                  CL_ERR_R( l_err );
+
+    return CL_SUCCESS;
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Kernel for inserting image t_node.m_in[ 0 ] into image t_node.m_out[ 0 ].
+// Kernel header from kernel*.cl:
+// __kernel void insert_image(               __global OCLImage *t_ocl_big_img,
+//                                           __global OCLImage *t_ocl_small_img,
+//                                           int2 t_position )
+cl_int gpu_insert_image( cl::Program &t_program, OCLGraphNode &t_node,
+                                                 cl_int2 t_position )
+{
+    cl_int l_err;
+    OCLImage *t_ocl_big_img = t_node.m_out[ 0 ];
+    OCLImage *t_ocl_small_img = t_node.m_in[ 0 ];
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_insert_image( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_insert_image.setArg( 0, t_ocl_big_img );                     CL_ERR_R( l_err );
+    l_err = l_kern_insert_image.setArg( 1, t_ocl_small_img );                   CL_ERR_R( l_err );
+    l_err = l_kern_insert_image.setArg( 2, t_position );                        CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_insert_image.setSVMPointers( {
+            t_ocl_big_img,
+            t_ocl_big_img->m_data,
+            t_ocl_small_img,
+            t_ocl_small_img->m_data,
+            } );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_small_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_small_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution after dependencies, without waiting
+    l_err = t_node.m_queue.enqueueNDRangeKernel( l_kern_insert_image,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ),
+            &t_node.m_wait, &t_node.m_event );                                  CL_ERR_R( l_err );
+
+    return CL_SUCCESS;
+}
+
+// **************************************************************************
+#define IMG_SIZEX   876
+#define IMG_SIZEY   765
+
+#define DOT_SIZE    300
+
+int main( int t_narg, char **t_args )
+{
+    int l_queues = 2;
+    int l_runs = 100;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "q:n:" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 'q': l_queues = std::max( 1, atoi( optarg ) ); break;
+        case 'n': l_runs = std::max( 1, atoi( optarg ) ); break;
+        default:
+            std::cerr << "Usage: " << t_args[ 0 ] << " [-q queues] [-n runs] [transparent_image]" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    cl_int l_err;
+
+    l_err = ocl_init( 1 );                                                      CL_ERR_E( l_err );
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "Program loaded.\n" << std::endl;
+
+    // creating SVM allocator for cv::Mat
+    SVMMatAllocator svmallocator;
+    cv::Mat::setDefaultAllocator( &svmallocator );
+
+    // creating empty image
+    cv::Mat l_cv_background_img( IMG_SIZEY, IMG_SIZEX, CV_8UC4 );
+
+    // Background OCLImage for kernel
+    OCLImage *l_ocl_background_img = ocl_svm_malloc< OCLImage >();
+    l_ocl_background_img->m_size.x = l_cv_background_img.size().width;
+    l_ocl_background_img->m_size.y = l_cv_background_img.size().height;
+    l_ocl_background_img->m_data = l_cv_background_img.data;
+
+    // creating cv::Mat for transparent dot, it is shown, so it is not intermediate
+    cv::Mat l_ocl_transp_dot( DOT_SIZE, DOT_SIZE, CV_8UC4 );
+    OCLImage *l_ocl_dot_img = ocl_svm_malloc< OCLImage >();
+    l_ocl_dot_img->m_size.x = l_ocl_transp_dot.size().width;
+    l_ocl_dot_img->m_size.y = l_ocl_transp_dot.size().height;
+    l_ocl_dot_img->m_data = l_ocl_transp_dot.data;
+
+    // loaded transparent image
+    cv::Mat l_cv_load_img;
+    OCLImage *l_ocl_load_img = nullptr;
+    if ( optind < t_narg )
+    {
+        std::cout << "Opening image: '" << t_args[ optind ] << "'." << std::endl;
+
+        l_cv_load_img = cv::imread( t_args[ optind ], cv::IMREAD_UNCHANGED );
+
+        if ( !l_cv_load_img.empty() && l_cv_load_img.channels() == 4 )
+        {
+            std::cout << "Image loaded." << std::endl;
+
+            l_ocl_load_img = ocl_svm_malloc< OCLImage >();
+            l_ocl_load_img->m_size.x = l_cv_load_img.size().width;
+            l_ocl_load_img->m_size.y = l_cv_load_img.size().height;
+            l_ocl_load_img->m_data = l_cv_load_img.data;
+        }
+        else if ( l_cv_load_img.channels() != 4 )
+        {
+            std::cout << "Image is not transparent!" << std::endl;
+        }
+        else
+        {
+            std::cout << "Unable to read image!" << std::endl;
+        }
+    }
+
+    // declaration of pipeline, nothing runs yet
+    OCLGraph l_graph( l_queues );
+
+    int l_background = l_graph.image( l_ocl_background_img );
+    int l_red_dot = l_graph.image( l_ocl_dot_img );
+    int l_green_dot = l_graph.image( DOT_SIZE, DOT_SIZE, 4 );
+    int l_blue_dot = l_graph.image( DOT_SIZE, DOT_SIZE, 4 );
+
+    l_graph.add( "chessboard", [ & ] ( OCLGraphNode &t_node ) { return gpu_create_chessboard( l_program, t_node, 3 ); },
+                 {}, { l_background } );
+    l_graph.add( "red dot", [ & ] ( OCLGraphNode &t_node ) { return gpu_create_transparent_dot( l_program, t_node, {{ 0, 0, 255, 0 }} ); },
+                 {}, { l_red_dot } );
+    l_graph.add( "insert red", [ & ] ( OCLGraphNode &t_node ) { return gpu_insert_image( l_program, t_node, {{ 100, 50 }} ); },
+                 { l_red_dot }, { l_background } );
+    l_graph.add( "green dot", [ & ] ( OCLGraphNode &t_node ) { return gpu_create_transparent_dot( l_program, t_node, {{ 0, 255, 0, 0 }} ); },
+                 {}, { l_green_dot } );
+    l_graph.add( "insert green", [ & ] ( OCLGraphNode &t_node ) { return gpu_insert_image( l_program, t_node, {{ 450, 350 }} ); },
+                 { l_green_dot }, { l_background } );
+    l_graph.add( "blue dot", [ & ] ( OCLGraphNode &t_node ) { return gpu_create_transparent_dot( l_program, t_node, {{ 255, 0, 0, 0 }} ); },
+                 {}, { l_blue_dot } );
+    l_graph.add( "insert blue", [ & ] ( OCLGraphNode &t_node ) { return gpu_insert_image( l_program, t_node, {{ 500, 50 }} ); },
+                 { l_blue_dot }, { l_background } );
+    if ( l_ocl_load_img )
+    {
+        int l_loaded = l_graph.image( l_ocl_load_img );
+        l_graph.add( "insert loaded", [ & ] ( OCLGraphNode &t_node ) { return gpu_insert_image( l_program, t_node, {{ IMG_SIZEX / 2, IMG_SIZEY / 2 }} ); },
+                     { l_loaded }, { l_background } );
+    }
+
+    std::cout << "Graph on " << l_queues << " queues:" << std::endl;
+    l_graph.print( std::cout );
+    std::cout << "Intermediate buffers: " << l_graph.buffers() << " (" << l_graph.buffer_bytes() << " bytes), reused "
+              << l_graph.reuses() << " times." << std::endl;
+
+    // the first run shows result, then average time is measured
+    l_err = l_graph.run();                                                      CL_ERR_E( l_err );
+
+    auto l_start = std::chrono::steady_clock::now();
+    for ( int i = 0; i < l_runs; i++ )
+    {
+        l_graph.run();
+    }
+    double l_ms = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - l_start ).count();
+
+    std::cout << std::fixed << std::setprecision( 3 ) << "Average time of graph: " << l_ms / l_runs << " ms." << std::endl;
+
+    // show dot
+    cv::imshow( "Dot", l_ocl_transp_dot );
+    // show chessboard with dots
+    cv::imshow( "Chessboard with Dots", l_cv_background_img );
+
+    // wait for key
+    cv::waitKey( 0 );
+
+    ocl_svm_free( l_ocl_background_img );
+    ocl_svm_free( l_ocl_dot_img );
+    if ( l_ocl_load_img ) ocl_svm_free( l_ocl_load_img );
+}
@@ -0,0 +1,310 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Point-wise operations fused into one kernel.
+ * Color rotation and conversion to gray are launched as two kernels
+ * and then written as one expression, which is evaluated by one
+ * generated kernel. Both results must be the same.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <unistd.h>
+#include <iostream>
+#include <math.h>
+#include <chrono>
+
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/core_c.h>
+#include <opencv2/core/mat.hpp>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_svm_mat_allocator.h"
+#include "ocl_expr.h"
+
+#define KERNEL_SPV      "kernel_18.spv"
+#define KERNEL_PREFIX   "gpu_"
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// BGR colors rotation.
+// Kernel header from kernel*.cl:
+//__kernel void rotate_bgr(            __global OCLImage *t_ocl_img )
+cl_int gpu_rotate_bgr( cl::Program &t_program, OCLImage *t_ocl_img )
+{
+    cl_int l_err;
+
+    // kernel is selected only once
+    static cl::Kernel l_kern_rotate_bgr;
+    if ( l_kern_rotate_bgr() == nullptr )
+    {
+        // removing prefix gpu_
+        std::string l_kern_name( __FUNCTION__ );
+        if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+        {
+            l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+        }
+
+        // select the kernel from opencl program
+        l_kern_rotate_bgr = cl::Kernel( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+    }
+
+    // set kernel arguments
+    l_err = l_kern_rotate_bgr.setArg( 0, t_ocl_img );                           CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_rotate_bgr.setSVMPointers( { t_ocl_img, t_ocl_img->m_data } );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_rotate_bgr,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    // waiting for completion
+    return defQueue.finish();
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Kernel for BGR to BW conversion
+// Kernel header from kernel*.cl:
+// __kernel void convert_bgr_to_bw(          __global OCLImage *t_ocl_bgr_img,
+//                                           __global OCLImage *t_ocl_bw_img )
+cl_int gpu_convert_bgr_to_bw( cl::Program &t_program, OCLImage *t_ocl_bgr_img,
+                                                      OCLImage *t_ocl_bw_img )
+{
+    cl_int l_err;
+
+    // kernel is selected only once
+    static cl::Kernel l_kern_convert_bgr_to_bw;
+    if ( l_kern_convert_bgr_to_bw() == nullptr )
+    {
+        // removing prefix gpu_
+        std::string l_kern_name( __FUNCTION__ );
+        if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+        {
+            l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+        }
+
+        // select the kernel from opencl program
+        l_kern_convert_bgr_to_bw = cl::Kernel( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+    }
+
+    // set kernel arguments
+    l_err = l_kern_convert_bgr_to_bw.setArg( 0, t_ocl_bgr_img );                CL_ERR_R( l_err );
+    l_err = l_kern_convert_bgr_to_bw.setArg( 1, t_ocl_bw_img );                 CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_convert_bgr_to_bw.setSVMPointers( {
+            t_ocl_bgr_img,
+            t_ocl_bgr_img->m_data,
+            t_ocl_bw_img,
+            t_ocl_bw_img->m_data,
+            } );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_bgr_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_bgr_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_convert_bgr_to_bw,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    // waiting for completion
+    return defQueue.finish();
+}
+
+// **************************************************************************
+// descriptor in SVM for data of cv::Mat
+OCLImage *svm_image( cv::Mat &t_cv_img )
+{
+    OCLImage *l_ocl_img = ocl_svm_malloc< OCLImage >();
+    if ( l_ocl_img == nullptr )
+    {
+        std::cerr << "Unable to allocate image descriptor!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+    l_ocl_img->m_size.x = t_cv_img.size().width;
+    l_ocl_img->m_size.y = t_cv_img.size().height;
+    l_ocl_img->m_data = t_cv_img.data;
+    return l_ocl_img;
+}
+
+// **************************************************************************
+#define IMG_SIZEX   1920
+#define IMG_SIZEY   1080
+
+int main( int t_narg, char **t_args )
+{
+    int l_width = IMG_SIZEX;
+    int l_height = IMG_SIZEY;
+    int l_runs = 20;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "s:n:" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 's': sscanf( optarg, "%dx%d", &l_width, &l_height ); break;
+        case 'n': l_runs = std::max( 1, atoi( optarg ) ); break;
+        default:
+            std::cerr << "Usage: " << t_args[ 0 ] << " [-s WxH] [-n runs] [image]" << std::endl;
+            std::cerr << "  -s  size of synthetic image, when no image is given" << std::endl;
+            std::cerr << "  -n  number of runs of unfused and fused version" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    cl_int l_err;
+
+    l_err = ocl_init( 1 );                                                      CL_ERR_E( l_err );
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "Program loaded.\n" << std::endl;
+
+    // creating SVM allocator for cv::Mat
+    SVMMatAllocator svmallocator;
+    cv::Mat::setDefaultAllocator( &svmallocator );
+
+    // image loaded from file or synthetic image
+    cv::Mat l_cv_src_img;
+    if ( optind < t_narg )
+    {
+        l_cv_src_img = cv::imread( t_args[ optind ], cv::IMREAD_COLOR );
+        if ( l_cv_src_img.empty() )
+        {
+            std::cerr << "Unable to open image '" << t_args[ optind ] << "'." << std::endl;
+            exit( EXIT_FAILURE );
+        }
+        cv::cvtColor( l_cv_src_img, l_cv_src_img, cv::COLOR_BGR2BGRA );
+    }
+    else
+    {
+        l_cv_src_img.create( std::max( 1, l_height ), std::max( 1, l_width ), CV_8UC4 );
+        cv::randu( l_cv_src_img, cv::Scalar::all( 0 ), cv::Scalar::all( 255 ) );
+    }
+
+    // rotation in place needs copy of source for unfused version
+    cv::Mat l_cv_tmp_img( l_cv_src_img.size(), CV_8UC4 );
+    cv::Mat l_cv_bw_img( l_cv_src_img.size(), CV_8UC1 );
+    cv::Mat l_cv_fused_img( l_cv_src_img.size(), CV_8UC1 );
+    cv::Mat l_cv_effect_img( l_cv_src_img.size(), CV_8UC4 );
+
+    OCLImage *l_ocl_src_img = svm_image( l_cv_src_img );
+    OCLImage *l_ocl_tmp_img = svm_image( l_cv_tmp_img );
+    OCLImage *l_ocl_bw_img = svm_image( l_cv_bw_img );
+    OCLImage *l_ocl_fused_img = svm_image( l_cv_fused_img );
+    OCLImage *l_ocl_effect_img = svm_image( l_cv_effect_img );
+
+    std::cout << "Image " << l_cv_src_img.cols << "x" << l_cv_src_img.rows << ", " << l_runs << " runs." << std::endl;
+
+    // two kernels: rotation reads and writes 4 bytes, conversion reads 4 and writes 1 byte
+    double l_unfused_ms = 0;
+    for ( int r = 0; r < l_runs; r++ )
+    {
+        l_cv_src_img.copyTo( l_cv_tmp_img );
+
+        auto l_start = std::chrono::steady_clock::now();
+        l_err = gpu_rotate_bgr( l_program, l_ocl_tmp_img );                      CL_ERR_E( l_err );
+        l_err = gpu_convert_bgr_to_bw( l_program, l_ocl_tmp_img, l_ocl_bw_img );  CL_ERR_E( l_err );
+        l_unfused_ms += std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - l_start ).count();
+    }
+
+    // one generated kernel: 4 bytes read and 1 byte written
+    OCLExprImage l_src( l_ocl_src_img, 4 );
+    OCLExprImage l_fused( l_ocl_fused_img, 1 );
+    double l_fused_ms = 0;
+    for ( int r = 0; r < l_runs; r++ )
+    {
+        auto l_start = std::chrono::steady_clock::now();
+        l_fused = to_gray( rotate_bgr( l_src ) );
+        l_err = l_fused.error();                                                CL_ERR_E( l_err );
+        l_fused_ms += std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - l_start ).count();
+    }
+
+    // longer expression with scalar parameter, every factor uses the same program
+    OCLExprImage l_effect( l_ocl_effect_img, 4 );
+    for ( float l_factor : { 0.5f, 1.0f, 1.5f } )
+    {
+        l_effect = invert( scale( rotate_bgr( l_src ), l_factor ) );
+        l_err = l_effect.error();                                               CL_ERR_E( l_err );
+    }
+
+    // fused version must give the same result
+    double l_diff = cv::norm( l_cv_bw_img, l_cv_fused_img, cv::NORM_INF );
+    std::cout << "\nMax. difference between unfused and fused: " << l_diff << std::endl;
+
+    double l_pixels = ( double ) l_cv_src_img.total();
+    std::cout << "Unfused (2 kernels): " << l_unfused_ms / l_runs << " ms, traffic "
+              << l_pixels * 13 / ( 1 << 20 ) << " MB" << std::endl;
+    std::cout << "Fused (1 kernel):    " << l_fused_ms / l_runs << " ms, traffic "
+              << l_pixels * 5 / ( 1 << 20 ) << " MB" << std::endl;
+
+    size_t l_hits, l_builds;
+    ocl_expr_cache_stats( l_hits, l_builds );
+    std::cout << "Generated programs: " << l_builds << ", taken from cache: " << l_hits << std::endl;
+
+    ocl_svm_free( l_ocl_src_img );
+    ocl_svm_free( l_ocl_tmp_img );
+    ocl_svm_free( l_ocl_bw_img );
+    ocl_svm_free( l_ocl_fused_img );
+    ocl_svm_free( l_ocl_effect_img );
+
+    cv::imshow( "Unfused", l_cv_bw_img );
+    cv::imshow( "Fused", l_cv_fused_img );
+    cv::imshow( "Effect", l_cv_effect_img );
+    cv::waitKey( 0 );
+}
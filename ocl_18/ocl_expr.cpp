@@ -0,0 +1,182 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_expr.cpp
+ * @brief Lazy point-wise image expressions fused into one kernel.
+ *
+ * @details
+ * Source file for evaluation of expressions from @ref OCLExprImage
+ * and for cache of generated programs.
+ *
+ ***************************************************************************/
+
+#include <map>
+#include <mutex>
+#include <iostream>
+
+#include "ocl_utils.h"
+#include "ocl_expr.h"
+
+// generated programs by signature
+static std::mutex s_mutex;
+static std::map< std::string, cl::Program > s_cache;
+static size_t s_hits = 0;
+static size_t s_builds = 0;
+
+// source of kernel from generated statements
+static std::string ocl_expr_source( OCLExprContext &t_gen, int t_channels )
+{
+    // the same layout as OCLImage in ocl_image.h, but in OpenCL C
+    std::string l_src =
+        "typedef struct { uint4 m_size; __global void *m_data; } OCLImage;\n"
+        "\n"
+        "__kernel void fused( __global OCLImage *t_dst";
+    for ( size_t i = 0; i < t_gen.m_images.size(); i++ )
+    {
+        l_src += ", __global OCLImage *t_src" + std::to_string( i );
+    }
+    for ( size_t i = 0; i < t_gen.m_floats.size(); i++ )
+    {
+        l_src += ", float t_param" + std::to_string( i );
+    }
+    l_src += " )\n{\n"
+             "    int l_x = get_global_id( 0 );\n"
+             "    int l_y = get_global_id( 1 );\n"
+             "    if ( l_x >= t_dst->m_size.x || l_y >= t_dst->m_size.y ) return;\n\n";
+    l_src += t_gen.m_code;
+
+    // only the result is written into global memory
+    std::string l_type = OCLExprContext::type( t_channels );
+    l_src += "\n    ( ( __global " + l_type + " * ) t_dst->m_data )[ l_y * t_dst->m_size.x + l_x ] = l_v"
+           + std::to_string( t_gen.m_vars - 1 ) + ";\n}\n";
+
+    return l_src;
+}
+
+// build of generated source for default device
+static cl::Program ocl_expr_build( const std::string &t_source )
+{
+    cl_int l_err;
+
+    // pointer in structure in global memory needs OpenCL C 2.0 or newer
+    std::string l_version = cl::Device::getDefault().getInfo< CL_DEVICE_VERSION >();
+    const char *l_options = l_version.find( "OpenCL 3" ) == 0 ? "-cl-std=CL3.0" : "-cl-std=CL2.0";
+
+    cl::Program l_program( cl::Context::getDefault(), t_source, false, &l_err );  CL_ERR_C( l_err );
+    if ( l_err == CL_SUCCESS )
+    {
+        l_err = l_program.build( l_options );                                   CL_ERR_C( l_err );
+    }
+
+    if ( l_err != CL_SUCCESS )
+    {
+        std::cerr << "Build of generated kernel failed!\n" << t_source << std::endl;
+        auto out = l_program.getBuildInfo< CL_PROGRAM_BUILD_LOG >( &l_err );
+        for ( auto &pair : out )
+        {
+            std::cerr << pair.second << std::endl << std::endl;
+        }
+        return cl::Program();
+    }
+
+    return l_program;
+}
+
+// @copydoc ocl_expr_eval
+cl_int ocl_expr_eval( OCLImage *t_dst, int t_channels, OCLExprContext &t_ctx,
+                      const std::function< void( OCLExprContext & ) > &t_generate )
+{
+    cl_int l_err;
+
+    if ( t_ctx.m_error != CL_SUCCESS ) return t_ctx.m_error;
+
+    // point-wise operations need images of the same size
+    for ( OCLImage *l_img : t_ctx.m_images )
+    {
+        if ( l_img->m_size.x != t_dst->m_size.x || l_img->m_size.y != t_dst->m_size.y ) return CL_INVALID_IMAGE_SIZE;
+    }
+
+    // program from cache or generated now
+    std::string l_key = t_ctx.m_signature + "->" + OCLExprContext::type( t_channels );
+    cl::Program l_program;
+    {
+        std::lock_guard< std::mutex > l_lock( s_mutex );
+        auto l_found = s_cache.find( l_key );
+        if ( l_found != s_cache.end() )
+        {
+            l_program = l_found->second;
+            s_hits++;
+        }
+        else
+        {
+            OCLExprContext l_gen;
+            l_gen.m_generate = true;
+            t_generate( l_gen );
+            l_program = ocl_expr_build( ocl_expr_source( l_gen, t_channels ) );
+            if ( l_program() == nullptr ) return CL_BUILD_PROGRAM_FAILURE;
+            s_cache[ l_key ] = l_program;
+            s_builds++;
+        }
+    }
+
+    cl::Kernel l_kern_fused( l_program, "fused", &l_err );                      CL_ERR_R( l_err );
+
+    // set kernel arguments in order of traversal
+    std::vector< void * > l_svm_ptrs = { t_dst, t_dst->m_data };
+    cl_uint l_arg = 0;
+    l_err = l_kern_fused.setArg( l_arg++, t_dst );                              CL_ERR_R( l_err );
+    for ( OCLImage *l_img : t_ctx.m_images )
+    {
+        l_err = l_kern_fused.setArg( l_arg++, l_img );                          CL_ERR_R( l_err );
+        l_svm_ptrs.push_back( l_img );
+        l_svm_ptrs.push_back( l_img->m_data );
+    }
+    for ( float l_param : t_ctx.m_floats )
+    {
+        l_err = l_kern_fused.setArg( l_arg++, l_param );                        CL_ERR_R( l_err );
+    }
+
+    // list of SVM pointers for data synchronization
+    l_kern_fused.setSVMPointers( l_svm_ptrs );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_dst->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_dst->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_fused,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    // waiting for completion
+    return defQueue.finish();
+}
+
+// @copydoc ocl_expr_cache_stats
+void ocl_expr_cache_stats( size_t &t_hits, size_t &t_builds )
+{
+    std::lock_guard< std::mutex > l_lock( s_mutex );
+    t_hits = s_hits;
+    t_builds = s_builds;
+}
@@ -0,0 +1,284 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_expr.h
+ * @brief Lazy point-wise image expressions fused into one kernel.
+ *
+ * @details
+ * Header file for class @ref OCLExprImage and point-wise operations
+ * @ref rotate_bgr, @ref to_gray, @ref invert and @ref scale.
+ *
+ * Every kernel of point-wise operation reads whole image from global
+ * memory and writes it back. Chain of kernels, e.g. rotation and
+ * conversion to gray, costs more passes and more launches.
+ * Expression `l_bw = to_gray( rotate_bgr( l_img ) )` only builds tree
+ * of templates, nothing is computed. Assignment into @ref OCLExprImage
+ * generates one OpenCL C kernel for the whole tree, so every pixel
+ * is read once and written once.
+ *
+ * Generated programs are cached by signature of expression, e.g.
+ * `gray(rotate(img4))`. Scalar parameters are kernel arguments,
+ * so they are not part of signature.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_EXPR_H
+#define __OCL_EXPR_H
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_image.h"
+
+/**
+ * @brief State of expression traversal: signature, arguments and generated code.
+*/
+struct OCLExprContext
+{
+    bool m_generate = false;                ///< Code is generated only for new signature.
+    std::string m_signature;                ///< Structure of expression.
+    std::string m_code;                     ///< Statements of generated kernel.
+    std::vector< OCLImage * > m_images;     ///< Input images, kernel arguments.
+    std::vector< float > m_floats;          ///< Scalar parameters, kernel arguments.
+    int m_vars = 0;                         ///< Counter of temporary variables.
+    cl_int m_error = CL_SUCCESS;            ///< Invalid expression.
+
+    /// New temporary variable.
+    std::string var() { return "l_v" + std::to_string( m_vars++ ); }
+
+    /// OpenCL type of pixel.
+    static const char *type( int t_channels ) { return t_channels == 4 ? "uchar4" : "uchar"; }
+};
+
+/**
+ * @brief Base of all expressions (CRTP).
+*/
+template< typename T_Expr >
+struct OCLExpr
+{
+    /// Derived expression.
+    const T_Expr &self() const { return static_cast< const T_Expr & >( *this ); }
+};
+
+/**
+ * @brief Evaluation of expression into image, program is taken from cache or built.
+ * @param t_dst Destination image, it can be also input of expression.
+ * @param t_channels Channels of destination image.
+ * @param t_ctx Context after traversal without code generation.
+ * @param t_generate Traversal with code generation, called only for new signature.
+ * @return CL_SUCCESS or error code.
+*/
+cl_int ocl_expr_eval( OCLImage *t_dst, int t_channels, OCLExprContext &t_ctx,
+                      const std::function< void( OCLExprContext & ) > &t_generate );
+
+/**
+ * @brief Statistics of program cache.
+ * @param t_hits Evaluations with program from cache.
+ * @param t_builds Built programs.
+*/
+void ocl_expr_cache_stats( size_t &t_hits, size_t &t_builds );
+
+/**
+ * @anchor OCLExprImage
+ * @brief Image as leaf of expression and as destination of evaluation.
+*/
+class OCLExprImage : public OCLExpr< OCLExprImage >
+{
+public:
+    /**
+     * @brief Image with data in SVM.
+     * @param t_ocl_img Descriptor in SVM.
+     * @param t_channels Channels of image, 4 (BGRA) or 1 (gray).
+    */
+    OCLExprImage( OCLImage *t_ocl_img, int t_channels ) : m_ocl_img( t_ocl_img ), m_channels( t_channels ) {}
+
+    /**
+     * @brief Evaluation of expression by one fused kernel.
+    */
+    template< typename T_Expr >
+    OCLExprImage &operator=( const OCLExpr< T_Expr > &t_expr )
+    {
+        OCLExprContext l_ctx;
+        t_expr.self().emit( l_ctx );
+        if ( l_ctx.m_error == CL_SUCCESS && t_expr.self().channels() != m_channels )
+        {
+            l_ctx.m_error = CL_INVALID_VALUE;
+        }
+        m_error = ocl_expr_eval( m_ocl_img, m_channels, l_ctx,
+                                 [ &t_expr ] ( OCLExprContext &t_gen ) { t_expr.self().emit( t_gen ); } );
+        return *this;
+    }
+
+    /// Result of the last evaluation.
+    cl_int error() const { return m_error; }
+
+    /// @cond
+    int channels() const { return m_channels; }
+
+    std::string emit( OCLExprContext &t_ctx ) const
+    {
+        int l_index = t_ctx.m_images.size();
+        t_ctx.m_images.push_back( m_ocl_img );
+        t_ctx.m_signature += m_channels == 4 ? "img4" : "img1";
+        if ( !t_ctx.m_generate ) return "";
+
+        std::string l_var = t_ctx.var();
+        std::string l_src = "t_src" + std::to_string( l_index );
+        t_ctx.m_code += std::string( "    " ) + OCLExprContext::type( m_channels ) + " " + l_var + " = ( ( __global "
+                      + OCLExprContext::type( m_channels ) + " * ) " + l_src + "->m_data )[ l_y * " + l_src + "->m_size.x + l_x ];\n";
+        return l_var;
+    }
+    /// @endcond
+
+protected:
+    /// @cond
+    OCLImage *m_ocl_img;
+    int m_channels;
+    cl_int m_error = CL_SUCCESS;
+    /// @endcond
+};
+
+/// @cond
+// Unary point-wise operation, T_Op gives its name, channels and code.
+template< typename T_Op, typename T_Arg >
+struct OCLExprUnary : public OCLExpr< OCLExprUnary< T_Op, T_Arg > >
+{
+    T_Arg m_arg;
+    float m_param;
+
+    OCLExprUnary( const T_Arg &t_arg, float t_param = 0 ) : m_arg( t_arg ), m_param( t_param ) {}
+
+    int channels() const { return T_Op::channels( m_arg.channels() ); }
+
+    std::string emit( OCLExprContext &t_ctx ) const
+    {
+        t_ctx.m_signature += std::string( T_Op::name() ) + "(";
+        std::string l_arg = m_arg.emit( t_ctx );
+        std::string l_param;
+        if ( T_Op::has_param() )
+        {
+            l_param = "t_param" + std::to_string( t_ctx.m_floats.size() );
+            t_ctx.m_floats.push_back( m_param );
+            t_ctx.m_signature += ",f";
+        }
+        t_ctx.m_signature += ")";
+
+        if ( !T_Op::valid( m_arg.channels() ) ) t_ctx.m_error = CL_INVALID_VALUE;
+        if ( !t_ctx.m_generate ) return "";
+
+        std::string l_var = t_ctx.var();
+        t_ctx.m_code += std::string( "    " ) + OCLExprContext::type( channels() ) + " " + l_var + " = "
+                      + T_Op::code( l_arg, l_param, m_arg.channels() ) + ";\n";
+        return l_var;
+    }
+};
+
+struct OCLOpRotateBGR
+{
+    static const char *name() { return "rotate"; }
+    static bool has_param() { return false; }
+    static bool valid( int t_channels ) { return t_channels == 4; }
+    static int channels( int ) { return 4; }
+    static std::string code( const std::string &t_a, const std::string &, int )
+    {
+        return "( uchar4 )( " + t_a + ".y, " + t_a + ".z, " + t_a + ".x, " + t_a + ".w )";
+    }
+};
+
+struct OCLOpToGray
+{
+    static const char *name() { return "gray"; }
+    static bool has_param() { return false; }
+    static bool valid( int t_channels ) { return t_channels == 4; }
+    static int channels( int ) { return 1; }
+    static std::string code( const std::string &t_a, const std::string &, int )
+    {
+        // the same integer arithmetic as kernel convert_bgr_to_bw
+        return "( uchar )( " + t_a + ".x * 11 / 100 + " + t_a + ".y * 59 / 100 + " + t_a + ".z * 30 / 100 )";
+    }
+};
+
+struct OCLOpInvert
+{
+    static const char *name() { return "invert"; }
+    static bool has_param() { return false; }
+    static bool valid( int ) { return true; }
+    static int channels( int t_channels ) { return t_channels; }
+    static std::string code( const std::string &t_a, const std::string &, int t_channels )
+    {
+        // alpha channel is kept
+        if ( t_channels == 1 ) return "( uchar )( 255 - " + t_a + " )";
+        return "( uchar4 )( 255 - " + t_a + ".x, 255 - " + t_a + ".y, 255 - " + t_a + ".z, " + t_a + ".w )";
+    }
+};
+
+struct OCLOpScale
+{
+    static const char *name() { return "scale"; }
+    static bool has_param() { return true; }
+    static bool valid( int ) { return true; }
+    static int channels( int t_channels ) { return t_channels; }
+    static std::string code( const std::string &t_a, const std::string &t_p, int t_channels )
+    {
+        // alpha channel is kept
+        if ( t_channels == 1 ) return "convert_uchar_sat( " + t_a + " * " + t_p + " )";
+        return "( uchar4 )( convert_uchar3_sat( convert_float3( " + t_a + ".xyz ) * " + t_p + " ), " + t_a + ".w )";
+    }
+};
+/// @endcond
+
+/**
+ * @anchor rotate_bgr
+ * @brief Rotation of BGR colors, alpha is kept.
+*/
+template< typename T_Arg >
+OCLExprUnary< OCLOpRotateBGR, T_Arg > rotate_bgr( const OCLExpr< T_Arg > &t_arg )
+{
+    return OCLExprUnary< OCLOpRotateBGR, T_Arg >( t_arg.self() );
+}
+
+/**
+ * @anchor to_gray
+ * @brief Conversion of BGR image to gray image.
+*/
+template< typename T_Arg >
+OCLExprUnary< OCLOpToGray, T_Arg > to_gray( const OCLExpr< T_Arg > &t_arg )
+{
+    return OCLExprUnary< OCLOpToGray, T_Arg >( t_arg.self() );
+}
+
+/**
+ * @anchor invert
+ * @brief Negative of image, alpha is kept.
+*/
+template< typename T_Arg >
+OCLExprUnary< OCLOpInvert, T_Arg > invert( const OCLExpr< T_Arg > &t_arg )
+{
+    return OCLExprUnary< OCLOpInvert, T_Arg >( t_arg.self() );
+}
+
+/**
+ * @anchor scale
+ * @brief Brightness multiplied by t_factor with saturation, alpha is kept.
+*/
+template< typename T_Arg >
+OCLExprUnary< OCLOpScale, T_Arg > scale( const OCLExpr< T_Arg > &t_arg, float t_factor )
+{
+    return OCLExprUnary< OCLOpScale, T_Arg >( t_arg.self(), t_factor );
+}
+
+#endif // __OCL_EXPR_H
@@ -0,0 +1,221 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Sequence of frames blurred by kernel.
+ * Residency of SVM buffers is left to driver, then input of the next
+ * frame is migrated to device while kernel processes current frame
+ * and result is migrated back to host after kernel.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <unistd.h>
+#include <iostream>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/core_c.h>
+#include <opencv2/core/mat.hpp>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_svm_mat_allocator.h"
+#include "ocl_prefetch.h"
+
+#define KERNEL_SPV      "kernel_19.spv"
+#define KERNEL_PREFIX   "gpu_"
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+// Kernel is launched by prefetcher after migration of its input, caller waits.
+//
+// Kernel for box blur of BGR image
+// Kernel header from kernel*.cl:
+// __kernel void blur_bgr(                   __global OCLImage *t_ocl_src_img,
+//                                           __global OCLImage *t_ocl_dst_img,
+//                                           int t_radius )
+cl_int gpu_blur_bgr( OCLPrefetcher &t_prefetcher, cl::Program &t_program, OCLImage *t_ocl_src_img, OCLImage *t_ocl_dst_img, int t_radius )
+{
+    cl_int l_err;
+
+    // kernel is selected only once
+    static cl::Kernel l_kern_blur_bgr;
+    if ( l_kern_blur_bgr() == nullptr )
+    {
+        // removing prefix gpu_
+        std::string l_kern_name( __FUNCTION__ );
+        if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+        {
+            l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+        }
+
+        // select the kernel from opencl program
+        l_kern_blur_bgr = cl::Kernel( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+    }
+
+    // set kernel arguments
+    l_err = l_kern_blur_bgr.setArg( 0, t_ocl_src_img );                         CL_ERR_R( l_err );
+    l_err = l_kern_blur_bgr.setArg( 1, t_ocl_dst_img );                         CL_ERR_R( l_err );
+    l_err = l_kern_blur_bgr.setArg( 2, t_radius );                              CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_blur_bgr.setSVMPointers( {
+            t_ocl_src_img,
+            t_ocl_src_img->m_data,
+            t_ocl_dst_img,
+            t_ocl_dst_img->m_data,
+            } );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_dst_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_dst_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // kernel waits for migrations of its input
+    return t_prefetcher.launch( l_kern_blur_bgr,
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );
+}
+
+// **************************************************************************
+// descriptor in SVM for data of cv::Mat
+OCLImage *svm_image( cv::Mat &t_cv_img )
+{
+    OCLImage *l_ocl_img = ocl_svm_malloc< OCLImage >();
+    if ( l_ocl_img == nullptr )
+    {
+        std::cerr << "Unable to allocate image descriptor!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+    l_ocl_img->m_size.x = t_cv_img.size().width;
+    l_ocl_img->m_size.y = t_cv_img.size().height;
+    l_ocl_img->m_data = t_cv_img.data;
+    return l_ocl_img;
+}
+
+// **************************************************************************
+#define IMG_SIZEX   1920
+#define IMG_SIZEY   1080
+
+int main( int t_narg, char **t_args )
+{
+    int l_width = IMG_SIZEX;
+    int l_height = IMG_SIZEY;
+    int l_frames = 8;
+    int l_radius = 2;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "s:n:r:" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 's': sscanf( optarg, "%dx%d", &l_width, &l_height ); break;
+        case 'n': l_frames = std::max( 1, atoi( optarg ) ); break;
+        case 'r': l_radius = std::max( 0, atoi( optarg ) ); break;
+        default:
+            std::cerr << "Usage: " << t_args[ 0 ] << " [-s WxH] [-n frames] [-r radius]" << std::endl;
+            std::cerr << "  -s  size of frames" << std::endl;
+            std::cerr << "  -n  number of frames, every frame has its own buffers" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    cl_int l_err;
+
+    l_err = ocl_init( 1 );                                                      CL_ERR_E( l_err );
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "Program loaded.\n" << std::endl;
+
+    // creating SVM allocator for cv::Mat
+    SVMMatAllocator svmallocator;
+    cv::Mat::setDefaultAllocator( &svmallocator );
+
+    cv::Size l_size( std::max( 1, l_width ), std::max( 1, l_height ) );
+    std::vector< cv::Mat > l_cv_src_imgs( l_frames ), l_cv_dst_imgs( l_frames );
+    std::vector< OCLImage * > l_ocl_src_imgs( l_frames ), l_ocl_dst_imgs( l_frames );
+    for ( int f = 0; f < l_frames; f++ )
+    {
+        l_cv_src_imgs[ f ].create( l_size, CV_8UC4 );
+        l_cv_dst_imgs[ f ].create( l_size, CV_8UC4 );
+        l_ocl_src_imgs[ f ] = svm_image( l_cv_src_imgs[ f ] );
+        l_ocl_dst_imgs[ f ] = svm_image( l_cv_dst_imgs[ f ] );
+    }
+
+    std::cout << "Frames " << l_frames << "x " << l_size.width << "x" << l_size.height << ", radius " << l_radius << "." << std::endl;
+
+    for ( bool l_enabled : { false, true } )
+    {
+        OCLPrefetcher l_prefetcher( l_enabled );
+
+        // frames are written by host, so their pages are on host again, data are the same in both runs
+        cv::setRNGSeed( 1 );
+        for ( int f = 0; f < l_frames; f++ )
+        {
+            cv::randu( l_cv_src_imgs[ f ], cv::Scalar::all( 0 ), cv::Scalar::all( 255 ) );
+            l_cv_dst_imgs[ f ].setTo( cv::Scalar::all( 0 ) );
+        }
+
+        auto l_start = std::chrono::steady_clock::now();
+
+        l_err = l_prefetcher.prefetch( OCLPrefetcher::ranges( l_ocl_src_imgs[ 0 ], 4 ) );  CL_ERR_E( l_err );
+        for ( int f = 0; f < l_frames; f++ )
+        {
+            l_err = gpu_blur_bgr( l_prefetcher, l_program, l_ocl_src_imgs[ f ], l_ocl_dst_imgs[ f ], l_radius );  CL_ERR_E( l_err );
+
+            // input of the next frame moves while kernel runs
+            if ( f + 1 < l_frames )
+            {
+                l_err = l_prefetcher.prefetch( OCLPrefetcher::ranges( l_ocl_src_imgs[ f + 1 ], 4 ) );  CL_ERR_E( l_err );
+            }
+            l_err = l_prefetcher.to_host( OCLPrefetcher::ranges( l_ocl_dst_imgs[ f ], 4 ) );  CL_ERR_E( l_err );
+        }
+        l_err = l_prefetcher.finish();                                          CL_ERR_E( l_err );
+
+        // host reads all results
+        double l_sum = 0;
+        for ( int f = 0; f < l_frames; f++ )
+        {
+            l_sum += cv::sum( l_cv_dst_imgs[ f ] )[ 0 ];
+        }
+
+        double l_ms = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - l_start ).count();
+
+        std::cout << "\n" << ( l_prefetcher.enabled() ? "Prefetch and migration to host:" : "Residency left to driver:" )
+                  << " " << l_ms / l_frames << " ms per frame (checksum " << ( long ) l_sum << ")" << std::endl;
+        l_prefetcher.report( std::cout );
+    }
+
+    for ( int f = 0; f < l_frames; f++ )
+    {
+        ocl_svm_free( l_ocl_src_imgs[ f ] );
+        ocl_svm_free( l_ocl_dst_imgs[ f ] );
+    }
+}
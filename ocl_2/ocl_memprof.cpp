@@ -0,0 +1,294 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_memprof.cpp
+ * @brief Profiler of SVM allocations with call sites, leaks and growth.
+ *
+ * @details
+ * Source file for functions @ref ocl_memprof_report and @ref ocl_memprof_checkpoint.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+
+#include <execinfo.h>
+#include <cxxabi.h>
+
+#include "ocl_utils.h"
+#include "ocl_memprof.h"
+
+// frames of backtrace stored for every allocation
+#define MEMPROF_FRAMES      16
+// frames of site printed in report
+#define MEMPROF_PRINT       8
+// checkpoints needed before growth is reported
+#define MEMPROF_GROWTH_MIN  8
+
+typedef std::vector< void * > MemFrames;
+
+// allocations with the same backtrace
+struct MemSite
+{
+    MemFrames m_frames;
+    unsigned long long m_allocs = 0;
+    unsigned long long m_frees = 0;
+    unsigned long long m_bytes = 0;
+    long long m_live = 0;
+    long long m_peak = 0;
+    double m_lifetime_ms = 0;       // sum for freed allocations
+    long long m_first_live = 0;     // live bytes at the first checkpoint
+    long long m_checkpoint_live = 0;
+    int m_grown = 0;                // checkpoints with more live bytes than previous one
+};
+
+// one live allocation
+struct MemAlloc
+{
+    MemSite *m_site;
+    size_t m_size;
+    long long m_time;
+};
+
+static std::mutex g_memprof_mutex;
+static std::map< MemFrames, MemSite > g_memprof_sites;
+static std::unordered_map< void *, MemAlloc > g_memprof_allocs;
+static unsigned long long g_memprof_count = 0;
+static unsigned long long g_memprof_bytes = 0;
+static long long g_memprof_live = 0;
+static long long g_memprof_peak = 0;
+static int g_memprof_checkpoints = 0;
+
+// hooks of ocl_utils are chained, previous hooks are called too
+static OCLSVMHooks g_memprof_prev = { nullptr, nullptr };
+static bool g_memprof_recording = false;
+
+static long long memprof_now()
+{
+    return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+// hook of ocl_svm_malloc
+static void memprof_alloc( void *t_ptr, size_t t_size )
+{
+    if ( g_memprof_prev.m_alloc ) g_memprof_prev.m_alloc( t_ptr, t_size );
+    if ( !g_memprof_recording ) return;
+
+    void *l_frames[ MEMPROF_FRAMES + 1 ];
+    int l_count = backtrace( l_frames, MEMPROF_FRAMES + 1 );
+    long long l_now = memprof_now();
+
+    // the first frame is this hook
+    MemFrames l_key( l_frames + std::min( l_count, 1 ), l_frames + l_count );
+
+    std::lock_guard< std::mutex > l_lock( g_memprof_mutex );
+    MemSite &l_site = g_memprof_sites[ l_key ];
+    if ( l_site.m_frames.empty() ) l_site.m_frames = l_key;
+
+    l_site.m_allocs++;
+    l_site.m_bytes += t_size;
+    l_site.m_live += t_size;
+    l_site.m_peak = std::max( l_site.m_peak, l_site.m_live );
+
+    g_memprof_count++;
+    g_memprof_bytes += t_size;
+    g_memprof_live += t_size;
+    g_memprof_peak = std::max( g_memprof_peak, g_memprof_live );
+
+    g_memprof_allocs[ t_ptr ] = { &l_site, t_size, l_now };
+}
+
+// hook of ocl_svm_free, pointers allocated before start are ignored
+static void memprof_free( void *t_ptr )
+{
+    if ( g_memprof_prev.m_free ) g_memprof_prev.m_free( t_ptr );
+    if ( !g_memprof_recording ) return;
+
+    long long l_now = memprof_now();
+
+    std::lock_guard< std::mutex > l_lock( g_memprof_mutex );
+    auto l_it = g_memprof_allocs.find( t_ptr );
+    if ( l_it == g_memprof_allocs.end() ) return;
+
+    MemAlloc &l_alloc = l_it->second;
+    l_alloc.m_site->m_frees++;
+    l_alloc.m_site->m_live -= l_alloc.m_size;
+    l_alloc.m_site->m_lifetime_ms += ( l_now - l_alloc.m_time ) / 1e6;
+    g_memprof_live -= l_alloc.m_size;
+
+    g_memprof_allocs.erase( l_it );
+}
+
+/// @copydoc ocl_memprof_checkpoint
+void ocl_memprof_checkpoint()
+{
+    if ( !ocl_memprof_on() ) return;
+
+    std::lock_guard< std::mutex > l_lock( g_memprof_mutex );
+    g_memprof_checkpoints++;
+    for ( auto &l_item : g_memprof_sites )
+    {
+        MemSite &l_site = l_item.second;
+        if ( g_memprof_checkpoints == 1 ) l_site.m_first_live = l_site.m_live;
+        else if ( l_site.m_live > l_site.m_checkpoint_live ) l_site.m_grown++;
+        l_site.m_checkpoint_live = l_site.m_live;
+    }
+}
+
+// bytes in readable units
+static std::string memprof_bytes( long long t_bytes )
+{
+    char l_str[ 32 ];
+    if ( t_bytes < 1024 ) snprintf( l_str, sizeof( l_str ), "%lld B", t_bytes );
+    else if ( t_bytes < 1024 * 1024 ) snprintf( l_str, sizeof( l_str ), "%.1f KB", t_bytes / 1024.0 );
+    else snprintf( l_str, sizeof( l_str ), "%.1f MB", t_bytes / ( 1024.0 * 1024.0 ) );
+    return l_str;
+}
+
+// symbolized backtrace of site up to main
+static void memprof_frames( std::ostream &t_stream, const MemSite &t_site )
+{
+    char **l_symbols = backtrace_symbols( t_site.m_frames.data(), t_site.m_frames.size() );
+    if ( l_symbols == nullptr ) return;
+
+    for ( int i = 0; i < ( int ) t_site.m_frames.size() && i < MEMPROF_PRINT; i++ )
+    {
+        // module(mangled+offset) [address], only mangled name is demangled
+        std::string l_line = l_symbols[ i ];
+        size_t l_begin = l_line.find( '(' );
+        size_t l_end = l_line.find( '+', l_begin );
+        std::string l_name;
+        if ( l_begin != std::string::npos && l_end != std::string::npos && l_end > l_begin + 1 )
+        {
+            l_name = l_line.substr( l_begin + 1, l_end - l_begin - 1 );
+            int l_status;
+            char *l_demangled = abi::__cxa_demangle( l_name.c_str(), nullptr, nullptr, &l_status );
+            if ( l_status == 0 )
+            {
+                l_line.replace( l_begin + 1, l_end - l_begin - 1, l_demangled );
+            }
+            free( l_demangled );
+        }
+        t_stream << "        " << l_line << std::endl;
+        if ( l_name == "main" ) break;
+    }
+    free( l_symbols );
+}
+
+/// @copydoc ocl_memprof_report
+void ocl_memprof_report( std::ostream &t_stream, int t_top )
+{
+    std::lock_guard< std::mutex > l_lock( g_memprof_mutex );
+
+    t_stream << "SVM memory profile: " << g_memprof_count << " allocations, " << memprof_bytes( g_memprof_bytes )
+             << ", peak " << memprof_bytes( g_memprof_peak ) << ", live " << memprof_bytes( g_memprof_live )
+             << " in " << g_memprof_allocs.size() << " allocations." << std::endl;
+
+    std::vector< const MemSite * > l_sites;
+    for ( auto &l_item : g_memprof_sites ) l_sites.push_back( &l_item.second );
+
+    // leaks, the largest first
+    std::sort( l_sites.begin(), l_sites.end(), [] ( const MemSite *a, const MemSite *b ) { return a->m_live > b->m_live; } );
+    if ( g_memprof_live > 0 ) t_stream << std::endl << "Live allocations, leaks when at exit:" << std::endl;
+    for ( const MemSite *l_site : l_sites )
+    {
+        if ( l_site->m_live == 0 ) break;
+        t_stream << "    " << memprof_bytes( l_site->m_live ) << " in " << l_site->m_allocs - l_site->m_frees
+                 << " of " << l_site->m_allocs << " allocations" << std::endl;
+        memprof_frames( t_stream, *l_site );
+    }
+
+    // top consumers
+    std::sort( l_sites.begin(), l_sites.end(), [] ( const MemSite *a, const MemSite *b ) { return a->m_peak > b->m_peak; } );
+    if ( !l_sites.empty() ) t_stream << std::endl << "Top sites by peak of live bytes:" << std::endl;
+    for ( int i = 0; i < ( int ) l_sites.size() && i < t_top; i++ )
+    {
+        const MemSite *l_site = l_sites[ i ];
+        t_stream << "    peak " << memprof_bytes( l_site->m_peak ) << ", " << l_site->m_allocs << " allocations, "
+                 << memprof_bytes( l_site->m_bytes ) << " total";
+        if ( l_site->m_frees ) t_stream << ", average lifetime " << l_site->m_lifetime_ms / l_site->m_frees << " ms";
+        t_stream << std::endl;
+        memprof_frames( t_stream, *l_site );
+    }
+
+    // live bytes growing in most of checkpoints
+    if ( g_memprof_checkpoints < MEMPROF_GROWTH_MIN ) return;
+    bool l_header = false;
+    for ( const MemSite *l_site : l_sites )
+    {
+        if ( l_site->m_grown * 2 <= g_memprof_checkpoints - 1 || l_site->m_live <= l_site->m_first_live ) continue;
+        if ( !l_header ) t_stream << std::endl << "Growing sites in " << g_memprof_checkpoints << " checkpoints:" << std::endl;
+        l_header = true;
+        t_stream << "    grown in " << l_site->m_grown << " checkpoints, live " << memprof_bytes( l_site->m_first_live )
+                 << " -> " << memprof_bytes( l_site->m_live ) << std::endl;
+        memprof_frames( t_stream, *l_site );
+    }
+}
+
+// profiling from environment variable OCL_MEMPROF, report is written at exit
+static struct MemprofFromEnv
+{
+    std::string m_file_name;
+
+    MemprofFromEnv()
+    {
+        const char *l_file_name = getenv( "OCL_MEMPROF" );
+        if ( l_file_name == nullptr || *l_file_name == 0 ) return;
+        m_file_name = l_file_name;
+
+        // the first backtrace loads libgcc, it must not be in hook
+        void *l_frame;
+        backtrace( &l_frame, 1 );
+
+        g_memprof_prev = g_ocl_svm_hooks;
+        g_ocl_svm_hooks = { memprof_alloc, memprof_free };
+        g_memprof_recording = true;
+    }
+
+    ~MemprofFromEnv()
+    {
+        if ( m_file_name.empty() ) return;
+        // hooks stay in chain, they only stop recording
+        g_memprof_recording = false;
+
+        if ( m_file_name == "-" )
+        {
+            ocl_memprof_report( std::cerr );
+            return;
+        }
+        std::ofstream l_file( m_file_name );
+        if ( !l_file )
+        {
+            std::cerr << "Unable to write memory profile '" << m_file_name << "'!" << std::endl;
+            return;
+        }
+        ocl_memprof_report( l_file );
+    }
+} g_memprof_from_env;
+
+/// @copydoc ocl_memprof_on
+bool ocl_memprof_on()
+{
+    return !g_memprof_from_env.m_file_name.empty();
+}
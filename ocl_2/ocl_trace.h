@@ -0,0 +1,124 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_trace.h
+ * @brief Timeline of host calls and kernels in Chrome trace format.
+ *
+ * @details
+ * Header file for @ref OCL_TRACE_SCOPE and functions @ref ocl_trace_start,
+ * @ref ocl_trace_stop and @ref ocl_trace_event.
+ *
+ * Host spans are recorded by @ref OCL_TRACE_SCOPE from its line to the end
+ * of block. Device spans are taken from profiling of events: waiting in
+ * queue and execution of kernel. Device clock is moved onto host clock
+ * by time of enqueue measured on host.
+ *
+ * Tracing is started by environment variable OCL_TRACE with name of file,
+ * e.g. OCL_TRACE=trace.json ./ocl_6 ball.png, and trace is written at exit.
+ * File can be opened in chrome://tracing or https://ui.perfetto.dev.
+ * @ref ocl_init creates default queue with profiling, when OCL_TRACE is set.
+ *
+ * When tracing is off, every scope costs only one test of global flag.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_TRACE_H
+#define __OCL_TRACE_H
+
+#include <string>
+#include <atomic>
+#include <chrono>
+
+#include <CL/opencl.hpp>
+
+/// @cond
+// written under lock by start and stop, read by any thread
+extern std::atomic< bool > g_ocl_trace_on;
+/// @endcond
+
+/**
+ * @anchor ocl_trace_start
+ * @brief Recording of trace is started, previous records are cleared.
+ * @param t_file_name File for trace written by @ref ocl_trace_stop.
+*/
+void ocl_trace_start( const std::string &t_file_name );
+
+/**
+ * @anchor ocl_trace_stop
+ * @brief Recording is stopped and trace is written into file.
+ * @return true when file was written or tracing was off.
+*/
+bool ocl_trace_stop();
+
+/// Tracing is on.
+inline bool ocl_trace_on() { return g_ocl_trace_on.load( std::memory_order_relaxed ); }
+
+/// Host time of trace in ns, for @ref ocl_trace_event.
+inline long long ocl_trace_now()
+{
+    return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+/**
+ * @anchor ocl_trace_event
+ * @brief Device span from profiling of completed event.
+ * @param t_name Name of span, it must stay valid, e.g. string literal.
+ * @param t_event Completed event from queue with profiling, otherwise it is ignored.
+ * @param t_host_enqueue Time from @ref ocl_trace_now before enqueue of command.
+*/
+void ocl_trace_event( const char *t_name, const cl::Event &t_event, long long t_host_enqueue );
+
+/**
+ * @brief Host span from constructor to destructor.
+*/
+class OCLTraceScope
+{
+public:
+    /// Span starts, t_name must stay valid, e.g. string literal.
+    OCLTraceScope( const char *t_name ) : m_name( ocl_trace_on() ? t_name : nullptr )
+    {
+        if ( m_name ) m_start = ocl_trace_now();
+    }
+
+    /// Span ends and it is recorded.
+    ~OCLTraceScope()
+    {
+        if ( m_name ) record();
+    }
+
+    OCLTraceScope( const OCLTraceScope & ) = delete;
+    OCLTraceScope &operator=( const OCLTraceScope & ) = delete;
+
+protected:
+    /// @cond
+    const char *m_name;
+    long long m_start;
+
+    void record();
+    /// @endcond
+};
+
+/// @cond
+#define OCL_TRACE_CAT2( t_a, t_b ) t_a##t_b
+#define OCL_TRACE_CAT( t_a, t_b ) OCL_TRACE_CAT2( t_a, t_b )
+/// @endcond
+
+/**
+ * @anchor OCL_TRACE_SCOPE
+ * @brief Host span from this line to the end of block.
+ * @param t_name Name of span, string literal.
+*/
+#define OCL_TRACE_SCOPE( t_name ) OCLTraceScope OCL_TRACE_CAT( l_trace_scope_, __LINE__ )( t_name )
+
+#endif // __OCL_TRACE_H
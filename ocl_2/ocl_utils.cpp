@@ -17,14 +17,119 @@
  ***************************************************************************/
 
 #include <cstdlib>
+#include <strings.h>
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <vector>
+#include <mutex>
+#include <algorithm>
+#include <unordered_map>
 
 #include <CL/opencl.hpp> 
 
 #include "ocl_utils.h"
 
+OCLSVMCounters g_ocl_svm_counters;
+OCLSVMHooks g_ocl_svm_hooks = { nullptr, nullptr };
+void ( *g_ocl_program_hook )( const cl::Program &, const std::string & ) = nullptr;
+
+// handlers are called under lock, so owner can not be removed during call
+static std::mutex g_reclaim_mutex;
+static std::vector< std::pair< void *, OCLSVMReclaim > > g_reclaims;
+
+// sizes of live SVM allocations, ocl_svm_free does not know size
+static std::mutex g_svm_sizes_mutex;
+static std::unordered_map< void *, size_t > g_svm_sizes;
+
+// budget from OCL_SVM_BUDGET in MB, 0 - no budget
+static size_t svm_env_budget()
+{
+    const char *l_budget = getenv( "OCL_SVM_BUDGET" );
+    return l_budget ? ( size_t ) std::max( 0, atoi( l_budget ) ) << 20 : 0;
+}
+
+static std::atomic< size_t > g_svm_budget{ svm_env_budget() };
+
+// size of new allocation is recorded, called by ocl_svm_malloc
+void ocl_svm_track_alloc( void *t_ptr, size_t t_size )
+{
+    std::lock_guard< std::mutex > l_lock( g_svm_sizes_mutex );
+    g_svm_sizes[ t_ptr ] = t_size;
+    g_ocl_svm_counters.m_live_bytes.fetch_add( t_size, std::memory_order_relaxed );
+}
+
+// size of freed allocation is subtracted, called by ocl_svm_free
+void ocl_svm_track_free( void *t_ptr )
+{
+    std::lock_guard< std::mutex > l_lock( g_svm_sizes_mutex );
+    auto l_found = g_svm_sizes.find( t_ptr );
+    if ( l_found == g_svm_sizes.end() ) return;
+    g_ocl_svm_counters.m_live_bytes.fetch_sub( l_found->second, std::memory_order_relaxed );
+    g_svm_sizes.erase( l_found );
+}
+
+/// @copydoc ocl_svm_add_reclaim
+void ocl_svm_add_reclaim( void *t_owner, OCLSVMReclaim t_reclaim )
+{
+    std::lock_guard< std::mutex > l_lock( g_reclaim_mutex );
+    g_reclaims.push_back( { t_owner, t_reclaim } );
+}
+
+/// @copydoc ocl_svm_remove_reclaim
+void ocl_svm_remove_reclaim( void *t_owner )
+{
+    std::lock_guard< std::mutex > l_lock( g_reclaim_mutex );
+    for ( auto l_it = g_reclaims.begin(); l_it != g_reclaims.end(); l_it++ )
+    {
+        if ( l_it->first == t_owner )
+        {
+            g_reclaims.erase( l_it );
+            return;
+        }
+    }
+}
+
+/// @copydoc ocl_svm_reclaim
+bool ocl_svm_reclaim( size_t t_size )
+{
+    std::lock_guard< std::mutex > l_lock( g_reclaim_mutex );
+    bool l_released = false;
+    for ( auto &l_reclaim : g_reclaims )
+    {
+        l_released |= l_reclaim.second( l_reclaim.first, t_size );
+    }
+    return l_released;
+}
+
+/// @copydoc ocl_svm_set_budget
+void ocl_svm_set_budget( size_t t_budget )
+{
+    g_svm_budget = t_budget;
+    ocl_svm_fit_budget( 0 );
+}
+
+/// @copydoc ocl_svm_budget
+size_t ocl_svm_budget()
+{
+    return g_svm_budget;
+}
+
+/// @copydoc ocl_svm_fit_budget
+void ocl_svm_fit_budget( size_t t_size )
+{
+    size_t l_budget = g_svm_budget;
+    if ( l_budget == 0 ) return;
+
+    // budget is soft, allocation continues when nothing more is released
+    while ( true )
+    {
+        size_t l_live = ( size_t ) std::max( 0LL, g_ocl_svm_counters.m_live_bytes.load() );
+        if ( l_live + t_size <= l_budget ) return;
+        if ( !ocl_svm_reclaim( l_live + t_size - l_budget ) ) return;
+    }
+}
+
 /// @copydoc _out_error
 void _out_error( std::ostream &t_stream, int t_error, std::string t_func_name, int t_line_num )
 {
@@ -44,6 +149,10 @@ cl_int ocl_init( int t_verbose, int t_gpu_dev_index )
 
     cl_int l_err;
 
+    // OCL_DEVICE_TYPE=CPU selects CPU devices instead of GPU, e.g. PoCL
+    const char *l_type_env = getenv( "OCL_DEVICE_TYPE" );
+    cl_device_type l_dev_type = l_type_env && strcasecmp( l_type_env, "CPU" ) == 0 ? CL_DEVICE_TYPE_CPU : CL_DEVICE_TYPE_GPU;
+
     // Searching of platforms
     std::vector<cl::Platform> l_platforms;
     l_err = cl::Platform::get( &l_platforms );                                  CL_ERR_R( l_err );
@@ -77,7 +186,7 @@ cl_int ocl_init( int t_verbose, int t_gpu_dev_index )
 
         for ( auto &d : l_devices )
         {
-            if ( d.getInfo< CL_DEVICE_TYPE >() == CL_DEVICE_TYPE_GPU && 
+            if ( d.getInfo< CL_DEVICE_TYPE >() == l_dev_type && 
                     p.getInfo< CL_PLATFORM_VERSION >().find( "OpenCL 3." ) >= 0 )
             {
                 l_gpu_devices.push_back( { p, d } ); 
@@ -171,7 +280,10 @@ cl_int ocl_init( int t_verbose, int t_gpu_dev_index )
         std::cout << "Default Context created." << std::endl;
     }
 
-    cl::CommandQueue defQueue( ( cl_command_queue_properties ) 0U, &l_err );    CL_ERR_R( l_err );
+    // trace, device latencies of metrics and capture need profiling of default queue,
+    // see ocl_trace.h, ocl_metrics.h and ocl_capture.h
+    cl_command_queue_properties l_queue_props = getenv( "OCL_TRACE" ) || getenv( "OCL_METRICS" ) || getenv( "OCL_CAPTURE" ) ? CL_QUEUE_PROFILING_ENABLE : 0U;
+    cl::CommandQueue defQueue( l_queue_props, &l_err );                         CL_ERR_R( l_err );
     cl::CommandQueue::setDefault( defQueue );
 
     if ( t_verbose > 0 )
@@ -228,6 +340,8 @@ cl::Program ocl_load_program( const std::string t_kernel_filename )
         return l_program;
     }
     // build sucessfull
+
+    if ( g_ocl_program_hook ) g_ocl_program_hook( l_program, t_kernel_filename );
     
     return l_program;
 }
@@ -0,0 +1,27 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course 
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Kernel without SVM, data are in device buffers copied from host.
+ * 
+ ***************************************************************************/
+
+// kernel for negative of BGR image, alpha channel is kept
+__kernel void invert_bgr( __global const uchar4 *t_src, __global uchar4 *t_dst, uint t_count )
+{
+    // get work-item position  
+    size_t global_idx = get_global_id( 0 );
+
+    // verify work-item position
+    if ( global_idx >= t_count ) return;
+
+    uchar4 l_bgr = t_src[ global_idx ];
+    t_dst[ global_idx ] = ( uchar4 )( 255 - l_bgr.x, 255 - l_bgr.y, 255 - l_bgr.z, l_bgr.w );
+}
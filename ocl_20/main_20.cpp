@@ -0,0 +1,222 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Streaming of frames without SVM.
+ * Bandwidth of copies from pageable and from pinned memory is measured,
+ * then frames are streamed through ring of pinned staging slots,
+ * where upload, kernel and download of different frames overlap.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <unistd.h>
+#include <iostream>
+#include <iomanip>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_staging.h"
+
+#define KERNEL_SPV      "kernel_20.spv"
+#define KERNEL_PREFIX   "gpu_"
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+// Kernel is enqueued by staging ring after upload of slot, caller waits.
+//
+// Negative of BGR image in device buffers.
+// Kernel header from kernel*.cl:
+// __kernel void invert_bgr(                 __global const uchar4 *t_src,
+//                                           __global uchar4 *t_dst,
+//                                           uint t_count )
+cl_int gpu_invert_bgr( OCLStagingRing &t_ring, int t_slot, cl::Program &t_program, cl_uint t_count )
+{
+    cl_int l_err;
+
+    // kernel is selected only once
+    static cl::Kernel l_kern_invert_bgr;
+    if ( l_kern_invert_bgr() == nullptr )
+    {
+        // removing prefix gpu_
+        std::string l_kern_name( __FUNCTION__ );
+        if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+        {
+            l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+        }
+
+        // select the kernel from opencl program
+        l_kern_invert_bgr = cl::Kernel( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+    }
+
+    // set kernel arguments, device buffers of slot
+    l_err = l_kern_invert_bgr.setArg( 0, t_ring.dev_in( t_slot ) );             CL_ERR_R( l_err );
+    l_err = l_kern_invert_bgr.setArg( 1, t_ring.dev_out( t_slot ) );            CL_ERR_R( l_err );
+    l_err = l_kern_invert_bgr.setArg( 2, t_count );                             CL_ERR_R( l_err );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size = 256;
+    // global range
+    int l_gr_size = ( t_count + ( l_wg_size - 1 ) ) / l_wg_size * l_wg_size;
+
+    // kernel waits for upload of slot
+    return t_ring.compute( t_slot, l_kern_invert_bgr, cl::NDRange( l_gr_size ), cl::NDRange( l_wg_size ) );
+}
+
+// **************************************************************************
+// blocking copies of the same buffer, bandwidth in GB/s
+double copy_gbps( cl::Buffer &t_dev, void *t_host, size_t t_bytes, int t_repeat, bool t_upload )
+{
+    cl_int l_err;
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    auto l_start = std::chrono::steady_clock::now();
+    for ( int r = 0; r < t_repeat; r++ )
+    {
+        if ( t_upload )
+        {
+            l_err = defQueue.enqueueWriteBuffer( t_dev, CL_TRUE, 0, t_bytes, t_host );  CL_ERR_E( l_err );
+        }
+        else
+        {
+            l_err = defQueue.enqueueReadBuffer( t_dev, CL_TRUE, 0, t_bytes, t_host );   CL_ERR_E( l_err );
+        }
+    }
+    double l_ms = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - l_start ).count();
+
+    return ( double ) t_bytes * t_repeat / l_ms / 1e6;
+}
+
+// **************************************************************************
+#define IMG_SIZEX   1920
+#define IMG_SIZEY   1080
+
+int main( int t_narg, char **t_args )
+{
+    int l_width = IMG_SIZEX;
+    int l_height = IMG_SIZEY;
+    int l_frames = 100;
+    int l_slots = 3;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "s:n:d:" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 's': sscanf( optarg, "%dx%d", &l_width, &l_height ); break;
+        case 'n': l_frames = std::max( 1, atoi( optarg ) ); break;
+        case 'd': l_slots = std::max( 1, atoi( optarg ) ); break;
+        default:
+            std::cerr << "Usage: " << t_args[ 0 ] << " [-s WxH] [-n frames] [-d slots]" << std::endl;
+            std::cerr << "  -s  size of frames" << std::endl;
+            std::cerr << "  -d  depth of staging ring, 1 - no overlap" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    cl_int l_err;
+
+    l_err = ocl_init( 1 );                                                      CL_ERR_E( l_err );
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "Program loaded.\n" << std::endl;
+
+    cl_uint l_count = std::max( 1, l_width ) * std::max( 1, l_height );
+    size_t l_bytes = l_count * 4;
+    std::cout << "Frame " << l_width << "x" << l_height << ", " << l_bytes / 1048576.0 << " MB." << std::endl;
+
+    // pageable memory against pinned memory of ring
+    {
+        OCLStagingRing l_ring( 1, l_bytes, l_bytes );
+        int l_slot = l_ring.acquire();
+        if ( l_slot < 0 ) exit( EXIT_FAILURE );
+
+        std::vector< unsigned char > l_pageable( l_bytes, 1 );
+        memset( l_ring.input( l_slot ), 1, l_bytes );
+
+        std::cout << std::fixed << std::setprecision( 2 );
+        std::cout << "\nBlocking copies        upload GB/s  download GB/s" << std::endl;
+        std::cout << "  pageable memory      " << std::setw( 10 ) << copy_gbps( l_ring.dev_in( l_slot ), l_pageable.data(), l_bytes, 20, true )
+                  << std::setw( 15 ) << copy_gbps( l_ring.dev_out( l_slot ), l_pageable.data(), l_bytes, 20, false ) << std::endl;
+        std::cout << "  pinned memory        " << std::setw( 10 ) << copy_gbps( l_ring.dev_in( l_slot ), l_ring.input( l_slot ), l_bytes, 20, true )
+                  << std::setw( 15 ) << copy_gbps( l_ring.dev_out( l_slot ), l_ring.output( l_slot ), l_bytes, 20, false ) << std::endl;
+        l_ring.release( l_slot );
+    }
+
+    // streaming: without overlap and with ring of slots
+    for ( int l_depth : { 1, l_slots } )
+    {
+        OCLStagingRing l_ring( l_depth, l_bytes, l_bytes );
+        std::vector< int > l_in_flight;
+        long l_bad = 0;
+
+        auto l_consume = [ & ] ( int t_slot )
+        {
+            // the first pixel of frame f has value f, inverted by kernel
+            cl_uchar4 *l_out = ( cl_uchar4 * ) l_ring.output( t_slot );
+            if ( l_out == nullptr ) exit( EXIT_FAILURE );
+            cl_uchar4 *l_in = ( cl_uchar4 * ) l_ring.input( t_slot );
+            if ( l_out[ 0 ].s[ 0 ] != 255 - l_in[ 0 ].s[ 0 ] || l_out[ l_count - 1 ].s[ 3 ] != l_in[ l_count - 1 ].s[ 3 ] ) l_bad++;
+            l_ring.release( t_slot );
+        };
+
+        auto l_start = std::chrono::steady_clock::now();
+        for ( int f = 0; f < l_frames; f++ )
+        {
+            // the oldest frame is consumed when ring is full
+            if ( ( int ) l_in_flight.size() == l_depth )
+            {
+                l_consume( l_in_flight.front() );
+                l_in_flight.erase( l_in_flight.begin() );
+            }
+
+            int l_slot = l_ring.acquire();
+            if ( l_slot < 0 ) exit( EXIT_FAILURE );
+
+            // producer writes directly into pinned memory
+            memset( l_ring.input( l_slot ), f & 0xFF, l_bytes );
+
+            l_err = l_ring.upload( l_slot );                                    CL_ERR_E( l_err );
+            l_err = gpu_invert_bgr( l_ring, l_slot, l_program, l_count );       CL_ERR_E( l_err );
+            l_err = l_ring.download( l_slot );                                  CL_ERR_E( l_err );
+            l_in_flight.push_back( l_slot );
+        }
+        for ( int l_slot : l_in_flight )
+        {
+            l_consume( l_slot );
+        }
+        l_err = l_ring.finish();                                                CL_ERR_E( l_err );
+        double l_ms = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - l_start ).count();
+
+        std::cout << "\nStreaming with " << l_depth << " slot(s): " << l_ms / l_frames << " ms per frame, "
+                  << l_frames * 1000.0 / l_ms << " frames/s, bad frames " << l_bad << std::endl;
+        std::cout << "  upload   " << l_ring.upload_stats().gbps() << " GB/s during copies, "
+                  << l_ring.upload_stats().m_bytes / l_ms / 1e6 << " GB/s of wall time" << std::endl;
+        std::cout << "  download " << l_ring.download_stats().gbps() << " GB/s during copies, "
+                  << l_ring.download_stats().m_bytes / l_ms / 1e6 << " GB/s of wall time" << std::endl;
+    }
+}
@@ -0,0 +1,181 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_staging.h
+ * @brief Ring of pinned staging buffers for streaming without SVM.
+ *
+ * @details
+ * Header file for class @ref OCLStagingRing.
+ *
+ * Without SVM, data must be copied explicitly between host and device
+ * buffers. Copy from pageable host memory goes through hidden driver
+ * buffer and it is usually synchronous. Staging buffers are allocated
+ * by OpenCL with CL_MEM_ALLOC_HOST_PTR and mapped once, so host writes
+ * directly into pinned memory and DMA copies it without extra pass.
+ *
+ * Every slot of ring has pinned input, pinned output and two device
+ * buffers. Upload, compute and download have their own queues,
+ * so upload of frame i+1, kernel of frame i and download of frame i-1
+ * can run at the same time.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_STAGING_H
+#define __OCL_STAGING_H
+
+#include <vector>
+
+#include <CL/opencl.hpp>
+
+/**
+ * @brief Transfer statistics from profiling of copies.
+*/
+struct OCLStagingStats
+{
+    size_t m_copies;            ///< Number of copies.
+    size_t m_bytes;             ///< Copied bytes.
+    double m_ms;                ///< Sum of copy times.
+
+    /// Bandwidth in GB/s.
+    double gbps() const { return m_ms > 0 ? m_bytes / m_ms / 1e6 : 0; }
+};
+
+/**
+ * @anchor OCLStagingRing
+ * @brief Ring of slots with pinned host memory and device buffers.
+ *
+ * @details
+ * For every frame: @ref acquire slot, fill @ref input, @ref upload,
+ * set kernel arguments to @ref dev_in and @ref dev_out, @ref compute,
+ * @ref download. Later @ref output waits for data and @ref release
+ * returns slot into ring. Functions do not wait, only @ref acquire
+ * and @ref output.
+*/
+class OCLStagingRing
+{
+public:
+    /**
+     * @brief Allocation of all slots in default context.
+     * @param t_slots Number of slots, 3 is enough for overlap of all stages.
+     * @param t_in_bytes Size of input of one frame.
+     * @param t_out_bytes Size of output of one frame.
+    */
+    OCLStagingRing( int t_slots, size_t t_in_bytes, size_t t_out_bytes );
+
+    /**
+     * @brief Pinned memory is unmapped.
+    */
+    ~OCLStagingRing();
+
+    OCLStagingRing( const OCLStagingRing & ) = delete;
+    OCLStagingRing &operator=( const OCLStagingRing & ) = delete;
+
+    /**
+     * @brief The next slot in ring, function waits until it is released.
+     * @return Index of slot or -1 when allocation failed.
+    */
+    int acquire();
+
+    /// Pinned host memory for input of slot.
+    void *input( int t_slot ) { return m_slots[ t_slot ].m_in_host; }
+
+    /// Device buffer with input of slot.
+    cl::Buffer &dev_in( int t_slot ) { return m_slots[ t_slot ].m_dev_in; }
+
+    /// Device buffer for output of slot.
+    cl::Buffer &dev_out( int t_slot ) { return m_slots[ t_slot ].m_dev_out; }
+
+    /**
+     * @brief Non-blocking copy of input to device.
+     * @param t_bytes Bytes of input, 0 - whole input.
+    */
+    cl_int upload( int t_slot, size_t t_bytes = 0 );
+
+    /**
+     * @brief Kernel is enqueued after upload of slot.
+     * @param t_slot Slot, kernel arguments must be already set.
+     * @param t_kernel Kernel for slot.
+     * @param t_global Global range.
+     * @param t_local Work-group size.
+    */
+    cl_int compute( int t_slot, cl::Kernel &t_kernel, const cl::NDRange &t_global, const cl::NDRange &t_local );
+
+    /**
+     * @brief Non-blocking copy of output to pinned memory after kernel.
+     * @param t_bytes Bytes of output, 0 - whole output.
+    */
+    cl_int download( int t_slot, size_t t_bytes = 0 );
+
+    /**
+     * @brief Pinned memory with output, function waits for download.
+     *
+     * @details
+     * Profiling of upload and download of slot is added to statistics.
+     *
+     * @return Output or nullptr, when some command of slot failed.
+    */
+    void *output( int t_slot );
+
+    /// Slot can be acquired again.
+    void release( int t_slot );
+
+    /**
+     * @brief Waiting for all queues, profiling of copies not added by @ref output is added to statistics.
+    */
+    cl_int finish();
+
+    /// Statistics of uploads.
+    const OCLStagingStats &upload_stats() const { return m_up_stats; }
+
+    /// Statistics of downloads.
+    const OCLStagingStats &download_stats() const { return m_down_stats; }
+
+    /// Statistics are cleared.
+    void reset_stats();
+
+protected:
+    /// @cond
+    struct Slot
+    {
+        cl::Buffer m_in_pinned;
+        cl::Buffer m_out_pinned;
+        void *m_in_host;
+        void *m_out_host;
+        cl::Buffer m_dev_in;
+        cl::Buffer m_dev_out;
+        cl::Event m_uploaded;
+        cl::Event m_computed;
+        cl::Event m_downloaded;
+        size_t m_up_bytes;              // copies not added to statistics yet
+        size_t m_down_bytes;
+        cl_int m_error;
+        bool m_busy;
+    };
+
+    cl::CommandQueue m_up_queue;
+    cl::CommandQueue m_compute_queue;
+    cl::CommandQueue m_down_queue;
+    std::vector< Slot > m_slots;
+    size_t m_in_bytes;
+    size_t m_out_bytes;
+    int m_next;
+    OCLStagingStats m_up_stats;
+    OCLStagingStats m_down_stats;
+
+    void unmap();
+    void account( Slot &t_slot );
+    /// @endcond
+};
+
+#endif // __OCL_STAGING_H
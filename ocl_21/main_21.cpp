@@ -0,0 +1,368 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Benchmark of all kernels from demos over sizes of images
+ * and shapes of work-groups. Kernels are timed by profiling events,
+ * results are written as CSV and JSON and compared with baseline.
+ * With profile of device from ocl_0 kernels are placed on roofline.
+ *
+ * Call 'make bench' to run benchmark.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <iostream>
+#include <iomanip>
+#include <math.h>
+#include <vector>
+#include <set>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_bench.h"
+#include "ocl_profile.h"
+#include "ocl_roofline.h"
+
+#define KERNEL_SPV      "kernel_21.spv"
+
+// **************************************************************************
+// operations of one pixel or element counted from kernel source
+struct KernelOps
+{
+    const char *m_kernel;
+    double m_ops;
+    bool m_float;
+};
+
+const KernelOps g_kernel_ops[] =
+{
+    { "mult_vect",              1,  true },     // multiplication
+    { "rotate_bgr",             0,  false },    // only moves
+    { "convert_bgr_to_bw",      8,  false },    // 3 mul, 3 div, 2 add
+    { "create_chessboard",      6,  false },    // 2 div, add, and, mul, index
+    { "create_transparent_dot", 14, true },     // distance: 3 mul, add, sqrt, sub, div, mul
+    { "insert_image",           21, false },    // 3x: 2 mul, 2 div, add, 2 sub
+};
+
+// **************************************************************************
+// list "AxB,CxD" into pairs
+std::vector< std::pair< int, int > > parse_pairs( const char *t_list )
+{
+    std::vector< std::pair< int, int > > l_pairs;
+    std::stringstream l_ss( t_list );
+    std::string l_item;
+    while ( std::getline( l_ss, l_item, ',' ) )
+    {
+        int l_a = 0, l_b = 0;
+        if ( sscanf( l_item.c_str(), "%dx%d", &l_a, &l_b ) == 2 && l_a > 0 && l_b > 0 )
+        {
+            l_pairs.push_back( { l_a, l_b } );
+        }
+    }
+    return l_pairs;
+}
+
+// **************************************************************************
+// image with descriptor and data in SVM, data filled by pattern
+OCLImage *bench_image( int t_width, int t_height, int t_elem_size )
+{
+    OCLImage *l_ocl_img = ocl_svm_malloc< OCLImage >();
+    void *l_data = ocl_svm_malloc< void >( ( size_t ) t_width * t_height * t_elem_size );
+    if ( l_ocl_img == nullptr || l_data == nullptr )
+    {
+        std::cerr << "Unable to allocate image " << t_width << "x" << t_height << "!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+    l_ocl_img->m_size.x = t_width;
+    l_ocl_img->m_size.y = t_height;
+    l_ocl_img->m_data = l_data;
+    for ( size_t i = 0; i < ( size_t ) t_width * t_height * t_elem_size; i++ )
+    {
+        l_ocl_img->m_data1[ i ] = i * 7;
+    }
+    return l_ocl_img;
+}
+
+void bench_free( OCLImage *t_ocl_img )
+{
+    ocl_svm_free( t_ocl_img->m_data );
+    ocl_svm_free( t_ocl_img );
+}
+
+// **************************************************************************
+// global range rounded up to work-group
+cl::NDRange bench_range( int t_width, int t_height, int t_wg_x, int t_wg_y )
+{
+    return cl::NDRange( ( t_width + t_wg_x - 1 ) / t_wg_x * t_wg_x, ( t_height + t_wg_y - 1 ) / t_wg_y * t_wg_y );
+}
+
+// **************************************************************************
+int main( int t_narg, char **t_args )
+{
+    const char *l_sizes = "640x480,1280x720,1920x1080,3840x2160";
+    const char *l_wgs = "8x8,16x16,32x8,64x4";
+    const char *l_output = nullptr;
+    const char *l_baseline = nullptr;
+    const char *l_profile_name = nullptr;
+    int l_warmup = 3;
+    int l_repeat = 10;
+    int l_device = 0;
+    double l_tolerance = 10;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "s:w:W:r:g:o:b:t:p:" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 's': l_sizes = optarg; break;
+        case 'w': l_wgs = optarg; break;
+        case 'W': l_warmup = std::max( 0, atoi( optarg ) ); break;
+        case 'r': l_repeat = std::max( 1, atoi( optarg ) ); break;
+        case 'g': l_device = std::max( 0, atoi( optarg ) ); break;
+        case 'o': l_output = optarg; break;
+        case 'b': l_baseline = optarg; break;
+        case 't': l_tolerance = std::max( 0.0, atof( optarg ) ); break;
+        case 'p': l_profile_name = optarg; break;
+        default:
+            std::cerr << "Usage: " << t_args[ 0 ] << " [-s WxH,...] [-w WxH,...] [-W warmup] [-r repeat] [-g device] [-o name] [-b baseline.csv] [-t percent] [-p profile.json]" << std::endl;
+            std::cerr << "  -s  sizes of images" << std::endl;
+            std::cerr << "  -w  shapes of work-groups, vector uses their product" << std::endl;
+            std::cerr << "  -g  index of GPU device" << std::endl;
+            std::cerr << "  -o  results are written into name.csv and name.json" << std::endl;
+            std::cerr << "  -b  results are compared with CSV, slower by more than -t percent fail" << std::endl;
+            std::cerr << "  -p  profile of device from 'ocl_0 -c' for roofline" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    std::vector< std::pair< int, int > > l_size_list = parse_pairs( l_sizes );
+    std::vector< std::pair< int, int > > l_wg_list = parse_pairs( l_wgs );
+    if ( l_size_list.empty() || l_wg_list.empty() )
+    {
+        std::cerr << "No size or no work-group to measure!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    // baseline is read before output, it can be the same file
+    std::vector< OCLBenchResult > l_base;
+    if ( l_baseline )
+    {
+        std::ifstream l_base_file( l_baseline );
+        l_base = OCLBench::read_csv( l_base_file );
+        if ( l_base.empty() )
+        {
+            std::cerr << "No results in baseline " << l_baseline << "!" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    OCLDeviceProfile l_profile;
+    if ( l_profile_name && !l_profile.load( l_profile_name ) )
+    {
+        std::cerr << "Unable to read profile " << l_profile_name << "!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    cl_int l_err;
+
+    l_err = ocl_init( 1, l_device );                                            CL_ERR_E( l_err );
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "Program loaded.\n" << std::endl;
+
+    // kernels are selected only once, arguments are set for every size
+    cl::Kernel l_kern_mult_vect( l_program, "mult_vect", &l_err );              CL_ERR_E( l_err );
+    cl::Kernel l_kern_rotate_bgr( l_program, "rotate_bgr", &l_err );            CL_ERR_E( l_err );
+    cl::Kernel l_kern_convert_bgr_to_bw( l_program, "convert_bgr_to_bw", &l_err );  CL_ERR_E( l_err );
+    cl::Kernel l_kern_create_chessboard( l_program, "create_chessboard", &l_err );  CL_ERR_E( l_err );
+    cl::Kernel l_kern_transparent_dot( l_program, "create_transparent_dot", &l_err );  CL_ERR_E( l_err );
+    cl::Kernel l_kern_insert_image( l_program, "insert_image", &l_err );        CL_ERR_E( l_err );
+
+    size_t l_max_wg = cl::Device::getDefault().getInfo< CL_DEVICE_MAX_WORK_GROUP_SIZE >();
+
+    OCLBench l_bench( l_warmup, l_repeat );
+
+    for ( auto &l_size : l_size_list )
+    {
+        int l_width = l_size.first;
+        int l_height = l_size.second;
+        size_t l_pixels = ( size_t ) l_width * l_height;
+
+        // inserted image has quarter of pixels
+        int l_small_width = std::max( 1, l_width / 2 );
+        int l_small_height = std::max( 1, l_height / 2 );
+        size_t l_small_pixels = ( size_t ) l_small_width * l_small_height;
+
+        OCLImage *l_ocl_bgr_img = bench_image( l_width, l_height, 4 );
+        OCLImage *l_ocl_bw_img = bench_image( l_width, l_height, 1 );
+        OCLImage *l_ocl_small_img = bench_image( l_small_width, l_small_height, 4 );
+        float *l_vector = ocl_svm_malloc< float >( l_pixels );
+        if ( l_vector == nullptr )
+        {
+            std::cerr << "Unable to allocate vector!" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+        for ( size_t i = 0; i < l_pixels; i++ )
+        {
+            l_vector[ i ] = 1.0f;
+        }
+
+        // mult_vect by 1.0 keeps values, image kernels write the same values again
+        l_err = l_kern_mult_vect.setArg( 0, l_vector );                         CL_ERR_E( l_err );
+        l_err = l_kern_mult_vect.setArg( 1, 1.0f );                             CL_ERR_E( l_err );
+        l_err = l_kern_mult_vect.setArg( 2, ( int ) l_pixels );                 CL_ERR_E( l_err );
+        l_kern_mult_vect.setSVMPointers( { l_vector } );
+
+        l_err = l_kern_rotate_bgr.setArg( 0, l_ocl_bgr_img );                   CL_ERR_E( l_err );
+        l_kern_rotate_bgr.setSVMPointers( { l_ocl_bgr_img, l_ocl_bgr_img->m_data } );
+
+        l_err = l_kern_convert_bgr_to_bw.setArg( 0, l_ocl_bgr_img );            CL_ERR_E( l_err );
+        l_err = l_kern_convert_bgr_to_bw.setArg( 1, l_ocl_bw_img );             CL_ERR_E( l_err );
+        l_kern_convert_bgr_to_bw.setSVMPointers( { l_ocl_bgr_img, l_ocl_bgr_img->m_data, l_ocl_bw_img, l_ocl_bw_img->m_data } );
+
+        l_err = l_kern_create_chessboard.setArg( 0, l_ocl_bgr_img );            CL_ERR_E( l_err );
+        l_err = l_kern_create_chessboard.setArg( 1, 3 );                        CL_ERR_E( l_err );
+        l_kern_create_chessboard.setSVMPointers( { l_ocl_bgr_img, l_ocl_bgr_img->m_data } );
+
+        cl_uchar4 l_color = {{ 0, 0, 255, 0 }};
+        l_err = l_kern_transparent_dot.setArg( 0, l_ocl_small_img );            CL_ERR_E( l_err );
+        l_err = l_kern_transparent_dot.setArg( 1, l_color );                    CL_ERR_E( l_err );
+        l_kern_transparent_dot.setSVMPointers( { l_ocl_small_img, l_ocl_small_img->m_data } );
+
+        cl_int2 l_position = {{ l_width / 4, l_height / 4 }};
+        l_err = l_kern_insert_image.setArg( 0, l_ocl_bgr_img );                 CL_ERR_E( l_err );
+        l_err = l_kern_insert_image.setArg( 1, l_ocl_small_img );               CL_ERR_E( l_err );
+        l_err = l_kern_insert_image.setArg( 2, l_position );                    CL_ERR_E( l_err );
+        l_kern_insert_image.setSVMPointers( { l_ocl_bgr_img, l_ocl_bgr_img->m_data, l_ocl_small_img, l_ocl_small_img->m_data } );
+
+        std::set< int > l_vector_wgs;
+        for ( auto &l_wg : l_wg_list )
+        {
+            int l_wg_x = l_wg.first;
+            int l_wg_y = l_wg.second;
+            if ( ( size_t ) l_wg_x * l_wg_y > l_max_wg )
+            {
+                std::cout << "Work-group " << l_wg_x << "x" << l_wg_y << " is over limit " << l_max_wg << " of device, skipped." << std::endl;
+                continue;
+            }
+
+            // bytes read and written by kernel, descriptors are neglected
+            cl::NDRange l_local( l_wg_x, l_wg_y );
+            cl::NDRange l_global = bench_range( l_width, l_height, l_wg_x, l_wg_y );
+            l_err = l_bench.run( "rotate_bgr", l_kern_rotate_bgr, l_width, l_height,
+                                 l_global, l_local, l_pixels, l_pixels * 8 );   CL_ERR_E( l_err );
+            l_err = l_bench.run( "convert_bgr_to_bw", l_kern_convert_bgr_to_bw, l_width, l_height,
+                                 l_global, l_local, l_pixels, l_pixels * 5 );   CL_ERR_E( l_err );
+            l_err = l_bench.run( "create_chessboard", l_kern_create_chessboard, l_width, l_height,
+                                 l_global, l_local, l_pixels, l_pixels * 4 );   CL_ERR_E( l_err );
+
+            cl::NDRange l_small_global = bench_range( l_small_width, l_small_height, l_wg_x, l_wg_y );
+            l_err = l_bench.run( "create_transparent_dot", l_kern_transparent_dot, l_small_width, l_small_height,
+                                 l_small_global, l_local, l_small_pixels, l_small_pixels * 4 );  CL_ERR_E( l_err );
+            l_err = l_bench.run( "insert_image", l_kern_insert_image, l_small_width, l_small_height,
+                                 l_small_global, l_local, l_small_pixels, l_small_pixels * 12 );  CL_ERR_E( l_err );
+
+            // vector has work-group of the same size, every size only once
+            int l_wg_size = l_wg_x * l_wg_y;
+            if ( l_vector_wgs.insert( l_wg_size ).second )
+            {
+                l_err = l_bench.run( "mult_vect", l_kern_mult_vect, l_pixels, 1,
+                                     cl::NDRange( ( l_pixels + l_wg_size - 1 ) / l_wg_size * l_wg_size ),
+                                     cl::NDRange( l_wg_size ), l_pixels, l_pixels * 8 );  CL_ERR_E( l_err );
+            }
+        }
+
+        ocl_svm_free( l_vector );
+        bench_free( l_ocl_bgr_img );
+        bench_free( l_ocl_bw_img );
+        bench_free( l_ocl_small_img );
+    }
+
+    // table of results
+    std::cout << std::fixed << std::setprecision( 3 );
+    std::cout << "\n" << std::left << std::setw( 24 ) << "kernel" << std::right << std::setw( 12 ) << "size"
+              << std::setw( 8 ) << "wg" << std::setw( 12 ) << "median ms" << std::setw( 12 ) << "min ms"
+              << std::setw( 10 ) << "GB/s" << std::setw( 12 ) << "Mpixel/s" << std::endl;
+    for ( const OCLBenchResult &l_res : l_bench.results() )
+    {
+        std::cout << std::left << std::setw( 24 ) << l_res.m_kernel << std::right
+                  << std::setw( 12 ) << ( std::to_string( l_res.m_width ) + "x" + std::to_string( l_res.m_height ) )
+                  << std::setw( 8 ) << ( std::to_string( l_res.m_wg_x ) + "x" + std::to_string( l_res.m_wg_y ) )
+                  << std::setw( 12 ) << l_res.m_median_ms << std::setw( 12 ) << l_res.m_min_ms
+                  << std::setw( 10 ) << l_res.gbps() << std::setw( 12 ) << l_res.mpixs() << std::endl;
+    }
+
+    // the fastest work-group of every kernel and size on roofline
+    if ( l_profile_name )
+    {
+        OCLRoofline l_roofline( l_profile );
+        const std::vector< OCLBenchResult > &l_results = l_bench.results();
+        for ( size_t i = 0; i < l_results.size(); i++ )
+        {
+            const OCLBenchResult &l_res = l_results[ i ];
+            bool l_best = true;
+            for ( size_t j = 0; j < l_results.size(); j++ )
+            {
+                const OCLBenchResult &l_other = l_results[ j ];
+                if ( l_other.m_kernel == l_res.m_kernel && l_other.m_width == l_res.m_width && l_other.m_height == l_res.m_height &&
+                     ( l_other.m_median_ms < l_res.m_median_ms || ( l_other.m_median_ms == l_res.m_median_ms && j < i ) ) )
+                {
+                    l_best = false;
+                }
+            }
+            if ( !l_best ) continue;
+
+            for ( const KernelOps &l_ops : g_kernel_ops )
+            {
+                if ( l_res.m_kernel != l_ops.m_kernel ) continue;
+                std::string l_name = l_res.m_kernel + " " + std::to_string( l_res.m_width ) + "x" + std::to_string( l_res.m_height )
+                                   + " wg " + std::to_string( l_res.m_wg_x ) + "x" + std::to_string( l_res.m_wg_y );
+                l_roofline.add( l_name, l_res.m_bytes, l_ops.m_ops * l_res.m_items, l_res.m_median_ms, l_ops.m_float );
+            }
+        }
+        std::cout << std::endl;
+        l_roofline.report( std::cout );
+    }
+
+    if ( l_output )
+    {
+        std::ofstream l_csv( std::string( l_output ) + ".csv" );
+        l_bench.write_csv( l_csv );
+        std::ofstream l_json( std::string( l_output ) + ".json" );
+        l_bench.write_json( l_json );
+        std::cout << "\nResults written into " << l_output << ".csv and " << l_output << ".json." << std::endl;
+    }
+
+    if ( l_baseline )
+    {
+        std::cout << std::endl;
+        if ( l_bench.compare( l_base, l_tolerance / 100, std::cout ) > 0 )
+        {
+            exit( EXIT_FAILURE );
+        }
+    }
+}
@@ -0,0 +1,204 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_bench.cpp
+ * @brief Benchmark of kernels timed by profiling events.
+ *
+ * @details
+ * Source file for class @ref OCLBench.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+#include "ocl_utils.h"
+#include "ocl_bench.h"
+
+// separators of CSV and quotes of JSON must not be in device name
+static std::string bench_name( std::string t_name )
+{
+    std::replace( t_name.begin(), t_name.end(), ',', ' ' );
+    std::replace( t_name.begin(), t_name.end(), '"', '\'' );
+    return t_name;
+}
+
+/// @copydoc OCLBench::OCLBench
+OCLBench::OCLBench( int t_warmup, int t_repeat ) : m_warmup( std::max( 0, t_warmup ) ), m_repeat( std::max( 1, t_repeat ) )
+{
+    cl_int l_err;
+
+    cl::Device l_device = cl::Device::getDefault();
+    m_device = bench_name( l_device.getInfo< CL_DEVICE_NAME >() );
+    m_queue = cl::CommandQueue( cl::Context::getDefault(), l_device, CL_QUEUE_PROFILING_ENABLE, &l_err );  CL_ERR_C( l_err );
+}
+
+/// @copydoc OCLBench::run
+cl_int OCLBench::run( const std::string &t_name, cl::Kernel &t_kernel, int t_width, int t_height,
+                      const cl::NDRange &t_global, const cl::NDRange &t_local, size_t t_items, size_t t_bytes )
+{
+    cl_int l_err;
+
+    // caches, clocks and lazy allocations of driver
+    for ( int w = 0; w < m_warmup; w++ )
+    {
+        l_err = m_queue.enqueueNDRangeKernel( t_kernel, cl::NullRange, t_global, t_local );  CL_ERR_R( l_err );
+    }
+    l_err = m_queue.finish();                                                   CL_ERR_R( l_err );
+
+    std::vector< cl::Event > l_events( m_repeat );
+    for ( int r = 0; r < m_repeat; r++ )
+    {
+        l_err = m_queue.enqueueNDRangeKernel( t_kernel, cl::NullRange, t_global, t_local, nullptr, &l_events[ r ] );  CL_ERR_R( l_err );
+    }
+    l_err = m_queue.finish();                                                   CL_ERR_R( l_err );
+
+    std::vector< double > l_ms( m_repeat );
+    double l_sum = 0;
+    for ( int r = 0; r < m_repeat; r++ )
+    {
+        cl_ulong l_start = l_events[ r ].getProfilingInfo< CL_PROFILING_COMMAND_START >();
+        cl_ulong l_end = l_events[ r ].getProfilingInfo< CL_PROFILING_COMMAND_END >();
+        l_ms[ r ] = ( l_end - l_start ) / 1e6;
+        l_sum += l_ms[ r ];
+    }
+    std::sort( l_ms.begin(), l_ms.end() );
+
+    size_t l_wg_x = t_local.dimensions() > 0 ? t_local[ 0 ] : 0;
+    size_t l_wg_y = t_local.dimensions() > 1 ? t_local[ 1 ] : 1;
+
+    OCLBenchResult l_res;
+    l_res.m_device = m_device;
+    l_res.m_kernel = t_name;
+    l_res.m_width = t_width;
+    l_res.m_height = t_height;
+    l_res.m_wg_x = l_wg_x;
+    l_res.m_wg_y = l_wg_y;
+    l_res.m_items = t_items;
+    l_res.m_bytes = t_bytes;
+    l_res.m_repeat = m_repeat;
+    l_res.m_min_ms = l_ms.front();
+    l_res.m_median_ms = m_repeat % 2 ? l_ms[ m_repeat / 2 ] : ( l_ms[ m_repeat / 2 - 1 ] + l_ms[ m_repeat / 2 ] ) / 2;
+    l_res.m_mean_ms = l_sum / m_repeat;
+    m_results.push_back( l_res );
+
+    return CL_SUCCESS;
+}
+
+/// @copydoc OCLBench::write_csv
+void OCLBench::write_csv( std::ostream &t_stream ) const
+{
+    t_stream << "device,kernel,width,height,wg_x,wg_y,items,bytes,repeat,min_ms,median_ms,mean_ms,gbps,mpixs" << std::endl;
+    t_stream << std::fixed << std::setprecision( 4 );
+    for ( const OCLBenchResult &l_res : m_results )
+    {
+        t_stream << l_res.m_device << "," << l_res.m_kernel << ","
+                 << l_res.m_width << "," << l_res.m_height << "," << l_res.m_wg_x << "," << l_res.m_wg_y << ","
+                 << l_res.m_items << "," << l_res.m_bytes << "," << l_res.m_repeat << ","
+                 << l_res.m_min_ms << "," << l_res.m_median_ms << "," << l_res.m_mean_ms << ","
+                 << l_res.gbps() << "," << l_res.mpixs() << std::endl;
+    }
+}
+
+/// @copydoc OCLBench::write_json
+void OCLBench::write_json( std::ostream &t_stream ) const
+{
+    t_stream << std::fixed << std::setprecision( 4 );
+    t_stream << "[" << std::endl;
+    for ( size_t i = 0; i < m_results.size(); i++ )
+    {
+        const OCLBenchResult &l_res = m_results[ i ];
+        t_stream << "  { \"device\": \"" << l_res.m_device << "\", \"kernel\": \"" << l_res.m_kernel << "\", "
+                 << "\"width\": " << l_res.m_width << ", \"height\": " << l_res.m_height << ", "
+                 << "\"wg_x\": " << l_res.m_wg_x << ", \"wg_y\": " << l_res.m_wg_y << ", "
+                 << "\"items\": " << l_res.m_items << ", \"bytes\": " << l_res.m_bytes << ", \"repeat\": " << l_res.m_repeat << ", "
+                 << "\"min_ms\": " << l_res.m_min_ms << ", \"median_ms\": " << l_res.m_median_ms << ", \"mean_ms\": " << l_res.m_mean_ms << ", "
+                 << "\"gbps\": " << l_res.gbps() << ", \"mpixs\": " << l_res.mpixs() << " }"
+                 << ( i + 1 < m_results.size() ? "," : "" ) << std::endl;
+    }
+    t_stream << "]" << std::endl;
+}
+
+/// @copydoc OCLBench::read_csv
+std::vector< OCLBenchResult > OCLBench::read_csv( std::istream &t_stream )
+{
+    std::vector< OCLBenchResult > l_results;
+    std::string l_line;
+    while ( std::getline( t_stream, l_line ) )
+    {
+        std::vector< std::string > l_cols;
+        std::stringstream l_ss( l_line );
+        std::string l_col;
+        while ( std::getline( l_ss, l_col, ',' ) )
+        {
+            l_cols.push_back( l_col );
+        }
+
+        // header and broken lines are skipped
+        if ( l_cols.size() < 12 || l_cols[ 0 ] == "device" ) continue;
+
+        OCLBenchResult l_res;
+        l_res.m_device = l_cols[ 0 ];
+        l_res.m_kernel = l_cols[ 1 ];
+        l_res.m_width = atoi( l_cols[ 2 ].c_str() );
+        l_res.m_height = atoi( l_cols[ 3 ].c_str() );
+        l_res.m_wg_x = atoi( l_cols[ 4 ].c_str() );
+        l_res.m_wg_y = atoi( l_cols[ 5 ].c_str() );
+        l_res.m_items = atoll( l_cols[ 6 ].c_str() );
+        l_res.m_bytes = atoll( l_cols[ 7 ].c_str() );
+        l_res.m_repeat = atoi( l_cols[ 8 ].c_str() );
+        l_res.m_min_ms = atof( l_cols[ 9 ].c_str() );
+        l_res.m_median_ms = atof( l_cols[ 10 ].c_str() );
+        l_res.m_mean_ms = atof( l_cols[ 11 ].c_str() );
+        l_results.push_back( l_res );
+    }
+    return l_results;
+}
+
+/// @copydoc OCLBench::compare
+int OCLBench::compare( const std::vector< OCLBenchResult > &t_baseline, double t_tolerance, std::ostream &t_stream ) const
+{
+    int l_regressions = 0;
+    int l_compared = 0;
+
+    t_stream << std::fixed << std::setprecision( 3 );
+    for ( const OCLBenchResult &l_res : m_results )
+    {
+        auto l_base = std::find_if( t_baseline.begin(), t_baseline.end(), [ & ] ( const OCLBenchResult &t_base )
+        {
+            return t_base.m_device == l_res.m_device && t_base.m_kernel == l_res.m_kernel &&
+                   t_base.m_width == l_res.m_width && t_base.m_height == l_res.m_height &&
+                   t_base.m_wg_x == l_res.m_wg_x && t_base.m_wg_y == l_res.m_wg_y;
+        } );
+        if ( l_base == t_baseline.end() || l_base->m_median_ms <= 0 ) continue;
+
+        l_compared++;
+        double l_ratio = l_res.m_median_ms / l_base->m_median_ms;
+        if ( l_ratio > 1 + t_tolerance )
+        {
+            l_regressions++;
+            t_stream << "REGRESSION " << l_res.m_kernel << " " << l_res.m_width << "x" << l_res.m_height
+                     << " wg " << l_res.m_wg_x << "x" << l_res.m_wg_y << ": "
+                     << l_base->m_median_ms << " ms -> " << l_res.m_median_ms << " ms (+"
+                     << ( l_ratio - 1 ) * 100 << "%)" << std::endl;
+        }
+    }
+    t_stream << "Compared " << l_compared << " of " << m_results.size() << " results with baseline, "
+             << l_regressions << " regression(s) over " << t_tolerance * 100 << "%." << std::endl;
+
+    return l_regressions;
+}
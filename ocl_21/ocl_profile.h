@@ -0,0 +1,81 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_profile.h
+ * @brief Measured limits of device saved in JSON file.
+ *
+ * @details
+ * Header file for structure @ref OCLDeviceProfile.
+ *
+ * Profile is measured by program ocl_0 with option -c and it is saved
+ * as flat JSON object. Other programs load it and use bandwidth and
+ * compute throughput as ceilings, e.g. for roofline model.
+ * Values not measured on device are 0.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_PROFILE_H
+#define __OCL_PROFILE_H
+
+#include <string>
+#include <ostream>
+
+/**
+ * @anchor OCLDeviceProfile
+ * @brief Measured bandwidths, latencies and compute throughput of device.
+*/
+struct OCLDeviceProfile
+{
+    std::string m_device;           ///< Name of device.
+
+    double m_read_gbps = 0;         ///< Global memory, kernel reads.
+    double m_write_gbps = 0;        ///< Global memory, kernel writes.
+    double m_copy_gbps = 0;         ///< Global memory, kernel copies, read and write bytes.
+
+    double m_svm_coarse_gbps = 0;   ///< Coarse-grained SVM: host writes, kernel copies, host reads.
+    double m_svm_fine_gbps = 0;     ///< Fine-grained SVM: the same without map and unmap.
+
+    double m_launch_us = 0;         ///< Empty kernel, many launches and one finish.
+    double m_launch_finish_us = 0;  ///< Empty kernel, every launch waits for finish.
+
+    double m_h2d_gbps = 0;          ///< Copy from pageable host memory to device.
+    double m_d2h_gbps = 0;          ///< Copy from device to pageable host memory.
+    double m_h2d_pinned_gbps = 0;   ///< Copy from pinned host memory to device.
+    double m_d2h_pinned_gbps = 0;   ///< Copy from device to pinned host memory.
+
+    double m_float_gflops = 0;      ///< Float multiply-add, 2 operations each.
+    double m_int_giops = 0;         ///< Integer multiply-add, 2 operations each.
+
+    /// The highest measured bandwidth of global memory.
+    double peak_gbps() const;
+
+    /**
+     * @brief Profile is written as JSON.
+     * @param t_file_name Name of file.
+     * @return true when file was written.
+    */
+    bool save( const std::string &t_file_name ) const;
+
+    /**
+     * @brief Profile is read from JSON written by @ref save, missing values are 0.
+     * @param t_file_name Name of file.
+     * @return true when file was read.
+    */
+    bool load( const std::string &t_file_name );
+
+    /// Human readable table.
+    void print( std::ostream &t_stream ) const;
+};
+
+#endif // __OCL_PROFILE_H
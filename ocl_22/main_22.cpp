@@ -0,0 +1,280 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Replay of launches captured by OCL_CAPTURE=file.ocap from other demos.
+ * Kernels run again with the same ranges, arguments and input data,
+ * device times are compared with captured times and results with
+ * captured hashes. CPU device like PoCL is used by OCL_DEVICE_TYPE=CPU.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <fstream>
+#include <unistd.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <map>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_capture.h"
+
+#define CAPTURE_UNKNOWN     0xFFFFFFFFU
+
+// **************************************************************************
+// times and results of one kernel
+struct ReplayStats
+{
+    int m_launches = 0;
+    double m_captured_ms = 0;
+    double m_replay_ms = 0;
+    double m_replay_min_ms = 1e30;
+    int m_checked = 0;
+    int m_mismatches = 0;
+};
+
+// range of captured launch
+cl::NDRange make_range( int t_dims, const size_t *t_sizes )
+{
+    if ( t_dims == 1 ) return cl::NDRange( t_sizes[ 0 ] );
+    if ( t_dims == 2 ) return cl::NDRange( t_sizes[ 0 ], t_sizes[ 1 ] );
+    return cl::NDRange( t_sizes[ 0 ], t_sizes[ 1 ], t_sizes[ 2 ] );
+}
+
+// **************************************************************************
+int main( int t_narg, char **t_args )
+{
+    const char *l_spv_name = nullptr;
+    int l_repeat = 1;
+    int l_device = 0;
+    bool l_verbose = false;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "r:g:p:v" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 'r': l_repeat = std::max( 1, atoi( optarg ) ); break;
+        case 'g': l_device = std::max( 0, atoi( optarg ) ); break;
+        case 'p': l_spv_name = optarg; break;
+        case 'v': l_verbose = true; break;
+        default:
+            break;
+        }
+    }
+    if ( optind >= t_narg )
+    {
+        std::cerr << "Usage: " << t_args[ 0 ] << " [-r repeat] [-g device] [-p kernel.spv] [-v] capture.ocap" << std::endl;
+        std::cerr << "  -r  every launch is repeated, the fastest time is reported too" << std::endl;
+        std::cerr << "  -g  index of device, OCL_DEVICE_TYPE=CPU selects CPU devices" << std::endl;
+        std::cerr << "  -p  SPIR-V for programs captured without it" << std::endl;
+        std::cerr << "  -v  every launch is printed" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    OCLCaptureFile l_capture;
+    if ( !l_capture.load( t_args[ optind ] ) )
+    {
+        std::cerr << "Unable to read capture " << t_args[ optind ] << "!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+    std::cout << "Capture " << t_args[ optind ] << ": " << l_capture.m_launches.size() << " launches, "
+              << l_capture.m_programs.size() << " programs, " << l_capture.m_data.size() << " data blocks." << std::endl;
+
+    cl_int l_err;
+
+    l_err = ocl_init( 1, l_device );                                            CL_ERR_E( l_err );
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    // own queue with profiling for device times
+    cl::CommandQueue l_queue( cl::Context::getDefault(), cl::Device::getDefault(), CL_QUEUE_PROFILING_ENABLE, &l_err );  CL_ERR_E( l_err );
+
+    // programs are built from captured SPIR-V
+    std::vector< cl::Program > l_programs;
+    for ( std::vector< char > &l_spirv : l_capture.m_programs )
+    {
+        cl::Program l_program;
+        if ( !l_spirv.empty() )
+        {
+            l_program = cl::Program( cl::Context::getDefault(), l_spirv, true, &l_err );  CL_ERR_C( l_err );
+        }
+        else if ( l_spv_name )
+        {
+            l_program = ocl_load_program( l_spv_name );
+        }
+        if ( l_program() == nullptr )
+        {
+            std::cerr << "Program " << l_programs.size() << " not built, use -p kernel.spv!" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+        l_programs.push_back( l_program );
+    }
+
+    std::cout << "Programs built.\n" << std::endl;
+
+    std::map< std::pair< unsigned, std::string >, cl::Kernel > l_kernels;
+    std::map< unsigned, char * > l_buffers;
+    std::vector< OCLImage * > l_descs;
+    std::map< std::string, ReplayStats > l_stats;
+    int l_skipped = 0;
+
+    for ( int r = 0; r < l_repeat; r++ )
+    {
+        for ( size_t i = 0; i < l_capture.m_launches.size(); i++ )
+        {
+            const OCLCapturedLaunch &l_launch = l_capture.m_launches[ i ];
+
+            // launch with pointer unknown in capture can not be repeated
+            bool l_known = true;
+            for ( const OCLCapturedArg &l_arg : l_launch.m_args )
+            {
+                if ( l_arg.m_kind != 'V' && l_arg.m_buffer == CAPTURE_UNKNOWN ) l_known = false;
+            }
+            if ( !l_known || l_launch.m_program >= l_programs.size() )
+            {
+                if ( r == 0 ) l_skipped++;
+                continue;
+            }
+
+            // buffers are allocated once and inputs are restored before every launch
+            bool l_restored = true;
+            for ( const OCLCapturedBuffer &l_buffer : l_launch.m_buffers )
+            {
+                char *&l_ptr = l_buffers[ l_buffer.m_id ];
+                if ( l_ptr == nullptr )
+                {
+                    l_ptr = ocl_svm_malloc< char >( l_buffer.m_size );
+                    if ( l_ptr == nullptr )
+                    {
+                        std::cerr << "Unable to allocate " << l_buffer.m_size << " bytes!" << std::endl;
+                        exit( EXIT_FAILURE );
+                    }
+                    memset( l_ptr, 0, l_buffer.m_size );
+                }
+                auto l_data = l_capture.m_data.find( l_buffer.m_hash_in );
+                if ( l_data != l_capture.m_data.end() && l_data->second.size() == l_buffer.m_size )
+                {
+                    memcpy( l_ptr, l_data->second.data(), l_buffer.m_size );
+                }
+                else
+                {
+                    l_restored = false;
+                }
+            }
+
+            cl::Kernel &l_kernel = l_kernels[ { l_launch.m_program, l_launch.m_kernel } ];
+            if ( l_kernel() == nullptr )
+            {
+                l_kernel = cl::Kernel( l_programs[ l_launch.m_program ], l_launch.m_kernel.c_str(), &l_err );  CL_ERR_E( l_err );
+            }
+
+            // arguments in order of kernel header, every image has own descriptor
+            std::vector< void * > l_svm_ptrs;
+            for ( cl_uint a = 0; a < l_launch.m_args.size(); a++ )
+            {
+                const OCLCapturedArg &l_arg = l_launch.m_args[ a ];
+                if ( l_arg.m_kind == 'V' )
+                {
+                    l_err = l_kernel.setArg( a, l_arg.m_value.size(), l_arg.m_value.data() );
+                }
+                else if ( l_arg.m_kind == 'B' )
+                {
+                    void *l_ptr = l_buffers[ l_arg.m_buffer ] + l_arg.m_offset;
+                    l_err = l_kernel.setArg( a, l_ptr );
+                    l_svm_ptrs.push_back( l_buffers[ l_arg.m_buffer ] );
+                }
+                else
+                {
+                    if ( l_descs.size() <= a ) l_descs.resize( a + 1, nullptr );
+                    if ( l_descs[ a ] == nullptr ) l_descs[ a ] = ocl_svm_malloc< OCLImage >();
+                    l_descs[ a ]->m_size.x = l_arg.m_width;
+                    l_descs[ a ]->m_size.y = l_arg.m_height;
+                    l_descs[ a ]->m_data = l_buffers[ l_arg.m_buffer ] + l_arg.m_offset;
+                    l_err = l_kernel.setArg( a, l_descs[ a ] );
+                    l_svm_ptrs.push_back( l_descs[ a ] );
+                    l_svm_ptrs.push_back( l_buffers[ l_arg.m_buffer ] );
+                }
+                CL_ERR_E( l_err );
+            }
+            l_kernel.setSVMPointers( l_svm_ptrs );
+
+            cl::Event l_event;
+            cl::NDRange l_local = l_launch.m_local[ 0 ] ? make_range( l_launch.m_dims, l_launch.m_local ) : cl::NullRange;
+            l_err = l_queue.enqueueNDRangeKernel( l_kernel, cl::NullRange, make_range( l_launch.m_dims, l_launch.m_global ),
+                                                  l_local, nullptr, &l_event );  CL_ERR_E( l_err );
+            l_err = l_queue.finish();                                           CL_ERR_E( l_err );
+
+            double l_ms = ( l_event.getProfilingInfo< CL_PROFILING_COMMAND_END >() -
+                            l_event.getProfilingInfo< CL_PROFILING_COMMAND_START >() ) / 1e6;
+
+            // results can be compared only when all inputs were restored
+            bool l_mismatch = false;
+            if ( l_restored )
+            {
+                for ( const OCLCapturedBuffer &l_buffer : l_launch.m_buffers )
+                {
+                    if ( ocl_capture_hash( l_buffers[ l_buffer.m_id ], l_buffer.m_size ) != l_buffer.m_hash_out ) l_mismatch = true;
+                }
+            }
+
+            ReplayStats &l_kernel_stats = l_stats[ l_launch.m_kernel ];
+            l_kernel_stats.m_launches++;
+            l_kernel_stats.m_captured_ms += l_launch.m_exec_ns / 1e6;
+            l_kernel_stats.m_replay_ms += l_ms;
+            l_kernel_stats.m_replay_min_ms = std::min( l_kernel_stats.m_replay_min_ms, l_ms );
+            l_kernel_stats.m_checked += l_restored;
+            l_kernel_stats.m_mismatches += l_mismatch;
+
+            if ( l_verbose )
+            {
+                std::cout << "[" << std::setw( 5 ) << i << "] " << std::left << std::setw( 24 ) << l_launch.m_kernel << std::right
+                          << std::fixed << std::setprecision( 3 )
+                          << " captured " << std::setw( 8 ) << l_launch.m_exec_ns / 1e6 << " ms"
+                          << "  replay " << std::setw( 8 ) << l_ms << " ms"
+                          << ( l_restored ? ( l_mismatch ? "  MISMATCH" : "  ok" ) : "" ) << std::endl;
+            }
+        }
+    }
+
+    if ( l_skipped )
+    {
+        std::cout << l_skipped << " launches skipped, their SVM pointers were not from ocl_svm_malloc." << std::endl;
+    }
+
+    // captured time is 0, when capture had queue without profiling
+    std::cout << std::endl << std::left << std::setw( 24 ) << "kernel" << std::right
+              << std::setw( 10 ) << "launches" << std::setw( 14 ) << "captured ms" << std::setw( 12 ) << "replay ms"
+              << std::setw( 10 ) << "min ms" << std::setw( 10 ) << "checked" << std::setw( 12 ) << "mismatches" << std::endl;
+    int l_mismatches = 0;
+    for ( auto &l_item : l_stats )
+    {
+        const ReplayStats &l_kernel_stats = l_item.second;
+        std::cout << std::left << std::setw( 24 ) << l_item.first << std::right << std::fixed << std::setprecision( 3 )
+                  << std::setw( 10 ) << l_kernel_stats.m_launches
+                  << std::setw( 14 ) << l_kernel_stats.m_captured_ms / l_kernel_stats.m_launches
+                  << std::setw( 12 ) << l_kernel_stats.m_replay_ms / l_kernel_stats.m_launches
+                  << std::setw( 10 ) << l_kernel_stats.m_replay_min_ms
+                  << std::setw( 10 ) << l_kernel_stats.m_checked
+                  << std::setw( 12 ) << l_kernel_stats.m_mismatches << std::endl;
+        l_mismatches += l_kernel_stats.m_mismatches;
+    }
+
+    for ( auto &l_buffer : l_buffers ) ocl_svm_free( l_buffer.second );
+    for ( OCLImage *l_desc : l_descs ) ocl_svm_free( l_desc );
+
+    return l_mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -27,64 +27,18 @@
 #include <CL/opencl.hpp> 
 
 #include "ocl_utils.h"
+#include "ocl_launch.h"
 #include "ocl_image.h"
 #include "ocl_svm_mat_allocator.h"
+#include "ocl_svm_image.h"
 
 #define KERNEL_SPV      "kernel_3.spv"
-#define KERNEL_PREFIX   "gpu_"
 
 // **************************************************************************
-// gpu_ function for kernel.
-// Kernel name is automatically created from this function name
-// removing prefix gpu_.
-// 
 // BGR colors rotation.
 // Kernel header from kernel*.cl:
 //__kernel void rotate_bgr(            __global OCLImage *t_ocl_img )
-cl_int gpu_rotate_bgr( cl::Program &t_program,  OCLImage *t_ocl_img )
-{
-    cl_int l_err;
-
-    // removing prefix gpu_
-    std::string l_kern_name( __FUNCTION__ );
-    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
-    {
-        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
-    }
-
-    // select the kernel from opencl program
-    cl::Kernel l_kern_rotate_bgr( t_program, l_kern_name.c_str(), &l_err );      CL_ERR_R( l_err );
-
-    // set kernel arguments
-    l_err = l_kern_rotate_bgr.setArg( 0, t_ocl_img );                            CL_ERR_R( l_err );
-
-    // list of SVM pointers for data synchronization
-    l_kern_rotate_bgr.setSVMPointers( { t_ocl_img, t_ocl_img->m_data } );
-
-    // get default Queue
-    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
-
-    // size of workgroup, should be multiple of 64, so 256 is OK 
-    int l_wg_size_x = 16;
-    int l_wg_size_y = 16;
-    // global range 
-    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
-    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
-    
-    // Submitting kernel for execution
-    l_err = defQueue.enqueueNDRangeKernel( l_kern_rotate_bgr, 
-            // offset
-            cl::NDRange( 0, 0 ), 
-            // global range
-            cl::NDRange( l_gr_size_x, l_gr_size_y ), 
-            // work-group
-            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
-    
-    // waiting for completion
-    defQueue.finish();
-
-    return CL_SUCCESS;
-}
+OCL_KERNEL( rotate_bgr, OCLImage * );
 
 // **************************************************************************
 #define IMG_SIZEX   432
@@ -112,6 +66,9 @@ int main( int t_narg, char **t_args )
     SVMMatAllocator svmallocator;
     cv::Mat::setDefaultAllocator( &svmallocator );
 
+    // pool of images must be destroyed before allocator
+    SVMImagePool l_pool;
+
     // creating empty image
     cv::Mat l_cv_img( IMG_SIZEY, IMG_SIZEX, CV_8UC4 );
 
@@ -158,17 +115,14 @@ int main( int t_narg, char **t_args )
         }
     }
 
-    // OCLImage for kernel
-    OCLImage *l_ocl_img = ocl_svm_malloc< OCLImage >();
-    l_ocl_img->m_size.x = l_cv_img.size().width;
-    l_ocl_img->m_size.y = l_cv_img.size().height;
-    l_ocl_img->m_data = l_cv_img.data;
+    // OCLImage for kernel, descriptor is released together with image
+    SVMImage l_img = l_pool.adopt( l_cv_img );
 
     // show loaded/created image
     cv::imshow( "B-G-R Image", l_cv_img );
 
     // rotate color
-    gpu_rotate_bgr( l_program, l_ocl_img );
+    launch< rotate_bgr >( l_program, l_img.ocl(), l_img.ocl() );
 
     // show new image
     cv::imshow( "B-G-R Image & Color Rotation", l_cv_img );
@@ -0,0 +1,428 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_capture.cpp
+ * @brief Capture of kernel launches into file for offline replay.
+ *
+ * @details
+ * Source file for classes @ref OCLCaptureLaunch and @ref OCLCaptureFile
+ * and functions @ref ocl_capture_start and @ref ocl_capture_stop.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <mutex>
+#include <set>
+
+#include "ocl_utils.h"
+#include "ocl_capture.h"
+
+#define CAPTURE_HEADER      "OCLCAP1\n"
+// id of pointer not allocated by ocl_svm_malloc
+#define CAPTURE_UNKNOWN     0xFFFFFFFFU
+
+std::atomic< bool > g_ocl_capture_on{ false };
+
+// SVM allocation known from hooks
+struct CaptureAlloc
+{
+    size_t m_size;
+    unsigned m_id;
+};
+
+static std::mutex g_capture_mutex;
+static std::ofstream g_capture_file;
+static bool g_capture_data = true;
+static std::map< const char *, CaptureAlloc > g_capture_allocs;
+static unsigned g_capture_next_id = 0;
+static std::set< unsigned long long > g_capture_stored;
+static std::map< cl_program, unsigned > g_capture_programs;
+
+// hooks of ocl_utils are chained, previous hooks are called too
+static OCLSVMHooks g_capture_prev = { nullptr, nullptr };
+static bool g_capture_hooked = false;
+
+// values are appended in byte order of host
+template< typename T >
+static void capture_put( std::string &t_record, const T &t_value )
+{
+    t_record.append( ( const char * ) &t_value, sizeof( T ) );
+}
+
+static void capture_put_str( std::string &t_record, const std::string &t_str )
+{
+    capture_put< unsigned >( t_record, t_str.size() );
+    t_record.append( t_str );
+}
+
+// hook of ocl_svm_malloc
+static void capture_alloc( void *t_ptr, size_t t_size )
+{
+    if ( ocl_capture_on() )
+    {
+        std::lock_guard< std::mutex > l_lock( g_capture_mutex );
+        g_capture_allocs[ ( const char * ) t_ptr ] = { t_size, g_capture_next_id++ };
+    }
+    if ( g_capture_prev.m_alloc ) g_capture_prev.m_alloc( t_ptr, t_size );
+}
+
+// hook of ocl_svm_free
+static void capture_free( void *t_ptr )
+{
+    if ( ocl_capture_on() )
+    {
+        std::lock_guard< std::mutex > l_lock( g_capture_mutex );
+        g_capture_allocs.erase( ( const char * ) t_ptr );
+    }
+    if ( g_capture_prev.m_free ) g_capture_prev.m_free( t_ptr );
+}
+
+/// @copydoc ocl_capture_hash
+unsigned long long ocl_capture_hash( const void *t_data, size_t t_size )
+{
+    const unsigned long long l_prime = 0x100000001B3ULL;
+    unsigned long long l_hash = 0xCBF29CE484222325ULL ^ t_size;
+
+    const char *l_bytes = ( const char * ) t_data;
+    size_t i = 0;
+    for ( ; i + 8 <= t_size; i += 8 )
+    {
+        unsigned long long l_word;
+        memcpy( &l_word, l_bytes + i, 8 );
+        l_hash = ( l_hash ^ l_word ) * l_prime;
+    }
+    for ( ; i < t_size; i++ )
+    {
+        l_hash = ( l_hash ^ ( unsigned char ) l_bytes[ i ] ) * l_prime;
+    }
+    return l_hash;
+}
+
+/// @copydoc ocl_capture_start
+bool ocl_capture_start( const std::string &t_file_name, bool t_data )
+{
+    std::lock_guard< std::mutex > l_lock( g_capture_mutex );
+
+    g_capture_file.close();
+    g_capture_file.clear();
+    g_capture_file.open( t_file_name, std::ios::binary );
+    if ( !g_capture_file )
+    {
+        std::cerr << "Unable to create capture '" << t_file_name << "'!" << std::endl;
+        return false;
+    }
+    g_capture_file.write( CAPTURE_HEADER, strlen( CAPTURE_HEADER ) );
+
+    g_capture_data = t_data;
+    g_capture_allocs.clear();
+    g_capture_stored.clear();
+    g_capture_programs.clear();
+
+    if ( !g_capture_hooked )
+    {
+        g_capture_prev = g_ocl_svm_hooks;
+        g_ocl_svm_hooks = { capture_alloc, capture_free };
+        g_capture_hooked = true;
+    }
+    g_ocl_capture_on.store( true, std::memory_order_relaxed );
+    return true;
+}
+
+/// @copydoc ocl_capture_stop
+bool ocl_capture_stop()
+{
+    std::lock_guard< std::mutex > l_lock( g_capture_mutex );
+    if ( !ocl_capture_on() ) return true;
+    g_ocl_capture_on.store( false, std::memory_order_relaxed );
+
+    bool l_good = g_capture_file.good();
+    g_capture_file.close();
+    return l_good;
+}
+
+/// @copydoc OCLCaptureLaunch::OCLCaptureLaunch
+OCLCaptureLaunch::OCLCaptureLaunch( const cl::Program &t_program, const char *t_name, const cl::NDRange &t_global, const cl::NDRange &t_local )
+    : m_num_args( 0 )
+{
+    unsigned l_program_id;
+    {
+        std::lock_guard< std::mutex > l_lock( g_capture_mutex );
+        auto l_found = g_capture_programs.find( t_program() );
+        if ( l_found != g_capture_programs.end() )
+        {
+            l_program_id = l_found->second;
+        }
+        else
+        {
+            // SPIR-V of program, it is empty for program not built from IL
+            l_program_id = g_capture_programs.size();
+            g_capture_programs[ t_program() ] = l_program_id;
+            auto l_il = t_program.getInfo< CL_PROGRAM_IL >();
+
+            std::string l_record( 1, 'P' );
+            capture_put< unsigned >( l_record, l_program_id );
+            capture_put< unsigned long long >( l_record, l_il.size() );
+            l_record.append( ( const char * ) l_il.data(), l_il.size() );
+            g_capture_file.write( l_record.data(), l_record.size() );
+        }
+    }
+
+    capture_put< unsigned >( m_record, l_program_id );
+    capture_put_str( m_record, t_name );
+    capture_put< unsigned >( m_record, t_global.dimensions() );
+    for ( int i = 0; i < 3; i++ )
+    {
+        capture_put< unsigned long long >( m_record, i < ( int ) t_global.dimensions() ? t_global.get()[ i ] : 1 );
+    }
+    for ( int i = 0; i < 3; i++ )
+    {
+        capture_put< unsigned long long >( m_record, i < ( int ) t_local.dimensions() ? t_local.get()[ i ] : 0 );
+    }
+}
+
+// buffer of pointer is added once, its content is hashed and stored
+unsigned OCLCaptureLaunch::add_buffer( const void *t_ptr, size_t &t_offset )
+{
+    static bool s_warned = false;
+    const char *l_ptr = ( const char * ) t_ptr;
+    t_offset = 0;
+
+    Buffer l_buffer = { CAPTURE_UNKNOWN, nullptr, 0, 0 };
+    {
+        std::lock_guard< std::mutex > l_lock( g_capture_mutex );
+        auto l_found = g_capture_allocs.upper_bound( l_ptr );
+        if ( l_found != g_capture_allocs.begin() )
+        {
+            l_found--;
+            if ( l_ptr < l_found->first + l_found->second.m_size )
+            {
+                l_buffer = { l_found->second.m_id, l_found->first, l_found->second.m_size, 0 };
+                t_offset = l_ptr - l_found->first;
+            }
+        }
+    }
+
+    if ( l_buffer.m_id == CAPTURE_UNKNOWN )
+    {
+        if ( !s_warned ) std::cerr << "Capture: SVM pointer not allocated by ocl_svm_malloc, its content is not captured!" << std::endl;
+        s_warned = true;
+        return CAPTURE_UNKNOWN;
+    }
+
+    for ( const Buffer &l_used : m_buffers )
+    {
+        if ( l_used.m_id == l_buffer.m_id ) return l_buffer.m_id;
+    }
+
+    l_buffer.m_hash_in = ocl_capture_hash( l_buffer.m_base, l_buffer.m_size );
+    m_buffers.push_back( l_buffer );
+
+    // the same content is stored only once
+    std::lock_guard< std::mutex > l_lock( g_capture_mutex );
+    if ( g_capture_data && g_capture_stored.insert( l_buffer.m_hash_in ).second )
+    {
+        std::string l_record( 1, 'D' );
+        capture_put< unsigned long long >( l_record, l_buffer.m_hash_in );
+        capture_put< unsigned long long >( l_record, l_buffer.m_size );
+        g_capture_file.write( l_record.data(), l_record.size() );
+        g_capture_file.write( ( const char * ) l_buffer.m_base, l_buffer.m_size );
+    }
+    return l_buffer.m_id;
+}
+
+/// @copydoc OCLCaptureLaunch::value
+void OCLCaptureLaunch::value( const void *t_ptr, size_t t_size )
+{
+    m_num_args++;
+    m_args += 'V';
+    capture_put< unsigned >( m_args, t_size );
+    m_args.append( ( const char * ) t_ptr, t_size );
+}
+
+/// @copydoc OCLCaptureLaunch::buffer
+void OCLCaptureLaunch::buffer( const void *t_ptr )
+{
+    size_t l_offset;
+    unsigned l_id = add_buffer( t_ptr, l_offset );
+
+    m_num_args++;
+    m_args += 'B';
+    capture_put< unsigned >( m_args, l_id );
+    capture_put< unsigned long long >( m_args, l_offset );
+}
+
+/// @copydoc OCLCaptureLaunch::image
+void OCLCaptureLaunch::image( const OCLImage *t_ocl_img )
+{
+    size_t l_offset;
+    unsigned l_id = add_buffer( t_ocl_img->m_data, l_offset );
+
+    m_num_args++;
+    m_args += 'I';
+    capture_put< unsigned >( m_args, l_id );
+    capture_put< unsigned long long >( m_args, l_offset );
+    capture_put< unsigned >( m_args, t_ocl_img->m_size.x );
+    capture_put< unsigned >( m_args, t_ocl_img->m_size.y );
+}
+
+/// @copydoc OCLCaptureLaunch::finish
+void OCLCaptureLaunch::finish( const cl::Event *t_event, long long t_host_ns )
+{
+    long long l_exec_ns = 0;
+    if ( t_event )
+    {
+        cl_int l_err;
+        cl_ulong l_start = t_event->getProfilingInfo< CL_PROFILING_COMMAND_START >( &l_err );
+        cl_ulong l_end = t_event->getProfilingInfo< CL_PROFILING_COMMAND_END >();
+        if ( l_err == CL_SUCCESS && l_end > l_start ) l_exec_ns = l_end - l_start;
+    }
+
+    std::string l_record( 1, 'L' );
+    l_record += m_record;
+    capture_put< unsigned >( l_record, m_num_args );
+    l_record += m_args;
+    capture_put< unsigned >( l_record, m_buffers.size() );
+    for ( const Buffer &l_buffer : m_buffers )
+    {
+        capture_put< unsigned >( l_record, l_buffer.m_id );
+        capture_put< unsigned long long >( l_record, l_buffer.m_size );
+        capture_put< unsigned long long >( l_record, l_buffer.m_hash_in );
+        capture_put< unsigned long long >( l_record, ocl_capture_hash( l_buffer.m_base, l_buffer.m_size ) );
+    }
+    capture_put< long long >( l_record, t_host_ns );
+    capture_put< long long >( l_record, l_exec_ns );
+
+    std::lock_guard< std::mutex > l_lock( g_capture_mutex );
+    if ( !ocl_capture_on() ) return;
+    g_capture_file.write( l_record.data(), l_record.size() );
+    g_capture_file.flush();
+}
+
+// values are read in byte order of host
+template< typename T >
+static bool capture_get( std::istream &t_stream, T &t_value )
+{
+    return ( bool ) t_stream.read( ( char * ) &t_value, sizeof( T ) );
+}
+
+static bool capture_get_bytes( std::istream &t_stream, std::vector< char > &t_bytes, unsigned long long t_size )
+{
+    t_bytes.resize( t_size );
+    return ( bool ) t_stream.read( t_bytes.data(), t_size );
+}
+
+// one launch record without type
+static bool capture_get_launch( std::istream &t_stream, OCLCapturedLaunch &t_launch )
+{
+    unsigned l_len, l_count;
+    unsigned long long l_value;
+    std::vector< char > l_name;
+
+    if ( !capture_get( t_stream, t_launch.m_program ) ) return false;
+    if ( !capture_get( t_stream, l_len ) || !capture_get_bytes( t_stream, l_name, l_len ) ) return false;
+    t_launch.m_kernel.assign( l_name.begin(), l_name.end() );
+    if ( !capture_get( t_stream, l_len ) ) return false;
+    t_launch.m_dims = l_len;
+    for ( int i = 0; i < 6; i++ )
+    {
+        if ( !capture_get( t_stream, l_value ) ) return false;
+        ( i < 3 ? t_launch.m_global[ i ] : t_launch.m_local[ i - 3 ] ) = l_value;
+    }
+
+    if ( !capture_get( t_stream, l_count ) ) return false;
+    t_launch.m_args.resize( l_count );
+    for ( OCLCapturedArg &l_arg : t_launch.m_args )
+    {
+        l_arg = OCLCapturedArg();
+        if ( !capture_get( t_stream, l_arg.m_kind ) ) return false;
+        if ( l_arg.m_kind == 'V' )
+        {
+            if ( !capture_get( t_stream, l_len ) || !capture_get_bytes( t_stream, l_arg.m_value, l_len ) ) return false;
+            continue;
+        }
+        if ( !capture_get( t_stream, l_arg.m_buffer ) || !capture_get( t_stream, l_value ) ) return false;
+        l_arg.m_offset = l_value;
+        if ( l_arg.m_kind == 'I' && ( !capture_get( t_stream, l_arg.m_width ) || !capture_get( t_stream, l_arg.m_height ) ) ) return false;
+        if ( l_arg.m_kind != 'B' && l_arg.m_kind != 'I' ) return false;
+    }
+
+    if ( !capture_get( t_stream, l_count ) ) return false;
+    t_launch.m_buffers.resize( l_count );
+    for ( OCLCapturedBuffer &l_buffer : t_launch.m_buffers )
+    {
+        if ( !capture_get( t_stream, l_buffer.m_id ) || !capture_get( t_stream, l_value ) ) return false;
+        l_buffer.m_size = l_value;
+        if ( !capture_get( t_stream, l_buffer.m_hash_in ) || !capture_get( t_stream, l_buffer.m_hash_out ) ) return false;
+    }
+    return capture_get( t_stream, t_launch.m_host_ns ) && capture_get( t_stream, t_launch.m_exec_ns );
+}
+
+/// @copydoc OCLCaptureFile::load
+bool OCLCaptureFile::load( const std::string &t_file_name )
+{
+    std::ifstream l_file( t_file_name, std::ios::binary );
+    char l_header[ sizeof( CAPTURE_HEADER ) - 1 ];
+    if ( !l_file.read( l_header, sizeof( l_header ) ) || memcmp( l_header, CAPTURE_HEADER, sizeof( l_header ) ) != 0 )
+    {
+        return false;
+    }
+
+    char l_type;
+    while ( capture_get( l_file, l_type ) )
+    {
+        unsigned l_id;
+        unsigned long long l_hash, l_size;
+        std::vector< char > l_bytes;
+        OCLCapturedLaunch l_launch;
+
+        if ( l_type == 'P' && capture_get( l_file, l_id ) && capture_get( l_file, l_size ) && capture_get_bytes( l_file, l_bytes, l_size ) )
+        {
+            if ( m_programs.size() <= l_id ) m_programs.resize( l_id + 1 );
+            m_programs[ l_id ].swap( l_bytes );
+        }
+        else if ( l_type == 'D' && capture_get( l_file, l_hash ) && capture_get( l_file, l_size ) && capture_get_bytes( l_file, l_bytes, l_size ) )
+        {
+            m_data[ l_hash ].swap( l_bytes );
+        }
+        else if ( l_type == 'L' && capture_get_launch( l_file, l_launch ) )
+        {
+            m_launches.push_back( l_launch );
+        }
+        else
+        {
+            std::cerr << "Capture '" << t_file_name << "' is truncated or damaged after "
+                      << m_launches.size() << " launches." << std::endl;
+            break;
+        }
+    }
+    return true;
+}
+
+// capture from environment variables OCL_CAPTURE and OCL_CAPTURE_DATA, file is closed at exit
+static struct CaptureFromEnv
+{
+    CaptureFromEnv()
+    {
+        const char *l_file_name = getenv( "OCL_CAPTURE" );
+        const char *l_data = getenv( "OCL_CAPTURE_DATA" );
+        if ( l_file_name && *l_file_name ) ocl_capture_start( l_file_name, !l_data || atoi( l_data ) != 0 );
+    }
+    ~CaptureFromEnv()
+    {
+        ocl_capture_stop();
+    }
+} g_capture_from_env;
@@ -0,0 +1,253 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_kernel_report.cpp
+ * @brief Resources of kernels, estimated occupancy and recommended work-group sizes.
+ *
+ * @details
+ * Source file for functions @ref ocl_kernel_resources, @ref ocl_kernel_occupancy,
+ * @ref ocl_kernel_local_size and @ref ocl_kernel_report.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+
+#include "ocl_utils.h"
+#include "ocl_kernel_report.h"
+
+// the largest recommended work-group
+#define KERNEL_REPORT_MAX_WG        256
+
+// the smallest width of recommended 2D work-group
+#define KERNEL_REPORT_MIN_WIDTH     16
+
+/// @copydoc ocl_kernel_resources
+OCLKernelResources ocl_kernel_resources( const cl::Kernel &t_kernel, const cl::Device &t_device )
+{
+    OCLKernelResources l_res;
+    l_res.m_name = t_kernel.getInfo< CL_KERNEL_FUNCTION_NAME >();
+    l_res.m_max_wg_size = t_kernel.getWorkGroupInfo< CL_KERNEL_WORK_GROUP_SIZE >( t_device );
+    l_res.m_preferred_multiple = std::max< size_t >( 1, t_kernel.getWorkGroupInfo< CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE >( t_device ) );
+    l_res.m_private_mem = t_kernel.getWorkGroupInfo< CL_KERNEL_PRIVATE_MEM_SIZE >( t_device );
+    l_res.m_local_mem = t_kernel.getWorkGroupInfo< CL_KERNEL_LOCAL_MEM_SIZE >( t_device );
+    auto l_compile = t_kernel.getWorkGroupInfo< CL_KERNEL_COMPILE_WORK_GROUP_SIZE >( t_device );
+    for ( int i = 0; i < 3; i++ ) l_res.m_compile_wg_size[ i ] = l_compile[ i ];
+    l_res.m_cu_capacity = std::max< size_t >( 1, t_device.getInfo< CL_DEVICE_MAX_WORK_GROUP_SIZE >() );
+    l_res.m_cu_local_mem = t_device.getInfo< CL_DEVICE_LOCAL_MEM_SIZE >();
+    return l_res;
+}
+
+// work-groups of kernel resident in one compute unit
+static size_t kernel_report_groups( const OCLKernelResources &t_res, size_t t_wg_size )
+{
+    if ( t_wg_size == 0 || t_wg_size > t_res.m_max_wg_size ) return 0;
+
+    // registers: kernel limit is lower than capacity of compute unit
+    size_t l_groups = t_res.m_max_wg_size / t_wg_size;
+
+    // local memory of work-groups must fit into compute unit
+    if ( t_res.m_local_mem > 0 ) l_groups = std::min< size_t >( l_groups, t_res.m_cu_local_mem / t_res.m_local_mem );
+    return l_groups;
+}
+
+/// @copydoc ocl_kernel_occupancy
+double ocl_kernel_occupancy( const OCLKernelResources &t_res, size_t t_wg_size )
+{
+    size_t l_groups = kernel_report_groups( t_res, t_wg_size );
+    if ( l_groups == 0 ) return 0;
+
+    // SIMD lanes of the last incomplete wavefront are idle
+    size_t l_lanes = ( t_wg_size + t_res.m_preferred_multiple - 1 ) / t_res.m_preferred_multiple * t_res.m_preferred_multiple;
+    double l_resident = std::min( 1.0, ( double ) l_groups * l_lanes / t_res.m_cu_capacity );
+    return l_resident * t_wg_size / l_lanes;
+}
+
+// recommended number of work-items in one work-group
+static size_t kernel_report_wg_size( const OCLKernelResources &t_res )
+{
+    size_t l_multiple = t_res.m_preferred_multiple;
+    size_t l_limit = std::min< size_t >( t_res.m_max_wg_size, KERNEL_REPORT_MAX_WG );
+    if ( l_limit < l_multiple ) return std::max< size_t >( 1, l_limit );
+
+    // the largest size with the best occupancy
+    size_t l_best = 0;
+    double l_best_occupancy = -1;
+    for ( size_t l_size = l_limit / l_multiple * l_multiple; l_size >= l_multiple; l_size -= l_multiple )
+    {
+        double l_occupancy = ocl_kernel_occupancy( t_res, l_size );
+        if ( l_occupancy > l_best_occupancy + 1e-9 )
+        {
+            l_best = l_size;
+            l_best_occupancy = l_occupancy;
+        }
+    }
+    return l_best;
+}
+
+/// @copydoc ocl_kernel_local_size
+cl::NDRange ocl_kernel_local_size( const OCLKernelResources &t_res, int t_dims )
+{
+    const size_t *l_compile = t_res.m_compile_wg_size;
+    if ( l_compile[ 0 ] )
+    {
+        if ( t_dims == 1 ) return cl::NDRange( l_compile[ 0 ] );
+        return cl::NDRange( l_compile[ 0 ], l_compile[ 1 ] );
+    }
+
+    size_t l_size = kernel_report_wg_size( t_res );
+    if ( t_dims == 1 ) return cl::NDRange( l_size );
+
+    // rows of image are read by neighbouring work-items
+    size_t l_width = std::min( l_size, std::max< size_t >( t_res.m_preferred_multiple, KERNEL_REPORT_MIN_WIDTH ) );
+    if ( l_size % l_width ) l_width = l_size;
+    return cl::NDRange( l_width, l_size / l_width );
+}
+
+// bytes in B or KB
+static std::string kernel_report_bytes( cl_ulong t_bytes )
+{
+    std::ostringstream l_str;
+    if ( t_bytes < 1024 ) l_str << t_bytes << " B";
+    else l_str << std::fixed << std::setprecision( 1 ) << t_bytes / 1024.0 << " KB";
+    return l_str.str();
+}
+
+// work-items of size required by kernel attribute, 0 - any size
+static size_t kernel_report_compile_size( const OCLKernelResources &t_res )
+{
+    const size_t *l_compile = t_res.m_compile_wg_size;
+    return l_compile[ 0 ] * std::max< size_t >( 1, l_compile[ 1 ] ) * std::max< size_t >( 1, l_compile[ 2 ] );
+}
+
+// occupancy in % or reason, why work-group can not be launched
+static std::string kernel_report_occupancy( const OCLKernelResources &t_res, size_t t_wg_size )
+{
+    std::ostringstream l_str;
+    size_t l_compile_size = kernel_report_compile_size( t_res );
+    if ( l_compile_size && t_wg_size != l_compile_size )
+        l_str << "-";
+    else if ( t_wg_size > t_res.m_max_wg_size )
+        l_str << "too big";
+    else
+        l_str << std::fixed << std::setprecision( 0 ) << ocl_kernel_occupancy( t_res, t_wg_size ) * 100 << " %";
+    return l_str.str();
+}
+
+/// @copydoc ocl_kernel_report
+void ocl_kernel_report( const cl::Program &t_program, std::ostream &t_stream, const std::string &t_title )
+{
+    cl_int l_err;
+    std::string l_names = t_program.getInfo< CL_PROGRAM_KERNEL_NAMES >( &l_err );  CL_ERR_C( l_err );
+    if ( l_err != CL_SUCCESS ) return;
+
+    cl::Device l_device = cl::Device::getDefault();
+    t_stream << "Kernels" << ( t_title.empty() ? "" : " of '" + t_title + "'" ) << " on " << l_device.getInfo< CL_DEVICE_NAME >()
+             << ": " << l_device.getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >() << " compute units, work-group max "
+             << l_device.getInfo< CL_DEVICE_MAX_WORK_GROUP_SIZE >() << ", local memory "
+             << kernel_report_bytes( l_device.getInfo< CL_DEVICE_LOCAL_MEM_SIZE >() ) << std::endl;
+    t_stream << std::left << std::setw( 28 ) << "kernel" << std::right << std::setw( 8 ) << "max wg" << std::setw( 6 ) << "mult"
+             << std::setw( 11 ) << "private" << std::setw( 11 ) << "local" << std::setw( 9 ) << "wg 128"
+             << std::setw( 9 ) << "wg 16x16" << std::setw( 9 ) << "best" << std::setw( 7 ) << "1D" << std::setw( 9 ) << "2D" << std::endl;
+
+    std::vector< std::string > l_notes;
+
+    // names of kernels are separated by ';'
+    std::istringstream l_names_str( l_names );
+    std::string l_name;
+    while ( std::getline( l_names_str, l_name, ';' ) )
+    {
+        if ( l_name.empty() ) continue;
+        cl::Kernel l_kernel( t_program, l_name.c_str(), &l_err );              CL_ERR_C( l_err );
+        if ( l_err != CL_SUCCESS ) continue;
+
+        OCLKernelResources l_res = ocl_kernel_resources( l_kernel, l_device );
+        size_t l_best = kernel_report_compile_size( l_res );
+        if ( l_best == 0 ) l_best = kernel_report_wg_size( l_res );
+        cl::NDRange l_1d = ocl_kernel_local_size( l_res, 1 );
+        cl::NDRange l_2d = ocl_kernel_local_size( l_res, 2 );
+        std::ostringstream l_2d_str;
+        l_2d_str << l_2d.get()[ 0 ] << "x" << l_2d.get()[ 1 ];
+
+        t_stream << std::left << std::setw( 28 ) << l_res.m_name << std::right
+                 << std::setw( 8 ) << l_res.m_max_wg_size << std::setw( 6 ) << l_res.m_preferred_multiple
+                 << std::setw( 11 ) << kernel_report_bytes( l_res.m_private_mem )
+                 << std::setw( 11 ) << kernel_report_bytes( l_res.m_local_mem )
+                 << std::setw( 9 ) << kernel_report_occupancy( l_res, 128 )
+                 << std::setw( 9 ) << kernel_report_occupancy( l_res, 256 )
+                 << std::setw( 9 ) << kernel_report_occupancy( l_res, l_best )
+                 << std::setw( 7 ) << l_1d.get()[ 0 ] << std::setw( 9 ) << l_2d_str.str() << std::endl;
+
+        // what limits the kernel
+        if ( l_res.m_compile_wg_size[ 0 ] )
+            l_notes.push_back( l_res.m_name + ": work-group size is required by kernel attribute" );
+        if ( l_res.m_max_wg_size < l_res.m_cu_capacity )
+            l_notes.push_back( l_res.m_name + ": registers limit work-group to " + std::to_string( l_res.m_max_wg_size ) + " work-items" );
+        else if ( 256 > l_res.m_max_wg_size )
+            l_notes.push_back( l_res.m_name + ": default 16x16 of OCLRange can not be launched" );
+        if ( l_res.m_private_mem > 0 )
+            l_notes.push_back( l_res.m_name + ": private memory " + kernel_report_bytes( l_res.m_private_mem ) + " per work-item, arrays or spilled registers in global memory" );
+        if ( l_res.m_local_mem > 0 && l_res.m_local_mem * 2 > l_res.m_cu_local_mem )
+            l_notes.push_back( l_res.m_name + ": local memory allows only one work-group in compute unit" );
+    }
+    for ( const std::string &l_note : l_notes )
+    {
+        t_stream << "  " << l_note << std::endl;
+    }
+}
+
+// report from environment variable OCL_KERNEL_REPORT, written for every loaded program
+static struct KernelReportFromEnv
+{
+    std::string m_file_name;
+    std::ofstream m_file;
+
+    KernelReportFromEnv()
+    {
+        const char *l_file_name = getenv( "OCL_KERNEL_REPORT" );
+        if ( l_file_name == nullptr || *l_file_name == 0 ) return;
+        m_file_name = l_file_name;
+
+        if ( m_file_name != "-" )
+        {
+            m_file.open( m_file_name );
+            if ( !m_file )
+            {
+                std::cerr << "Unable to write kernel report '" << m_file_name << "'!" << std::endl;
+                return;
+            }
+        }
+        g_ocl_program_hook = program_loaded;
+    }
+
+    static void program_loaded( const cl::Program &t_program, const std::string &t_file_name );
+} g_kernel_report_from_env;
+
+// hook of ocl_load_program
+void KernelReportFromEnv::program_loaded( const cl::Program &t_program, const std::string &t_file_name )
+{
+    if ( g_kernel_report_from_env.m_file_name == "-" )
+    {
+        ocl_kernel_report( t_program, std::cerr, t_file_name );
+        return;
+    }
+    ocl_kernel_report( t_program, g_kernel_report_from_env.m_file, t_file_name );
+    g_kernel_report_from_env.m_file << std::endl;
+    g_kernel_report_from_env.m_file.flush();
+}
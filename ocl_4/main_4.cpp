@@ -27,72 +27,19 @@
 #include <CL/opencl.hpp>
 
 #include "ocl_utils.h"
+#include "ocl_launch.h"
 #include "ocl_image.h"
 #include "ocl_svm_mat_allocator.h"
+#include "ocl_svm_image.h"
 
 #define KERNEL_SPV      "kernel_4.spv"
-#define KERNEL_PREFIX   "gpu_"
 
 // **************************************************************************
-// gpu_ function for kernel.
-// Kernel name is automatically created from this function name
-// removing prefix gpu_.
-// 
 // Kernel for BGR color rotation
 // Kernel header from kernel*.cl:
 // __kernel void convert_bgr_to_bw(          __global OCLImage *t_ocl_bgr_img,
 //                                           __global OCLImage *t_ocl_bw_img )
-cl_int gpu_convert_bgr_to_bw( cl::Program &t_program, OCLImage *t_ocl_bgr_img,
-                                                      OCLImage *t_ocl_bw_img )
-{
-    cl_int l_err;
-
-    // removing prefix gpu_
-    std::string l_kern_name( __FUNCTION__ );
-    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
-    {
-        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
-    }
-
-    // select the kernel from opencl program
-    cl::Kernel l_kern_convert_bgr_to_bw( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
-
-    // set kernel arguments
-    l_err = l_kern_convert_bgr_to_bw.setArg( 0, t_ocl_bgr_img );                CL_ERR_R( l_err );
-    l_err = l_kern_convert_bgr_to_bw.setArg( 1, t_ocl_bw_img );                 CL_ERR_R( l_err );
-
-    // list of SVM pointers for data synchronization
-    l_kern_convert_bgr_to_bw.setSVMPointers( {
-            t_ocl_bgr_img,
-            t_ocl_bgr_img->m_data,
-            t_ocl_bw_img,
-            t_ocl_bw_img->m_data,
-            } );
-
-    // get default Queue
-    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
-
-    // size of workgroup, should be multiple of 64, so 256 is OK
-    int l_wg_size_x = 16;
-    int l_wg_size_y = 16;
-    // global range
-    int l_gr_size_x = ( t_ocl_bgr_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
-    int l_gr_size_y = ( t_ocl_bgr_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
-
-    // Submitting kernel for execution
-    l_err = defQueue.enqueueNDRangeKernel( l_kern_convert_bgr_to_bw,
-            // offset
-            cl::NDRange( 0, 0 ),
-            // global range
-            cl::NDRange( l_gr_size_x, l_gr_size_y ),
-            // work-group
-            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
-
-    // waiting for completion
-    defQueue.finish();
-
-    return CL_SUCCESS;
-}
+OCL_KERNEL( convert_bgr_to_bw, OCLImage *, OCLImage * );
 
 // **************************************************************************
 int main( int t_narg, char **t_args )
@@ -125,6 +72,9 @@ int main( int t_narg, char **t_args )
     SVMMatAllocator svmallocator;
     cv::Mat::setDefaultAllocator( &svmallocator );
 
+    // pool of images must be destroyed before allocator
+    SVMImagePool l_pool;
+
     // load image from file
     cv::Mat l_cv_bgr_img = cv::imread( t_args[ 1 ], cv::IMREAD_UNCHANGED );
 
@@ -142,29 +92,20 @@ int main( int t_narg, char **t_args )
         cv::cvtColor( l_cv_bgr_img, l_cv_bgr_img, cv::COLOR_BGR2BGRA );
     }
 
-    // creating empty BW image, the same size as BGR image
-    cv::Mat l_cv_bw_img( l_cv_bgr_img.size(), CV_8UC1 );
-
     // BGR OCLImage for kernel
-    OCLImage *l_ocl_bgr_img = ocl_svm_malloc< OCLImage >();
-    l_ocl_bgr_img->m_size.x = l_cv_bgr_img.size().width;
-    l_ocl_bgr_img->m_size.y = l_cv_bgr_img.size().height;
-    l_ocl_bgr_img->m_data = l_cv_bgr_img.data;
+    SVMImage l_bgr_img = l_pool.adopt( l_cv_bgr_img );
 
-    // BW OCLImage for kernel
-    OCLImage *l_ocl_bw_img = ocl_svm_malloc< OCLImage >();
-    l_ocl_bw_img->m_size.x = l_cv_bw_img.size().width;
-    l_ocl_bw_img->m_size.y = l_cv_bw_img.size().height;
-    l_ocl_bw_img->m_data = l_cv_bw_img.data;
+    // creating empty BW image with OCLImage, the same size as BGR image
+    SVMImage l_bw_img = l_pool.acquire( l_cv_bgr_img.size(), CV_8UC1 );
 
     // show loaded BGR image
     cv::imshow( "BGR Image", l_cv_bgr_img );
 
     // convert BGR image to BW image
-    gpu_convert_bgr_to_bw( l_program, l_ocl_bgr_img, l_ocl_bw_img );
+    launch< convert_bgr_to_bw >( l_program, l_bgr_img.ocl(), l_bgr_img.ocl(), l_bw_img.ocl() );
 
     // show new BW image
-    cv::imshow( "BW Image", l_cv_bw_img );
+    cv::imshow( "BW Image", l_bw_img.mat() );
 
     // wait for key
     cv::waitKey( 0 );
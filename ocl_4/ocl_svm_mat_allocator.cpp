@@ -44,6 +44,13 @@ cv::UMatData* SVMMatAllocator::allocate(
         total *= sizes[i];
     }
     uchar* data = data0 ? ( uchar* ) data0 : ocl_svm_malloc< uchar >( total );
+    if( !data )
+        CV_Error_( cv::Error::StsNoMem, ( "Failed to allocate %zu bytes of SVM", total ) );
+    if( !data0 && data )
+    {
+        g_ocl_svm_counters.m_mat_bytes.fetch_add( total, std::memory_order_relaxed );
+        g_ocl_svm_counters.m_mat_live_bytes.fetch_add( total, std::memory_order_relaxed );
+    }
     cv::UMatData* u = new cv::UMatData(this);
     u->data = u->origdata = data;
     u->size = total;
@@ -69,6 +76,8 @@ void SVMMatAllocator::deallocate(cv::UMatData* u) const
     CV_Assert( u->refcount == 0 );
     if( !( u->flags & cv::UMatData::USER_ALLOCATED ) )
     {
+        if( u->origdata )
+            g_ocl_svm_counters.m_mat_live_bytes.fetch_sub( u->size, std::memory_order_relaxed );
         ocl_svm_free( u->origdata );
         u->origdata = 0;
     }
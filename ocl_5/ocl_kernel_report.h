@@ -0,0 +1,110 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_kernel_report.h
+ * @brief Resources of kernels, estimated occupancy and recommended work-group sizes.
+ *
+ * @details
+ * Header file for functions @ref ocl_kernel_resources, @ref ocl_kernel_occupancy,
+ * @ref ocl_kernel_local_size and @ref ocl_kernel_report.
+ *
+ * Compiler of device knows, how many resources one work-item needs.
+ * Kernel with many registers has CL_KERNEL_WORK_GROUP_SIZE lower than
+ * device limit, local memory of work-group limits number of groups
+ * in one compute unit and work-group not multiple of preferred size
+ * leaves SIMD lanes idle. Private memory above 0 is usually array
+ * or spilled registers in slow global memory.
+ *
+ * Occupancy is only estimate, OpenCL does not tell number of resident
+ * work-items. Capacity of compute unit is taken as CL_DEVICE_MAX_WORK_GROUP_SIZE
+ * work-items, so occupancy compares kernels and work-group sizes
+ * on the same device, it is not hardware counter.
+ *
+ * Report is written by environment variable OCL_KERNEL_REPORT for every
+ * program built by @ref ocl_load_program, e.g. OCL_KERNEL_REPORT=- ./ocl_6 ball.png,
+ * '-' is stderr, otherwise name of file. Report of any SPIR-V file
+ * is written by ocl_0 -k kernel.spv.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_KERNEL_REPORT_H
+#define __OCL_KERNEL_REPORT_H
+
+#include <string>
+#include <ostream>
+
+#include <CL/opencl.hpp>
+
+/**
+ * @brief Resources of one kernel on device.
+*/
+struct OCLKernelResources
+{
+    std::string m_name;             ///< Name of kernel.
+    size_t m_max_wg_size;           ///< CL_KERNEL_WORK_GROUP_SIZE, lowered by registers.
+    size_t m_preferred_multiple;    ///< CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE, width of SIMD.
+    cl_ulong m_private_mem;         ///< CL_KERNEL_PRIVATE_MEM_SIZE of one work-item.
+    cl_ulong m_local_mem;           ///< CL_KERNEL_LOCAL_MEM_SIZE of one work-group.
+    size_t m_compile_wg_size[ 3 ];  ///< Size required by kernel attribute, 0 - any size.
+    size_t m_cu_capacity;           ///< CL_DEVICE_MAX_WORK_GROUP_SIZE, work-items of compute unit.
+    cl_ulong m_cu_local_mem;        ///< CL_DEVICE_LOCAL_MEM_SIZE of compute unit.
+};
+
+/**
+ * @anchor ocl_kernel_resources
+ * @brief Resources of kernel queried from device.
+ * @param t_kernel Kernel created from built program.
+ * @param t_device Device of program.
+*/
+OCLKernelResources ocl_kernel_resources( const cl::Kernel &t_kernel, const cl::Device &t_device = cl::Device::getDefault() );
+
+/**
+ * @anchor ocl_kernel_occupancy
+ * @brief Estimated part of compute unit used by kernel with work-group size.
+ * @param t_res Resources of kernel.
+ * @param t_wg_size Work-items in one work-group, e.g. 256 for 16x16.
+ * @return 0 - 1, 0 when work-group can not be launched.
+*/
+double ocl_kernel_occupancy( const OCLKernelResources &t_res, size_t t_wg_size );
+
+/**
+ * @anchor ocl_kernel_local_size
+ * @brief Recommended work-group size with the best estimated occupancy.
+ *
+ * @details
+ * Size is multiple of preferred multiple and at most 256 work-items,
+ * larger groups give fewer groups for load balancing. 2D size
+ * has width at least 16 for coalesced rows of image.
+ * Size required by kernel attribute is returned unchanged.
+ *
+ * @param t_res Resources of kernel.
+ * @param t_dims Dimensions of range, 1 or 2.
+*/
+cl::NDRange ocl_kernel_local_size( const OCLKernelResources &t_res, int t_dims );
+
+/**
+ * @anchor ocl_kernel_report
+ * @brief Table of all kernels in program with resources, occupancy and recommended sizes.
+ *
+ * @details
+ * Occupancy is shown for default sizes of @ref OCLRange, 128 and 16x16,
+ * and for recommended size. Notes explain what limits the kernel.
+ *
+ * @param t_program Built program.
+ * @param t_stream Output of report.
+ * @param t_title Name of program in report, e.g. file name.
+*/
+void ocl_kernel_report( const cl::Program &t_program, std::ostream &t_stream, const std::string &t_title = "" );
+
+#endif // __OCL_KERNEL_REPORT_H
@@ -0,0 +1,270 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_launch.h
+ * @brief Type-safe launch of kernels with automatic list of SVM pointers.
+ *
+ * @details
+ * Header file for @ref OCL_KERNEL, @ref OCLRange and @ref launch.
+ *
+ * Every gpu_ function repeats the same steps: kernel is selected from
+ * program, arguments are set one by one, list of SVM pointers is written
+ * by hand and global range is rounded up to work-group size.
+ * Kernel declared by @ref OCL_KERNEL carries types of its arguments,
+ * so @ref launch checks arguments by compiler, converts them to
+ * declared types, sets them in one pass and creates list of SVM pointers
+ * from them: pointer to @ref OCLImage adds descriptor and its m_data,
+ * other pointers are SVM buffers.
+ *
+ * Kernel object is created only once for every thread and program.
+ * Every launch is host span and device span of @ref ocl_trace.h
+ * and it is counted with its latencies by @ref ocl_metrics.h.
+ * When capture of @ref ocl_capture.h is on, launch is recorded for replay.
+ *
+ * @code
+ * OCL_KERNEL( insert_image, OCLImage *, OCLImage *, cl_int2 );
+ * l_err = launch< insert_image >( l_program, l_ocl_small_img, l_ocl_big_img, l_ocl_small_img, {{ 10, 20 }} );
+ * @endcode
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_LAUNCH_H
+#define __OCL_LAUNCH_H
+
+#include <tuple>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <iostream>
+#include <type_traits>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_trace.h"
+#include "ocl_metrics.h"
+#include "ocl_capture.h"
+
+/**
+ * @anchor OCL_KERNEL
+ * @brief Declaration of kernel, its name and types of arguments in order of kernel header.
+ * @param t_name Name of kernel in program, it is also name of declared type.
+*/
+#define OCL_KERNEL( t_name, ... )                                               \
+    struct t_name                                                               \
+    {                                                                           \
+        static const char *name() { return #t_name; }                           \
+        typedef std::tuple< __VA_ARGS__ > args;                                 \
+    }
+
+/**
+ * @anchor OCLRange
+ * @brief Global range rounded up to work-group size.
+*/
+struct OCLRange
+{
+    cl::NDRange m_global;           ///< Global range.
+    cl::NDRange m_local;            ///< Work-group size.
+
+    /**
+     * @brief 2D range for every pixel of image.
+     * @param t_ocl_img Image giving size of range, nullptr gives empty range.
+     * @param t_wg_size_x Width of work-group.
+     * @param t_wg_size_y Height of work-group, 16x16 is multiple of 64.
+    */
+    OCLRange( const OCLImage *t_ocl_img, int t_wg_size_x = 16, int t_wg_size_y = 16 )
+        : m_global( t_ocl_img ? ( t_ocl_img->m_size.x + ( t_wg_size_x - 1 ) ) / t_wg_size_x * t_wg_size_x : 0,
+                    t_ocl_img ? ( t_ocl_img->m_size.y + ( t_wg_size_y - 1 ) ) / t_wg_size_y * t_wg_size_y : 0 ),
+          m_local( t_wg_size_x, t_wg_size_y ) {}
+
+    /**
+     * @brief 1D range for every element of vector.
+     * @param t_len Length of vector.
+     * @param t_wg_size Size of work-group, multiple of 64.
+    */
+    OCLRange( size_t t_len, int t_wg_size = 128 )
+        : m_global( ( t_len + ( t_wg_size - 1 ) ) / t_wg_size * t_wg_size ), m_local( t_wg_size ) {}
+
+    /**
+     * @brief Explicit ranges, global range must be multiple of work-group.
+    */
+    OCLRange( const cl::NDRange &t_global, const cl::NDRange &t_local ) : m_global( t_global ), m_local( t_local ) {}
+};
+
+/// @cond
+// SVM pointers of one kernel argument
+inline void ocl_launch_svm_ptrs( std::vector< void * > &t_ptrs, OCLImage *t_ocl_img )
+{
+    t_ptrs.push_back( t_ocl_img );
+    t_ptrs.push_back( t_ocl_img->m_data );
+}
+
+template< typename T >
+void ocl_launch_svm_ptrs( std::vector< void * > &t_ptrs, T *t_ptr )
+{
+    t_ptrs.push_back( ( void * ) t_ptr );
+}
+
+template< typename T >
+void ocl_launch_svm_ptrs( std::vector< void * > &, const T & )
+{
+}
+
+// image descriptor must exist, e.g. SVMImage::ocl() of image not restored from host memory
+inline bool ocl_launch_valid( OCLImage *t_ocl_img )
+{
+    return t_ocl_img != nullptr;
+}
+
+template< typename T >
+bool ocl_launch_valid( const T & )
+{
+    return true;
+}
+
+// argument of kernel in capture
+inline void ocl_launch_capture( OCLCaptureLaunch &t_capture, OCLImage *t_ocl_img )
+{
+    t_capture.image( t_ocl_img );
+}
+
+template< typename T >
+void ocl_launch_capture( OCLCaptureLaunch &t_capture, T *t_ptr )
+{
+    t_capture.buffer( t_ptr );
+}
+
+template< typename T >
+void ocl_launch_capture( OCLCaptureLaunch &t_capture, const T &t_value )
+{
+    t_capture.value( &t_value, sizeof( T ) );
+}
+
+// only SVM pointers and plain values can be kernel arguments
+template< typename T >
+struct OCLKernelArg
+{
+    static constexpr bool value = std::is_pointer< T >::value ||
+                                  ( std::is_trivially_copyable< T >::value && std::is_standard_layout< T >::value );
+};
+
+template< typename T_Kernel, typename T_Args >
+struct OCLLaunch;
+
+template< typename T_Kernel, typename... T_Args >
+struct OCLLaunch< T_Kernel, std::tuple< T_Args... > >
+{
+    static_assert( ( OCLKernelArg< T_Args >::value && ... ), "Kernel argument must be SVM pointer or plain value!" );
+
+    // parameters have declared types, so wrong argument is compile error
+    // and value is converted to declared type before setArg, e.g. double to float
+    cl_int operator()( cl::Program &t_program, const OCLRange &t_range, T_Args... t_args ) const
+    {
+        OCL_TRACE_SCOPE( T_Kernel::name() );
+        auto l_launch_start = std::chrono::steady_clock::now();
+        cl_int l_err = CL_SUCCESS;
+
+        // metrics of kernel are registered only once
+        static OCLCounter &s_launches = ocl_counter( "ocl_kernel_launches_total", "kernel", T_Kernel::name() );
+        static OCLHistogram &s_launch_time = ocl_histogram( "ocl_kernel_launch_seconds", "kernel", T_Kernel::name() );
+        static OCLHistogram &s_queue_time = ocl_histogram( "ocl_kernel_queue_seconds", "kernel", T_Kernel::name() );
+        static OCLHistogram &s_exec_time = ocl_histogram( "ocl_kernel_exec_seconds", "kernel", T_Kernel::name() );
+
+        // kernel is selected only once for every thread and program
+        thread_local cl::Program l_program;
+        thread_local cl::Kernel l_kernel;
+        if ( l_program() != t_program() )
+        {
+            l_kernel = cl::Kernel( t_program, T_Kernel::name(), &l_err );       CL_ERR_R( l_err );
+
+            // declaration must match kernel in program
+            cl_uint l_num_args = l_kernel.getInfo< CL_KERNEL_NUM_ARGS >();
+            if ( l_num_args != sizeof...( T_Args ) )
+            {
+                std::cerr << "Kernel '" << T_Kernel::name() << "' has " << l_num_args << " arguments, declared "
+                          << sizeof...( T_Args ) << "!" << std::endl;
+                l_kernel = cl::Kernel();
+                return CL_INVALID_KERNEL_ARGS;
+            }
+            l_program = t_program;
+        }
+
+        // launch is recorded with content of inputs before enqueue
+        std::unique_ptr< OCLCaptureLaunch > l_capture;
+        if ( ocl_capture_on() ) l_capture.reset( new OCLCaptureLaunch( t_program, T_Kernel::name(), t_range.m_global, t_range.m_local ) );
+
+        // set kernel arguments and list of SVM pointers in one pass
+        cl_uint l_index = 0;
+        std::vector< void * > l_svm_ptrs;
+        l_svm_ptrs.reserve( 2 * sizeof...( T_Args ) );
+        auto l_set_arg = [ & ] ( auto t_arg )
+        {
+            if ( l_err != CL_SUCCESS ) return;
+            if ( !ocl_launch_valid( t_arg ) )
+            {
+                l_err = CL_INVALID_ARG_VALUE;
+                return;
+            }
+            l_err = l_kernel.setArg( l_index++, t_arg );
+            ocl_launch_svm_ptrs( l_svm_ptrs, t_arg );
+            if ( l_capture ) ocl_launch_capture( *l_capture, t_arg );
+        };
+        ( l_set_arg( t_args ), ... );                                           CL_ERR_R( l_err );
+
+        // list of SVM pointers for data synchronization
+        l_kernel.setSVMPointers( l_svm_ptrs );
+
+        // get default Queue
+        cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+        // Submitting kernel for execution, event only for trace and metrics
+        cl::Event l_event;
+        bool l_profile = ocl_trace_on() || ocl_metrics_on() || ocl_capture_on();
+        long long l_enqueue = l_profile ? ocl_trace_now() : 0;
+        l_err = defQueue.enqueueNDRangeKernel( l_kernel, cl::NullRange, t_range.m_global, t_range.m_local,
+                                               nullptr, l_profile ? &l_event : nullptr );  CL_ERR_R( l_err );
+
+        // waiting for completion
+        l_err = defQueue.finish();                                              CL_ERR_R( l_err );
+
+        long long l_launch_ns = std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - l_launch_start ).count();
+        s_launches.add();
+        s_launch_time.record( l_launch_ns );
+        if ( l_profile )
+        {
+            ocl_trace_event( T_Kernel::name(), l_event, l_enqueue );
+            ocl_metrics_event( s_queue_time, s_exec_time, l_event );
+        }
+        if ( l_capture ) l_capture->finish( &l_event, l_launch_ns );
+
+        return CL_SUCCESS;
+    }
+};
+/// @endcond
+
+/**
+ * @anchor launch
+ * @brief Launch of kernel declared by @ref OCL_KERNEL, function waits for completion.
+ *
+ * @details
+ * Call: launch< T_Kernel >( program, range, arguments... ).
+ * Range is @ref OCLRange, e.g. image or length of vector.
+ * Function returns CL_SUCCESS or error code, CL_INVALID_ARG_VALUE
+ * for nullptr image, so kernel is not launched.
+*/
+template< typename T_Kernel >
+constexpr OCLLaunch< T_Kernel, typename T_Kernel::args > launch {};
+
+#endif // __OCL_LAUNCH_H
@@ -0,0 +1,62 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_memprof.h
+ * @brief Profiler of SVM allocations with call sites, leaks and growth.
+ *
+ * @details
+ * Header file for functions @ref ocl_memprof_report and @ref ocl_memprof_checkpoint.
+ *
+ * Profiler is started by environment variable OCL_MEMPROF with name of
+ * report file, or '-' for cerr, e.g. OCL_MEMPROF=- ./ocl_6 ball.png.
+ * It sets hooks of @ref ocl_svm_malloc and @ref ocl_svm_free, so
+ * @ref SVMMatAllocator, @ref SVMImagePool and all utils are profiled too.
+ * When OCL_MEMPROF is not set, every allocation costs one test of pointer.
+ *
+ * Every allocation stores backtrace of its caller. Allocations from the same
+ * backtrace are one site with number of allocations, bytes, live bytes,
+ * peak of live bytes and average lifetime. At exit the report lists
+ * allocations still live (leaks) and sites with the largest peak.
+ *
+ * Long-running loops, e.g. video, call @ref ocl_memprof_checkpoint once per
+ * iteration. Site whose live bytes grow in most of checkpoints is reported
+ * as growing, before steady growth ends as out of memory.
+ *
+ * Function names in backtraces need linking with -rdynamic.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_MEMPROF_H
+#define __OCL_MEMPROF_H
+
+#include <ostream>
+
+/// Profiler is on, see OCL_MEMPROF.
+bool ocl_memprof_on();
+
+/**
+ * @anchor ocl_memprof_checkpoint
+ * @brief Live bytes of every site are compared with previous checkpoint.
+*/
+void ocl_memprof_checkpoint();
+
+/**
+ * @anchor ocl_memprof_report
+ * @brief Report of leaks, top sites and growing sites.
+ * @param t_stream Output stream.
+ * @param t_top Number of sites with the largest peak.
+*/
+void ocl_memprof_report( std::ostream &t_stream, int t_top = 10 );
+
+#endif // __OCL_MEMPROF_H
@@ -0,0 +1,252 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_metrics.cpp
+ * @brief Always-on counters and latency histograms exported for Prometheus.
+ *
+ * @details
+ * Source file for classes @ref OCLCounter and @ref OCLHistogram
+ * and functions @ref ocl_counter, @ref ocl_histogram and @ref ocl_metrics_write.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+
+#include "ocl_utils.h"
+#include "ocl_metrics.h"
+
+// bucket of value, 16 linear buckets and then 16 buckets for every power of 2
+int OCLHistogram::index( unsigned long long t_ns )
+{
+    if ( t_ns < SUB_BUCKETS ) return t_ns;
+    int l_exp = 63 - __builtin_clzll( t_ns );
+    int l_index = ( l_exp - 3 ) * SUB_BUCKETS + ( ( t_ns >> ( l_exp - 4 ) ) & ( SUB_BUCKETS - 1 ) );
+    return std::min( l_index, BUCKETS - 1 );
+}
+
+// the first value above bucket
+unsigned long long OCLHistogram::upper( int t_index )
+{
+    if ( t_index < SUB_BUCKETS ) return t_index + 1;
+    int l_exp = t_index / SUB_BUCKETS + 3;
+    unsigned long long l_width = 1ULL << ( l_exp - 4 );
+    return ( SUB_BUCKETS + t_index % SUB_BUCKETS ) * l_width + l_width;
+}
+
+/// @copydoc OCLHistogram::record
+void OCLHistogram::record( unsigned long long t_ns )
+{
+    m_buckets[ index( t_ns ) ].fetch_add( 1, std::memory_order_relaxed );
+    m_count.fetch_add( 1, std::memory_order_relaxed );
+    m_sum.fetch_add( t_ns, std::memory_order_relaxed );
+}
+
+/// @copydoc OCLHistogram::quantile
+unsigned long long OCLHistogram::quantile( double t_q ) const
+{
+    unsigned long long l_count = count();
+    if ( l_count == 0 ) return 0;
+
+    unsigned long long l_rank = std::max( 1.0, t_q * l_count + 0.5 );
+    unsigned long long l_seen = 0;
+    for ( int i = 0; i < BUCKETS; i++ )
+    {
+        l_seen += m_buckets[ i ].load( std::memory_order_relaxed );
+        if ( l_seen >= l_rank ) return upper( i );
+    }
+    return upper( BUCKETS - 1 );
+}
+
+/// @copydoc OCLHistogram::count_below_pow2
+unsigned long long OCLHistogram::count_below_pow2( int t_exp ) const
+{
+    unsigned long long l_limit = 1ULL << t_exp;
+    unsigned long long l_count = 0;
+    for ( int i = 0; i < BUCKETS && upper( i ) <= l_limit; i++ )
+    {
+        l_count += m_buckets[ i ].load( std::memory_order_relaxed );
+    }
+    return l_count;
+}
+
+// registry: name -> label -> metric, metrics are never removed
+typedef std::pair< std::string, std::string > MetricLabel;
+
+static std::mutex g_metrics_mutex;
+static std::map< std::string, std::map< MetricLabel, std::unique_ptr< OCLCounter > > > g_counters;
+static std::map< std::string, std::map< MetricLabel, std::unique_ptr< OCLHistogram > > > g_histograms;
+
+/// @copydoc ocl_counter
+OCLCounter &ocl_counter( const std::string &t_name, const std::string &t_label, const std::string &t_value )
+{
+    std::lock_guard< std::mutex > l_lock( g_metrics_mutex );
+    std::unique_ptr< OCLCounter > &l_counter = g_counters[ t_name ][ MetricLabel( t_label, t_value ) ];
+    if ( !l_counter ) l_counter.reset( new OCLCounter );
+    return *l_counter;
+}
+
+/// @copydoc ocl_histogram
+OCLHistogram &ocl_histogram( const std::string &t_name, const std::string &t_label, const std::string &t_value )
+{
+    std::lock_guard< std::mutex > l_lock( g_metrics_mutex );
+    std::unique_ptr< OCLHistogram > &l_hist = g_histograms[ t_name ][ MetricLabel( t_label, t_value ) ];
+    if ( !l_hist ) l_hist.reset( new OCLHistogram );
+    return *l_hist;
+}
+
+/// @copydoc ocl_metrics_event
+void ocl_metrics_event( OCLHistogram &t_queue, OCLHistogram &t_exec, const cl::Event &t_event )
+{
+    // queue without profiling has no times
+    cl_int l_err;
+    cl_ulong l_queued = t_event.getProfilingInfo< CL_PROFILING_COMMAND_QUEUED >( &l_err );
+    if ( l_err != CL_SUCCESS ) return;
+    cl_ulong l_start = t_event.getProfilingInfo< CL_PROFILING_COMMAND_START >();
+    cl_ulong l_end = t_event.getProfilingInfo< CL_PROFILING_COMMAND_END >();
+
+    t_queue.record( l_start > l_queued ? l_start - l_queued : 0 );
+    t_exec.record( l_end > l_start ? l_end - l_start : 0 );
+}
+
+// {label="value"} or nothing, t_extra is added for buckets
+static std::string metric_labels( const MetricLabel &t_label, const std::string &t_extra = "" )
+{
+    std::string l_labels;
+    if ( !t_label.first.empty() ) l_labels = t_label.first + "=\"" + t_label.second + "\"";
+    if ( !t_extra.empty() ) l_labels += ( l_labels.empty() ? "" : "," ) + t_extra;
+    return l_labels.empty() ? "" : "{" + l_labels + "}";
+}
+
+/// @copydoc ocl_metrics_write
+void ocl_metrics_write( std::ostream &t_stream )
+{
+    // counters of ocl_utils without registry
+    t_stream << "# TYPE ocl_svm_allocs_total counter" << std::endl
+             << "ocl_svm_allocs_total " << g_ocl_svm_counters.m_allocs.load() << std::endl
+             << "# TYPE ocl_svm_alloc_bytes_total counter" << std::endl
+             << "ocl_svm_alloc_bytes_total " << g_ocl_svm_counters.m_alloc_bytes.load() << std::endl
+             << "# TYPE ocl_svm_frees_total counter" << std::endl
+             << "ocl_svm_frees_total " << g_ocl_svm_counters.m_frees.load() << std::endl
+             << "# TYPE ocl_svm_alloc_failures_total counter" << std::endl
+             << "ocl_svm_alloc_failures_total " << g_ocl_svm_counters.m_failures.load() << std::endl
+             << "# TYPE ocl_svm_live_bytes gauge" << std::endl
+             << "ocl_svm_live_bytes " << g_ocl_svm_counters.m_live_bytes.load() << std::endl
+             << "# TYPE ocl_svm_mat_alloc_bytes_total counter" << std::endl
+             << "ocl_svm_mat_alloc_bytes_total " << g_ocl_svm_counters.m_mat_bytes.load() << std::endl
+             << "# TYPE ocl_svm_mat_live_bytes gauge" << std::endl
+             << "ocl_svm_mat_live_bytes " << g_ocl_svm_counters.m_mat_live_bytes.load() << std::endl;
+
+    std::lock_guard< std::mutex > l_lock( g_metrics_mutex );
+
+    for ( auto &l_metric : g_counters )
+    {
+        t_stream << "# TYPE " << l_metric.first << " counter" << std::endl;
+        for ( auto &l_item : l_metric.second )
+        {
+            t_stream << l_metric.first << metric_labels( l_item.first ) << " " << l_item.second->value() << std::endl;
+        }
+    }
+
+    // buckets from 1 us to 68 s by powers of 2
+    for ( auto &l_metric : g_histograms )
+    {
+        t_stream << "# TYPE " << l_metric.first << " histogram" << std::endl;
+        for ( auto &l_item : l_metric.second )
+        {
+            const OCLHistogram &l_hist = *l_item.second;
+            for ( int e = 10; e <= 36; e++ )
+            {
+                char l_le[ 32 ];
+                snprintf( l_le, sizeof( l_le ), "le=\"%g\"", ( double ) ( 1ULL << e ) / 1e9 );
+                t_stream << l_metric.first << "_bucket" << metric_labels( l_item.first, l_le ) << " " << l_hist.count_below_pow2( e ) << std::endl;
+            }
+            t_stream << l_metric.first << "_bucket" << metric_labels( l_item.first, "le=\"+Inf\"" ) << " " << l_hist.count() << std::endl;
+            t_stream << l_metric.first << "_sum" << metric_labels( l_item.first ) << " " << l_hist.sum() / 1e9 << std::endl;
+            t_stream << l_metric.first << "_count" << metric_labels( l_item.first ) << " " << l_hist.count() << std::endl;
+        }
+    }
+}
+
+/// @copydoc ocl_metrics_snapshot
+bool ocl_metrics_snapshot( const std::string &t_file_name )
+{
+    std::string l_tmp_name = t_file_name + ".tmp";
+    {
+        std::ofstream l_file( l_tmp_name );
+        if ( !l_file ) return false;
+        ocl_metrics_write( l_file );
+        if ( !l_file.good() ) return false;
+    }
+    return rename( l_tmp_name.c_str(), t_file_name.c_str() ) == 0;
+}
+
+// snapshots from environment variables OCL_METRICS and OCL_METRICS_PERIOD
+static struct MetricsFromEnv
+{
+    std::string m_file_name;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    bool m_stop = false;
+
+    MetricsFromEnv()
+    {
+        const char *l_file_name = getenv( "OCL_METRICS" );
+        if ( l_file_name == nullptr || *l_file_name == 0 ) return;
+        m_file_name = l_file_name;
+
+        const char *l_period = getenv( "OCL_METRICS_PERIOD" );
+        int l_seconds = l_period ? std::max( 1, atoi( l_period ) ) : 10;
+
+        m_thread = std::thread( [ this, l_seconds ] ()
+        {
+            std::unique_lock< std::mutex > l_lock( m_mutex );
+            while ( !m_cond.wait_for( l_lock, std::chrono::seconds( l_seconds ), [ this ] { return m_stop; } ) )
+            {
+                ocl_metrics_snapshot( m_file_name );
+            }
+        } );
+    }
+
+    ~MetricsFromEnv()
+    {
+        if ( m_file_name.empty() ) return;
+        {
+            std::lock_guard< std::mutex > l_lock( m_mutex );
+            m_stop = true;
+        }
+        m_cond.notify_one();
+        m_thread.join();
+        if ( !ocl_metrics_snapshot( m_file_name ) )
+        {
+            std::cerr << "Unable to write metrics '" << m_file_name << "'!" << std::endl;
+        }
+    }
+} g_metrics_from_env;
+
+/// @copydoc ocl_metrics_on
+bool ocl_metrics_on()
+{
+    return !g_metrics_from_env.m_file_name.empty();
+}
@@ -0,0 +1,216 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_svm_image.h
+ * @brief Image in SVM owning its cv::Mat and its OCLImage descriptor.
+ *
+ * @details
+ * Header file for classes @ref SVMImage and @ref SVMImagePool.
+ *
+ * Image for kernel needs cv::Mat with data in SVM and @ref OCLImage
+ * descriptor in SVM with size and pointer to the same data.
+ * @ref SVMImage keeps both together, it can be only moved, not copied.
+ * When it is destroyed, both parts are returned into @ref SVMImagePool
+ * and the next image of the same size and type reuses them,
+ * so loops do not allocate SVM memory in every iteration.
+ *
+ * cv::Mat must be allocated by @ref SVMMatAllocator, so the pool must
+ * be created after allocator and destroyed before it, and all images
+ * must be destroyed before their pool.
+ *
+ * Pool is reclaim handler of @ref ocl_svm_malloc. When allocation does not
+ * fit into process-wide budget set by @ref ocl_svm_set_budget or OCL_SVM_BUDGET,
+ * or when it fails, free cv::Mat are released first and then the least
+ * recently used idle images are spilled into host memory. Spilled image
+ * is restored into SVM by the next SVMImage::mat() or SVMImage::ocl(),
+ * so lack of memory costs copies instead of crash.
+ *
+ * Image is idle when it is not pinned and no other cv::Mat shares its data.
+ * Pointers and references from mat() and ocl() are valid only until
+ * the next call of pool, images used by other threads or kept in variables
+ * over acquire must be pinned by SVMImage::pin().
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_SVM_IMAGE_H
+#define __OCL_SVM_IMAGE_H
+
+#include <map>
+#include <set>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include <opencv2/core/mat.hpp>
+
+#include "ocl_image.h"
+
+class SVMImagePool;
+
+/**
+ * @anchor SVMImage
+ * @brief Move-only handle of cv::Mat and its descriptor from @ref SVMImagePool.
+*/
+class SVMImage
+{
+public:
+    /// Empty image.
+    SVMImage() : m_pool( nullptr ), m_ocl_img( nullptr ), m_used( 0 ), m_pinned( false ) {}
+
+    /**
+     * @brief Mat and descriptor are returned into pool.
+    */
+    ~SVMImage() { release(); }
+
+    SVMImage( const SVMImage & ) = delete;
+    SVMImage &operator=( const SVMImage & ) = delete;
+
+    /// Ownership is moved, t_img is empty after move.
+    SVMImage( SVMImage &&t_img );
+
+    /// Current image is released, ownership is moved from t_img.
+    SVMImage &operator=( SVMImage &&t_img );
+
+    /// Image has no data.
+    bool empty() const { return m_ocl_img == nullptr; }
+
+    /// Image for OpenCV functions, spilled image is restored into SVM.
+    cv::Mat &mat();
+
+    /// Descriptor for kernel arguments, nullptr when spilled image can not be restored, @ref launch returns error for it.
+    OCLImage *ocl();
+
+    /// Pinned image is never spilled into host memory.
+    void pin( bool t_pinned = true ) { m_pinned = t_pinned; }
+
+    /// Image data are in host memory now.
+    bool spilled() const { return !m_host.empty(); }
+
+    /**
+     * @brief Mat and descriptor are returned into pool, image is empty.
+    */
+    void release();
+
+protected:
+    /// @cond
+    friend class SVMImagePool;
+
+    SVMImagePool *m_pool;
+    cv::Mat m_mat;
+    OCLImage *m_ocl_img;
+    cv::Mat m_host;                 // data of spilled image
+    unsigned long long m_used;      // tick of pool for LRU
+    bool m_pinned;
+    /// @endcond
+};
+
+/**
+ * @brief Statistics of @ref SVMImagePool.
+*/
+struct SVMImagePoolStats
+{
+    size_t m_requests;          ///< Images requested by @ref SVMImagePool::acquire.
+    size_t m_hits;              ///< Requests served by recycled cv::Mat.
+    size_t m_cached;            ///< Free cv::Mat kept in pool.
+    size_t m_cached_bytes;      ///< Bytes of free cv::Mat kept in pool.
+    size_t m_resident_bytes;    ///< Bytes in SVM, free and used cv::Mat.
+    size_t m_spills;            ///< Images spilled into host memory.
+    size_t m_restores;          ///< Images restored into SVM.
+
+    /// Part of requests served from pool.
+    double hit_rate() const { return m_requests ? ( double ) m_hits / m_requests : 0; }
+};
+
+/**
+ * @anchor SVMImagePool
+ * @brief Thread-safe pool of images in SVM keyed by size and type.
+ *
+ * @details
+ * Recycled cv::Mat keeps its old content. cv::Mat is recycled only
+ * when image was its last owner, copy of mat() kept by caller
+ * means it is simply released.
+*/
+class SVMImagePool
+{
+public:
+    /**
+     * @brief Empty pool.
+     * @param t_max_free Max. number of free cv::Mat of one size and type.
+    */
+    explicit SVMImagePool( int t_max_free = 4 );
+
+    /**
+     * @brief All free cv::Mat and descriptors are released.
+    */
+    ~SVMImagePool();
+
+    SVMImagePool( const SVMImagePool & ) = delete;
+    SVMImagePool &operator=( const SVMImagePool & ) = delete;
+
+    /**
+     * @brief Image from pool or newly allocated.
+     * @param t_size Size of image.
+     * @param t_type Type of image, CV_8UC4 or CV_8UC1.
+     * @return Image, empty when SVM allocation failed.
+    */
+    SVMImage acquire( cv::Size t_size, int t_type );
+
+    /**
+     * @brief Existing cv::Mat in SVM gets descriptor from pool, e.g. image from cv::imread.
+     * @param t_cv_img Continuous image allocated by @ref SVMMatAllocator.
+     * @return Image sharing data with t_cv_img.
+    */
+    SVMImage adopt( const cv::Mat &t_cv_img );
+
+    /// Current statistics.
+    SVMImagePoolStats stats() const;
+
+    /// Free cv::Mat and descriptors are released.
+    void clear();
+
+protected:
+    /// @cond
+    friend class SVMImage;
+
+    typedef std::tuple< int, int, int > Key;   // width, height, type
+
+    void release( SVMImage &t_img );
+    void move( SVMImage &t_from, SVMImage &t_to );
+    void use( SVMImage &t_img );
+    SVMImage image( const cv::Mat &t_cv_img, OCLImage *t_ocl_img );
+    OCLImage *descriptor();
+
+    // memory management, mutex must be locked
+    size_t resident_bytes() const;
+    size_t drop_free();
+    size_t spill_lru();
+
+    // memory management with lock
+    bool reclaim( size_t t_bytes );
+    static bool reclaim_handler( void *t_pool, size_t t_bytes );
+
+    std::map< Key, std::vector< cv::Mat > > m_free;
+    std::vector< OCLImage * > m_free_descs;
+    std::set< SVMImage * > m_images;
+    size_t m_max_free;
+    size_t m_requests;
+    size_t m_hits;
+    size_t m_spills;
+    size_t m_restores;
+    unsigned long long m_tick;
+    mutable std::mutex m_mutex;
+    /// @endcond
+};
+
+#endif // __OCL_SVM_IMAGE_H
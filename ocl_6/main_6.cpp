@@ -10,6 +10,7 @@
  * https:/poli.cs.vsb.cz/edu/apps
  *
  * Animation with bouncing ball.
+ * Timeline of frames is written by: OCL_TRACE=trace.json ./ocl_6 ball.png
  *
  ***************************************************************************/
 
@@ -27,134 +28,29 @@
 #include <CL/opencl.hpp>
 
 #include "ocl_utils.h"
+#include "ocl_launch.h"
+#include "ocl_trace.h"
+#include "ocl_memprof.h"
 #include "ocl_image.h"
 #include "ocl_svm_mat_allocator.h"
+#include "ocl_svm_image.h"
 
 #define KERNEL_SPV      "kernel_6.spv"
-#define KERNEL_PREFIX   "gpu_"
 
 // **************************************************************************
-// gpu_ function for kernel.
-// Kernel name is automatically created from this function name
-// removing prefix gpu_.
-//
 // Kernel for creating chessboard
 // Kernel header from kernel*.cl:
 // __kernel void create_chessboard(          __global OCLImage *t_ocl_img, 
 //                                                    int t_sq_size )
-cl_int gpu_create_chessboard( cl::Program &t_program, OCLImage *t_ocl_img,
-                                                      int t_sq_size )
-{
-    cl_int l_err;
-
-    // removing prefix gpu_
-    std::string l_kern_name( __FUNCTION__ );
-    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
-    {
-        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
-    }
-
-    // select the kernel from opencl program
-    cl::Kernel l_kern_create_chessboard( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
-
-    // set kernel arguments
-    l_err = l_kern_create_chessboard.setArg( 0, t_ocl_img );                    CL_ERR_R( l_err );
-    l_err = l_kern_create_chessboard.setArg( 1, t_sq_size );                    CL_ERR_R( l_err );
-
-    // list of SVM pointers for data synchronization
-    l_kern_create_chessboard.setSVMPointers( {
-            t_ocl_img,
-            t_ocl_img->m_data,
-            } );
-
-    // get default Queue
-    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
-
-    // size of workgroup, should be multiple of 64, so 256 is OK
-    int l_wg_size_x = 16;
-    int l_wg_size_y = 16;
-    // global range
-    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
-    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
-
-    // Submitting kernel for execution
-    l_err = defQueue.enqueueNDRangeKernel( l_kern_create_chessboard,
-            // offset
-            cl::NDRange( 0, 0 ),
-            // global range
-            cl::NDRange( l_gr_size_x, l_gr_size_y ),
-            // work-group
-            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
-
-    // waiting for completion
-    defQueue.finish();
-
-    return CL_SUCCESS;
-}
+OCL_KERNEL( create_chessboard, OCLImage *, int );
 
 // **************************************************************************
-// gpu_ function for kernel.
-// Kernel name is automatically created from this function name
-// removing prefix gpu_.
-//
 // Kernel for inserting image into image
 // Kernel header from kernel*.cl:
 // __kernel void insert_image(          __global OCLImage *t_ocl_big_img, 
 //                                      __global OCLImage *t_ocl_small_img, 
 //                                               int2 t_position )
-cl_int gpu_insert_image( cl::Program &t_program, OCLImage *t_ocl_big_img,
-                                                 OCLImage *t_ocl_small_img,
-                                                 cl_int2 t_position )
-{
-    cl_int l_err;
-
-    // removing prefix gpu_
-    std::string l_kern_name( __FUNCTION__ );
-    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
-    {
-        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
-    }
-
-    // select the kernel from opencl program
-    cl::Kernel l_kern_insert_image( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
-
-    // set kernel arguments
-    l_err = l_kern_insert_image.setArg( 0, t_ocl_big_img );                     CL_ERR_R( l_err );
-    l_err = l_kern_insert_image.setArg( 1, t_ocl_small_img );                   CL_ERR_R( l_err );
-    l_err = l_kern_insert_image.setArg( 2, t_position );                        CL_ERR_R( l_err );
-
-    // list of SVM pointers for data synchronization
-    l_kern_insert_image.setSVMPointers( {
-            t_ocl_big_img,
-            t_ocl_big_img->m_data,
-            t_ocl_small_img,
-            t_ocl_small_img->m_data,
-            } );
-
-    // get default Queue
-    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
-
-    // size of workgroup, should be multiple of 64, so 256 is OK
-    int l_wg_size_x = 16;
-    int l_wg_size_y = 16;
-    // global range
-    int l_gr_size_x = ( t_ocl_small_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
-    int l_gr_size_y = ( t_ocl_small_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
-
-    // Submitting kernel for execution
-    l_err = defQueue.enqueueNDRangeKernel( l_kern_insert_image,
-            // offset
-            cl::NDRange( 0, 0 ),
-            // global range
-            cl::NDRange( l_gr_size_x, l_gr_size_y ),
-            // work-group
-            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
-
-    // waiting for completion
-    defQueue.finish();
-
-    return CL_SUCCESS;
-}
+OCL_KERNEL( insert_image, OCLImage *, OCLImage *, cl_int2 );
 
 // **************************************************************************
 #define IMG_SIZEX   876
@@ -188,16 +84,16 @@ int main( int t_narg, char **t_args )
     SVMMatAllocator svmallocator;
     cv::Mat::setDefaultAllocator( &svmallocator );
 
-    // creating empty image
-    cv::Mat l_cv_background_img( IMG_SIZEY, IMG_SIZEX, CV_8UC4 );
+    // pool of images must be destroyed before allocator
+    SVMImagePool l_pool;
 
-    // Background OCLImage for kernel
-    OCLImage *l_ocl_background_img = ocl_svm_malloc< OCLImage >();
-    l_ocl_background_img->m_size.x = l_cv_background_img.size().width;
-    l_ocl_background_img->m_size.y = l_cv_background_img.size().height;
-    l_ocl_background_img->m_data = l_cv_background_img.data;
+    // creating empty image with background OCLImage for kernel
+    SVMImage l_background_img = l_pool.acquire( cv::Size( IMG_SIZEX, IMG_SIZEY ), CV_8UC4 );
+    l_background_img.pin();     // pointers below are used over next acquire
+    cv::Mat &l_cv_background_img = l_background_img.mat();
+    OCLImage *l_ocl_background_img = l_background_img.ocl();
 
-    gpu_create_chessboard( l_program, l_ocl_background_img, 3 );
+    launch< create_chessboard >( l_program, l_ocl_background_img, l_ocl_background_img, 3 );
     
     // show created chessboard
     cv::imshow( "Chessboard", l_cv_background_img );
@@ -223,14 +119,9 @@ int main( int t_narg, char **t_args )
         exit( EXIT_FAILURE );
     }
 
-    OCLImage *l_ocl_load_img = ocl_svm_malloc< OCLImage >();
-    l_ocl_load_img->m_size.x = l_cv_load_img.size().width;
-    l_ocl_load_img->m_size.y = l_cv_load_img.size().height;
-    l_ocl_load_img->m_data = l_cv_load_img.data;
-
-    // copy of background
-    cv::Mat l_cv_bg_backup_img;
-    l_cv_background_img.copyTo( l_cv_bg_backup_img );
+    SVMImage l_load_img = l_pool.adopt( l_cv_load_img );
+    l_load_img.pin();
+    OCLImage *l_ocl_load_img = l_load_img.ocl();
 
     // animation
     // positive z axis is up
@@ -250,6 +141,12 @@ int main( int t_narg, char **t_args )
 
     while ( 1 )
     {
+        // OCL_MEMPROF=- reports SVM memory growing from frame to frame
+        ocl_memprof_checkpoint();
+
+        // OCL_TRACE=trace.json shows which part of frame is slow
+        OCL_TRACE_SCOPE( "frame" );
+
         timeval anim_tv_cur, anim_tv_delta;
         gettimeofday( &anim_tv_cur, nullptr );
         timersub( &anim_tv_cur, &anim_tv_start, &anim_tv_delta );
@@ -263,13 +160,21 @@ int main( int t_narg, char **t_args )
         cl_int2 ipos = {{ IMG_SIZEX / 2, 0 }};
         ipos.y = l_ocl_background_img->m_size.y - anim_z * anim_ppm - l_ocl_load_img->m_size.y;
 
-        // restore background
-        l_cv_bg_backup_img.copyTo( l_cv_background_img );
+        // frame from pool reuses memory of previous frame, background stays unchanged
+        SVMImage l_frame_img = l_pool.acquire( l_cv_background_img.size(), CV_8UC4 );
+        if ( l_frame_img.empty() ) continue;    // no memory for frame, frame is dropped
+        {
+            OCL_TRACE_SCOPE( "copyTo" );
+            l_cv_background_img.copyTo( l_frame_img.mat() );
+        }
 
-        gpu_insert_image( l_program, l_ocl_background_img, l_ocl_load_img, ipos );
+        launch< insert_image >( l_program, l_ocl_load_img, l_frame_img.ocl(), l_ocl_load_img, ipos );
 
-        cv::imshow( "Chessboard", l_cv_background_img );
-        cv::waitKey( 1 );
+        {
+            OCL_TRACE_SCOPE( "imshow" );
+            cv::imshow( "Chessboard", l_frame_img.mat() );
+            cv::waitKey( 1 );
+        }
     
         // one cycle passed
         if ( anim_t > anim_tc )
@@ -287,6 +192,10 @@ int main( int t_narg, char **t_args )
             timeradd( &anim_tv_cur, &anim_tv_delta, &anim_tv_start );
         }
     }
+
+    SVMImagePoolStats l_stats = l_pool.stats();
+    std::cout << "Image pool: " << l_stats.m_requests << " requests, hit rate " << l_stats.hit_rate() * 100 << " %, "
+              << l_stats.m_spills << " spills, " << l_stats.m_restores << " restores." << std::endl;
    
     // wait for key
     cv::waitKey( 0 );
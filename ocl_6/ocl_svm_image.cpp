@@ -0,0 +1,380 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_svm_image.cpp
+ * @brief Image in SVM owning its cv::Mat and its OCLImage descriptor.
+ *
+ * @details
+ * Source file for classes @ref SVMImage and @ref SVMImagePool.
+ *
+ ***************************************************************************/
+
+#include <iostream>
+#include <algorithm>
+
+#include "ocl_utils.h"
+#include "ocl_svm_image.h"
+#include "ocl_trace.h"
+#include "ocl_metrics.h"
+
+// bytes of cv::Mat data
+static size_t mat_bytes( const cv::Mat &t_cv_img )
+{
+    return t_cv_img.total() * t_cv_img.elemSize();
+}
+
+/// @copydoc SVMImage::SVMImage(SVMImage&&)
+SVMImage::SVMImage( SVMImage &&t_img ) : SVMImage()
+{
+    *this = std::move( t_img );
+}
+
+/// @copydoc SVMImage::operator=(SVMImage&&)
+SVMImage &SVMImage::operator=( SVMImage &&t_img )
+{
+    if ( this != &t_img )
+    {
+        release();
+        if ( t_img.m_pool ) t_img.m_pool->move( t_img, *this );
+    }
+    return *this;
+}
+
+/// @copydoc SVMImage::release
+void SVMImage::release()
+{
+    if ( m_ocl_img == nullptr ) return;
+
+    m_pool->release( *this );
+}
+
+/// @copydoc SVMImage::mat
+cv::Mat &SVMImage::mat()
+{
+    if ( m_pool ) m_pool->use( *this );
+    return spilled() ? m_host : m_mat;
+}
+
+/// @copydoc SVMImage::ocl
+OCLImage *SVMImage::ocl()
+{
+    if ( m_pool ) m_pool->use( *this );
+    return spilled() ? nullptr : m_ocl_img;
+}
+
+/// @copydoc SVMImagePool::SVMImagePool
+SVMImagePool::SVMImagePool( int t_max_free ) :
+    m_max_free( std::max( 0, t_max_free ) ),
+    m_requests( 0 ), m_hits( 0 ), m_spills( 0 ), m_restores( 0 ), m_tick( 0 )
+{
+    ocl_svm_add_reclaim( this, reclaim_handler );
+}
+
+/// @copydoc SVMImagePool::~SVMImagePool
+SVMImagePool::~SVMImagePool()
+{
+    ocl_svm_remove_reclaim( this );
+    clear();
+}
+
+// free descriptor or nullptr, mutex must be locked
+OCLImage *SVMImagePool::descriptor()
+{
+    if ( m_free_descs.empty() ) return nullptr;
+
+    OCLImage *l_ocl_img = m_free_descs.back();
+    m_free_descs.pop_back();
+    return l_ocl_img;
+}
+
+// image is registered for LRU, descriptor points to data
+SVMImage SVMImagePool::image( const cv::Mat &t_cv_img, OCLImage *t_ocl_img )
+{
+    SVMImage l_img;
+    l_img.m_mat = t_cv_img;
+    l_img.m_ocl_img = t_ocl_img;
+    l_img.m_ocl_img->m_size.x = t_cv_img.cols;
+    l_img.m_ocl_img->m_size.y = t_cv_img.rows;
+    l_img.m_ocl_img->m_data = t_cv_img.data;
+
+    // lock must be released before return, returned image may be moved
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        l_img.m_pool = this;
+        l_img.m_used = ++m_tick;
+        m_images.insert( &l_img );
+    }
+    return l_img;
+}
+
+/// @copydoc SVMImagePool::acquire
+SVMImage SVMImagePool::acquire( cv::Size t_size, int t_type )
+{
+    OCL_TRACE_SCOPE( "SVMImagePool::acquire" );
+    static OCLCounter &s_hits = ocl_counter( "ocl_pool_hits_total" );
+    static OCLCounter &s_misses = ocl_counter( "ocl_pool_misses_total" );
+
+    cv::Mat l_cv_img;
+    OCLImage *l_ocl_img;
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        m_requests++;
+
+        auto l_found = m_free.find( Key( t_size.width, t_size.height, t_type ) );
+        if ( l_found != m_free.end() && !l_found->second.empty() )
+        {
+            l_cv_img = l_found->second.back();
+            l_found->second.pop_back();
+            m_hits++;
+        }
+        l_ocl_img = descriptor();
+    }
+
+    // new descriptor and image are allocated outside of lock, allocation may reclaim memory of pool
+    if ( l_ocl_img == nullptr ) l_ocl_img = ocl_svm_malloc< OCLImage >();
+    if ( l_ocl_img == nullptr )
+    {
+        std::cerr << "Unable to allocate image descriptor!" << std::endl;
+        return SVMImage();
+    }
+
+    ( l_cv_img.empty() ? s_misses : s_hits ).add();
+
+    if ( l_cv_img.empty() )
+    {
+        try
+        {
+            l_cv_img.create( t_size, t_type );
+        }
+        catch ( const cv::Exception & )
+        {
+            std::cerr << "Unable to allocate image " << t_size.width << "x" << t_size.height << "!" << std::endl;
+            std::lock_guard< std::mutex > l_lock( m_mutex );
+            m_free_descs.push_back( l_ocl_img );
+            return SVMImage();
+        }
+    }
+
+    return image( l_cv_img, l_ocl_img );
+}
+
+/// @copydoc SVMImagePool::adopt
+SVMImage SVMImagePool::adopt( const cv::Mat &t_cv_img )
+{
+    OCL_TRACE_SCOPE( "SVMImagePool::adopt" );
+    OCLImage *l_ocl_img;
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        l_ocl_img = descriptor();
+    }
+
+    if ( l_ocl_img == nullptr ) l_ocl_img = ocl_svm_malloc< OCLImage >();
+    if ( l_ocl_img == nullptr )
+    {
+        std::cerr << "Unable to allocate image descriptor!" << std::endl;
+        return SVMImage();
+    }
+
+    // kernel needs rows without gaps
+    return image( t_cv_img.isContinuous() ? t_cv_img : t_cv_img.clone(), l_ocl_img );
+}
+
+// ownership of image is moved into empty t_to
+void SVMImagePool::move( SVMImage &t_from, SVMImage &t_to )
+{
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+
+    m_images.erase( &t_from );
+    m_images.insert( &t_to );
+
+    t_to.m_pool = this;
+    t_to.m_mat = t_from.m_mat;
+    t_to.m_ocl_img = t_from.m_ocl_img;
+    t_to.m_host = t_from.m_host;
+    t_to.m_used = t_from.m_used;
+    t_to.m_pinned = t_from.m_pinned;
+
+    t_from.m_pool = nullptr;
+    t_from.m_mat.release();
+    t_from.m_ocl_img = nullptr;
+    t_from.m_host.release();
+    t_from.m_pinned = false;
+}
+
+// mat and descriptor from image back into pool
+void SVMImagePool::release( SVMImage &t_img )
+{
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+
+    m_images.erase( &t_img );
+    m_free_descs.push_back( t_img.m_ocl_img );
+
+    // mat shared by other owner must not be reused
+    cv::Mat &l_cv_img = t_img.m_mat;
+    if ( !l_cv_img.empty() && l_cv_img.u != nullptr && l_cv_img.u->refcount == 1 )
+    {
+        std::vector< cv::Mat > &l_list = m_free[ Key( l_cv_img.cols, l_cv_img.rows, l_cv_img.type() ) ];
+        if ( l_list.size() < m_max_free )
+        {
+            l_list.push_back( l_cv_img );
+        }
+    }
+
+    t_img.m_pool = nullptr;
+    t_img.m_mat.release();
+    t_img.m_ocl_img = nullptr;
+    t_img.m_host.release();
+    t_img.m_pinned = false;
+}
+
+// image is used now, spilled image is copied back into SVM
+void SVMImagePool::use( SVMImage &t_img )
+{
+    cv::Mat l_host;
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        t_img.m_used = ++m_tick;
+        if ( t_img.m_host.empty() ) return;
+        l_host = t_img.m_host;
+    }
+
+    OCL_TRACE_SCOPE( "SVMImagePool::restore" );
+    static OCLCounter &s_restores = ocl_counter( "ocl_pool_restores_total" );
+
+    cv::Mat l_cv_img;
+    try
+    {
+        l_cv_img.create( l_host.size(), l_host.type() );
+    }
+    catch ( const cv::Exception & )
+    {
+        // image stays in host memory, kernel can not use it
+        std::cerr << "Unable to restore image " << l_host.cols << "x" << l_host.rows << " into SVM!" << std::endl;
+        return;
+    }
+    l_host.copyTo( l_cv_img );
+
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+    t_img.m_mat = l_cv_img;
+    t_img.m_host.release();
+    t_img.m_ocl_img->m_data = l_cv_img.data;
+    m_restores++;
+    s_restores.add();
+}
+
+// bytes of free and used cv::Mat in SVM, mutex must be locked
+size_t SVMImagePool::resident_bytes() const
+{
+    size_t l_bytes = 0;
+    for ( auto &l_pair : m_free )
+    {
+        for ( const cv::Mat &l_cv_img : l_pair.second ) l_bytes += mat_bytes( l_cv_img );
+    }
+    for ( const SVMImage *l_img : m_images )
+    {
+        l_bytes += mat_bytes( l_img->m_mat );
+    }
+    return l_bytes;
+}
+
+// one free cv::Mat is released, mutex must be locked
+size_t SVMImagePool::drop_free()
+{
+    for ( auto &l_pair : m_free )
+    {
+        if ( l_pair.second.empty() ) continue;
+        size_t l_bytes = mat_bytes( l_pair.second.back() );
+        l_pair.second.pop_back();
+        return l_bytes;
+    }
+    return 0;
+}
+
+// the least recently used idle image is moved into host memory, mutex must be locked
+size_t SVMImagePool::spill_lru()
+{
+    static OCLCounter &s_spills = ocl_counter( "ocl_pool_spills_total" );
+
+    SVMImage *l_lru = nullptr;
+    for ( SVMImage *l_img : m_images )
+    {
+        const cv::Mat &l_cv_img = l_img->m_mat;
+        if ( l_img->m_pinned || l_cv_img.empty() || l_cv_img.u == nullptr || l_cv_img.u->refcount != 1 ) continue;
+        if ( l_lru == nullptr || l_img->m_used < l_lru->m_used ) l_lru = l_img;
+    }
+    if ( l_lru == nullptr ) return 0;
+
+    // copy in host memory must not use default SVMMatAllocator
+    size_t l_bytes = mat_bytes( l_lru->m_mat );
+    l_lru->m_host.allocator = cv::Mat::getStdAllocator();
+    l_lru->m_mat.copyTo( l_lru->m_host );
+    l_lru->m_mat.release();
+    l_lru->m_ocl_img->m_data = nullptr;
+    m_spills++;
+    s_spills.add();
+    return l_bytes;
+}
+
+// at least t_bytes are released after failed allocation or over budget
+bool SVMImagePool::reclaim( size_t t_bytes )
+{
+    OCL_TRACE_SCOPE( "SVMImagePool::reclaim" );
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+
+    size_t l_total = 0;
+    while ( l_total < t_bytes )
+    {
+        size_t l_released = drop_free();
+        if ( l_released == 0 ) l_released = spill_lru();
+        if ( l_released == 0 ) break;
+        l_total += l_released;
+    }
+    return l_total > 0;
+}
+
+// handler for ocl_svm_add_reclaim
+bool SVMImagePool::reclaim_handler( void *t_pool, size_t t_bytes )
+{
+    return ( ( SVMImagePool * ) t_pool )->reclaim( t_bytes );
+}
+
+/// @copydoc SVMImagePool::stats
+SVMImagePoolStats SVMImagePool::stats() const
+{
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+
+    SVMImagePoolStats l_stats = { m_requests, m_hits, 0, 0, resident_bytes(), m_spills, m_restores };
+    for ( auto &l_pair : m_free )
+    {
+        for ( const cv::Mat &l_cv_img : l_pair.second )
+        {
+            l_stats.m_cached++;
+            l_stats.m_cached_bytes += mat_bytes( l_cv_img );
+        }
+    }
+    return l_stats;
+}
+
+/// @copydoc SVMImagePool::clear
+void SVMImagePool::clear()
+{
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+
+    m_free.clear();
+    for ( OCLImage *l_ocl_img : m_free_descs )
+    {
+        ocl_svm_free( l_ocl_img );
+    }
+    m_free_descs.clear();
+}
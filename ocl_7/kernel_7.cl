@@ -0,0 +1,129 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course 
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Video stream processing.
+ * Chain of kernels is applied to every frame of video.
+ * 
+ ***************************************************************************/
+
+#include "ocl_image.h"
+
+// kernel for BGR color rotation
+__kernel void rotate_bgr( __global OCLImage *t_ocl_img )
+{
+    // get work-item position  
+    size_t global_idx = get_global_id( 0 );
+    size_t global_idy = get_global_id( 1 );
+
+    // verify work-item position
+    if ( global_idx >= t_ocl_img->m_size.x ) return;
+    if ( global_idy >= t_ocl_img->m_size.y ) return;
+
+    // get one point from image
+    uchar4 l_bgr = t_ocl_img->at4( global_idy, global_idx );
+
+    // rotate colors
+    uchar4 l_bgr_rot;
+    l_bgr_rot.x = l_bgr.y;
+    l_bgr_rot.y = l_bgr.z;
+    l_bgr_rot.z = l_bgr.x;
+
+    // put point into image
+    t_ocl_img->at4( global_idy, global_idx ) = l_bgr_rot;
+}
+
+// **************************************************************************
+// kernel for BGR to BW conversion
+__kernel void convert_bgr_to_bw( __global OCLImage *t_ocl_bgr_img, __global OCLImage *t_ocl_bw_img )
+{
+    // get work-item position  
+    size_t global_idx = get_global_id( 0 );
+    size_t global_idy = get_global_id( 1 );
+
+    // verify work-item position
+    if ( global_idx >= t_ocl_bgr_img->m_size.x ) return;
+    if ( global_idy >= t_ocl_bgr_img->m_size.y ) return;
+
+    // get one point from image
+    uchar4 l_bgr = t_ocl_bgr_img->at4( global_idy, global_idx );
+
+    // convert BGR to BW: 10% Blue + 59% Green + 30% Red
+    //uchar l_bw = l_bgr.x * 0.11f + l_bgr.y * 0.59f + l_bgr.z * 0.30f;
+    uchar l_bw = l_bgr.x * 11 / 100 + l_bgr.y * 59 / 100 + l_bgr.z * 30 / 100;
+
+    // put point into image
+    t_ocl_bw_img->at1( global_idy, global_idx ) = l_bw;
+}
+
+// **************************************************************************
+// kernel for creating dot image with alpha channel 
+__kernel void create_transparent_dot( __global OCLImage *t_ocl_img, uchar4 t_color )
+{
+    // get work-item position  
+    size_t global_idx = get_global_id( 0 );
+    size_t global_idy = get_global_id( 1 );
+
+    // verify work-item position
+    if ( global_idx >= t_ocl_img->m_size.x ) return;
+    if ( global_idy >= t_ocl_img->m_size.y ) return;
+
+    // length of diagonal
+    int l_diagonal = sqrt( ( float ) t_ocl_img->m_size.x * t_ocl_img->m_size.x +
+                                     t_ocl_img->m_size.y * t_ocl_img->m_size.y );
+
+    // relative positions of point from the center 
+    int l_rx = global_idx - t_ocl_img->m_size.x / 2;
+    int l_ry = global_idy - t_ocl_img->m_size.y / 2;
+
+    // distance from the center
+    int l_r = l_diagonal / 2 - sqrt( ( float ) l_rx * l_rx + l_ry * l_ry );
+
+    // transparency decreases from the center
+    t_color.w = 255 * l_r / ( l_diagonal / 2 );
+
+    // set point
+    t_ocl_img->at4( global_idy, global_idx ) = t_color;
+}
+
+// **************************************************************************
+// kernel for inserting image into image
+__kernel void insert_image( __global OCLImage *t_ocl_big_img, __global OCLImage *t_ocl_small_img, int2 t_position )
+{
+    // get work-item position, small image
+    size_t global_idx = get_global_id( 0 );
+    size_t global_idy = get_global_id( 1 );
+
+    // verify work-item position, small image
+    if ( global_idx >= t_ocl_small_img->m_size.x ) return;
+    if ( global_idy >= t_ocl_small_img->m_size.y ) return;
+
+    // position in big image
+    int l_bx = t_position.x + global_idx;
+    int l_by = t_position.y + global_idy;
+
+    // position verification for big image
+    if ( l_bx < 0 || l_bx >= t_ocl_big_img->m_size.x ) return;
+    if ( l_by < 0 || l_by >= t_ocl_big_img->m_size.y ) return;
+
+    // two corresponding points from big and small image
+    uchar4 l_bg_bgr = t_ocl_big_img->at4( l_by, l_bx );
+    uchar4 l_fg_bgr = t_ocl_small_img->at4( global_idy, global_idx );
+
+    uchar4 l_out_bgr = { 0, 0, 0, 255 };
+    // transparency calculation
+    l_out_bgr.x = l_fg_bgr.x * l_fg_bgr.w / 255 + l_bg_bgr.x * ( 255 - l_fg_bgr.w ) / 255;
+    l_out_bgr.y = l_fg_bgr.y * l_fg_bgr.w / 255 + l_bg_bgr.y * ( 255 - l_fg_bgr.w ) / 255;
+    l_out_bgr.z = l_fg_bgr.z * l_fg_bgr.w / 255 + l_bg_bgr.z * ( 255 - l_fg_bgr.w ) / 255;
+
+    // store result into big image
+    t_ocl_big_img->at4( l_by, l_bx ) = l_out_bgr;
+}
+
@@ -0,0 +1,619 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Video stream processing.
+ * Frames from video file or camera are decoded into ring of SVM frames
+ * and chain of kernels is applied to every frame.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <ostream>
+#include <unistd.h>
+#include <iostream>
+#include <math.h>
+#include <thread>
+#include <atomic>
+#include <sstream>
+
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/core_c.h>
+#include <opencv2/core/mat.hpp>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_svm_mat_allocator.h"
+#include "ocl_frame_ring.h"
+
+#define KERNEL_SPV      "kernel_7.spv"
+#define KERNEL_PREFIX   "gpu_"
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+// 
+// BGR colors rotation.
+// Kernel header from kernel*.cl:
+//__kernel void rotate_bgr(            __global OCLImage *t_ocl_img )
+cl_int gpu_rotate_bgr( cl::Program &t_program,  OCLImage *t_ocl_img )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_rotate_bgr( t_program, l_kern_name.c_str(), &l_err );      CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_rotate_bgr.setArg( 0, t_ocl_img );                            CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_rotate_bgr.setSVMPointers( { t_ocl_img, t_ocl_img->m_data } );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK 
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range 
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+    
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_rotate_bgr, 
+            // offset
+            cl::NDRange( 0, 0 ), 
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ), 
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+    
+    // waiting for completion
+    defQueue.finish();
+
+    return CL_SUCCESS;
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+// 
+// Kernel for BGR color rotation
+// Kernel header from kernel*.cl:
+// __kernel void convert_bgr_to_bw(          __global OCLImage *t_ocl_bgr_img,
+//                                           __global OCLImage *t_ocl_bw_img )
+cl_int gpu_convert_bgr_to_bw( cl::Program &t_program, OCLImage *t_ocl_bgr_img,
+                                                      OCLImage *t_ocl_bw_img )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_convert_bgr_to_bw( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_convert_bgr_to_bw.setArg( 0, t_ocl_bgr_img );                CL_ERR_R( l_err );
+    l_err = l_kern_convert_bgr_to_bw.setArg( 1, t_ocl_bw_img );                 CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_convert_bgr_to_bw.setSVMPointers( {
+            t_ocl_bgr_img,
+            t_ocl_bgr_img->m_data,
+            t_ocl_bw_img,
+            t_ocl_bw_img->m_data,
+            } );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_bgr_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_bgr_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_convert_bgr_to_bw,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    // waiting for completion
+    defQueue.finish();
+
+    return CL_SUCCESS;
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Kernel for creating dot image with alpha channel.
+// Kernel header from kernel*.cl:
+// __kernel void create_transparent_dot(          __global OCLImage *t_ocl_img, 
+//                                                         uchar4 t_color )
+cl_int gpu_create_transparent_dot( cl::Program &t_program, OCLImage *t_ocl_img,
+                                                           cl_uchar4 t_color )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_transparent_dot( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_transparent_dot.setArg( 0, t_ocl_img );                      CL_ERR_R( l_err );
+    l_err = l_kern_transparent_dot.setArg( 1, t_color );                        CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_transparent_dot.setSVMPointers( {
+            t_ocl_img,
+            t_ocl_img->m_data,
+            } );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_transparent_dot,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    // waiting for completion
+    defQueue.finish();
+
+    return CL_SUCCESS;
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Kernel for inserting image into image
+// Kernel header from kernel*.cl:
+// __kernel void insert_image(          __global OCLImage *t_ocl_big_img, 
+//                                      __global OCLImage *t_ocl_small_img, 
+//                                               int2 t_position )
+cl_int gpu_insert_image( cl::Program &t_program, OCLImage *t_ocl_big_img,
+                                                 OCLImage *t_ocl_small_img,
+                                                 cl_int2 t_position )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_insert_image( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_insert_image.setArg( 0, t_ocl_big_img );                     CL_ERR_R( l_err );
+    l_err = l_kern_insert_image.setArg( 1, t_ocl_small_img );                   CL_ERR_R( l_err );
+    l_err = l_kern_insert_image.setArg( 2, t_position );                        CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_insert_image.setSVMPointers( {
+            t_ocl_big_img,
+            t_ocl_big_img->m_data,
+            t_ocl_small_img,
+            t_ocl_small_img->m_data,
+            } );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_small_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_small_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_insert_image,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    // waiting for completion
+    defQueue.finish();
+
+    return CL_SUCCESS;
+}
+
+// **************************************************************************
+// Statistics of frame latency and throughput.
+// Latency is measured from decoding of frame to its output into sink.
+// Histogram with fixed buckets is used, so no allocation is needed per frame.
+#define STAT_BUCKET_MS  0.1
+#define STAT_BUCKETS    10000
+
+struct StreamStats
+{
+    long m_frames = 0;
+    double m_lat_sum = 0;
+    double m_lat_min = 1e9;
+    double m_lat_max = 0;
+    long m_hist[ STAT_BUCKETS + 1 ] = { 0 };
+
+    void add( double t_lat_ms )
+    {
+        m_frames++;
+        m_lat_sum += t_lat_ms;
+        m_lat_min = std::min( m_lat_min, t_lat_ms );
+        m_lat_max = std::max( m_lat_max, t_lat_ms );
+        m_hist[ std::min( ( long ) ( t_lat_ms / STAT_BUCKET_MS ), ( long ) STAT_BUCKETS ) ]++;
+    }
+
+    // latency in ms for given percentile 0..100
+    double percentile( double t_perc ) const
+    {
+        long l_limit = ceil( m_frames * t_perc / 100 );
+        long l_count = 0;
+        for ( int i = 0; i <= STAT_BUCKETS; i++ )
+        {
+            l_count += m_hist[ i ];
+            if ( l_count >= l_limit ) return ( i + 1 ) * STAT_BUCKET_MS;
+        }
+        return m_lat_max;
+    }
+};
+
+// **************************************************************************
+// Chain of kernels applied to every frame.
+enum ChainOp { OP_ROTATE, OP_OVERLAY, OP_BW };
+
+bool parse_chain( const std::string &t_chain, std::vector< ChainOp > &t_ops )
+{
+    std::stringstream l_ss( t_chain );
+    std::string l_op;
+    while ( std::getline( l_ss, l_op, ',' ) )
+    {
+        if ( l_op == "rotate" )         t_ops.push_back( OP_ROTATE );
+        else if ( l_op == "overlay" )   t_ops.push_back( OP_OVERLAY );
+        else if ( l_op == "bw" )        t_ops.push_back( OP_BW );
+        else
+        {
+            std::cerr << "Unknown kernel '" << l_op << "' in chain!" << std::endl;
+            return false;
+        }
+        // BW image has one channel, so it must be the last one
+        if ( t_ops.size() > 1 && t_ops[ t_ops.size() - 2 ] == OP_BW )
+        {
+            std::cerr << "Kernel 'bw' must be the last one in chain!" << std::endl;
+            return false;
+        }
+    }
+    return !t_ops.empty();
+}
+
+void usage( const char *t_name )
+{
+    std::cerr << "Usage: " << t_name << " [options] video_file|camera_index" << std::endl;
+    std::cerr << "  -k chain   comma separated kernels: rotate,overlay,bw (default rotate,overlay)" << std::endl;
+    std::cerr << "  -d policy  overload policy: block, newest, oldest (default block for file, oldest for camera)" << std::endl;
+    std::cerr << "  -r slots   number of frames in SVM ring (default 4)" << std::endl;
+    std::cerr << "  -o file    write result into video file" << std::endl;
+    std::cerr << "  -q         no output, frames are only processed" << std::endl;
+}
+
+#define DOT_SIZE        100
+#define REPORT_FRAMES   100
+
+int main( int t_narg, char **t_args )
+{
+    std::string l_chain_str = "rotate,overlay";
+    std::string l_policy_str;
+    std::string l_out_file;
+    int l_slots = 4;
+    bool l_quiet = false;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "k:d:r:o:q" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 'k': l_chain_str = optarg; break;
+        case 'd': l_policy_str = optarg; break;
+        case 'r': l_slots = atoi( optarg ); break;
+        case 'o': l_out_file = optarg; break;
+        case 'q': l_quiet = true; break;
+        default: usage( t_args[ 0 ] ); exit( EXIT_FAILURE );
+        }
+    }
+
+    // check arguments
+    if ( optind >= t_narg || l_slots < 2 )
+    {
+        usage( t_args[ 0 ] );
+        exit( EXIT_FAILURE );
+    }
+
+    std::vector< ChainOp > l_chain;
+    if ( !parse_chain( l_chain_str, l_chain ) )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    // video file or camera?
+    std::string l_source( t_args[ optind ] );
+    bool l_camera = l_source.find_first_not_of( "0123456789" ) == std::string::npos;
+
+    OCLDropPolicy l_policy = l_camera ? OCLDropPolicy::DROP_OLDEST : OCLDropPolicy::BLOCK;
+    if ( l_policy_str == "block" )          l_policy = OCLDropPolicy::BLOCK;
+    else if ( l_policy_str == "newest" )    l_policy = OCLDropPolicy::DROP_NEWEST;
+    else if ( l_policy_str == "oldest" )    l_policy = OCLDropPolicy::DROP_OLDEST;
+    else if ( !l_policy_str.empty() )
+    {
+        usage( t_args[ 0 ] );
+        exit( EXIT_FAILURE );
+    }
+
+    cl_int l_err;
+
+    l_err = ocl_init( 1 );                                                      CL_ERR_E( l_err );
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "Program loaded.\n" << std::endl;
+
+    // creating SVM allocator for cv::Mat
+    SVMMatAllocator svmallocator;
+    cv::Mat::setDefaultAllocator( &svmallocator );
+
+    cv::VideoCapture l_capture;
+    if ( l_camera )
+    {
+        l_capture.open( atoi( l_source.c_str() ) );
+    }
+    else
+    {
+        l_capture.open( l_source );
+    }
+
+    if ( !l_capture.isOpened() )
+    {
+        std::cerr << "Unable to open video '" << l_source << "'." << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    // the first frame gives size of all frames
+    cv::Mat l_cv_decode_img;
+    if ( !l_capture.read( l_cv_decode_img ) || l_cv_decode_img.empty() )
+    {
+        std::cerr << "Unable to read the first frame!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    cv::Size l_size = l_cv_decode_img.size();
+    std::cout << "Video " << l_size.width << "x" << l_size.height << " opened." << std::endl;
+
+    // ring of SVM frames, allocated once
+    OCLFrameRing l_ring( l_slots, l_size, CV_8UC4, l_policy );
+
+    // transparent dot for overlay
+    cv::Mat l_cv_dot_img( DOT_SIZE, DOT_SIZE, CV_8UC4 );
+    OCLImage *l_ocl_dot_img = ocl_svm_malloc< OCLImage >();
+    l_ocl_dot_img->m_size.x = l_cv_dot_img.size().width;
+    l_ocl_dot_img->m_size.y = l_cv_dot_img.size().height;
+    l_ocl_dot_img->m_data = l_cv_dot_img.data;
+
+    gpu_create_transparent_dot( l_program, l_ocl_dot_img, {{ 0, 255, 255, 0 }} );
+
+    // BW output image, used when chain ends with bw
+    cv::Mat l_cv_bw_img( l_size, CV_8UC1 );
+    OCLImage *l_ocl_bw_img = ocl_svm_malloc< OCLImage >();
+    l_ocl_bw_img->m_size.x = l_cv_bw_img.size().width;
+    l_ocl_bw_img->m_size.y = l_cv_bw_img.size().height;
+    l_ocl_bw_img->m_data = l_cv_bw_img.data;
+
+    bool l_bw_out = l_chain.back() == OP_BW;
+
+    // frame sink
+    cv::VideoWriter l_writer;
+    cv::Mat l_cv_sink_img;
+    if ( !l_out_file.empty() )
+    {
+        double l_fps = l_capture.get( cv::CAP_PROP_FPS );
+        l_writer = cv::VideoWriter( l_out_file, cv::VideoWriter::fourcc( 'M', 'J', 'P', 'G' ),
+                                    l_fps > 0 ? l_fps : 25, l_size, !l_bw_out );
+        if ( !l_writer.isOpened() )
+        {
+            std::cerr << "Unable to create video '" << l_out_file << "'." << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    // producer thread decodes frames into ring
+    std::thread l_decoder( [ & ] ()
+    {
+        long l_skipped = 0;
+        do
+        {
+            // frame with different size can't be stored into ring
+            if ( l_cv_decode_img.size() != l_size )
+            {
+                l_skipped++;
+                continue;
+            }
+
+            OCLFrame *l_frame = l_ring.acquire_write();
+            if ( l_frame == nullptr )
+            {
+                // consumer closed ring, camera stream never ends itself
+                if ( l_ring.closed() ) break;
+                continue;                                       // dropped
+            }
+
+            // conversion into existing SVM frame, no allocation
+            cv::cvtColor( l_cv_decode_img, l_frame->m_cv_img, cv::COLOR_BGR2BGRA );
+
+            l_ring.commit_write( l_frame );
+        }
+        while ( l_capture.read( l_cv_decode_img ) );
+
+        if ( l_skipped )
+        {
+            std::cerr << l_skipped << " frames with different size skipped." << std::endl;
+        }
+        l_ring.close();
+    } );
+
+    StreamStats l_stats;
+    long l_window_frames = 0;
+    auto l_start = std::chrono::steady_clock::now();
+    auto l_window_start = l_start;
+
+    // consumer, kernels are applied to frames
+    OCLFrame *l_frame;
+    while ( ( l_frame = l_ring.acquire_read() ) != nullptr )
+    {
+        for ( auto l_op : l_chain )
+        {
+            switch ( l_op )
+            {
+            case OP_ROTATE:
+                gpu_rotate_bgr( l_program, l_frame->m_ocl_img );
+                break;
+
+            case OP_OVERLAY:
+                {
+                    // dot is moving along diagonal
+                    int l_pos = ( l_frame->m_index * 4 ) % std::max( 1, std::min( l_size.width, l_size.height ) );
+                    gpu_insert_image( l_program, l_frame->m_ocl_img, l_ocl_dot_img, {{ l_pos, l_pos }} );
+                }
+                break;
+
+            case OP_BW:
+                gpu_convert_bgr_to_bw( l_program, l_frame->m_ocl_img, l_ocl_bw_img );
+                break;
+            }
+        }
+
+        cv::Mat &l_cv_out_img = l_bw_out ? l_cv_bw_img : l_frame->m_cv_img;
+
+        bool l_quit = false;
+        if ( l_writer.isOpened() )
+        {
+            if ( l_bw_out )
+            {
+                l_writer.write( l_cv_out_img );
+            }
+            else
+            {
+                // sink image is allocated only once
+                cv::cvtColor( l_cv_out_img, l_cv_sink_img, cv::COLOR_BGRA2BGR );
+                l_writer.write( l_cv_sink_img );
+            }
+        }
+        else if ( !l_quiet )
+        {
+            cv::imshow( "Video", l_cv_out_img );
+            l_quit = cv::waitKey( 1 ) == 27;
+        }
+
+        auto l_now = std::chrono::steady_clock::now();
+        l_stats.add( std::chrono::duration< double, std::milli >( l_now - l_frame->m_time ).count() );
+
+        l_ring.release_read( l_frame );
+
+        // periodic report
+        if ( ++l_window_frames == REPORT_FRAMES )
+        {
+            double l_sec = std::chrono::duration< double >( l_now - l_window_start ).count();
+            std::cout << "Frames " << l_stats.m_frames << ": " << l_window_frames / l_sec << " FPS, "
+                      << "latency avg " << l_stats.m_lat_sum / l_stats.m_frames << " ms, "
+                      << "dropped " << l_ring.dropped() << std::endl;
+            l_window_frames = 0;
+            l_window_start = l_now;
+        }
+
+        if ( l_quit )
+        {
+            l_ring.close();
+            break;
+        }
+    }
+
+    l_decoder.join();
+
+    double l_sec = std::chrono::duration< double >( std::chrono::steady_clock::now() - l_start ).count();
+
+    std::cout << "\nProcessed frames:  " << l_stats.m_frames << std::endl;
+    std::cout << "Dropped frames:    " << l_ring.dropped() << std::endl;
+    std::cout << "Sustained FPS:     " << l_stats.m_frames / l_sec << std::endl;
+    if ( l_stats.m_frames > 0 )
+    {
+        std::cout << "Latency [ms]:      min " << l_stats.m_lat_min
+                  << ", avg " << l_stats.m_lat_sum / l_stats.m_frames
+                  << ", p50 " << l_stats.percentile( 50 )
+                  << ", p95 " << l_stats.percentile( 95 )
+                  << ", p99 " << l_stats.percentile( 99 )
+                  << ", max " << l_stats.m_lat_max << std::endl;
+    }
+
+    ocl_svm_free( l_ocl_dot_img );
+    ocl_svm_free( l_ocl_bw_img );
+}
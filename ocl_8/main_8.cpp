@@ -0,0 +1,590 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Host (CPU) execution of kernels.
+ * The same kernel source is executed on GPU and on CPU,
+ * results are compared and execution times are measured.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <ostream>
+#include <unistd.h>
+#include <iostream>
+#include <math.h>
+#include <chrono>
+
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/core_c.h>
+#include <opencv2/core/mat.hpp>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_svm_mat_allocator.h"
+#include "ocl_host_exec.h"
+
+#define KERNEL_SPV      "kernel_8.spv"
+#define KERNEL_PREFIX   "gpu_"
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+// 
+// BGR colors rotation.
+// Kernel header from kernel*.cl:
+//__kernel void rotate_bgr(            __global OCLImage *t_ocl_img )
+cl_int gpu_rotate_bgr( cl::Program &t_program,  OCLImage *t_ocl_img )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_rotate_bgr( t_program, l_kern_name.c_str(), &l_err );      CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_rotate_bgr.setArg( 0, t_ocl_img );                            CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_rotate_bgr.setSVMPointers( { t_ocl_img, t_ocl_img->m_data } );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK 
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range 
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+    
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_rotate_bgr, 
+            // offset
+            cl::NDRange( 0, 0 ), 
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ), 
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+    
+    // waiting for completion
+    defQueue.finish();
+
+    return CL_SUCCESS;
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+// 
+// Kernel for BGR color rotation
+// Kernel header from kernel*.cl:
+// __kernel void convert_bgr_to_bw(          __global OCLImage *t_ocl_bgr_img,
+//                                           __global OCLImage *t_ocl_bw_img )
+cl_int gpu_convert_bgr_to_bw( cl::Program &t_program, OCLImage *t_ocl_bgr_img,
+                                                      OCLImage *t_ocl_bw_img )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_convert_bgr_to_bw( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_convert_bgr_to_bw.setArg( 0, t_ocl_bgr_img );                CL_ERR_R( l_err );
+    l_err = l_kern_convert_bgr_to_bw.setArg( 1, t_ocl_bw_img );                 CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_convert_bgr_to_bw.setSVMPointers( {
+            t_ocl_bgr_img,
+            t_ocl_bgr_img->m_data,
+            t_ocl_bw_img,
+            t_ocl_bw_img->m_data,
+            } );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_bgr_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_bgr_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_convert_bgr_to_bw,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    // waiting for completion
+    defQueue.finish();
+
+    return CL_SUCCESS;
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Kernel for creating chessboard
+// Kernel header from kernel*.cl:
+// __kernel void create_chessboard(          __global OCLImage *t_ocl_img, 
+//                                                    int t_sq_size )
+cl_int gpu_create_chessboard( cl::Program &t_program, OCLImage *t_ocl_img,
+                                                      int t_sq_size )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_create_chessboard( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_create_chessboard.setArg( 0, t_ocl_img );                    CL_ERR_R( l_err );
+    l_err = l_kern_create_chessboard.setArg( 1, t_sq_size );                    CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_create_chessboard.setSVMPointers( {
+            t_ocl_img,
+            t_ocl_img->m_data,
+            } );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_create_chessboard,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    // waiting for completion
+    defQueue.finish();
+
+    return CL_SUCCESS;
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Kernel for creating dot image with alpha channel.
+// Kernel header from kernel*.cl:
+// __kernel void create_transparent_dot(          __global OCLImage *t_ocl_img, 
+//                                                         uchar4 t_color )
+cl_int gpu_create_transparent_dot( cl::Program &t_program, OCLImage *t_ocl_img,
+                                                           cl_uchar4 t_color )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_transparent_dot( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_transparent_dot.setArg( 0, t_ocl_img );                      CL_ERR_R( l_err );
+    l_err = l_kern_transparent_dot.setArg( 1, t_color );                        CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_transparent_dot.setSVMPointers( {
+            t_ocl_img,
+            t_ocl_img->m_data,
+            } );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_transparent_dot,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    // waiting for completion
+    defQueue.finish();
+
+    return CL_SUCCESS;
+}
+
+// **************************************************************************
+// gpu_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix gpu_.
+//
+// Kernel for inserting image into image
+// Kernel header from kernel*.cl:
+// __kernel void insert_image(          __global OCLImage *t_ocl_big_img, 
+//                                      __global OCLImage *t_ocl_small_img, 
+//                                               int2 t_position )
+cl_int gpu_insert_image( cl::Program &t_program, OCLImage *t_ocl_big_img,
+                                                 OCLImage *t_ocl_small_img,
+                                                 cl_int2 t_position )
+{
+    cl_int l_err;
+
+    // removing prefix gpu_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_insert_image( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_insert_image.setArg( 0, t_ocl_big_img );                     CL_ERR_R( l_err );
+    l_err = l_kern_insert_image.setArg( 1, t_ocl_small_img );                   CL_ERR_R( l_err );
+    l_err = l_kern_insert_image.setArg( 2, t_position );                        CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_insert_image.setSVMPointers( {
+            t_ocl_big_img,
+            t_ocl_big_img->m_data,
+            t_ocl_small_img,
+            t_ocl_small_img->m_data,
+            } );
+
+    // get default Queue
+    cl::CommandQueue defQueue = cl::CommandQueue::getDefault();
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_small_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_small_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // Submitting kernel for execution
+    l_err = defQueue.enqueueNDRangeKernel( l_kern_insert_image,
+            // offset
+            cl::NDRange( 0, 0 ),
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ) );                          CL_ERR_R( l_err );
+
+    // waiting for completion
+    defQueue.finish();
+
+    return CL_SUCCESS;
+}
+
+// **************************************************************************
+// Kernels compiled for host as methods of HostKernels.
+struct HostKernels : OCLHostItem
+{
+#include "kernel_8.cl"
+};
+
+// **************************************************************************
+// cpu_ functions for kernels.
+// NDRange is the same as in gpu_ functions, work-groups are executed by thread pool.
+#define CPU_WG_SIZE     16
+
+cl::NDRange cpu_global_range( OCLImage *t_ocl_img )
+{
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( CPU_WG_SIZE - 1 ) ) / CPU_WG_SIZE * CPU_WG_SIZE;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( CPU_WG_SIZE - 1 ) ) / CPU_WG_SIZE * CPU_WG_SIZE;
+    return cl::NDRange( l_gr_size_x, l_gr_size_y );
+}
+
+void cpu_rotate_bgr( OCLHostPool &t_pool, OCLImage *t_ocl_img )
+{
+    ocl_host_enqueue_ndrange< HostKernels >( cl::NDRange( 0, 0 ), cpu_global_range( t_ocl_img ),
+            cl::NDRange( CPU_WG_SIZE, CPU_WG_SIZE ),
+            [ = ] ( HostKernels &k ) { k.rotate_bgr( t_ocl_img ); }, t_pool );
+}
+
+void cpu_convert_bgr_to_bw( OCLHostPool &t_pool, OCLImage *t_ocl_bgr_img, OCLImage *t_ocl_bw_img )
+{
+    ocl_host_enqueue_ndrange< HostKernels >( cl::NDRange( 0, 0 ), cpu_global_range( t_ocl_bgr_img ),
+            cl::NDRange( CPU_WG_SIZE, CPU_WG_SIZE ),
+            [ = ] ( HostKernels &k ) { k.convert_bgr_to_bw( t_ocl_bgr_img, t_ocl_bw_img ); }, t_pool );
+}
+
+void cpu_create_chessboard( OCLHostPool &t_pool, OCLImage *t_ocl_img, int t_sq_size )
+{
+    ocl_host_enqueue_ndrange< HostKernels >( cl::NDRange( 0, 0 ), cpu_global_range( t_ocl_img ),
+            cl::NDRange( CPU_WG_SIZE, CPU_WG_SIZE ),
+            [ = ] ( HostKernels &k ) { k.create_chessboard( t_ocl_img, t_sq_size ); }, t_pool );
+}
+
+void cpu_create_transparent_dot( OCLHostPool &t_pool, OCLImage *t_ocl_img, cl_uchar4 t_color )
+{
+    ocl_host_enqueue_ndrange< HostKernels >( cl::NDRange( 0, 0 ), cpu_global_range( t_ocl_img ),
+            cl::NDRange( CPU_WG_SIZE, CPU_WG_SIZE ),
+            [ = ] ( HostKernels &k ) { k.create_transparent_dot( t_ocl_img, t_color ); }, t_pool );
+}
+
+void cpu_insert_image( OCLHostPool &t_pool, OCLImage *t_ocl_big_img, OCLImage *t_ocl_small_img, cl_int2 t_position )
+{
+    ocl_host_enqueue_ndrange< HostKernels >( cl::NDRange( 0, 0 ), cpu_global_range( t_ocl_small_img ),
+            cl::NDRange( CPU_WG_SIZE, CPU_WG_SIZE ),
+            [ = ] ( HostKernels &k ) { k.insert_image( t_ocl_big_img, t_ocl_small_img, t_position ); }, t_pool );
+}
+
+// **************************************************************************
+// OCLImage for cv::Mat, in SVM when GPU is used.
+OCLImage *create_ocl_image( cv::Mat &t_cv_img, bool t_svm )
+{
+    OCLImage *l_ocl_img = t_svm ? ocl_svm_malloc< OCLImage >() : new OCLImage;
+    l_ocl_img->m_size.x = t_cv_img.size().width;
+    l_ocl_img->m_size.y = t_cv_img.size().height;
+    l_ocl_img->m_data = t_cv_img.data;
+    return l_ocl_img;
+}
+
+// OCLImage from create_ocl_image is released.
+void destroy_ocl_image( OCLImage *t_ocl_img, bool t_svm )
+{
+    if ( t_svm ) ocl_svm_free( t_ocl_img );
+    else delete t_ocl_img;
+}
+
+// Number of different bytes in two images.
+long compare_images( const cv::Mat &t_img1, const cv::Mat &t_img2 )
+{
+    long l_diff = 0;
+    for ( int y = 0; y < t_img1.rows; y++ )
+    {
+        const uchar *l_row1 = t_img1.data + y * t_img1.step;
+        const uchar *l_row2 = t_img2.data + y * t_img2.step;
+        for ( size_t x = 0; x < t_img1.cols * t_img1.elemSize(); x++ )
+        {
+            l_diff += l_row1[ x ] != l_row2[ x ];
+        }
+    }
+    return l_diff;
+}
+
+// Average time of function in ms.
+template< class T_func >
+double measure_ms( int t_repeat, T_func t_func )
+{
+    t_func();       // warm-up
+    auto l_start = std::chrono::steady_clock::now();
+    for ( int i = 0; i < t_repeat; i++ )
+    {
+        t_func();
+    }
+    return std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - l_start ).count() / t_repeat;
+}
+
+// **************************************************************************
+#define IMG_SIZEX   1920
+#define IMG_SIZEY   1080
+
+#define DOT_SIZE    300
+
+int main( int t_narg, char **t_args )
+{
+    bool l_cpu_only = false;
+    int l_repeat = 10;
+    int l_threads = 0;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "cn:t:" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 'c': l_cpu_only = true; break;
+        case 'n': l_repeat = std::max( 1, atoi( optarg ) ); break;
+        case 't': l_threads = atoi( optarg ); break;
+        default:
+            std::cerr << "Usage: " << t_args[ 0 ] << " [-c] [-n repeat] [-t threads] [image]" << std::endl;
+            std::cerr << "  -c  only CPU, OpenCL is not used" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    cl_int l_err;
+    cl::Program l_program;
+
+    // creating SVM allocator for cv::Mat
+    SVMMatAllocator svmallocator;
+
+    if ( !l_cpu_only )
+    {
+        l_err = ocl_init( 1 );                                                  CL_ERR_E( l_err );
+
+        std::cout << "\nInitialization done." << std::endl;
+
+        l_program = ocl_load_program( KERNEL_SPV );
+
+        if ( l_program() == nullptr )
+        {
+            std::cerr << "Program not built!" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+
+        std::cout << "Program loaded.\n" << std::endl;
+
+        cv::Mat::setDefaultAllocator( &svmallocator );
+    }
+
+    // thread pool for CPU
+    OCLHostPool l_pool( l_threads );
+    std::cout << "CPU threads: " << l_pool.threads() << std::endl;
+
+    // source image loaded or created by chessboard kernel
+    cv::Mat l_cv_src_img;
+    if ( optind < t_narg )
+    {
+        l_cv_src_img = cv::imread( t_args[ optind ], cv::IMREAD_COLOR );
+        if ( l_cv_src_img.empty() )
+        {
+            std::cerr << "Unable to open image '" << t_args[ optind ] << "'." << std::endl;
+            exit( EXIT_FAILURE );
+        }
+        cv::cvtColor( l_cv_src_img, l_cv_src_img, cv::COLOR_BGR2BGRA );
+    }
+    else
+    {
+        l_cv_src_img.create( IMG_SIZEY, IMG_SIZEX, CV_8UC4 );
+    }
+
+    cv::Mat l_cv_gpu_img( l_cv_src_img.size(), CV_8UC4 ), l_cv_cpu_img( l_cv_src_img.size(), CV_8UC4 );
+    cv::Mat l_cv_gpu_bw_img( l_cv_src_img.size(), CV_8UC1 ), l_cv_cpu_bw_img( l_cv_src_img.size(), CV_8UC1 );
+    cv::Mat l_cv_gpu_dot_img( DOT_SIZE, DOT_SIZE, CV_8UC4 ), l_cv_cpu_dot_img( DOT_SIZE, DOT_SIZE, CV_8UC4 );
+
+    OCLImage *l_ocl_gpu_img = create_ocl_image( l_cv_gpu_img, !l_cpu_only );
+    OCLImage *l_ocl_cpu_img = create_ocl_image( l_cv_cpu_img, !l_cpu_only );
+    OCLImage *l_ocl_gpu_bw_img = create_ocl_image( l_cv_gpu_bw_img, !l_cpu_only );
+    OCLImage *l_ocl_cpu_bw_img = create_ocl_image( l_cv_cpu_bw_img, !l_cpu_only );
+    OCLImage *l_ocl_gpu_dot_img = create_ocl_image( l_cv_gpu_dot_img, !l_cpu_only );
+    OCLImage *l_ocl_cpu_dot_img = create_ocl_image( l_cv_cpu_dot_img, !l_cpu_only );
+
+    std::cout << "Image " << l_cv_src_img.cols << "x" << l_cv_src_img.rows << ", " << l_repeat << " repetitions.\n" << std::endl;
+    std::cout << std::setw( 24 ) << std::left << "Kernel"
+              << std::setw( 12 ) << "CPU [ms]" << std::setw( 12 ) << "GPU [ms]"
+              << std::setw( 10 ) << "Speedup" << "Diff [bytes]" << std::endl;
+
+    // every test prepares inputs, runs kernel on CPU and GPU and compares outputs
+    auto l_test = [ & ] ( const char *t_name, std::function< void() > t_prepare,
+                          std::function< void() > t_cpu, std::function< void() > t_gpu,
+                          const cv::Mat &t_cpu_out, const cv::Mat &t_gpu_out )
+    {
+        t_prepare();
+        double l_cpu_ms = measure_ms( l_repeat, [ & ] { t_prepare(); t_cpu(); } );
+
+        std::cout << std::setw( 24 ) << std::left << t_name << std::setw( 12 ) << l_cpu_ms;
+        if ( l_cpu_only )
+        {
+            std::cout << std::endl;
+            return;
+        }
+
+        double l_gpu_ms = measure_ms( l_repeat, [ & ] { t_prepare(); t_gpu(); } );
+        std::cout << std::setw( 12 ) << l_gpu_ms << std::setw( 10 ) << l_cpu_ms / l_gpu_ms
+                  << compare_images( t_cpu_out, t_gpu_out ) << std::endl;
+    };
+
+    bool l_loaded = optind < t_narg;
+
+    l_test( "create_chessboard",
+            [] {},
+            [ & ] { cpu_create_chessboard( l_pool, l_ocl_cpu_img, 3 ); },
+            [ & ] { gpu_create_chessboard( l_program, l_ocl_gpu_img, 3 ); },
+            l_cv_cpu_img, l_cv_gpu_img );
+
+    // chessboard is source image when no image was loaded
+    if ( !l_loaded ) l_cv_cpu_img.copyTo( l_cv_src_img );
+
+    l_test( "rotate_bgr",
+            [ & ] { l_cv_src_img.copyTo( l_cv_cpu_img ); l_cv_src_img.copyTo( l_cv_gpu_img ); },
+            [ & ] { cpu_rotate_bgr( l_pool, l_ocl_cpu_img ); },
+            [ & ] { gpu_rotate_bgr( l_program, l_ocl_gpu_img ); },
+            l_cv_cpu_img, l_cv_gpu_img );
+
+    l_test( "convert_bgr_to_bw",
+            [ & ] { l_cv_src_img.copyTo( l_cv_cpu_img ); l_cv_src_img.copyTo( l_cv_gpu_img ); },
+            [ & ] { cpu_convert_bgr_to_bw( l_pool, l_ocl_cpu_img, l_ocl_cpu_bw_img ); },
+            [ & ] { gpu_convert_bgr_to_bw( l_program, l_ocl_gpu_img, l_ocl_gpu_bw_img ); },
+            l_cv_cpu_bw_img, l_cv_gpu_bw_img );
+
+    l_test( "create_transparent_dot",
+            [] {},
+            [ & ] { cpu_create_transparent_dot( l_pool, l_ocl_cpu_dot_img, {{ 0, 0, 255, 0 }} ); },
+            [ & ] { gpu_create_transparent_dot( l_program, l_ocl_gpu_dot_img, {{ 0, 0, 255, 0 }} ); },
+            l_cv_cpu_dot_img, l_cv_gpu_dot_img );
+
+    // the same dot is inserted on CPU and GPU
+    if ( !l_cpu_only ) l_cv_cpu_dot_img.copyTo( l_cv_gpu_dot_img );
+
+    l_test( "insert_image",
+            [ & ] { l_cv_src_img.copyTo( l_cv_cpu_img ); l_cv_src_img.copyTo( l_cv_gpu_img ); },
+            [ & ] { cpu_insert_image( l_pool, l_ocl_cpu_img, l_ocl_cpu_dot_img, {{ 100, 50 }} ); },
+            [ & ] { gpu_insert_image( l_program, l_ocl_gpu_img, l_ocl_gpu_dot_img, {{ 100, 50 }} ); },
+            l_cv_cpu_img, l_cv_gpu_img );
+
+    std::cout << "\nCPU times include copy of source image, GPU times include also launch and finish." << std::endl;
+    std::cout << "Kernels with float functions (sqrt) may differ within OpenCL precision." << std::endl;
+
+    for ( OCLImage *l_ocl_img : { l_ocl_gpu_img, l_ocl_cpu_img, l_ocl_gpu_bw_img, l_ocl_cpu_bw_img, l_ocl_gpu_dot_img, l_ocl_cpu_dot_img } )
+    {
+        destroy_ocl_image( l_ocl_img, !l_cpu_only );
+    }
+}
@@ -0,0 +1,158 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_host_exec.cpp
+ * @brief Host (CPU) execution of OpenCL kernels compiled as C++.
+ *
+ * @details
+ * Source file for thread pool @ref OCLHostPool.
+ *
+ ***************************************************************************/
+
+#include "ocl_host_exec.h"
+
+/// @copydoc OCLHostPool::OCLHostPool
+OCLHostPool::OCLHostPool( int t_threads ) : m_remaining( 0 ), m_generation( 0 ), m_stop( false )
+{
+    if ( t_threads <= 0 )
+    {
+        t_threads = std::max( 1U, std::thread::hardware_concurrency() );
+    }
+
+    // the calling thread is also used for execution
+    for ( int i = 0; i < t_threads; i++ )
+    {
+        m_queues.emplace_back( new TaskQueue );
+    }
+    for ( int i = 1; i < t_threads; i++ )
+    {
+        m_workers.emplace_back( &OCLHostPool::worker, this, i );
+    }
+}
+
+/// @copydoc OCLHostPool::~OCLHostPool
+OCLHostPool::~OCLHostPool()
+{
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        m_stop = true;
+    }
+    m_cond.notify_all();
+
+    for ( auto &l_thread : m_workers )
+    {
+        l_thread.join();
+    }
+}
+
+/// @copydoc OCLHostPool::getDefault
+OCLHostPool &OCLHostPool::getDefault()
+{
+    static OCLHostPool l_pool;
+    return l_pool;
+}
+
+/// @copydoc OCLHostPool::parallel_for
+void OCLHostPool::parallel_for( size_t t_count, size_t t_chunk, const std::function< void( size_t, size_t ) > &t_func )
+{
+    if ( t_count == 0 ) return;
+    if ( t_chunk == 0 ) t_chunk = 1;
+
+    // only one parallel_for at a time
+    std::lock_guard< std::mutex > l_run_lock( m_run_mutex );
+
+    size_t l_tasks = ( t_count + t_chunk - 1 ) / t_chunk;
+    m_remaining = l_tasks;
+
+    // tasks are distributed evenly between queues in continuous blocks
+    size_t l_per_queue = ( l_tasks + m_queues.size() - 1 ) / m_queues.size();
+    for ( size_t t = 0; t < l_tasks; t++ )
+    {
+        TaskQueue &l_queue = *m_queues[ t / l_per_queue ];
+        std::lock_guard< std::mutex > l_lock( l_queue.m_mutex );
+        l_queue.m_tasks.push_back( { t * t_chunk, std::min( t_count, ( t + 1 ) * t_chunk ), &t_func } );
+    }
+
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        m_generation++;
+    }
+    m_cond.notify_all();
+
+    // calling thread works too
+    execute( 0 );
+
+    std::unique_lock< std::mutex > l_lock( m_mutex );
+    m_done_cond.wait( l_lock, [ this ] { return m_remaining == 0; } );
+}
+
+/// @copydoc OCLHostPool::worker
+void OCLHostPool::worker( int t_index )
+{
+    unsigned long l_generation = 0;
+    while ( 1 )
+    {
+        {
+            std::unique_lock< std::mutex > l_lock( m_mutex );
+            m_cond.wait( l_lock, [ & ] { return m_stop || m_generation != l_generation; } );
+            if ( m_stop ) return;
+            l_generation = m_generation;
+        }
+        execute( t_index );
+    }
+}
+
+/// @copydoc OCLHostPool::execute
+void OCLHostPool::execute( int t_index )
+{
+    Task l_task;
+    while ( pop( t_index, l_task ) || steal( t_index, l_task ) )
+    {
+        ( *l_task.m_func )( l_task.m_begin, l_task.m_end );
+
+        if ( --m_remaining == 0 )
+        {
+            std::lock_guard< std::mutex > l_lock( m_mutex );
+            m_done_cond.notify_all();
+        }
+    }
+}
+
+/// @copydoc OCLHostPool::pop
+bool OCLHostPool::pop( int t_index, Task &t_task )
+{
+    // own queue is used from the back
+    TaskQueue &l_queue = *m_queues[ t_index ];
+    std::lock_guard< std::mutex > l_lock( l_queue.m_mutex );
+    if ( l_queue.m_tasks.empty() ) return false;
+    t_task = l_queue.m_tasks.back();
+    l_queue.m_tasks.pop_back();
+    return true;
+}
+
+/// @copydoc OCLHostPool::steal
+bool OCLHostPool::steal( int t_index, Task &t_task )
+{
+    // other queues are used from the front
+    for ( size_t i = 1; i < m_queues.size(); i++ )
+    {
+        TaskQueue &l_queue = *m_queues[ ( t_index + i ) % m_queues.size() ];
+        std::lock_guard< std::mutex > l_lock( l_queue.m_mutex );
+        if ( l_queue.m_tasks.empty() ) continue;
+        t_task = l_queue.m_tasks.front();
+        l_queue.m_tasks.pop_front();
+        return true;
+    }
+    return false;
+}
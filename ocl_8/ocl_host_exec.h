@@ -0,0 +1,296 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_host_exec.h
+ * @brief Host (CPU) execution of OpenCL kernels compiled as C++.
+ *
+ * @details
+ * Kernel sources kernel_*.cl are written in C++ for OpenCL and
+ * @ref OCLImage is available for host and device.
+ * So the same kernel source can be compiled by host compiler
+ * and executed on CPU. Kernels are included into structure derived
+ * from @ref OCLHostItem, which emulates OpenCL built-in functions
+ * get_global_id(), get_local_size(), etc.:
+ *
+ * @code
+ * struct HostKernels : OCLHostItem
+ * {
+ * #include "kernel_8.cl"
+ * };
+ *
+ * ocl_host_enqueue_ndrange< HostKernels >( cl::NDRange( 0, 0 ),
+ *         cl::NDRange( gr_size_x, gr_size_y ), cl::NDRange( 16, 16 ),
+ *         [ = ] ( HostKernels &k ) { k.rotate_bgr( ocl_img ); } );
+ * @endcode
+ *
+ * Work-groups are executed in parallel by @ref OCLHostPool,
+ * work-items of one work-group are executed sequentially, so barriers
+ * and local memory are not supported.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_HOST_EXEC_H
+#define __OCL_HOST_EXEC_H
+
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_image.h"
+
+/**
+ * @name
+ * @brief Address space qualifiers of OpenCL are empty on host.
+ * @{
+*/
+#define __kernel
+#define __global
+#define __constant
+#define __private
+/// @}
+
+/**
+ * @anchor OCLHostItem
+ * @brief Emulation of OpenCL work-item built-in functions and types.
+ *
+ * @details
+ * Kernels compiled as methods of derived structure use these functions
+ * and types instead of OpenCL built-ins. Every thread has its own
+ * instance, so work-item position is not shared between threads
+ * and compiler is able to keep it in registers.
+*/
+struct OCLHostItem
+{
+    /// @name
+    /// @brief OpenCL types used in kernels
+    /// @{
+    using uchar = cl_uchar;
+    using uint = cl_uint;
+    using uchar4 = cl_uchar4;
+    using uint4 = cl_uint4;
+    using int2 = cl_int2;
+    using int4 = cl_int4;
+    using float4 = cl_float4;
+    /// @}
+
+    cl_uint m_work_dim;                     ///< Number of dimensions.
+    size_t m_global_size[ 3 ];              ///< Global range.
+    size_t m_global_offset[ 3 ];            ///< Global offset.
+    size_t m_enqueued_local_size[ 3 ];      ///< Size of work-group.
+    size_t m_num_groups[ 3 ];               ///< Number of work-groups.
+    size_t m_group_id[ 3 ];                 ///< Current work-group.
+    size_t m_local_size[ 3 ];               ///< Size of current (maybe non-uniform) work-group.
+    size_t m_local_id[ 3 ];                 ///< Position of work-item in work-group.
+    size_t m_global_id[ 3 ];                ///< Position of work-item in global range.
+
+    /// @name
+    /// @brief OpenCL math functions with float precision
+    /// @{
+    static inline float sqrt( float x ) { return std::sqrt( x ); }
+    static inline double sqrt( double x ) { return std::sqrt( x ); }
+    /// @}
+
+    /// @name
+    /// @brief OpenCL work-item functions
+    /// @{
+    inline cl_uint get_work_dim() const { return m_work_dim; }
+    inline size_t get_global_size( cl_uint d ) const { return d < 3 ? m_global_size[ d ] : 1; }
+    inline size_t get_global_id( cl_uint d ) const { return d < 3 ? m_global_id[ d ] : 0; }
+    inline size_t get_global_offset( cl_uint d ) const { return d < 3 ? m_global_offset[ d ] : 0; }
+    inline size_t get_local_size( cl_uint d ) const { return d < 3 ? m_local_size[ d ] : 1; }
+    inline size_t get_enqueued_local_size( cl_uint d ) const { return d < 3 ? m_enqueued_local_size[ d ] : 1; }
+    inline size_t get_local_id( cl_uint d ) const { return d < 3 ? m_local_id[ d ] : 0; }
+    inline size_t get_num_groups( cl_uint d ) const { return d < 3 ? m_num_groups[ d ] : 1; }
+    inline size_t get_group_id( cl_uint d ) const { return d < 3 ? m_group_id[ d ] : 0; }
+    /// @}
+};
+
+/**
+ * @anchor OCLHostPool
+ * @brief Thread pool with work-stealing used for execution of work-groups.
+ *
+ * @details
+ * Every worker thread has its own queue of tasks. When it is empty,
+ * tasks are stolen from queues of other workers.
+ * The calling thread helps with execution until all tasks are done.
+*/
+class OCLHostPool
+{
+public:
+    /**
+     * @brief Start of worker threads.
+     * @param t_threads Number of threads, 0 - number of CPU cores.
+    */
+    explicit OCLHostPool( int t_threads = 0 );
+
+    /**
+     * @brief Stop and join of all threads.
+    */
+    ~OCLHostPool();
+
+    OCLHostPool( const OCLHostPool & ) = delete;
+    OCLHostPool &operator=( const OCLHostPool & ) = delete;
+
+    /**
+     * @brief Parallel execution of range [0, t_count) split into chunks.
+     * @param t_count Number of elements.
+     * @param t_chunk Number of elements in one task.
+     * @param t_func Function called for every chunk [begin, end).
+    */
+    void parallel_for( size_t t_count, size_t t_chunk, const std::function< void( size_t, size_t ) > &t_func );
+
+    /**
+     * @brief Number of threads including the calling thread.
+    */
+    int threads() const { return m_workers.size() + 1; }
+
+    /**
+     * @brief Pool shared by whole program.
+    */
+    static OCLHostPool &getDefault();
+
+protected:
+    /// @cond
+    struct Task
+    {
+        size_t m_begin, m_end;
+        const std::function< void( size_t, size_t ) > *m_func;
+    };
+
+    struct TaskQueue
+    {
+        std::mutex m_mutex;
+        std::deque< Task > m_tasks;
+    };
+
+    std::vector< std::thread > m_workers;
+    std::vector< std::unique_ptr< TaskQueue > > m_queues;
+    std::atomic< size_t > m_remaining;
+    unsigned long m_generation;
+    bool m_stop;
+    std::mutex m_mutex;
+    std::mutex m_run_mutex;
+    std::condition_variable m_cond;
+    std::condition_variable m_done_cond;
+
+    void worker( int t_index );
+    void execute( int t_index );
+    bool pop( int t_index, Task &t_task );
+    bool steal( int t_index, Task &t_task );
+    /// @endcond
+};
+
+/**
+ * @anchor ocl_host_enqueue_ndrange
+ * @brief Execution of kernel on host in NDRange.
+ *
+ * @details
+ * Arguments correspond to cl::CommandQueue::enqueueNDRangeKernel.
+ * Global range does not have to be a multiple of work-group size,
+ * the last work-groups are then non-uniform (OpenCL 2.0).
+ * Function returns when all work-items are done.
+ *
+ * @param T_kernels Structure derived from @ref OCLHostItem with kernels.
+ * @param t_offset Global offset.
+ * @param t_global Global range.
+ * @param t_local Size of work-group or cl::NullRange.
+ * @param t_call Callable object with kernel call, e.g. lambda [ = ] ( T_kernels &k ) { k.kernel( args ); }.
+ * @param t_pool Thread pool for execution.
+*/
+template< class T_kernels, class T_call >
+void ocl_host_enqueue_ndrange( const cl::NDRange &t_offset, const cl::NDRange &t_global, const cl::NDRange &t_local,
+                               T_call t_call, OCLHostPool &t_pool = OCLHostPool::getDefault() )
+{
+    T_kernels l_proto;
+
+    l_proto.m_work_dim = t_global.dimensions();
+    size_t l_groups = 1;
+    for ( cl_uint d = 0; d < 3; d++ )
+    {
+        bool l_used = d < l_proto.m_work_dim;
+        l_proto.m_global_size[ d ] = l_used ? t_global.get()[ d ] : 1;
+        l_proto.m_global_offset[ d ] = l_used && t_offset.dimensions() > d ? t_offset.get()[ d ] : 0;
+        // without work-group size, rows are used as work-groups
+        if ( t_local.dimensions() > d )
+        {
+            l_proto.m_enqueued_local_size[ d ] = t_local.get()[ d ];
+        }
+        else
+        {
+            l_proto.m_enqueued_local_size[ d ] = d == 0 ? l_proto.m_global_size[ 0 ] : 1;
+        }
+        l_proto.m_num_groups[ d ] = ( l_proto.m_global_size[ d ] + l_proto.m_enqueued_local_size[ d ] - 1 )
+                                    / l_proto.m_enqueued_local_size[ d ];
+        l_groups *= l_proto.m_num_groups[ d ];
+    }
+
+    if ( l_groups == 0 ) return;
+
+    // more tasks than threads for load balancing
+    size_t l_chunk = std::max< size_t >( 1, l_groups / ( t_pool.threads() * 8 ) );
+
+    t_pool.parallel_for( l_groups, l_chunk, [ & ] ( size_t t_begin, size_t t_end )
+    {
+        // one copy of work-item state for this thread
+        T_kernels l_item( l_proto );
+
+        for ( size_t g = t_begin; g < t_end; g++ )
+        {
+            l_item.m_group_id[ 0 ] = g % l_item.m_num_groups[ 0 ];
+            l_item.m_group_id[ 1 ] = g / l_item.m_num_groups[ 0 ] % l_item.m_num_groups[ 1 ];
+            l_item.m_group_id[ 2 ] = g / l_item.m_num_groups[ 0 ] / l_item.m_num_groups[ 1 ];
+
+            size_t l_first[ 3 ];
+            for ( int d = 0; d < 3; d++ )
+            {
+                size_t l_start = l_item.m_group_id[ d ] * l_item.m_enqueued_local_size[ d ];
+                l_item.m_local_size[ d ] = std::min( l_item.m_enqueued_local_size[ d ], l_item.m_global_size[ d ] - l_start );
+                l_first[ d ] = l_item.m_global_offset[ d ] + l_start;
+            }
+
+            for ( size_t lz = 0; lz < l_item.m_local_size[ 2 ]; lz++ )
+            {
+                l_item.m_local_id[ 2 ] = lz;
+                l_item.m_global_id[ 2 ] = l_first[ 2 ] + lz;
+
+                for ( size_t ly = 0; ly < l_item.m_local_size[ 1 ]; ly++ )
+                {
+                    l_item.m_local_id[ 1 ] = ly;
+                    l_item.m_global_id[ 1 ] = l_first[ 1 ] + ly;
+
+                    // inner loop over one row of work-group, kernel call is inlined
+                    size_t l_size_x = l_item.m_local_size[ 0 ];
+                    for ( size_t lx = 0; lx < l_size_x; lx++ )
+                    {
+                        l_item.m_local_id[ 0 ] = lx;
+                        l_item.m_global_id[ 0 ] = l_first[ 0 ] + lx;
+                        t_call( l_item );
+                    }
+                }
+            }
+        }
+    } );
+}
+
+#endif // __OCL_HOST_EXEC_H
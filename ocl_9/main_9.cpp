@@ -0,0 +1,287 @@
+/** *************************************************************************
+ *
+ * Demo program for teaching the course
+ * Computer Architectures and Parallel Systems.
+ *
+ * GPU Programming using OpenCL
+ *
+ * 02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ * petr.olivka@vsb.cz
+ * https:/poli.cs.vsb.cz/edu/apps
+ *
+ * Co-execution of kernels on GPU and host CPU.
+ * Rows of image are split between GPU and CPU, the ratio of split
+ * is learned from times of previous frames.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <ostream>
+#include <unistd.h>
+#include <iostream>
+#include <math.h>
+#include <chrono>
+
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/core_c.h>
+#include <opencv2/core/mat.hpp>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_image.h"
+#include "ocl_svm_mat_allocator.h"
+#include "ocl_host_exec.h"
+#include "ocl_coexec.h"
+
+#define KERNEL_SPV      "kernel_9.spv"
+#define KERNEL_PREFIX   "coexec_"
+
+// **************************************************************************
+// Kernels compiled for host as methods of HostKernels.
+struct HostKernels : OCLHostItem
+{
+#include "kernel_9.cl"
+};
+
+// **************************************************************************
+// coexec_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix coexec_.
+//
+// BGR colors rotation.
+// Kernel header from kernel*.cl:
+//__kernel void rotate_bgr(            __global OCLImage *t_ocl_img )
+cl_int coexec_rotate_bgr( OCLCoExec &t_coexec, cl::Program &t_program, OCLImage *t_ocl_img )
+{
+    cl_int l_err;
+
+    // removing prefix coexec_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_rotate_bgr( t_program, l_kern_name.c_str(), &l_err );      CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_rotate_bgr.setArg( 0, t_ocl_img );                            CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_rotate_bgr.setSVMPointers( { t_ocl_img, t_ocl_img->m_data } );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // rows are split between device and host, both parts are finished
+    return t_coexec.enqueue< HostKernels >( l_kern_rotate_bgr,
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ),
+            // host part
+            [ = ] ( HostKernels &k ) { k.rotate_bgr( t_ocl_img ); } );
+}
+
+// **************************************************************************
+// coexec_ function for kernel.
+// Kernel name is automatically created from this function name
+// removing prefix coexec_.
+//
+// Kernel for BGR to BW conversion
+// Kernel header from kernel*.cl:
+// __kernel void convert_bgr_to_bw(          __global OCLImage *t_ocl_bgr_img,
+//                                           __global OCLImage *t_ocl_bw_img )
+cl_int coexec_convert_bgr_to_bw( OCLCoExec &t_coexec, cl::Program &t_program, OCLImage *t_ocl_bgr_img,
+                                                                           OCLImage *t_ocl_bw_img )
+{
+    cl_int l_err;
+
+    // removing prefix coexec_
+    std::string l_kern_name( __FUNCTION__ );
+    if ( l_kern_name.find( KERNEL_PREFIX ) == 0 )
+    {
+        l_kern_name.erase( 0, strlen( KERNEL_PREFIX ) );
+    }
+
+    // select the kernel from opencl program
+    cl::Kernel l_kern_convert_bgr_to_bw( t_program, l_kern_name.c_str(), &l_err );  CL_ERR_R( l_err );
+
+    // set kernel arguments
+    l_err = l_kern_convert_bgr_to_bw.setArg( 0, t_ocl_bgr_img );                CL_ERR_R( l_err );
+    l_err = l_kern_convert_bgr_to_bw.setArg( 1, t_ocl_bw_img );                 CL_ERR_R( l_err );
+
+    // list of SVM pointers for data synchronization
+    l_kern_convert_bgr_to_bw.setSVMPointers( {
+            t_ocl_bgr_img,
+            t_ocl_bgr_img->m_data,
+            t_ocl_bw_img,
+            t_ocl_bw_img->m_data,
+            } );
+
+    // size of workgroup, should be multiple of 64, so 256 is OK
+    int l_wg_size_x = 16;
+    int l_wg_size_y = 16;
+    // global range
+    int l_gr_size_x = ( t_ocl_bgr_img->m_size.x + ( l_wg_size_x - 1 ) ) / l_wg_size_x * l_wg_size_x;
+    int l_gr_size_y = ( t_ocl_bgr_img->m_size.y + ( l_wg_size_y - 1 ) ) / l_wg_size_y * l_wg_size_y;
+
+    // rows are split between device and host, both parts are finished
+    return t_coexec.enqueue< HostKernels >( l_kern_convert_bgr_to_bw,
+            // global range
+            cl::NDRange( l_gr_size_x, l_gr_size_y ),
+            // work-group
+            cl::NDRange( l_wg_size_x, l_wg_size_y ),
+            // host part
+            [ = ] ( HostKernels &k ) { k.convert_bgr_to_bw( t_ocl_bgr_img, t_ocl_bw_img ); } );
+}
+
+// **************************************************************************
+#define IMG_SIZEX   3840
+#define IMG_SIZEY   2160
+
+int main( int t_narg, char **t_args )
+{
+    int l_frames = 100;
+    float l_ratio = 0.5;
+    bool l_fixed = false;
+
+    int l_opt;
+    while ( ( l_opt = getopt( t_narg, t_args, "n:r:f" ) ) != -1 )
+    {
+        switch ( l_opt )
+        {
+        case 'n': l_frames = std::max( 1, atoi( optarg ) ); break;
+        case 'r': l_ratio = atof( optarg ); break;
+        case 'f': l_fixed = true; break;
+        default:
+            std::cerr << "Usage: " << t_args[ 0 ] << " [-n frames] [-r ratio] [-f] [image]" << std::endl;
+            std::cerr << "  -r  initial part of rows for GPU, 0.0 - 1.0" << std::endl;
+            std::cerr << "  -f  ratio is fixed, it is not learned" << std::endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    cl_int l_err;
+
+    l_err = ocl_init( 1 );                                                      CL_ERR_E( l_err );
+
+    std::cout << "\nInitialization done." << std::endl;
+
+    cl::Program l_program( ocl_load_program( KERNEL_SPV ) );
+
+    if ( l_program() == nullptr )
+    {
+        std::cerr << "Program not built!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+
+    std::cout << "Program loaded.\n" << std::endl;
+
+    // creating SVM allocator for cv::Mat
+    SVMMatAllocator svmallocator;
+    cv::Mat::setDefaultAllocator( &svmallocator );
+
+    // image loaded from file or empty image
+    cv::Mat l_cv_src_img;
+    if ( optind < t_narg )
+    {
+        l_cv_src_img = cv::imread( t_args[ optind ], cv::IMREAD_COLOR );
+        if ( l_cv_src_img.empty() )
+        {
+            std::cerr << "Unable to open image '" << t_args[ optind ] << "'." << std::endl;
+            exit( EXIT_FAILURE );
+        }
+        cv::cvtColor( l_cv_src_img, l_cv_src_img, cv::COLOR_BGR2BGRA );
+    }
+    else
+    {
+        l_cv_src_img.create( IMG_SIZEY, IMG_SIZEX, CV_8UC4 );
+        l_cv_src_img.setTo( cv::Scalar( 50, 100, 150, 0 ) );
+    }
+
+    // images written by GPU and CPU at once must be in fine-grain SVM
+    cl_svm_mem_flags l_svm_flags = OCLCoExec::svm_flags();
+    unsigned char *l_bgr_data = ocl_svm_malloc< unsigned char >( l_cv_src_img.total() * 4, l_svm_flags );
+    unsigned char *l_bw_data = ocl_svm_malloc< unsigned char >( l_cv_src_img.total(), l_svm_flags );
+    if ( l_bgr_data == nullptr || l_bw_data == nullptr )
+    {
+        std::cerr << "Unable to allocate SVM images!" << std::endl;
+        exit( EXIT_FAILURE );
+    }
+    cv::Mat l_cv_bgr_img( l_cv_src_img.size(), CV_8UC4, l_bgr_data );
+    cv::Mat l_cv_bw_img( l_cv_src_img.size(), CV_8UC1, l_bw_data );
+
+    // BGR OCLImage for kernel
+    OCLImage *l_ocl_bgr_img = ocl_svm_malloc< OCLImage >( 1, l_svm_flags );
+    l_ocl_bgr_img->m_size.x = l_cv_bgr_img.size().width;
+    l_ocl_bgr_img->m_size.y = l_cv_bgr_img.size().height;
+    l_ocl_bgr_img->m_data = l_cv_bgr_img.data;
+
+    // BW OCLImage for kernel
+    OCLImage *l_ocl_bw_img = ocl_svm_malloc< OCLImage >( 1, l_svm_flags );
+    l_ocl_bw_img->m_size.x = l_cv_bw_img.size().width;
+    l_ocl_bw_img->m_size.y = l_cv_bw_img.size().height;
+    l_ocl_bw_img->m_data = l_cv_bw_img.data;
+
+    // separate learning for every kernel, kernels have different speed on GPU and CPU
+    OCLCoExec l_coexec_rotate( l_ratio, l_fixed ? 0 : 0.3 );
+    OCLCoExec l_coexec_bw( l_ratio, l_fixed ? 0 : 0.3 );
+
+    // the same frames only on GPU for comparison
+    OCLCoExec l_gpu_only( 1.0, 0 );
+
+    std::cout << "Image " << l_cv_src_img.cols << "x" << l_cv_src_img.rows << ", " << l_frames << " frames." << std::endl;
+    if ( !l_coexec_rotate.enabled() )
+    {
+        std::cout << "Co-execution is not available, only GPU is used." << std::endl;
+    }
+
+    double l_coexec_ms = 0, l_gpu_ms = 0;
+
+    for ( int f = 0; f < l_frames; f++ )
+    {
+        l_cv_src_img.copyTo( l_cv_bgr_img );
+
+        auto l_start = std::chrono::steady_clock::now();
+        coexec_rotate_bgr( l_coexec_rotate, l_program, l_ocl_bgr_img );
+        coexec_convert_bgr_to_bw( l_coexec_bw, l_program, l_ocl_bgr_img, l_ocl_bw_img );
+        auto l_end = std::chrono::steady_clock::now();
+        l_coexec_ms += std::chrono::duration< double, std::milli >( l_end - l_start ).count();
+
+        if ( f % 10 == 0 )
+        {
+            std::cout << "Frame " << std::setw( 4 ) << f
+                      << "  rotate_bgr GPU " << std::setw( 5 ) << std::setprecision( 2 ) << std::fixed
+                      << l_coexec_rotate.ratio() * 100 << "% "
+                      << "(GPU " << l_coexec_rotate.device_ms() << " ms, CPU " << l_coexec_rotate.host_ms() << " ms)"
+                      << "  convert_bgr_to_bw GPU " << std::setw( 5 ) << l_coexec_bw.ratio() * 100 << "% "
+                      << "(GPU " << l_coexec_bw.device_ms() << " ms, CPU " << l_coexec_bw.host_ms() << " ms)" << std::endl;
+        }
+
+        l_cv_src_img.copyTo( l_cv_bgr_img );
+
+        l_start = std::chrono::steady_clock::now();
+        coexec_rotate_bgr( l_gpu_only, l_program, l_ocl_bgr_img );
+        coexec_convert_bgr_to_bw( l_gpu_only, l_program, l_ocl_bgr_img, l_ocl_bw_img );
+        l_end = std::chrono::steady_clock::now();
+        l_gpu_ms += std::chrono::duration< double, std::milli >( l_end - l_start ).count();
+    }
+
+    std::cout << "\nAverage frame time GPU only:     " << l_gpu_ms / l_frames << " ms" << std::endl;
+    std::cout << "Average frame time GPU and CPU:  " << l_coexec_ms / l_frames << " ms" << std::endl;
+
+    cv::imshow( "BW Image", l_cv_bw_img );
+    cv::waitKey( 0 );
+
+    ocl_svm_free( l_ocl_bgr_img );
+    ocl_svm_free( l_ocl_bw_img );
+    ocl_svm_free( l_bgr_data );
+    ocl_svm_free( l_bw_data );
+}
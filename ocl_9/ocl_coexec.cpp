@@ -0,0 +1,96 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_coexec.cpp
+ * @brief Co-execution of one kernel launch on OpenCL device and host CPU.
+ *
+ * @details
+ * Source file for class @ref OCLCoExec.
+ *
+ ***************************************************************************/
+
+#include <cmath>
+#include <iostream>
+
+#include "ocl_coexec.h"
+
+/// @copydoc OCLCoExec::OCLCoExec
+OCLCoExec::OCLCoExec( float t_ratio, float t_smoothing, OCLHostPool &t_pool ) :
+    m_pool( t_pool ), m_ratio( t_ratio ), m_smoothing( t_smoothing ), m_enabled( false ), m_dev_ms( 0 ), m_host_ms( 0 )
+{
+    cl_int l_err;
+
+    cl::Device l_device = cl::Device::getDefault();
+
+    // host and device can write into one buffer at the same time only with fine-grain SVM
+    m_enabled = supported( l_device );
+
+    if ( !m_enabled )
+    {
+        std::cerr << "Device has no fine-grain SVM buffers, co-execution disabled." << std::endl;
+    }
+
+    m_queue = cl::CommandQueue( cl::Context::getDefault(), l_device, CL_QUEUE_PROFILING_ENABLE, &l_err ); CL_ERR_C( l_err );
+}
+
+/// @copydoc OCLCoExec::supported
+bool OCLCoExec::supported( const cl::Device &t_device )
+{
+    cl_device_svm_capabilities l_caps = t_device.getInfo< CL_DEVICE_SVM_CAPABILITIES >();
+    return ( l_caps & CL_DEVICE_SVM_FINE_GRAIN_BUFFER ) != 0;
+}
+
+/// @copydoc OCLCoExec::svm_flags
+cl_svm_mem_flags OCLCoExec::svm_flags()
+{
+    return CL_MEM_READ_WRITE | ( supported() ? CL_MEM_SVM_FINE_GRAIN_BUFFER : 0 );
+}
+
+/// @copydoc OCLCoExec::split_rows
+size_t OCLCoExec::split_rows( size_t t_rows, size_t t_wg_rows ) const
+{
+    size_t l_groups = t_rows / t_wg_rows;
+    if ( l_groups < 2 )
+    {
+        return t_rows;
+    }
+
+    long l_dev_groups = lround( m_ratio * l_groups );
+
+    // fixed ratio is used as it is, 0.0 or 1.0 is host or device only
+    if ( m_smoothing > 0 )
+    {
+        l_dev_groups = std::max( 1L, std::min( ( long ) l_groups - 1, l_dev_groups ) );
+    }
+
+    return l_dev_groups * t_wg_rows;
+}
+
+/// @copydoc OCLCoExec::update
+void OCLCoExec::update( size_t t_dev_rows, size_t t_host_rows )
+{
+    if ( t_dev_rows == 0 || t_host_rows == 0 || m_dev_ms <= 0 || m_host_ms <= 0 )
+    {
+        return;
+    }
+
+    // rows per ms
+    double l_dev_speed = t_dev_rows / m_dev_ms;
+    double l_host_speed = t_host_rows / m_host_ms;
+
+    // both parts finish at the same time with this ratio
+    double l_ratio = l_dev_speed / ( l_dev_speed + l_host_speed );
+
+    m_ratio = ( 1 - m_smoothing ) * m_ratio + m_smoothing * l_ratio;
+}
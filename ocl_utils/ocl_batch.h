@@ -0,0 +1,159 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_batch.h
+ * @brief Many small images processed by one kernel launch.
+ *
+ * @details
+ * Header file for class @ref OCLBatcher.
+ *
+ * Launch of kernel for small image (thumbnail, sprite) takes more time
+ * than its computation. So images are gathered into batch and processed
+ * by one 1D NDRange over all pixels of all images. Batched kernel gets
+ * array of descriptors and prefix sum of pixel counts, work-item finds
+ * its image by binary search in prefix sum.
+ *
+ * Batch is launched when it is full (number of images or pixels),
+ * or when the oldest image waits longer than latency budget.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_BATCH_H
+#define __OCL_BATCH_H
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_image.h"
+
+/**
+ * @brief One batch in SVM prepared for batched kernel.
+*/
+struct OCLBatch
+{
+    cl_uint m_count;                ///< Number of images.
+    OCLImage *m_ocl_src_imgs;       ///< Array of source descriptors.
+    OCLImage *m_ocl_dst_imgs;       ///< Array of destination descriptors.
+    cl_int2 *m_positions;           ///< Array of positions, e.g. in destination image.
+    cl_uint *m_prefix;              ///< Prefix sum of source pixels, m_count + 1 elements.
+    std::vector< void * > m_svm_ptrs;   ///< All SVM pointers for setSVMPointers.
+
+    /// Number of all pixels in batch.
+    cl_uint pixels() const { return m_prefix[ m_count ]; }
+};
+
+/**
+ * @brief Function which launches batched kernel and waits for it.
+*/
+using OCLBatchLaunch = std::function< cl_int( OCLBatch &t_batch ) >;
+
+/**
+ * @anchor OCLBatcher
+ * @brief Gathering of small images into batches up to size or latency budget.
+*/
+class OCLBatcher
+{
+public:
+    /**
+     * @brief Allocation of batch arrays and start of launching thread.
+     *
+     * @details
+     * When arrays can not be allocated, error is printed and batcher
+     * stays failed: @ref ok is false, @ref add and @ref flush return
+     * CL_OUT_OF_RESOURCES.
+     *
+     * @param t_launch Launch of batched kernel.
+     * @param t_max_images Max. number of images in one batch.
+     * @param t_max_pixels Batch is launched when it has more pixels.
+     * @param t_max_latency_ms Max. waiting time of the first image in batch.
+    */
+    OCLBatcher( OCLBatchLaunch t_launch, int t_max_images = 256, size_t t_max_pixels = 1 << 22, double t_max_latency_ms = 1.0 );
+
+    /**
+     * @brief Remaining images are launched, thread is joined.
+    */
+    ~OCLBatcher();
+
+    OCLBatcher( const OCLBatcher & ) = delete;
+    OCLBatcher &operator=( const OCLBatcher & ) = delete;
+
+    /**
+     * @brief Image is added into batch, descriptors are copied.
+     * @param t_src Source image, its pixels are processed.
+     * @param t_dst Destination image or nullptr.
+     * @param t_position Position of source in destination image.
+     * @return Future with result of batch launch, ready with error of failed batcher.
+    */
+    std::shared_future< cl_int > add( const OCLImage *t_src, const OCLImage *t_dst = nullptr, cl_int2 t_position = {} );
+
+    /**
+     * @brief Pending images are launched without waiting for budget.
+     * @return CL_SUCCESS or error of failed batcher.
+    */
+    cl_int flush();
+
+    /// Batch arrays were allocated and launching thread runs.
+    bool ok() const { return m_error == CL_SUCCESS; }
+
+    /// Number of launched batches.
+    size_t batches() const { return m_batches; }
+
+    /// Number of launched images.
+    size_t images() const { return m_images; }
+
+protected:
+    /// @cond
+    struct Item
+    {
+        OCLImage m_src;
+        OCLImage m_dst;
+        cl_int2 m_position;
+    };
+
+    OCLBatchLaunch m_launch;
+    size_t m_max_images;
+    size_t m_max_pixels;
+    std::chrono::duration< double, std::milli > m_max_latency;
+
+    std::vector< Item > m_pending;
+    size_t m_pending_pixels;
+    std::chrono::steady_clock::time_point m_first_time;
+    std::promise< cl_int > m_promise;
+    std::shared_future< cl_int > m_future;
+
+    OCLBatch m_batch;
+    std::atomic< size_t > m_batches;
+    std::atomic< size_t > m_images;
+    cl_int m_error;
+    bool m_force;
+    bool m_stop;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::condition_variable m_space_cond;
+    std::thread m_thread;
+
+    void run();
+    void launch( std::vector< Item > &t_items, std::promise< cl_int > &t_promise );
+    /// @endcond
+};
+
+#endif // __OCL_BATCH_H
@@ -0,0 +1,132 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_bench.h
+ * @brief Benchmark of kernels timed by profiling events.
+ *
+ * @details
+ * Header file for class @ref OCLBench.
+ *
+ * Wall clock around enqueue and finish measures also driver overhead
+ * and synchronization. Kernel is here enqueued into profiling queue
+ * several times for warm-up, then every repetition is timed by its
+ * event and median is used, so one slow run does not spoil result.
+ *
+ * Results are written as CSV or JSON. CSV file can be used later
+ * as baseline and results slower than baseline are reported.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_BENCH_H
+#define __OCL_BENCH_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <istream>
+
+#include <CL/opencl.hpp>
+
+/**
+ * @brief One measured kernel, size and work-group.
+*/
+struct OCLBenchResult
+{
+    std::string m_device;       ///< Name of device.
+    std::string m_kernel;       ///< Name of kernel.
+    int m_width;                ///< Width of image or length of vector.
+    int m_height;               ///< Height of image, 1 for vector.
+    int m_wg_x;                 ///< Width of work-group.
+    int m_wg_y;                 ///< Height of work-group.
+    size_t m_items;             ///< Pixels or elements processed by kernel.
+    size_t m_bytes;             ///< Bytes read and written by kernel.
+    int m_repeat;               ///< Number of timed runs.
+    double m_min_ms;            ///< The fastest run.
+    double m_median_ms;         ///< Median of runs.
+    double m_mean_ms;           ///< Mean of runs.
+
+    /// Bandwidth of median run in GB/s.
+    double gbps() const { return m_median_ms > 0 ? m_bytes / m_median_ms / 1e6 : 0; }
+
+    /// Throughput of median run in Mpixel/s.
+    double mpixs() const { return m_median_ms > 0 ? m_items / m_median_ms / 1e3 : 0; }
+};
+
+/**
+ * @anchor OCLBench
+ * @brief Timing of kernels by events with warm-up and repetitions.
+ *
+ * @details
+ * Kernel arguments and SVM pointers must be set before @ref run.
+*/
+class OCLBench
+{
+public:
+    /**
+     * @brief Profiling queue on default device.
+     * @param t_warmup Runs before timing.
+     * @param t_repeat Timed runs.
+    */
+    OCLBench( int t_warmup = 3, int t_repeat = 10 );
+
+    /**
+     * @brief Kernel is measured, result is added to list.
+     * @param t_name Name of kernel in results.
+     * @param t_kernel Kernel with arguments.
+     * @param t_width Width of image or length of vector.
+     * @param t_height Height of image, 1 for vector.
+     * @param t_global Global range.
+     * @param t_local Work-group size.
+     * @param t_items Pixels or elements processed by kernel.
+     * @param t_bytes Bytes read and written by kernel.
+     * @return CL_SUCCESS or error code, result is not added on error.
+    */
+    cl_int run( const std::string &t_name, cl::Kernel &t_kernel, int t_width, int t_height,
+                const cl::NDRange &t_global, const cl::NDRange &t_local, size_t t_items, size_t t_bytes );
+
+    /// All results.
+    const std::vector< OCLBenchResult > &results() const { return m_results; }
+
+    /// Results as CSV with header line.
+    void write_csv( std::ostream &t_stream ) const;
+
+    /// Results as JSON array.
+    void write_json( std::ostream &t_stream ) const;
+
+    /**
+     * @brief Results from CSV written by @ref write_csv.
+     * @return Results, empty when stream has no valid line.
+    */
+    static std::vector< OCLBenchResult > read_csv( std::istream &t_stream );
+
+    /**
+     * @brief Results are compared with baseline of the same device, kernel, size and work-group.
+     * @param t_baseline Results from @ref read_csv.
+     * @param t_tolerance Allowed slowdown of median, 0.1 - 10%.
+     * @param t_stream Stream for report.
+     * @return Number of regressions.
+    */
+    int compare( const std::vector< OCLBenchResult > &t_baseline, double t_tolerance, std::ostream &t_stream ) const;
+
+protected:
+    /// @cond
+    cl::CommandQueue m_queue;
+    std::string m_device;
+    int m_warmup;
+    int m_repeat;
+    std::vector< OCLBenchResult > m_results;
+    /// @endcond
+};
+
+#endif // __OCL_BENCH_H
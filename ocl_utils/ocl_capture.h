@@ -0,0 +1,199 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_capture.h
+ * @brief Capture of kernel launches into file for offline replay.
+ *
+ * @details
+ * Header file for classes @ref OCLCaptureLaunch and @ref OCLCaptureFile
+ * and functions @ref ocl_capture_start and @ref ocl_capture_stop.
+ *
+ * Capture is started by environment variable OCL_CAPTURE with name of file,
+ * e.g. OCL_CAPTURE=ball.ocap ./ocl_6 ball.png. Every @ref launch writes
+ * one record: kernel name, ranges, values of arguments, SVM buffers
+ * with hash of content before and after kernel, host time and device time.
+ * Program is stored once as SPIR-V, so capture does not need sources.
+ *
+ * Content of buffers is stored once for every hash, loop over the same
+ * images stores only changed data. OCL_CAPTURE_DATA=0 stores only hashes,
+ * file is small, but replay can not check results.
+ *
+ * Size of SVM buffer is known only for memory from @ref ocl_svm_malloc,
+ * capture records all allocations by hooks of ocl_utils.
+ *
+ * File is binary in byte order of host:
+ * - header "OCLCAP1\n",
+ * - 'P' program: id, size, SPIR-V,
+ * - 'D' data: hash, size, bytes,
+ * - 'L' launch: program id, name, ranges, arguments, buffers, times.
+ *
+ * File is replayed by ocl_22 on any device with SVM, CPU device like PoCL
+ * is selected by OCL_DEVICE_TYPE=CPU.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_CAPTURE_H
+#define __OCL_CAPTURE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <atomic>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_image.h"
+
+/// @cond
+// written under lock by start and stop, read by any thread
+extern std::atomic< bool > g_ocl_capture_on;
+/// @endcond
+
+/**
+ * @anchor ocl_capture_start
+ * @brief Capture of launches is started into new file.
+ * @param t_file_name Name of capture file.
+ * @param t_data Content of buffers is stored, otherwise only hashes.
+ * @return false when file can not be created.
+*/
+bool ocl_capture_start( const std::string &t_file_name, bool t_data = true );
+
+/**
+ * @anchor ocl_capture_stop
+ * @brief Capture is stopped and file is closed.
+ * @return true when all records were written.
+*/
+bool ocl_capture_stop();
+
+/// Capture is on.
+inline bool ocl_capture_on() { return g_ocl_capture_on.load( std::memory_order_relaxed ); }
+
+/// Hash of memory content, FNV-1a over 64 bit words.
+unsigned long long ocl_capture_hash( const void *t_data, size_t t_size );
+
+/**
+ * @anchor OCLCaptureLaunch
+ * @brief Record of one launch, used by @ref launch.
+ *
+ * @details
+ * Arguments are added in order of kernel header before enqueue,
+ * inputs are hashed and stored immediately. finish() after completion
+ * hashes outputs and writes record.
+*/
+class OCLCaptureLaunch
+{
+public:
+    /**
+     * @brief Launch of kernel t_name from t_program.
+     * @param t_program Program, its SPIR-V is stored with the first launch.
+     * @param t_name Name of kernel.
+     * @param t_global Global range.
+     * @param t_local Work-group size or cl::NullRange.
+    */
+    OCLCaptureLaunch( const cl::Program &t_program, const char *t_name, const cl::NDRange &t_global, const cl::NDRange &t_local );
+
+    /// Plain value argument.
+    void value( const void *t_ptr, size_t t_size );
+
+    /// SVM pointer argument.
+    void buffer( const void *t_ptr );
+
+    /// Image argument, descriptor and its data.
+    void image( const OCLImage *t_ocl_img );
+
+    /**
+     * @brief Outputs are hashed and record is written.
+     * @param t_event Completed event of kernel with profiling, or nullptr.
+     * @param t_host_ns Host time of launch with waiting.
+    */
+    void finish( const cl::Event *t_event, long long t_host_ns );
+
+protected:
+    /// @cond
+    struct Buffer
+    {
+        unsigned m_id;
+        const void *m_base;
+        size_t m_size;
+        unsigned long long m_hash_in;
+    };
+
+    unsigned add_buffer( const void *t_ptr, size_t &t_offset );
+
+    std::string m_record;           // program, name and ranges
+    std::string m_args;
+    unsigned m_num_args;
+    std::vector< Buffer > m_buffers;
+    /// @endcond
+};
+
+/**
+ * @brief Argument of captured launch.
+*/
+struct OCLCapturedArg
+{
+    char m_kind;                    ///< 'V' - value, 'B' - buffer, 'I' - image.
+    std::vector< char > m_value;    ///< Bytes of value.
+    unsigned m_buffer;              ///< Buffer of pointer or of image data.
+    size_t m_offset;                ///< Offset of pointer in buffer.
+    unsigned m_width;               ///< Width of image.
+    unsigned m_height;              ///< Height of image.
+};
+
+/**
+ * @brief SVM buffer used by captured launch.
+*/
+struct OCLCapturedBuffer
+{
+    unsigned m_id;                  ///< Id of allocation, the same for all launches.
+    size_t m_size;                  ///< Size in bytes, 0 - unknown allocation.
+    unsigned long long m_hash_in;   ///< Hash of content before kernel.
+    unsigned long long m_hash_out;  ///< Hash of content after kernel.
+};
+
+/**
+ * @brief One captured launch.
+*/
+struct OCLCapturedLaunch
+{
+    unsigned m_program;                         ///< Index of program.
+    std::string m_kernel;                       ///< Name of kernel.
+    int m_dims;                                 ///< Dimensions of ranges.
+    size_t m_global[ 3 ];                       ///< Global range.
+    size_t m_local[ 3 ];                        ///< Work-group size, 0 - NullRange.
+    std::vector< OCLCapturedArg > m_args;       ///< Arguments in order of kernel header.
+    std::vector< OCLCapturedBuffer > m_buffers; ///< Buffers of arguments.
+    long long m_host_ns;                        ///< Host time of launch with waiting.
+    long long m_exec_ns;                        ///< Device time, 0 - queue without profiling.
+};
+
+/**
+ * @anchor OCLCaptureFile
+ * @brief Content of capture file for replay.
+*/
+class OCLCaptureFile
+{
+public:
+    /**
+     * @brief All records are read.
+     * @return false for missing file or wrong header, truncated file keeps complete records.
+    */
+    bool load( const std::string &t_file_name );
+
+    std::vector< std::vector< char > > m_programs;                  ///< SPIR-V of programs by id.
+    std::map< unsigned long long, std::vector< char > > m_data;     ///< Content of buffers by hash.
+    std::vector< OCLCapturedLaunch > m_launches;                    ///< Launches in order of completion.
+};
+
+#endif // __OCL_CAPTURE_H
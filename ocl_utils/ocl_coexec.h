@@ -0,0 +1,185 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_coexec.h
+ * @brief Co-execution of one kernel launch on OpenCL device and host CPU.
+ *
+ * @details
+ * Header file for class @ref OCLCoExec.
+ * Rows of 2D NDRange are split between OpenCL device and host threads
+ * (see @ref ocl_host_enqueue_ndrange). Device part is submitted first,
+ * then host computes its rows while device is working. Both parts write
+ * directly into the same SVM memory.
+ *
+ * Split ratio is learned from timings of previous launches, so both
+ * parts should finish at the same time.
+ *
+ * Concurrent access of host and device into one SVM buffer requires
+ * fine-grain SVM buffer. All memory used by kernel, including @ref OCLImage
+ * descriptors, must be allocated by @ref ocl_svm_malloc with flags
+ * CL_MEM_READ_WRITE | CL_MEM_SVM_FINE_GRAIN_BUFFER, see @ref svm_flags.
+ * On devices without fine-grain SVM co-execution is disabled and the whole
+ * NDRange is executed by device.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_COEXEC_H
+#define __OCL_COEXEC_H
+
+#include <chrono>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_utils.h"
+#include "ocl_host_exec.h"
+
+/**
+ * @anchor OCLCoExec
+ * @brief Split of 2D kernel launch between OpenCL device and host CPU.
+*/
+class OCLCoExec
+{
+public:
+    /**
+     * @brief Creation of profiling queue for default device and context.
+     * @param t_ratio Initial part of rows executed by device, 0.0 - 1.0.
+     * @param t_smoothing Weight of the last measurement for learning of ratio, 0.0 - ratio is fixed.
+     * @param t_pool Thread pool for host part.
+    */
+    OCLCoExec( float t_ratio = 0.5, float t_smoothing = 0.3, OCLHostPool &t_pool = OCLHostPool::getDefault() );
+
+    /**
+     * @brief Execution of kernel on device and host, function waits for both parts.
+     *
+     * @details
+     * Arguments of t_kernel must be already set including SVM pointers.
+     * Global range in y must be a multiple of work-group size in y.
+     *
+     * @param T_kernels Structure derived from @ref OCLHostItem with kernels.
+     * @param t_kernel Kernel for device part.
+     * @param t_global 2D global range.
+     * @param t_local 2D work-group size.
+     * @param t_call Kernel call for host part, see @ref ocl_host_enqueue_ndrange.
+     * @return cl_int error code or CL_SUCCESS.
+    */
+    template< class T_kernels, class T_call >
+    cl_int enqueue( cl::Kernel &t_kernel, const cl::NDRange &t_global, const cl::NDRange &t_local, T_call t_call );
+
+    /**
+     * @brief Current part of rows executed by device.
+    */
+    float ratio() const { return m_ratio; }
+
+    /**
+     * @brief Co-execution is possible with current device.
+    */
+    bool enabled() const { return m_enabled; }
+
+    /**
+     * @brief Device supports fine-grain SVM buffers.
+    */
+    static bool supported( const cl::Device &t_device = cl::Device::getDefault() );
+
+    /**
+     * @anchor svm_flags
+     * @brief Flags of @ref ocl_svm_malloc for memory shared by device and host part.
+     * @return Fine-grain flags when co-execution is supported, otherwise coarse-grain.
+    */
+    static cl_svm_mem_flags svm_flags();
+
+    /**
+     * @brief Time of device part in the last launch, in ms.
+    */
+    double device_ms() const { return m_dev_ms; }
+
+    /**
+     * @brief Time of host part in the last launch, in ms.
+    */
+    double host_ms() const { return m_host_ms; }
+
+protected:
+    cl::CommandQueue m_queue;       ///< Queue with profiling.
+    OCLHostPool &m_pool;            ///< Threads for host part.
+    float m_ratio;                  ///< Part of rows for device.
+    float m_smoothing;              ///< Weight of new measurement.
+    bool m_enabled;                 ///< Device has fine-grain SVM buffers.
+    double m_dev_ms;                ///< The last device time.
+    double m_host_ms;               ///< The last host time.
+
+    /**
+     * @brief Number of rows for device, multiple of work-group rows.
+     * When ratio is learned, both parts get at least one row of work-groups,
+     * so both can be measured.
+    */
+    size_t split_rows( size_t t_rows, size_t t_wg_rows ) const;
+
+    /**
+     * @brief Update of ratio from throughput of device and host.
+    */
+    void update( size_t t_dev_rows, size_t t_host_rows );
+};
+
+/// @copydoc OCLCoExec::enqueue
+template< class T_kernels, class T_call >
+cl_int OCLCoExec::enqueue( cl::Kernel &t_kernel, const cl::NDRange &t_global, const cl::NDRange &t_local, T_call t_call )
+{
+    cl_int l_err;
+
+    size_t l_size_x = t_global.get()[ 0 ];
+    size_t l_rows = t_global.get()[ 1 ];
+    size_t l_wg_rows = t_local.dimensions() > 1 ? t_local.get()[ 1 ] : 1;
+
+    size_t l_dev_rows = m_enabled ? split_rows( l_rows, l_wg_rows ) : l_rows;
+    size_t l_host_rows = l_rows - l_dev_rows;
+
+    // device part is submitted first, rows [0, l_dev_rows)
+    cl::Event l_event;
+    if ( l_dev_rows > 0 )
+    {
+        l_err = m_queue.enqueueNDRangeKernel( t_kernel,
+                // offset
+                cl::NDRange( 0, 0 ),
+                // global range
+                cl::NDRange( l_size_x, l_dev_rows ),
+                // work-group
+                t_local, nullptr, &l_event );                                   CL_ERR_R( l_err );
+        m_queue.flush();
+    }
+
+    // host part, rows [l_dev_rows, l_rows)
+    m_host_ms = 0;
+    if ( l_host_rows > 0 )
+    {
+        auto l_start = std::chrono::steady_clock::now();
+        ocl_host_enqueue_ndrange< T_kernels >( cl::NDRange( 0, l_dev_rows ), cl::NDRange( l_size_x, l_host_rows ),
+                                               t_local, t_call, m_pool );
+        m_host_ms = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - l_start ).count();
+    }
+
+    // waiting for device part
+    m_dev_ms = 0;
+    if ( l_dev_rows > 0 )
+    {
+        l_err = l_event.wait();                                                 CL_ERR_R( l_err );
+        // time from submission includes also launch overhead
+        m_dev_ms = ( l_event.getProfilingInfo< CL_PROFILING_COMMAND_END >() -
+                     l_event.getProfilingInfo< CL_PROFILING_COMMAND_QUEUED >() ) / 1e6;
+    }
+
+    update( l_dev_rows, l_host_rows );
+
+    return CL_SUCCESS;
+}
+
+#endif // __OCL_COEXEC_H
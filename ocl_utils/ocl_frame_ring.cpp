@@ -0,0 +1,169 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_frame_ring.cpp
+ * @brief Ring of SVM frames for video stream processing.
+ *
+ * @details
+ * Source file for class @ref OCLFrameRing.
+ *
+ ***************************************************************************/
+
+#include "ocl_utils.h"
+#include "ocl_frame_ring.h"
+
+/// @copydoc OCLFrameRing::OCLFrameRing
+OCLFrameRing::OCLFrameRing( int t_slots, cv::Size t_size, int t_type, OCLDropPolicy t_policy ) :
+    m_frames( t_slots ), m_policy( t_policy ), m_dropped( 0 ), m_next_index( 0 ), m_closed( false )
+{
+    for ( auto &l_frame : m_frames )
+    {
+        // cv::Mat::data is allocated by default allocator, it should be SVMMatAllocator
+        l_frame.m_cv_img.create( t_size, t_type );
+
+        l_frame.m_ocl_img = ocl_svm_malloc< OCLImage >();
+        l_frame.m_ocl_img->m_size.x = l_frame.m_cv_img.size().width;
+        l_frame.m_ocl_img->m_size.y = l_frame.m_cv_img.size().height;
+        l_frame.m_ocl_img->m_data = l_frame.m_cv_img.data;
+
+        l_frame.m_index = -1;
+        l_frame.m_state = OCLFrame::FREE;
+    }
+}
+
+/// @copydoc OCLFrameRing::~OCLFrameRing
+OCLFrameRing::~OCLFrameRing()
+{
+    for ( auto &l_frame : m_frames )
+    {
+        ocl_svm_free( l_frame.m_ocl_img );
+    }
+}
+
+/// @copydoc OCLFrameRing::find_free
+OCLFrame *OCLFrameRing::find_free()
+{
+    for ( auto &l_frame : m_frames )
+    {
+        if ( l_frame.m_state == OCLFrame::FREE ) return &l_frame;
+    }
+    return nullptr;
+}
+
+/// @copydoc OCLFrameRing::acquire_write
+OCLFrame *OCLFrameRing::acquire_write()
+{
+    std::unique_lock< std::mutex > l_lock( m_mutex );
+
+    OCLFrame *l_frame = find_free();
+
+    if ( l_frame == nullptr )
+    {
+        switch ( m_policy )
+        {
+        case OCLDropPolicy::BLOCK:
+            m_cond.wait( l_lock, [ & ] { return m_closed || ( l_frame = find_free() ) != nullptr; } );
+            break;
+
+        case OCLDropPolicy::DROP_NEWEST:
+            m_dropped++;
+            m_next_index++;
+            return nullptr;
+
+        case OCLDropPolicy::DROP_OLDEST:
+            // the oldest ready frame is reused, it was not yet taken by consumer
+            if ( !m_ready.empty() )
+            {
+                l_frame = m_ready.front();
+                m_ready.pop_front();
+                m_dropped++;
+            }
+            else
+            {
+                // all frames are in use by consumer, drop new one
+                m_dropped++;
+                m_next_index++;
+                return nullptr;
+            }
+            break;
+        }
+    }
+
+    if ( m_closed || l_frame == nullptr ) return nullptr;
+
+    l_frame->m_state = OCLFrame::WRITING;
+    l_frame->m_index = m_next_index++;
+    return l_frame;
+}
+
+/// @copydoc OCLFrameRing::commit_write
+void OCLFrameRing::commit_write( OCLFrame *t_frame )
+{
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        t_frame->m_time = std::chrono::steady_clock::now();
+        t_frame->m_state = OCLFrame::READY;
+        m_ready.push_back( t_frame );
+    }
+    m_cond.notify_all();
+}
+
+/// @copydoc OCLFrameRing::acquire_read
+OCLFrame *OCLFrameRing::acquire_read()
+{
+    std::unique_lock< std::mutex > l_lock( m_mutex );
+
+    m_cond.wait( l_lock, [ & ] { return m_closed || !m_ready.empty(); } );
+
+    if ( m_ready.empty() ) return nullptr;
+
+    OCLFrame *l_frame = m_ready.front();
+    m_ready.pop_front();
+    l_frame->m_state = OCLFrame::READING;
+    return l_frame;
+}
+
+/// @copydoc OCLFrameRing::release_read
+void OCLFrameRing::release_read( OCLFrame *t_frame )
+{
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        t_frame->m_state = OCLFrame::FREE;
+    }
+    m_cond.notify_all();
+}
+
+/// @copydoc OCLFrameRing::close
+void OCLFrameRing::close()
+{
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        m_closed = true;
+    }
+    m_cond.notify_all();
+}
+
+/// @copydoc OCLFrameRing::closed
+bool OCLFrameRing::closed() const
+{
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+    return m_closed;
+}
+
+/// @copydoc OCLFrameRing::dropped
+long OCLFrameRing::dropped() const
+{
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+    return m_dropped;
+}
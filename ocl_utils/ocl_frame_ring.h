@@ -0,0 +1,150 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_frame_ring.h
+ * @brief Ring of SVM frames for video stream processing.
+ *
+ * @details
+ * Header file for class @ref OCLFrameRing.
+ * The ring contains a fixed number of frames allocated in Share Virtual
+ * Memory (SVM) together with their @ref OCLImage descriptors.
+ * All memory is allocated once in constructor, so no allocation is
+ * necessary per frame.
+ *
+ * One producer (decoder) thread writes frames into ring
+ * and one consumer thread reads frames from ring.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_FRAME_RING_H
+#define __OCL_FRAME_RING_H
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+
+#include <opencv2/core/mat.hpp>
+
+#include "ocl_image.h"
+
+/**
+ * @brief Policy used by @ref OCLFrameRing when producer is faster than consumer.
+*/
+enum class OCLDropPolicy
+{
+    BLOCK,              ///< Producer waits for free frame, no frame is dropped.
+    DROP_NEWEST,        ///< New decoded frame is dropped.
+    DROP_OLDEST,        ///< The oldest frame waiting for processing is dropped.
+};
+
+/**
+ * @brief One frame in @ref OCLFrameRing.
+*/
+struct OCLFrame
+{
+    cv::Mat m_cv_img;                               ///< Frame image with 4 channels in SVM.
+    OCLImage *m_ocl_img;                            ///< Descriptor of m_cv_img in SVM.
+    long m_index;                                   ///< Sequence number of frame in stream.
+    std::chrono::steady_clock::time_point m_time;   ///< Time when frame was decoded.
+
+    /// @cond
+    enum { FREE, WRITING, READY, READING } m_state;
+    /// @endcond
+};
+
+/**
+ * @anchor OCLFrameRing
+ * @brief Ring of reusable SVM frames between producer and consumer thread.
+ *
+ * @details
+ * Producer calls @ref acquire_write, fills frame and calls @ref commit_write.
+ * Consumer calls @ref acquire_read, processes frame and calls @ref release_read.
+ * Frames are passed to consumer in order of their commit.
+*/
+class OCLFrameRing
+{
+public:
+    /**
+     * @brief Allocation of all frames and descriptors.
+     * @param t_slots Number of frames in ring.
+     * @param t_size Size of frames.
+     * @param t_type Type of frames, usually CV_8UC4.
+     * @param t_policy Policy for overload, see @ref OCLDropPolicy.
+    */
+    OCLFrameRing( int t_slots, cv::Size t_size, int t_type, OCLDropPolicy t_policy );
+
+    /**
+     * @brief Deallocation of all descriptors.
+    */
+    ~OCLFrameRing();
+
+    OCLFrameRing( const OCLFrameRing & ) = delete;
+    OCLFrameRing &operator=( const OCLFrameRing & ) = delete;
+
+    /**
+     * @brief Get free frame for producer.
+     * @return Frame for writing or nullptr when frame was dropped or ring is closed.
+    */
+    OCLFrame *acquire_write();
+
+    /**
+     * @brief Pass written frame to consumer.
+     * @param t_frame Frame from @ref acquire_write.
+    */
+    void commit_write( OCLFrame *t_frame );
+
+    /**
+     * @brief Get the oldest ready frame for consumer, function waits for frame.
+     * @return Frame for reading or nullptr when ring is closed and empty.
+    */
+    OCLFrame *acquire_read();
+
+    /**
+     * @brief Return processed frame back into ring.
+     * @param t_frame Frame from @ref acquire_read.
+    */
+    void release_read( OCLFrame *t_frame );
+
+    /**
+     * @brief End of stream. Waiting threads are woken up.
+    */
+    void close();
+
+    /**
+     * @brief Ring was closed, producer should stop reading of stream.
+    */
+    bool closed() const;
+
+    /**
+     * @brief Number of dropped frames.
+    */
+    long dropped() const;
+
+protected:
+    std::vector< OCLFrame > m_frames;       ///< All frames.
+    std::deque< OCLFrame * > m_ready;       ///< Ready frames in order of commit.
+    OCLDropPolicy m_policy;                 ///< Overload policy.
+    long m_dropped;                         ///< Counter of dropped frames.
+    long m_next_index;                      ///< Next sequence number.
+    bool m_closed;                          ///< End of stream flag.
+    mutable std::mutex m_mutex;             ///< Access to ring.
+    std::condition_variable m_cond;         ///< Change of ring state.
+
+    /// Find frame in FREE state, or nullptr.
+    OCLFrame *find_free();
+};
+
+#endif // __OCL_FRAME_RING_H
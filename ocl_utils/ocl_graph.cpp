@@ -0,0 +1,321 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_graph.cpp
+ * @brief Graph of image operations executed by events on more queues.
+ *
+ * @details
+ * Source file for class @ref OCLGraph.
+ *
+ ***************************************************************************/
+
+#include <set>
+#include <iostream>
+#include <algorithm>
+
+#include "ocl_utils.h"
+#include "ocl_graph.h"
+
+/// @copydoc OCLGraph::OCLGraph
+OCLGraph::OCLGraph( int t_queues ) : m_reuses( 0 ), m_error( CL_SUCCESS ), m_planned( false )
+{
+    cl_int l_err;
+
+    // in-order queues, order between queues is given only by events
+    for ( int q = 0; q < std::max( 1, t_queues ); q++ )
+    {
+        m_queues.push_back( cl::CommandQueue( cl::Context::getDefault(), cl::Device::getDefault(), 0, &l_err ) );  CL_ERR_C( l_err );
+    }
+}
+
+/// @copydoc OCLGraph::~OCLGraph
+OCLGraph::~OCLGraph()
+{
+    release_buffers();
+    for ( Image &l_img : m_images )
+    {
+        if ( l_img.m_bytes ) ocl_svm_free( l_img.m_ocl_img );
+    }
+}
+
+/// @copydoc OCLGraph::image(OCLImage*)
+int OCLGraph::image( OCLImage *t_ocl_img )
+{
+    m_images.push_back( { t_ocl_img, 0, -1, -1, -1 } );
+    return m_images.size() - 1;
+}
+
+/// @copydoc OCLGraph::image(int,int,int)
+int OCLGraph::image( int t_width, int t_height, int t_elem_size )
+{
+    // data are assigned by plan
+    OCLImage *l_ocl_img = ocl_svm_malloc< OCLImage >();
+    if ( l_ocl_img == nullptr )
+    {
+        std::cerr << "Unable to allocate image descriptor!" << std::endl;
+        m_error = CL_OUT_OF_RESOURCES;
+        return -1;
+    }
+    l_ocl_img->m_size.x = t_width;
+    l_ocl_img->m_size.y = t_height;
+    l_ocl_img->m_data = nullptr;
+
+    m_images.push_back( { l_ocl_img, ( size_t ) t_width * t_height * t_elem_size, -1, -1, -1 } );
+    m_planned = false;
+    return m_images.size() - 1;
+}
+
+/// @copydoc OCLGraph::add
+int OCLGraph::add( const std::string &t_name, OCLGraphLaunch t_launch, const std::vector< int > &t_in, const std::vector< int > &t_out )
+{
+    // node with image not created by graph would make run fail later
+    for ( auto *l_ids : { &t_in, &t_out } )
+    {
+        for ( int l_id : *l_ids )
+        {
+            if ( l_id < 0 || l_id >= ( int ) m_images.size() )
+            {
+                std::cerr << "Node '" << t_name << "' uses unknown image " << l_id << "!" << std::endl;
+                if ( m_error == CL_SUCCESS ) m_error = CL_INVALID_VALUE;
+                return -1;
+            }
+        }
+    }
+
+    Node l_node;
+    l_node.m_name = t_name;
+    l_node.m_launch = t_launch;
+    l_node.m_in = t_in;
+    l_node.m_out = t_out;
+    l_node.m_queue = 0;
+    m_nodes.push_back( l_node );
+    m_planned = false;
+    return m_nodes.size() - 1;
+}
+
+/// @copydoc OCLGraph::release_buffers
+void OCLGraph::release_buffers()
+{
+    for ( Buffer &l_buf : m_buffers )
+    {
+        ocl_svm_free( l_buf.m_data );
+    }
+    m_buffers.clear();
+}
+
+/// @copydoc OCLGraph::plan
+cl_int OCLGraph::plan()
+{
+    release_buffers();
+    m_reuses = 0;
+
+    // lifetime of images, nodes are in order of declaration, so it is topological order
+    std::vector< std::vector< int > > l_users( m_images.size() );
+    for ( Image &l_img : m_images ) l_img.m_first = l_img.m_last = -1;
+    for ( int i = 0; i < ( int ) m_nodes.size(); i++ )
+    {
+        for ( auto *l_ids : { &m_nodes[ i ].m_in, &m_nodes[ i ].m_out } )
+        {
+            for ( int l_id : *l_ids )
+            {
+                Image &l_img = m_images[ l_id ];
+                if ( l_img.m_first < 0 ) l_img.m_first = i;
+                l_img.m_last = i;
+                if ( l_users[ l_id ].empty() || l_users[ l_id ].back() != i ) l_users[ l_id ].push_back( i );
+            }
+        }
+    }
+
+    // dependencies from data: read after write, write after write and write after read
+    std::vector< int > l_writer( m_images.size(), -1 );
+    std::vector< std::vector< int > > l_readers( m_images.size() );
+    std::vector< std::set< int > > l_deps( m_nodes.size() );
+    for ( int i = 0; i < ( int ) m_nodes.size(); i++ )
+    {
+        for ( int l_id : m_nodes[ i ].m_in )
+        {
+            if ( l_writer[ l_id ] >= 0 ) l_deps[ i ].insert( l_writer[ l_id ] );
+        }
+        for ( int l_id : m_nodes[ i ].m_out )
+        {
+            if ( l_writer[ l_id ] >= 0 ) l_deps[ i ].insert( l_writer[ l_id ] );
+            l_deps[ i ].insert( l_readers[ l_id ].begin(), l_readers[ l_id ].end() );
+        }
+        for ( int l_id : m_nodes[ i ].m_in ) l_readers[ l_id ].push_back( i );
+        for ( int l_id : m_nodes[ i ].m_out )
+        {
+            l_writer[ l_id ] = i;
+            l_readers[ l_id ].clear();
+        }
+        l_deps[ i ].erase( i );
+    }
+
+    // buffers of intermediate images, free buffer is reused after all its users
+    struct FreeBuffer { int m_buffer; std::vector< int > m_users; };
+    std::vector< FreeBuffer > l_free;
+    for ( int i = 0; i < ( int ) m_nodes.size(); i++ )
+    {
+        for ( int l_id = 0; l_id < ( int ) m_images.size(); l_id++ )
+        {
+            Image &l_img = m_images[ l_id ];
+            if ( l_img.m_bytes == 0 || l_img.m_first != i ) continue;
+
+            auto l_found = std::find_if( l_free.begin(), l_free.end(),
+                [ & ] ( const FreeBuffer &t_free ) { return m_buffers[ t_free.m_buffer ].m_bytes == l_img.m_bytes; } );
+            if ( l_found != l_free.end() )
+            {
+                l_img.m_buffer = l_found->m_buffer;
+                l_deps[ i ].insert( l_found->m_users.begin(), l_found->m_users.end() );
+                l_free.erase( l_found );
+                m_reuses++;
+            }
+            else
+            {
+                void *l_data = ocl_svm_malloc< unsigned char >( l_img.m_bytes );
+                if ( l_data == nullptr )
+                {
+                    std::cerr << "Unable to allocate intermediate image of " << l_img.m_bytes << " bytes!" << std::endl;
+                    release_buffers();
+                    return CL_OUT_OF_RESOURCES;
+                }
+                m_buffers.push_back( { l_data, l_img.m_bytes } );
+                l_img.m_buffer = m_buffers.size() - 1;
+            }
+            l_img.m_ocl_img->m_data = m_buffers[ l_img.m_buffer ].m_data;
+        }
+
+        for ( int l_id = 0; l_id < ( int ) m_images.size(); l_id++ )
+        {
+            Image &l_img = m_images[ l_id ];
+            if ( l_img.m_bytes && l_img.m_last == i )
+            {
+                l_free.push_back( { l_img.m_buffer, l_users[ l_id ] } );
+            }
+        }
+    }
+
+    // node continues on queue of its dependency, when it was the last node there
+    std::vector< int > l_queue_last( m_queues.size(), -1 );
+    std::vector< int > l_queue_count( m_queues.size(), 0 );
+    for ( int i = 0; i < ( int ) m_nodes.size(); i++ )
+    {
+        Node &l_node = m_nodes[ i ];
+        l_node.m_deps.assign( l_deps[ i ].begin(), l_deps[ i ].end() );
+
+        int l_queue = -1;
+        for ( int l_dep : l_node.m_deps )
+        {
+            if ( l_queue_last[ m_nodes[ l_dep ].m_queue ] == l_dep )
+            {
+                l_queue = m_nodes[ l_dep ].m_queue;
+                break;
+            }
+        }
+        if ( l_queue < 0 )
+        {
+            l_queue = std::min_element( l_queue_count.begin(), l_queue_count.end() ) - l_queue_count.begin();
+        }
+
+        l_node.m_queue = l_queue;
+        l_queue_last[ l_queue ] = i;
+        l_queue_count[ l_queue ]++;
+    }
+
+    m_planned = true;
+    return CL_SUCCESS;
+}
+
+/// @copydoc OCLGraph::run
+cl_int OCLGraph::run()
+{
+    if ( m_error != CL_SUCCESS ) return m_error;
+
+    cl_int l_ret = m_planned ? CL_SUCCESS : plan();
+    if ( l_ret != CL_SUCCESS ) return l_ret;
+
+    std::vector< cl::Event > l_events( m_nodes.size() );
+    for ( size_t i = 0; i < m_nodes.size() && l_ret == CL_SUCCESS; i++ )
+    {
+        Node &l_node = m_nodes[ i ];
+
+        OCLGraphNode l_launch_node;
+        l_launch_node.m_name = l_node.m_name;
+        for ( int l_id : l_node.m_in ) l_launch_node.m_in.push_back( m_images[ l_id ].m_ocl_img );
+        for ( int l_id : l_node.m_out ) l_launch_node.m_out.push_back( m_images[ l_id ].m_ocl_img );
+        l_launch_node.m_queue = m_queues[ l_node.m_queue ];
+        for ( int l_dep : l_node.m_deps ) l_launch_node.m_wait.push_back( l_events[ l_dep ] );
+
+        l_ret = l_node.m_launch( l_launch_node );                               CL_ERR_C( l_ret );
+
+        // launch without event, marker on in-order queue follows its commands
+        if ( l_ret == CL_SUCCESS && l_launch_node.m_event() == nullptr )
+        {
+            l_ret = l_launch_node.m_queue.enqueueMarkerWithWaitList( &l_launch_node.m_wait, &l_launch_node.m_event );  CL_ERR_C( l_ret );
+        }
+        l_events[ i ] = l_launch_node.m_event;
+    }
+
+    // all queues start, then host waits only once
+    for ( cl::CommandQueue &l_queue : m_queues )
+    {
+        l_queue.flush();
+    }
+    for ( cl::CommandQueue &l_queue : m_queues )
+    {
+        cl_int l_err = l_queue.finish();                                        CL_ERR_C( l_err );
+        if ( l_ret == CL_SUCCESS ) l_ret = l_err;
+    }
+
+    return l_ret;
+}
+
+/// @copydoc OCLGraph::print
+void OCLGraph::print( std::ostream &t_out )
+{
+    if ( m_error != CL_SUCCESS || ( !m_planned && plan() != CL_SUCCESS ) )
+    {
+        t_out << "  graph can not be planned" << std::endl;
+        return;
+    }
+
+    for ( size_t i = 0; i < m_nodes.size(); i++ )
+    {
+        Node &l_node = m_nodes[ i ];
+        t_out << "  node " << i << " " << l_node.m_name << ": queue " << l_node.m_queue << ", waits for {";
+        for ( size_t d = 0; d < l_node.m_deps.size(); d++ )
+        {
+            t_out << ( d ? " " : "" ) << l_node.m_deps[ d ];
+        }
+        t_out << "}" << std::endl;
+    }
+
+    for ( size_t i = 0; i < m_images.size(); i++ )
+    {
+        Image &l_img = m_images[ i ];
+        if ( l_img.m_bytes == 0 ) continue;
+        t_out << "  image " << i << " " << l_img.m_ocl_img->m_size.x << "x" << l_img.m_ocl_img->m_size.y
+              << ": buffer " << l_img.m_buffer << ", nodes " << l_img.m_first << ".." << l_img.m_last << std::endl;
+    }
+}
+
+/// @copydoc OCLGraph::buffer_bytes
+size_t OCLGraph::buffer_bytes() const
+{
+    size_t l_bytes = 0;
+    for ( const Buffer &l_buf : m_buffers )
+    {
+        l_bytes += l_buf.m_bytes;
+    }
+    return l_bytes;
+}
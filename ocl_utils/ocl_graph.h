@@ -0,0 +1,179 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_graph.h
+ * @brief Graph of image operations executed by events on more queues.
+ *
+ * @details
+ * Header file for class @ref OCLGraph.
+ *
+ * Image operations are declared as nodes of graph with their input
+ * and output images. Dependencies are derived from data: node reading
+ * image waits for its last writer, node writing image waits for
+ * the last writer and for all readers. Independent branches run on
+ * different queues at the same time, dependencies are expressed
+ * only by event wait lists, host does not wait between nodes.
+ *
+ * Intermediate images are allocated by graph. Buffer of image is reused
+ * by later image of the same size when its last node is done.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_GRAPH_H
+#define __OCL_GRAPH_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <functional>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_image.h"
+
+/**
+ * @brief Node prepared for launch.
+ *
+ * @details
+ * Launch function must enqueue its commands into m_queue, wait
+ * for m_wait and store event of the last command into m_event.
+*/
+struct OCLGraphNode
+{
+    std::string m_name;                     ///< Name of node.
+    std::vector< OCLImage * > m_in;         ///< Input images in order of declaration.
+    std::vector< OCLImage * > m_out;        ///< Output images in order of declaration.
+    cl::CommandQueue m_queue;               ///< Queue for node.
+    std::vector< cl::Event > m_wait;        ///< Events of nodes, which must be done before.
+    cl::Event m_event;                      ///< Event of node, set by launch.
+};
+
+/**
+ * @brief Function which enqueues commands of node.
+*/
+using OCLGraphLaunch = std::function< cl_int( OCLGraphNode &t_node ) >;
+
+/**
+ * @anchor OCLGraph
+ * @brief Graph of image operations with dependencies derived from data.
+*/
+class OCLGraph
+{
+public:
+    /**
+     * @brief Empty graph with queues in default context.
+     * @param t_queues Number of queues for independent branches.
+    */
+    explicit OCLGraph( int t_queues = 2 );
+
+    /**
+     * @brief Intermediate buffers are released.
+    */
+    ~OCLGraph();
+
+    OCLGraph( const OCLGraph & ) = delete;
+    OCLGraph &operator=( const OCLGraph & ) = delete;
+
+    /**
+     * @brief External image, e.g. input or result, owned by caller.
+     * @param t_ocl_img Image in SVM.
+     * @return Id of image.
+    */
+    int image( OCLImage *t_ocl_img );
+
+    /**
+     * @brief Intermediate image allocated by graph.
+     * @param t_width Width of image.
+     * @param t_height Height of image.
+     * @param t_elem_size Size of pixel in bytes.
+     * @return Id of image, -1 when descriptor can not be allocated, then @ref run fails.
+    */
+    int image( int t_width, int t_height, int t_elem_size );
+
+    /**
+     * @brief Declaration of operation.
+     * @param t_name Name of node.
+     * @param t_launch Function enqueuing commands of node.
+     * @param t_in Ids of input images.
+     * @param t_out Ids of output images, image modified in place is output.
+     * @return Index of node, -1 for unknown image id, then @ref run fails.
+    */
+    int add( const std::string &t_name, OCLGraphLaunch t_launch, const std::vector< int > &t_in, const std::vector< int > &t_out );
+
+    /**
+     * @brief All nodes are submitted and graph is waited for.
+     * @return CL_SUCCESS or the first error, CL_OUT_OF_RESOURCES when images can not be allocated.
+    */
+    cl_int run();
+
+    /**
+     * @brief Descriptor of image, valid after the first @ref run or @ref print, nullptr for unknown id.
+    */
+    OCLImage *data( int t_image ) { return t_image >= 0 && t_image < ( int ) m_images.size() ? m_images[ t_image ].m_ocl_img : nullptr; }
+
+    /**
+     * @brief Nodes with their queues and dependencies.
+    */
+    void print( std::ostream &t_out );
+
+    /// Number of allocated intermediate buffers.
+    size_t buffers() const { return m_buffers.size(); }
+
+    /// Number of intermediate images which reused buffer.
+    size_t reuses() const { return m_reuses; }
+
+    /// Bytes of all intermediate buffers.
+    size_t buffer_bytes() const;
+
+protected:
+    /// @cond
+    struct Image
+    {
+        OCLImage *m_ocl_img;                // descriptor in SVM
+        size_t m_bytes;                     // 0 for external image
+        int m_buffer;                       // index into m_buffers
+        int m_first;                        // first and last node using image
+        int m_last;
+    };
+
+    struct Node
+    {
+        std::string m_name;
+        OCLGraphLaunch m_launch;
+        std::vector< int > m_in;
+        std::vector< int > m_out;
+        std::vector< int > m_deps;          // nodes which must be done before
+        int m_queue;
+    };
+
+    struct Buffer
+    {
+        void *m_data;
+        size_t m_bytes;
+    };
+
+    std::vector< cl::CommandQueue > m_queues;
+    std::vector< Image > m_images;
+    std::vector< Node > m_nodes;
+    std::vector< Buffer > m_buffers;
+    size_t m_reuses;
+    cl_int m_error;                         // graph declared with failed image or node
+    bool m_planned;
+
+    cl_int plan();
+    void release_buffers();
+    /// @endcond
+};
+
+#endif // __OCL_GRAPH_H
@@ -0,0 +1,155 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_metrics.h
+ * @brief Always-on counters and latency histograms exported for Prometheus.
+ *
+ * @details
+ * Header file for classes @ref OCLCounter and @ref OCLHistogram
+ * and functions @ref ocl_counter, @ref ocl_histogram and @ref ocl_metrics_write.
+ *
+ * Counter is one atomic add. Histogram has log-linear buckets like
+ * HDR histogram: 16 buckets for every power of 2, so relative error
+ * is under 7% from nanoseconds to minutes and recording is two
+ * atomic adds without lock. Counter and histogram are registered once
+ * by name and label, caller keeps reference, e.g. in static variable.
+ *
+ * Metrics are written in Prometheus text format. With environment variable
+ * OCL_METRICS=file.prom snapshot is written into file every
+ * OCL_METRICS_PERIOD seconds (default 10) and at exit, e.g. for textfile
+ * collector of node exporter. @ref ocl_init creates default queue with
+ * profiling then, so latencies of kernels on device are recorded too.
+ *
+ * Exported metrics:
+ * - ocl_kernel_launches_total{kernel}, ocl_kernel_launch_seconds{kernel}:
+ *   launches by @ref launch and host time of launch with waiting,
+ * - ocl_kernel_queue_seconds{kernel}, ocl_kernel_exec_seconds{kernel}:
+ *   enqueue-to-start and start-to-end on device,
+ * - ocl_svm_* from @ref OCLSVMCounters,
+ * - ocl_pool_hits_total, ocl_pool_misses_total, ocl_pool_spills_total,
+ *   ocl_pool_restores_total of @ref SVMImagePool.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_METRICS_H
+#define __OCL_METRICS_H
+
+#include <atomic>
+#include <string>
+#include <ostream>
+
+#include <CL/opencl.hpp>
+
+/**
+ * @anchor OCLCounter
+ * @brief Monotonic counter.
+*/
+class OCLCounter
+{
+public:
+    /// Value is increased.
+    void add( unsigned long long t_value = 1 ) { m_value.fetch_add( t_value, std::memory_order_relaxed ); }
+
+    /// Current value.
+    unsigned long long value() const { return m_value.load( std::memory_order_relaxed ); }
+
+protected:
+    /// @cond
+    std::atomic< unsigned long long > m_value{ 0 };
+    /// @endcond
+};
+
+/**
+ * @anchor OCLHistogram
+ * @brief Histogram of durations in ns with log-linear buckets.
+*/
+class OCLHistogram
+{
+public:
+    /// Buckets for every power of 2.
+    static const int SUB_BUCKETS = 16;
+    /// Number of buckets, values up to 2^40 ns.
+    static const int BUCKETS = ( 40 - 3 ) * SUB_BUCKETS;
+
+    /// Duration in ns is recorded.
+    void record( unsigned long long t_ns );
+
+    /// Number of recorded values.
+    unsigned long long count() const { return m_count.load( std::memory_order_relaxed ); }
+
+    /// Sum of recorded values in ns.
+    unsigned long long sum() const { return m_sum.load( std::memory_order_relaxed ); }
+
+    /**
+     * @brief Value under which is part t_q of recorded values.
+     * @param t_q Quantile 0 - 1, e.g. 0.99.
+     * @return Upper bound of bucket in ns, 0 for empty histogram.
+    */
+    unsigned long long quantile( double t_q ) const;
+
+    /// Number of values lower than 2^t_exp ns.
+    unsigned long long count_below_pow2( int t_exp ) const;
+
+protected:
+    /// @cond
+    std::atomic< unsigned long long > m_buckets[ BUCKETS ] = {};
+    std::atomic< unsigned long long > m_count{ 0 };
+    std::atomic< unsigned long long > m_sum{ 0 };
+
+    static int index( unsigned long long t_ns );
+    static unsigned long long upper( int t_index );
+    /// @endcond
+};
+
+/**
+ * @anchor ocl_counter
+ * @brief Counter registered by name and label, the same counter for the same name and label.
+ * @param t_name Name of metric, e.g. ocl_kernel_launches_total.
+ * @param t_label Name of label, empty - no label.
+ * @param t_value Value of label.
+ * @return Reference valid to the end of program.
+*/
+OCLCounter &ocl_counter( const std::string &t_name, const std::string &t_label = "", const std::string &t_value = "" );
+
+/**
+ * @anchor ocl_histogram
+ * @brief Histogram registered by name and label, exported in seconds.
+ * @copydetails ocl_counter
+*/
+OCLHistogram &ocl_histogram( const std::string &t_name, const std::string &t_label = "", const std::string &t_value = "" );
+
+/**
+ * @brief Device latencies from profiling of completed event.
+ * @param t_queue Histogram for enqueue-to-start.
+ * @param t_exec Histogram for start-to-end.
+ * @param t_event Event from queue with profiling, otherwise it is ignored.
+*/
+void ocl_metrics_event( OCLHistogram &t_queue, OCLHistogram &t_exec, const cl::Event &t_event );
+
+/// Snapshot of metrics is written periodically, see OCL_METRICS.
+bool ocl_metrics_on();
+
+/**
+ * @anchor ocl_metrics_write
+ * @brief All metrics in Prometheus text format.
+*/
+void ocl_metrics_write( std::ostream &t_stream );
+
+/**
+ * @brief Snapshot is written into temporary file and renamed, so reader never sees half of it.
+ * @return true when file was written.
+*/
+bool ocl_metrics_snapshot( const std::string &t_file_name );
+
+#endif // __OCL_METRICS_H
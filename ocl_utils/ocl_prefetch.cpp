@@ -0,0 +1,228 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_prefetch.cpp
+ * @brief Migration of SVM buffers ahead of kernel launches.
+ *
+ * @details
+ * Source file for class @ref OCLPrefetcher.
+ *
+ ***************************************************************************/
+
+#include <cstdio>
+#include <limits>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+
+#include "ocl_utils.h"
+#include "ocl_prefetch.h"
+
+/// @copydoc OCLPrefetcher::OCLPrefetcher
+OCLPrefetcher::OCLPrefetcher( bool t_enabled ) : m_kernel_end( 0 ), m_enqueued( 0 ), m_accounted( 0 )
+{
+    cl_int l_err;
+
+    cl::Device l_device = cl::Device::getDefault();
+    for ( int k = 0; k < OCL_PREFETCH_COUNT; k++ )
+    {
+        m_queues[ k ] = cl::CommandQueue( cl::Context::getDefault(), l_device, CL_QUEUE_PROFILING_ENABLE, &l_err );  CL_ERR_C( l_err );
+    }
+
+    // clEnqueueSVMMigrateMem is in OpenCL 2.1 and newer
+    int l_major = 0, l_minor = 0;
+    std::string l_version = l_device.getInfo< CL_DEVICE_VERSION >();
+    sscanf( l_version.c_str(), "OpenCL %d.%d", &l_major, &l_minor );
+    m_enabled = t_enabled && ( l_major > 2 || ( l_major == 2 && l_minor >= 1 ) );
+    if ( t_enabled && !m_enabled )
+    {
+        std::cerr << "SVM migration not supported by '" << l_version << "', left to driver." << std::endl;
+    }
+
+    reset_stats();
+}
+
+/// @copydoc OCLPrefetcher::ranges
+std::vector< OCLSVMRange > OCLPrefetcher::ranges( OCLImage *t_ocl_img, int t_elem_size )
+{
+    return {
+        { t_ocl_img, sizeof( OCLImage ) },
+        { t_ocl_img->m_data, ( size_t ) t_ocl_img->m_size.x * t_ocl_img->m_size.y * t_elem_size },
+    };
+}
+
+// migration of ranges on queue of given kind
+cl_int OCLPrefetcher::migrate( OCLPrefetchKind t_kind, const std::vector< OCLSVMRange > &t_ranges, const std::vector< cl::Event > &t_wait )
+{
+    if ( !m_enabled || t_ranges.empty() ) return CL_SUCCESS;
+
+    std::vector< void * > l_ptrs;
+    std::vector< size_t > l_sizes;
+    size_t l_bytes = 0;
+    for ( const OCLSVMRange &l_range : t_ranges )
+    {
+        l_ptrs.push_back( l_range.m_ptr );
+        l_sizes.push_back( l_range.m_bytes );
+        l_bytes += l_range.m_bytes;
+    }
+
+    cl_mem_migration_flags l_flags = t_kind == OCL_PREFETCH_TO_HOST ? CL_MIGRATE_MEM_OBJECT_HOST : 0;
+    cl::Event l_event;
+    cl_int l_err = m_queues[ t_kind ].enqueueMigrateSVM( l_ptrs, l_sizes, l_flags,
+                                                         t_wait.empty() ? nullptr : &t_wait, &l_event );  CL_ERR_R( l_err );
+    // migration starts now, not with the next finish
+    m_queues[ t_kind ].flush();
+
+    m_records.push_back( { t_kind, l_event, l_bytes } );
+    m_enqueued++;
+    if ( t_kind == OCL_PREFETCH_TO_DEVICE ) m_pending.push_back( l_event );
+
+    return CL_SUCCESS;
+}
+
+/// @copydoc OCLPrefetcher::prefetch
+cl_int OCLPrefetcher::prefetch( const std::vector< OCLSVMRange > &t_ranges )
+{
+    return migrate( OCL_PREFETCH_TO_DEVICE, t_ranges, {} );
+}
+
+/// @copydoc OCLPrefetcher::launch
+cl_int OCLPrefetcher::launch( cl::Kernel &t_kernel, const cl::NDRange &t_global, const cl::NDRange &t_local )
+{
+    // finished commands of previous frames are not kept
+    account( false );
+
+    cl::Event l_event;
+    cl::CommandQueue &l_queue = m_queues[ OCL_PREFETCH_KERNEL ];
+    cl_int l_err = l_queue.enqueueNDRangeKernel( t_kernel, cl::NullRange, t_global, t_local,
+                                                 m_pending.empty() ? nullptr : &m_pending, &l_event );  CL_ERR_R( l_err );
+    l_queue.flush();
+
+    m_pending.clear();
+    m_last_kernel = l_event;
+    m_records.push_back( { OCL_PREFETCH_KERNEL, l_event, 0 } );
+    m_enqueued++;
+
+    return CL_SUCCESS;
+}
+
+/// @copydoc OCLPrefetcher::to_host
+cl_int OCLPrefetcher::to_host( const std::vector< OCLSVMRange > &t_ranges )
+{
+    std::vector< cl::Event > l_wait;
+    if ( m_last_kernel() != nullptr ) l_wait.push_back( m_last_kernel );
+    return migrate( OCL_PREFETCH_TO_HOST, t_ranges, l_wait );
+}
+
+/// @copydoc OCLPrefetcher::finish
+cl_int OCLPrefetcher::finish()
+{
+    cl_int l_ret = CL_SUCCESS;
+    for ( cl::CommandQueue &l_queue : m_queues )
+    {
+        cl_int l_err = l_queue.finish();                                        CL_ERR_C( l_err );
+        if ( l_ret == CL_SUCCESS ) l_ret = l_err;
+    }
+    m_pending.clear();
+    m_last_kernel = cl::Event();
+
+    account( true );
+
+    return l_ret;
+}
+
+// profiling of finished commands is added to statistics and commands are dropped
+void OCLPrefetcher::account( bool t_all )
+{
+    // kernels run on one in-order queue, their intervals do not overlap and they finish in order
+    std::vector< KernelTime > l_kernels( m_kernel_times );
+    cl_ulong l_bound = std::numeric_limits< cl_ulong >::max();
+    for ( Record &l_rec : m_records )
+    {
+        if ( l_rec.m_kind != OCL_PREFETCH_KERNEL ) continue;
+        if ( !t_all && l_rec.m_event.getInfo< CL_EVENT_COMMAND_EXECUTION_STATUS >() > CL_COMPLETE )
+        {
+            // running or waiting kernel does not start before end of the previous one
+            l_bound = m_kernel_end;
+            break;
+        }
+        l_kernels.push_back( { l_rec.m_event.getProfilingInfo< CL_PROFILING_COMMAND_START >(),
+                               l_rec.m_event.getProfilingInfo< CL_PROFILING_COMMAND_END >(), 0 } );
+        m_kernel_end = l_kernels.back().m_end;
+    }
+
+    // commands are taken in order of enqueue, migration only when no later kernel can overlap it
+    size_t l_done = 0;
+    for ( ; l_done < m_records.size(); l_done++ )
+    {
+        Record &l_rec = m_records[ l_done ];
+        if ( !t_all && l_rec.m_event.getInfo< CL_EVENT_COMMAND_EXECUTION_STATUS >() > CL_COMPLETE ) break;
+
+        KernelTime l_time = { l_rec.m_event.getProfilingInfo< CL_PROFILING_COMMAND_START >(),
+                              l_rec.m_event.getProfilingInfo< CL_PROFILING_COMMAND_END >(), m_enqueued };
+        if ( l_rec.m_kind != OCL_PREFETCH_KERNEL && l_time.m_end > l_bound ) break;
+
+        OCLPrefetchStats &l_stats = m_stats[ l_rec.m_kind ];
+        l_stats.m_commands++;
+        l_stats.m_bytes += l_rec.m_bytes;
+        l_stats.m_ms += ( l_time.m_end - l_time.m_start ) / 1e6;
+        if ( l_rec.m_kind == OCL_PREFETCH_KERNEL )
+        {
+            // kernel may overlap only commands enqueued before it was taken
+            m_kernel_times.push_back( l_time );
+            continue;
+        }
+
+        // migration hidden behind kernels
+        for ( KernelTime &l_kernel : l_kernels )
+        {
+            cl_ulong l_start = std::max( l_kernel.m_start, l_time.m_start );
+            cl_ulong l_end = std::min( l_kernel.m_end, l_time.m_end );
+            if ( l_end > l_start ) l_stats.m_hidden_ms += ( l_end - l_start ) / 1e6;
+        }
+    }
+    m_records.erase( m_records.begin(), m_records.begin() + l_done );
+    m_accounted += l_done;
+
+    m_kernel_times.erase( std::remove_if( m_kernel_times.begin(), m_kernel_times.end(),
+                          [ this ] ( const KernelTime &t_time ) { return t_time.m_enqueued <= m_accounted; } ),
+                          m_kernel_times.end() );
+}
+
+/// @copydoc OCLPrefetcher::reset_stats
+void OCLPrefetcher::reset_stats()
+{
+    for ( OCLPrefetchStats &l_stats : m_stats )
+    {
+        l_stats = { 0, 0, 0, 0 };
+    }
+}
+
+/// @copydoc OCLPrefetcher::report
+void OCLPrefetcher::report( std::ostream &t_out ) const
+{
+    static const char *l_names[ OCL_PREFETCH_COUNT ] = { "to device", "kernel", "to host" };
+
+    t_out << "  command     count        MB    time ms  hidden ms" << std::endl;
+    for ( int k = 0; k < OCL_PREFETCH_COUNT; k++ )
+    {
+        const OCLPrefetchStats &l_stats = m_stats[ k ];
+        t_out << "  " << std::left << std::setw( 10 ) << l_names[ k ] << std::right
+              << std::setw( 7 ) << l_stats.m_commands
+              << std::fixed << std::setprecision( 1 ) << std::setw( 10 ) << l_stats.m_bytes / 1048576.0
+              << std::setprecision( 2 ) << std::setw( 11 ) << l_stats.m_ms;
+        if ( k != OCL_PREFETCH_KERNEL ) t_out << std::setw( 11 ) << l_stats.m_hidden_ms;
+        t_out << std::endl;
+    }
+}
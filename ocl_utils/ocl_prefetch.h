@@ -0,0 +1,176 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_prefetch.h
+ * @brief Migration of SVM buffers ahead of kernel launches.
+ *
+ * @details
+ * Header file for class @ref OCLPrefetcher.
+ *
+ * List of SVM pointers set by setSVMPointers only tells driver which
+ * memory kernel uses. On discrete GPU data are moved by page faults
+ * or copies when kernel touches them the first time. Prefetcher
+ * migrates buffers of the next launch by clEnqueueSVMMigrateMem on
+ * separate queue, while the previous kernel is running, and kernel
+ * only waits for event of migration. Results are migrated back
+ * to host after kernel, before host reads them.
+ *
+ * All commands are profiled, so report shows time of migrations
+ * and how much of it was hidden behind kernels.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_PREFETCH_H
+#define __OCL_PREFETCH_H
+
+#include <vector>
+#include <ostream>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_image.h"
+
+/**
+ * @brief Range of SVM memory for migration.
+*/
+struct OCLSVMRange
+{
+    void *m_ptr;                ///< Start of range in SVM.
+    size_t m_bytes;             ///< Size of range.
+};
+
+/**
+ * @brief Kind of profiled command.
+*/
+enum OCLPrefetchKind
+{
+    OCL_PREFETCH_TO_DEVICE = 0, ///< Migration to device before kernel.
+    OCL_PREFETCH_KERNEL,        ///< Kernel launch.
+    OCL_PREFETCH_TO_HOST,       ///< Migration of results to host.
+    OCL_PREFETCH_COUNT
+};
+
+/**
+ * @brief Profiling of one kind of commands.
+*/
+struct OCLPrefetchStats
+{
+    size_t m_commands;          ///< Number of commands.
+    size_t m_bytes;             ///< Migrated bytes.
+    double m_ms;                ///< Sum of execution times.
+    double m_hidden_ms;         ///< Part of m_ms running at the same time as kernels.
+};
+
+/**
+ * @anchor OCLPrefetcher
+ * @brief Kernel launches with explicit SVM migrations on separate queues.
+ *
+ * @details
+ * Typical loop for frame i: @ref launch of kernel for frame i,
+ * @ref prefetch of input of frame i+1, @ref to_host of result of frame i.
+ * Migrations need OpenCL 2.1, otherwise they are skipped and residency
+ * is left to driver as before.
+*/
+class OCLPrefetcher
+{
+public:
+    /**
+     * @brief Profiling queues for default device and context.
+     * @param t_enabled Migrations are used when device supports them.
+    */
+    explicit OCLPrefetcher( bool t_enabled = true );
+
+    /**
+     * @brief Migrations are issued.
+    */
+    bool enabled() const { return m_enabled; }
+
+    /**
+     * @brief Ranges of image: descriptor and data.
+     * @param t_ocl_img Image in SVM.
+     * @param t_elem_size Size of pixel in bytes.
+    */
+    static std::vector< OCLSVMRange > ranges( OCLImage *t_ocl_img, int t_elem_size );
+
+    /**
+     * @brief Migration to device, the next launch waits for it.
+     * @param t_ranges Memory used by the next launch, host must not write it any more.
+    */
+    cl_int prefetch( const std::vector< OCLSVMRange > &t_ranges );
+
+    /**
+     * @brief Kernel is enqueued after pending migrations to device. Function does not wait.
+     * @param t_kernel Kernel with arguments and SVM pointers.
+     * @param t_global Global range.
+     * @param t_local Work-group size.
+    */
+    cl_int launch( cl::Kernel &t_kernel, const cl::NDRange &t_global, const cl::NDRange &t_local );
+
+    /**
+     * @brief Migration to host after the last launched kernel.
+     * @param t_ranges Results which host will read after @ref finish.
+    */
+    cl_int to_host( const std::vector< OCLSVMRange > &t_ranges );
+
+    /**
+     * @brief Waiting for all queues, profiling of remaining commands is added to statistics.
+     *
+     * @details
+     * Finished commands of previous frames are added already by @ref launch,
+     * so long loops do not keep events of all frames.
+    */
+    cl_int finish();
+
+    /// Statistics of one kind of commands.
+    const OCLPrefetchStats &stats( OCLPrefetchKind t_kind ) const { return m_stats[ t_kind ]; }
+
+    /// Statistics are cleared.
+    void reset_stats();
+
+    /**
+     * @brief Table with migrations and kernels.
+    */
+    void report( std::ostream &t_out ) const;
+
+protected:
+    /// @cond
+    struct Record
+    {
+        OCLPrefetchKind m_kind;
+        cl::Event m_event;
+        size_t m_bytes;
+    };
+
+    struct KernelTime
+    {
+        cl_ulong m_start, m_end;
+        size_t m_enqueued;              // commands enqueued before kernel was added to statistics
+    };
+
+    cl_int migrate( OCLPrefetchKind t_kind, const std::vector< OCLSVMRange > &t_ranges, const std::vector< cl::Event > &t_wait );
+    void account( bool t_all );
+
+    cl::CommandQueue m_queues[ OCL_PREFETCH_COUNT ];   // in-order queue for every kind
+    std::vector< cl::Event > m_pending;                 // migrations for the next launch
+    cl::Event m_last_kernel;
+    std::vector< Record > m_records;                    // commands not profiled yet
+    std::vector< KernelTime > m_kernel_times;           // profiled kernels, older commands may overlap them
+    cl_ulong m_kernel_end;                              // end of the last finished kernel
+    size_t m_enqueued, m_accounted;                     // commands enqueued and added to statistics
+    OCLPrefetchStats m_stats[ OCL_PREFETCH_COUNT ];
+    bool m_enabled;
+    /// @endcond
+};
+
+#endif // __OCL_PREFETCH_H
@@ -0,0 +1,98 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_roofline.cpp
+ * @brief Roofline model of kernels against measured limits of device.
+ *
+ * @details
+ * Source file for class @ref OCLRoofline.
+ *
+ ***************************************************************************/
+
+#include <iomanip>
+#include <algorithm>
+
+#include "ocl_roofline.h"
+
+// kernel shorter than this number of launch latencies is latency-bound
+#define ROOFLINE_LATENCY_LAUNCHES   10
+
+/// @copydoc OCLRoofline::add
+void OCLRoofline::add( const std::string &t_kernel, double t_bytes, double t_ops, double t_ms, bool t_float )
+{
+    m_points.push_back( { t_kernel, t_bytes, t_ops, t_ms, t_float } );
+}
+
+// peak of operations in GOP/s, integer or float
+double OCLRoofline::peak_ops( bool t_float ) const
+{
+    return t_float ? m_profile.m_float_gflops : m_profile.m_int_giops;
+}
+
+/// @copydoc OCLRoofline::roof_ms
+double OCLRoofline::roof_ms( const OCLRooflinePoint &t_point ) const
+{
+    double l_mem_ms = m_profile.peak_gbps() > 0 ? t_point.m_bytes / m_profile.peak_gbps() / 1e6 : 0;
+    double l_ops_ms = peak_ops( t_point.m_float ) > 0 ? t_point.m_ops / peak_ops( t_point.m_float ) / 1e6 : 0;
+    return std::max( l_mem_ms, l_ops_ms );
+}
+
+/// @copydoc OCLRoofline::efficiency
+double OCLRoofline::efficiency( const OCLRooflinePoint &t_point ) const
+{
+    return t_point.m_ms > 0 ? std::min( 1.0, roof_ms( t_point ) / t_point.m_ms ) : 0;
+}
+
+/// @copydoc OCLRoofline::bound
+const char *OCLRoofline::bound( const OCLRooflinePoint &t_point ) const
+{
+    if ( t_point.m_ms * 1000 < ROOFLINE_LATENCY_LAUNCHES * m_profile.m_launch_us ) return "latency";
+
+    // ridge point: intensity where both ceilings meet
+    double l_ridge = m_profile.peak_gbps() > 0 ? peak_ops( t_point.m_float ) / m_profile.peak_gbps() : 0;
+    return t_point.intensity() < l_ridge ? "memory" : "compute";
+}
+
+/// @copydoc OCLRoofline::report
+void OCLRoofline::report( std::ostream &t_stream ) const
+{
+    std::vector< const OCLRooflinePoint * > l_sorted;
+    for ( const OCLRooflinePoint &l_point : m_points )
+    {
+        l_sorted.push_back( &l_point );
+    }
+    std::sort( l_sorted.begin(), l_sorted.end(), [ this ] ( const OCLRooflinePoint *t_a, const OCLRooflinePoint *t_b )
+    {
+        return t_a->m_ms - roof_ms( *t_a ) > t_b->m_ms - roof_ms( *t_b );
+    } );
+
+    t_stream << "Roofline of " << m_profile.m_device << ": " << std::fixed << std::setprecision( 1 )
+             << m_profile.peak_gbps() << " GB/s, " << m_profile.m_float_gflops << " GFLOP/s, "
+             << m_profile.m_int_giops << " GIOP/s, launch " << m_profile.m_launch_us << " us" << std::endl;
+    t_stream << std::left << std::setw( 44 ) << "kernel" << std::right << std::setw( 8 ) << "op/B"
+             << std::setw( 10 ) << "GB/s" << std::setw( 10 ) << "GOP/s" << std::setw( 10 ) << "bound"
+             << std::setw( 8 ) << "eff %" << std::setw( 10 ) << "ms" << std::setw( 10 ) << "lost ms" << std::endl;
+    for ( const OCLRooflinePoint *l_point : l_sorted )
+    {
+        double l_ms = std::max( l_point->m_ms, 1e-9 );
+        t_stream << std::left << std::setw( 44 ) << l_point->m_kernel << std::right
+                 << std::setprecision( 2 ) << std::setw( 8 ) << l_point->intensity()
+                 << std::setprecision( 1 ) << std::setw( 10 ) << l_point->m_bytes / l_ms / 1e6
+                 << std::setw( 10 ) << l_point->m_ops / l_ms / 1e6
+                 << std::setw( 10 ) << bound( *l_point )
+                 << std::setw( 8 ) << efficiency( *l_point ) * 100
+                 << std::setprecision( 3 ) << std::setw( 10 ) << l_point->m_ms
+                 << std::setw( 10 ) << l_point->m_ms - roof_ms( *l_point ) << std::endl;
+    }
+}
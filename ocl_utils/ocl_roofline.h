@@ -0,0 +1,106 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_roofline.h
+ * @brief Roofline model of kernels against measured limits of device.
+ *
+ * @details
+ * Header file for class @ref OCLRoofline.
+ *
+ * Kernel can not be faster than its bytes moved with peak bandwidth
+ * and than its operations done with peak throughput. The slower of both
+ * is the roof time of kernel and roof time divided by measured time is
+ * efficiency. Arithmetic intensity, operations per byte, below ridge point
+ * of device means memory-bound kernel, above it compute-bound kernel.
+ * Kernel running only few launch latencies is latency-bound, it has
+ * too little work to fill device.
+ *
+ * Peaks are taken from @ref OCLDeviceProfile measured by ocl_0 -c.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_ROOFLINE_H
+#define __OCL_ROOFLINE_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "ocl_profile.h"
+
+/**
+ * @brief One kernel placed on roofline.
+*/
+struct OCLRooflinePoint
+{
+    std::string m_kernel;       ///< Name of kernel and its size.
+    double m_bytes;             ///< Bytes read and written.
+    double m_ops;               ///< Arithmetic operations.
+    double m_ms;                ///< Measured time.
+    bool m_float;               ///< Float operations, otherwise integer.
+
+    /// Operations per byte.
+    double intensity() const { return m_bytes > 0 ? m_ops / m_bytes : 0; }
+};
+
+/**
+ * @anchor OCLRoofline
+ * @brief Kernels compared with bandwidth and compute ceilings of device.
+*/
+class OCLRoofline
+{
+public:
+    /**
+     * @brief Empty roofline for device.
+     * @param t_profile Measured limits of device.
+    */
+    explicit OCLRoofline( const OCLDeviceProfile &t_profile ) : m_profile( t_profile ) {}
+
+    /**
+     * @brief Kernel is added to roofline.
+     * @param t_kernel Name of kernel in report.
+     * @param t_bytes Bytes read and written by kernel.
+     * @param t_ops Arithmetic operations of kernel.
+     * @param t_ms Measured time, e.g. median of events.
+     * @param t_float Float operations, otherwise integer.
+    */
+    void add( const std::string &t_kernel, double t_bytes, double t_ops, double t_ms, bool t_float = false );
+
+    /// Kernels added to roofline.
+    const std::vector< OCLRooflinePoint > &points() const { return m_points; }
+
+    /// Time of kernel at roof of device in ms.
+    double roof_ms( const OCLRooflinePoint &t_point ) const;
+
+    /// Roof time divided by measured time, 0 - 1.
+    double efficiency( const OCLRooflinePoint &t_point ) const;
+
+    /// "latency", "memory" or "compute".
+    const char *bound( const OCLRooflinePoint &t_point ) const;
+
+    /**
+     * @brief Table of kernels sorted by time lost against roof, the first kernel is worth tuning.
+    */
+    void report( std::ostream &t_stream ) const;
+
+protected:
+    /// @cond
+    OCLDeviceProfile m_profile;
+    std::vector< OCLRooflinePoint > m_points;
+
+    double peak_ops( bool t_float ) const;
+    /// @endcond
+};
+
+#endif // __OCL_ROOFLINE_H
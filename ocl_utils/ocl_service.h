@@ -0,0 +1,238 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_service.h
+ * @brief Image processing service over Unix domain socket.
+ *
+ * @details
+ * Header file for classes @ref OCLServiceServer and @ref OCLServiceClient.
+ *
+ * Every demo pays initialization of OpenCL and load of program
+ * at its start. Long-running server does it only once and clients
+ * send only requests. Images are not sent through socket. Client
+ * creates shared memory (memfd), its file descriptor is passed to
+ * server once (SCM_RIGHTS) and requests contain only offsets of images
+ * in this memory. Size of memory is sealed, so client can not shrink
+ * it under mapping of server. When device supports fine-grain system SVM, kernels
+ * work directly in shared memory. Otherwise images are copied into
+ * SVM buffers from pool.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_SERVICE_H
+#define __OCL_SERVICE_H
+
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <functional>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_threads.h"
+
+/// Default path of service socket.
+#define OCL_SERVICE_SOCKET      "/tmp/ocl_service.sock"
+
+/// Magic number of all messages.
+#define OCL_SERVICE_MAGIC       0x4f434c53
+
+/// Operation reserved for passing of shared memory.
+#define OCL_SERVICE_ATTACH      0
+
+/**
+ * @brief Request sent by client, operations except attach are defined by server.
+*/
+struct OCLServiceRequest
+{
+    uint32_t m_magic;           ///< @ref OCL_SERVICE_MAGIC
+    uint32_t m_op;              ///< Operation.
+    uint32_t m_id;              ///< Request id returned in reply.
+    uint32_t m_width;           ///< Width of image.
+    uint32_t m_height;          ///< Height of image.
+    uint64_t m_src_offset;      ///< Source data in shared memory.
+    uint64_t m_src_size;        ///< Size of source data.
+    uint64_t m_dst_offset;      ///< Destination data in shared memory.
+    uint64_t m_dst_size;        ///< Size of destination data, 0 for in-place operation.
+};
+
+/**
+ * @brief Reply sent by server.
+*/
+struct OCLServiceReply
+{
+    uint32_t m_magic;           ///< @ref OCL_SERVICE_MAGIC
+    uint32_t m_id;              ///< Id of request.
+    int32_t m_status;           ///< CL_SUCCESS or error code.
+    uint32_t m_zero_copy;       ///< Images were not copied by server.
+    double m_server_ms;         ///< Time of request in server.
+};
+
+/**
+ * @brief Request with images mapped by server, pointers are usable by kernels.
+*/
+struct OCLServiceJob
+{
+    uint32_t m_op;              ///< Operation.
+    uint32_t m_width;           ///< Width of image.
+    uint32_t m_height;          ///< Height of image.
+    void *m_src;                ///< Source data.
+    size_t m_src_size;          ///< Size of source data.
+    void *m_dst;                ///< Destination data, the same as m_src for in-place operation.
+    size_t m_dst_size;          ///< Size of destination data.
+};
+
+/**
+ * @brief Function handling job in connection thread.
+*/
+using OCLServiceHandler = std::function< cl_int( OCLServiceJob &t_job ) >;
+
+/**
+ * @anchor OCLServiceServer
+ * @brief Server accepting requests over Unix domain socket.
+ *
+ * @details
+ * Every connection is handled by its own thread, so handler
+ * should use @ref OCLThreadRuntime for its kernels and queue.
+*/
+class OCLServiceServer
+{
+public:
+    /**
+     * @brief Server for default context and device.
+     * @param t_handler Handler of requests.
+     * @param t_path Path of socket.
+    */
+    OCLServiceServer( OCLServiceHandler t_handler, const std::string &t_path = OCL_SERVICE_SOCKET );
+
+    /**
+     * @brief Socket is closed and removed.
+    */
+    ~OCLServiceServer();
+
+    OCLServiceServer( const OCLServiceServer & ) = delete;
+    OCLServiceServer &operator=( const OCLServiceServer & ) = delete;
+
+    /**
+     * @brief Connections are accepted until @ref stop.
+     * @return 0 or -1 when socket can't be created.
+    */
+    int serve();
+
+    /**
+     * @brief Server stops, it can be called from signal handler.
+    */
+    void stop() { m_stop = true; }
+
+    /// Kernels use shared memory of clients directly.
+    bool zero_copy() const { return m_zero_copy; }
+
+    /// Number of handled requests.
+    size_t requests() const { return m_requests; }
+
+    /// SVM pool for copies of images and for descriptors of handler.
+    OCLSVMPool &pool() { return m_pool; }
+
+protected:
+    /// @cond
+    struct Connection
+    {
+        int m_fd;
+        std::thread m_thread;
+        std::atomic< bool > m_done;
+    };
+
+    OCLServiceHandler m_handler;
+    std::string m_path;
+    int m_fd;
+    bool m_zero_copy;
+    std::atomic< bool > m_stop;
+    std::atomic< size_t > m_requests;
+    OCLSVMPool m_pool;
+    std::mutex m_mutex;
+    std::list< std::unique_ptr< Connection > > m_connections;
+
+    void handle( Connection *t_conn );
+    int process( OCLServiceRequest &t_req, unsigned char *t_shm, size_t t_shm_size, OCLServiceReply &t_reply );
+    void reap( bool t_all );
+    /// @endcond
+};
+
+/**
+ * @anchor OCLServiceClient
+ * @brief Client of @ref OCLServiceServer with its shared memory.
+*/
+class OCLServiceClient
+{
+public:
+    OCLServiceClient() : m_fd( -1 ), m_shm( nullptr ), m_shm_size( 0 ), m_next_id( 1 ) {}
+
+    /**
+     * @brief Connection and shared memory are closed.
+    */
+    ~OCLServiceClient();
+
+    OCLServiceClient( const OCLServiceClient & ) = delete;
+    OCLServiceClient &operator=( const OCLServiceClient & ) = delete;
+
+    /**
+     * @brief Connection to server.
+     * @param t_path Path of server socket.
+     * @return 0 or -1 with errno.
+    */
+    int connect( const std::string &t_path = OCL_SERVICE_SOCKET );
+
+    /**
+     * @brief Creation of shared memory and its passing to server.
+     * @param t_size Size of shared memory in bytes.
+     * @return 0 or -1 with errno.
+    */
+    int attach( size_t t_size );
+
+    /// Shared memory for images.
+    unsigned char *data() { return m_shm; }
+
+    /// Size of shared memory.
+    size_t size() const { return m_shm_size; }
+
+    /**
+     * @brief Synchronous request, images must be in shared memory.
+     * @param t_op Operation of server.
+     * @param t_width Width of image.
+     * @param t_height Height of image.
+     * @param t_src_offset Source data in shared memory.
+     * @param t_src_size Size of source data.
+     * @param t_dst_offset Destination data in shared memory.
+     * @param t_dst_size Size of destination data, 0 for in-place operation.
+     * @param t_reply Reply of server.
+     * @return 0 or -1 when communication failed.
+    */
+    int request( uint32_t t_op, uint32_t t_width, uint32_t t_height,
+                 size_t t_src_offset, size_t t_src_size, size_t t_dst_offset, size_t t_dst_size,
+                 OCLServiceReply &t_reply );
+
+protected:
+    /// @cond
+    int m_fd;
+    unsigned char *m_shm;
+    size_t m_shm_size;
+    uint32_t m_next_id;
+    /// @endcond
+};
+
+#endif // __OCL_SERVICE_H
@@ -0,0 +1,240 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_staging.cpp
+ * @brief Ring of pinned staging buffers for streaming without SVM.
+ *
+ * @details
+ * Source file for class @ref OCLStagingRing.
+ *
+ ***************************************************************************/
+
+#include <iostream>
+#include <algorithm>
+
+#include "ocl_utils.h"
+#include "ocl_staging.h"
+
+/// @copydoc OCLStagingRing::OCLStagingRing
+OCLStagingRing::OCLStagingRing( int t_slots, size_t t_in_bytes, size_t t_out_bytes )
+    : m_in_bytes( t_in_bytes ), m_out_bytes( t_out_bytes ), m_next( 0 )
+{
+    cl_int l_err;
+
+    cl::Context l_context = cl::Context::getDefault();
+    cl::Device l_device = cl::Device::getDefault();
+    m_up_queue = cl::CommandQueue( l_context, l_device, CL_QUEUE_PROFILING_ENABLE, &l_err );       CL_ERR_C( l_err );
+    m_compute_queue = cl::CommandQueue( l_context, l_device, 0, &l_err );                          CL_ERR_C( l_err );
+    m_down_queue = cl::CommandQueue( l_context, l_device, CL_QUEUE_PROFILING_ENABLE, &l_err );     CL_ERR_C( l_err );
+
+    m_slots.resize( std::max( 1, t_slots ) );
+    for ( Slot &l_slot : m_slots )
+    {
+        l_slot.m_in_host = l_slot.m_out_host = nullptr;
+        l_slot.m_up_bytes = l_slot.m_down_bytes = 0;
+        l_slot.m_error = CL_SUCCESS;
+        l_slot.m_busy = false;
+    }
+
+    for ( Slot &l_slot : m_slots )
+    {
+        // pinned memory allocated by driver, mapped for whole life of ring
+        l_slot.m_in_pinned = cl::Buffer( l_context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, t_in_bytes, nullptr, &l_err );    CL_ERR_C( l_err );
+        if ( l_err == CL_SUCCESS )
+        {
+            l_slot.m_in_host = m_up_queue.enqueueMapBuffer( l_slot.m_in_pinned, CL_TRUE, CL_MAP_WRITE, 0, t_in_bytes, nullptr, nullptr, &l_err );  CL_ERR_C( l_err );
+        }
+        l_slot.m_out_pinned = cl::Buffer( l_context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, t_out_bytes, nullptr, &l_err );  CL_ERR_C( l_err );
+        if ( l_err == CL_SUCCESS )
+        {
+            l_slot.m_out_host = m_down_queue.enqueueMapBuffer( l_slot.m_out_pinned, CL_TRUE, CL_MAP_READ, 0, t_out_bytes, nullptr, nullptr, &l_err );  CL_ERR_C( l_err );
+        }
+
+        l_slot.m_dev_in = cl::Buffer( l_context, CL_MEM_READ_ONLY, t_in_bytes, nullptr, &l_err );      CL_ERR_C( l_err );
+        if ( l_err == CL_SUCCESS )
+        {
+            l_slot.m_dev_out = cl::Buffer( l_context, CL_MEM_WRITE_ONLY, t_out_bytes, nullptr, &l_err );  CL_ERR_C( l_err );
+        }
+
+        if ( l_slot.m_in_host == nullptr || l_slot.m_out_host == nullptr || l_err != CL_SUCCESS )
+        {
+            std::cerr << "Unable to allocate staging slot of " << t_in_bytes << "+" << t_out_bytes << " bytes!" << std::endl;
+            unmap();
+            m_slots.clear();
+            break;
+        }
+    }
+
+    reset_stats();
+}
+
+/// @copydoc OCLStagingRing::~OCLStagingRing
+OCLStagingRing::~OCLStagingRing()
+{
+    m_compute_queue.finish();
+    unmap();
+}
+
+// pinned memory of all slots is unmapped
+void OCLStagingRing::unmap()
+{
+    m_up_queue.finish();
+    m_down_queue.finish();
+
+    for ( Slot &l_slot : m_slots )
+    {
+        if ( l_slot.m_in_host ) m_up_queue.enqueueUnmapMemObject( l_slot.m_in_pinned, l_slot.m_in_host );
+        if ( l_slot.m_out_host ) m_down_queue.enqueueUnmapMemObject( l_slot.m_out_pinned, l_slot.m_out_host );
+        l_slot.m_in_host = l_slot.m_out_host = nullptr;
+    }
+    m_up_queue.finish();
+    m_down_queue.finish();
+}
+
+/// @copydoc OCLStagingRing::acquire
+int OCLStagingRing::acquire()
+{
+    if ( m_slots.empty() ) return -1;
+
+    int l_slot = m_next;
+    m_next = ( m_next + 1 ) % m_slots.size();
+
+    // slot not released yet, its download is the last command
+    Slot &l_s = m_slots[ l_slot ];
+    if ( l_s.m_busy )
+    {
+        output( l_slot );
+        release( l_slot );
+    }
+    // copies without download are profiled before their events are dropped
+    account( l_s );
+
+    l_s.m_busy = true;
+    l_s.m_error = CL_SUCCESS;
+    l_s.m_uploaded = l_s.m_computed = l_s.m_downloaded = cl::Event();
+    return l_slot;
+}
+
+/// @copydoc OCLStagingRing::upload
+cl_int OCLStagingRing::upload( int t_slot, size_t t_bytes )
+{
+    Slot &l_s = m_slots[ t_slot ];
+    size_t l_bytes = t_bytes ? std::min( t_bytes, m_in_bytes ) : m_in_bytes;
+
+    l_s.m_error = m_up_queue.enqueueWriteBuffer( l_s.m_dev_in, CL_FALSE, 0, l_bytes, l_s.m_in_host, nullptr, &l_s.m_uploaded );  CL_ERR_R( l_s.m_error );
+    m_up_queue.flush();
+
+    l_s.m_up_bytes = l_bytes;
+    return CL_SUCCESS;
+}
+
+/// @copydoc OCLStagingRing::compute
+cl_int OCLStagingRing::compute( int t_slot, cl::Kernel &t_kernel, const cl::NDRange &t_global, const cl::NDRange &t_local )
+{
+    Slot &l_s = m_slots[ t_slot ];
+    if ( l_s.m_error != CL_SUCCESS ) return l_s.m_error;
+
+    std::vector< cl::Event > l_wait;
+    if ( l_s.m_uploaded() != nullptr ) l_wait.push_back( l_s.m_uploaded );
+
+    l_s.m_error = m_compute_queue.enqueueNDRangeKernel( t_kernel, cl::NullRange, t_global, t_local,
+                                                        l_wait.empty() ? nullptr : &l_wait, &l_s.m_computed );  CL_ERR_R( l_s.m_error );
+    m_compute_queue.flush();
+
+    return CL_SUCCESS;
+}
+
+/// @copydoc OCLStagingRing::download
+cl_int OCLStagingRing::download( int t_slot, size_t t_bytes )
+{
+    Slot &l_s = m_slots[ t_slot ];
+    if ( l_s.m_error != CL_SUCCESS ) return l_s.m_error;
+    size_t l_bytes = t_bytes ? std::min( t_bytes, m_out_bytes ) : m_out_bytes;
+
+    std::vector< cl::Event > l_wait;
+    if ( l_s.m_computed() != nullptr ) l_wait.push_back( l_s.m_computed );
+
+    l_s.m_error = m_down_queue.enqueueReadBuffer( l_s.m_dev_out, CL_FALSE, 0, l_bytes, l_s.m_out_host,
+                                                  l_wait.empty() ? nullptr : &l_wait, &l_s.m_downloaded );  CL_ERR_R( l_s.m_error );
+    m_down_queue.flush();
+
+    l_s.m_down_bytes = l_bytes;
+    return CL_SUCCESS;
+}
+
+/// @copydoc OCLStagingRing::output
+void *OCLStagingRing::output( int t_slot )
+{
+    Slot &l_s = m_slots[ t_slot ];
+    if ( l_s.m_error != CL_SUCCESS ) return nullptr;
+
+    if ( l_s.m_downloaded() != nullptr )
+    {
+        l_s.m_error = l_s.m_downloaded.wait();                                  CL_ERR_C( l_s.m_error );
+        if ( l_s.m_error == CL_SUCCESS ) account( l_s );
+    }
+    return l_s.m_error == CL_SUCCESS ? l_s.m_out_host : nullptr;
+}
+
+/// @copydoc OCLStagingRing::release
+void OCLStagingRing::release( int t_slot )
+{
+    m_slots[ t_slot ].m_busy = false;
+}
+
+/// @copydoc OCLStagingRing::finish
+cl_int OCLStagingRing::finish()
+{
+    cl_int l_ret = CL_SUCCESS;
+    for ( cl::CommandQueue *l_queue : { &m_up_queue, &m_compute_queue, &m_down_queue } )
+    {
+        cl_int l_err = l_queue->finish();                                       CL_ERR_C( l_err );
+        if ( l_ret == CL_SUCCESS ) l_ret = l_err;
+    }
+
+    for ( Slot &l_slot : m_slots )
+    {
+        account( l_slot );
+    }
+
+    return l_ret;
+}
+
+// profiling of finished copies of slot is added to statistics, each copy once
+void OCLStagingRing::account( Slot &t_slot )
+{
+    for ( int k = 0; k < 2; k++ )
+    {
+        cl::Event &l_event = k == 0 ? t_slot.m_uploaded : t_slot.m_downloaded;
+        size_t &l_bytes = k == 0 ? t_slot.m_up_bytes : t_slot.m_down_bytes;
+        if ( l_bytes == 0 || l_event() == nullptr ) continue;
+
+        if ( l_event.wait() == CL_SUCCESS )
+        {
+            OCLStagingStats &l_stats = k == 0 ? m_up_stats : m_down_stats;
+            l_stats.m_copies++;
+            l_stats.m_bytes += l_bytes;
+            l_stats.m_ms += ( l_event.getProfilingInfo< CL_PROFILING_COMMAND_END >() -
+                              l_event.getProfilingInfo< CL_PROFILING_COMMAND_START >() ) / 1e6;
+        }
+        l_bytes = 0;
+    }
+}
+
+/// @copydoc OCLStagingRing::reset_stats
+void OCLStagingRing::reset_stats()
+{
+    m_up_stats = { 0, 0, 0 };
+    m_down_stats = { 0, 0, 0 };
+}
@@ -0,0 +1,220 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_submit.cpp
+ * @brief Lock-free submission of jobs from many threads to one queue.
+ *
+ * @details
+ * Source file for class @ref OCLSubmitter.
+ *
+ ***************************************************************************/
+
+#include <chrono>
+#include <iostream>
+
+#include "ocl_utils.h"
+#include "ocl_submit.h"
+
+// the smallest power of 2 not less than t_size
+static size_t round_pow2( size_t t_size )
+{
+    size_t l_size = 2;
+    while ( l_size < t_size ) l_size *= 2;
+    return l_size;
+}
+
+/// @copydoc OCLSubmitter::OCLSubmitter
+OCLSubmitter::OCLSubmitter( size_t t_capacity, size_t t_max_batch ) :
+    m_cells( round_pow2( t_capacity ) ), m_mask( m_cells.size() - 1 ), m_max_batch( std::max< size_t >( 1, t_max_batch ) ),
+    m_enqueue_pos( 0 ), m_dequeue_pos( 0 ), m_retries( 0 ), m_full( 0 ), m_jobs( 0 ), m_batches( 0 ),
+    m_max_depth( 0 ), m_depth_sum( 0 ), m_sleeping( false ), m_stop( false )
+{
+    cl_int l_err;
+
+    for ( size_t i = 0; i < m_cells.size(); i++ )
+    {
+        m_cells[ i ].m_seq.store( i, std::memory_order_relaxed );
+    }
+
+    // only submitter uses this queue
+    m_queue = cl::CommandQueue( cl::Context::getDefault(), cl::Device::getDefault(), 0, &l_err );  CL_ERR_C( l_err );
+
+    m_thread = std::thread( &OCLSubmitter::run, this );
+}
+
+/// @copydoc OCLSubmitter::~OCLSubmitter
+OCLSubmitter::~OCLSubmitter()
+{
+    m_stop = true;
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        m_cond.notify_one();
+    }
+    m_thread.join();
+}
+
+/// @copydoc OCLSubmitter::try_push
+bool OCLSubmitter::try_push( OCLJobFunc &t_func, std::future< cl_int > &t_future )
+{
+    Cell *l_cell;
+    size_t l_pos = m_enqueue_pos.load( std::memory_order_relaxed );
+    for ( ;; )
+    {
+        l_cell = &m_cells[ l_pos & m_mask ];
+        size_t l_seq = l_cell->m_seq.load( std::memory_order_acquire );
+        intptr_t l_diff = ( intptr_t ) l_seq - ( intptr_t ) l_pos;
+        if ( l_diff == 0 )
+        {
+            // cell is free, it is reserved by moving of enqueue position
+            if ( m_enqueue_pos.compare_exchange_weak( l_pos, l_pos + 1, std::memory_order_relaxed ) ) break;
+            m_retries.fetch_add( 1, std::memory_order_relaxed );
+        }
+        else if ( l_diff < 0 )
+        {
+            // ring is full
+            return false;
+        }
+        else
+        {
+            // other producer was faster
+            l_pos = m_enqueue_pos.load( std::memory_order_relaxed );
+        }
+    }
+
+    l_cell->m_job.m_func = std::move( t_func );
+    l_cell->m_job.m_promise = std::promise< cl_int >();
+    t_future = l_cell->m_job.m_promise.get_future();
+
+    // job is visible for submitter
+    l_cell->m_seq.store( l_pos + 1, std::memory_order_release );
+
+    size_t l_depth = l_pos + 1 - m_dequeue_pos.load( std::memory_order_relaxed );
+    size_t l_max = m_max_depth.load( std::memory_order_relaxed );
+    while ( l_depth > l_max && !m_max_depth.compare_exchange_weak( l_max, l_depth, std::memory_order_relaxed ) );
+
+    return true;
+}
+
+/// @copydoc OCLSubmitter::submit
+std::future< cl_int > OCLSubmitter::submit( OCLJobFunc t_func )
+{
+    std::future< cl_int > l_future;
+
+    if ( !try_push( t_func, l_future ) )
+    {
+        m_full.fetch_add( 1, std::memory_order_relaxed );
+        do
+        {
+            std::this_thread::yield();
+        }
+        while ( !try_push( t_func, l_future ) );
+    }
+
+    // submitter is woken only when it sleeps, fence orders the job before the flag check
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    if ( m_sleeping.load() )
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        m_cond.notify_one();
+    }
+
+    return l_future;
+}
+
+/// @copydoc OCLSubmitter::pop
+bool OCLSubmitter::pop( Job &t_job )
+{
+    size_t l_pos = m_dequeue_pos.load( std::memory_order_relaxed );
+    Cell &l_cell = m_cells[ l_pos & m_mask ];
+
+    if ( l_cell.m_seq.load( std::memory_order_acquire ) != l_pos + 1 )
+    {
+        return false;
+    }
+
+    t_job.m_func = std::move( l_cell.m_job.m_func );
+    t_job.m_promise = std::move( l_cell.m_job.m_promise );
+
+    // cell is free for the next round of producers
+    l_cell.m_seq.store( l_pos + m_mask + 1, std::memory_order_release );
+    m_dequeue_pos.store( l_pos + 1, std::memory_order_relaxed );
+
+    return true;
+}
+
+/// @copydoc OCLSubmitter::run
+void OCLSubmitter::run()
+{
+    std::vector< Job > l_batch( m_max_batch );
+    std::vector< cl_int > l_results( m_max_batch );
+
+    for ( ;; )
+    {
+        // depth of ring seen by submitter
+        size_t l_depth = m_enqueue_pos.load( std::memory_order_relaxed ) - m_dequeue_pos.load( std::memory_order_relaxed );
+
+        size_t l_count = 0;
+        while ( l_count < m_max_batch && pop( l_batch[ l_count ] ) )
+        {
+            l_count++;
+        }
+
+        if ( l_count == 0 )
+        {
+            if ( m_stop ) break;
+
+            // ring is checked again after m_sleeping is set, producer may not see it
+            std::unique_lock< std::mutex > l_lock( m_mutex );
+            m_sleeping = true;
+            if ( m_cells[ m_dequeue_pos.load() & m_mask ].m_seq.load() != m_dequeue_pos.load() + 1 && !m_stop )
+            {
+                m_cond.wait_for( l_lock, std::chrono::milliseconds( 1 ) );
+            }
+            m_sleeping = false;
+            continue;
+        }
+
+        m_depth_sum.fetch_add( l_depth, std::memory_order_relaxed );
+
+        // all jobs of batch are enqueued, then only one wait
+        for ( size_t i = 0; i < l_count; i++ )
+        {
+            l_results[ i ] = l_batch[ i ].m_func( m_queue );
+        }
+        m_queue.flush();
+        cl_int l_err = m_queue.finish();                                        CL_ERR_C( l_err );
+
+        for ( size_t i = 0; i < l_count; i++ )
+        {
+            l_batch[ i ].m_promise.set_value( l_results[ i ] != CL_SUCCESS ? l_results[ i ] : l_err );
+            l_batch[ i ].m_func = nullptr;
+        }
+
+        m_jobs.fetch_add( l_count, std::memory_order_relaxed );
+        m_batches.fetch_add( 1, std::memory_order_relaxed );
+    }
+}
+
+/// @copydoc OCLSubmitter::stats
+OCLSubmitStats OCLSubmitter::stats() const
+{
+    OCLSubmitStats l_stats;
+    l_stats.m_jobs = m_jobs.load();
+    l_stats.m_batches = m_batches.load();
+    l_stats.m_retries = m_retries.load();
+    l_stats.m_full = m_full.load();
+    l_stats.m_max_depth = m_max_depth.load();
+    l_stats.m_avg_depth = l_stats.m_batches ? ( double ) m_depth_sum.load() / l_stats.m_batches : 0;
+    return l_stats;
+}
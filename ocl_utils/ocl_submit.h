@@ -0,0 +1,139 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_submit.h
+ * @brief Lock-free submission of jobs from many threads to one queue.
+ *
+ * @details
+ * Header file for class @ref OCLSubmitter.
+ *
+ * Producer threads put jobs into bounded lock-free ring (multi-producer,
+ * single-consumer). One submitter thread takes jobs from ring, enqueues
+ * them into its command queue in batches and waits only once for the whole
+ * batch. Producer gets std::future with result of its job.
+ *
+ * Only submitter thread calls job functions, so kernels used by jobs
+ * can be shared without lock.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_SUBMIT_H
+#define __OCL_SUBMIT_H
+
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+#include <CL/opencl.hpp>
+
+/**
+ * @brief Job enqueues its commands into queue of submitter, it must not wait.
+*/
+using OCLJobFunc = std::function< cl_int( cl::CommandQueue &t_queue ) >;
+
+/**
+ * @brief Metrics of @ref OCLSubmitter.
+*/
+struct OCLSubmitStats
+{
+    size_t m_jobs;              ///< Finished jobs.
+    size_t m_batches;           ///< Number of batches, one wait for every batch.
+    size_t m_retries;           ///< Failed CAS of producers, contention on ring.
+    size_t m_full;              ///< Producers waiting on full ring.
+    size_t m_max_depth;         ///< Max. number of jobs in ring.
+    double m_avg_depth;         ///< Average number of jobs in ring seen by submitter.
+};
+
+/**
+ * @anchor OCLSubmitter
+ * @brief Lock-free job ring with submitter thread.
+*/
+class OCLSubmitter
+{
+public:
+    /**
+     * @brief Allocation of ring and start of submitter thread.
+     * @param t_capacity Size of ring, rounded up to power of 2.
+     * @param t_max_batch Max. number of jobs enqueued before one wait.
+    */
+    OCLSubmitter( size_t t_capacity = 1024, size_t t_max_batch = 32 );
+
+    /**
+     * @brief All jobs in ring are finished and thread is joined.
+    */
+    ~OCLSubmitter();
+
+    OCLSubmitter( const OCLSubmitter & ) = delete;
+    OCLSubmitter &operator=( const OCLSubmitter & ) = delete;
+
+    /**
+     * @brief Job is put into ring, function waits only when ring is full.
+     * @param t_func Function enqueuing commands of job.
+     * @return Future with cl_int error code or CL_SUCCESS, it is ready when job is finished.
+    */
+    std::future< cl_int > submit( OCLJobFunc t_func );
+
+    /**
+     * @brief Current metrics.
+    */
+    OCLSubmitStats stats() const;
+
+protected:
+    /// @cond
+    struct Job
+    {
+        OCLJobFunc m_func;
+        std::promise< cl_int > m_promise;
+    };
+
+    struct Cell
+    {
+        std::atomic< size_t > m_seq;    // sequence number, Dmitry Vyukov's bounded queue
+        Job m_job;
+    };
+
+    std::vector< Cell > m_cells;
+    size_t m_mask;
+    size_t m_max_batch;
+
+    // producers and consumer on separate cache lines
+    alignas( 64 ) std::atomic< size_t > m_enqueue_pos;
+    alignas( 64 ) std::atomic< size_t > m_dequeue_pos;
+
+    alignas( 64 ) std::atomic< size_t > m_retries;
+    std::atomic< size_t > m_full;
+    std::atomic< size_t > m_jobs;
+    std::atomic< size_t > m_batches;
+    std::atomic< size_t > m_max_depth;
+    std::atomic< size_t > m_depth_sum;
+
+    std::atomic< bool > m_sleeping;
+    std::atomic< bool > m_stop;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+
+    cl::CommandQueue m_queue;
+    std::thread m_thread;
+
+    bool try_push( OCLJobFunc &t_func, std::future< cl_int > &t_future );
+    bool pop( Job &t_job );
+    void run();
+    /// @endcond
+};
+
+#endif // __OCL_SUBMIT_H
@@ -0,0 +1,174 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_threads.cpp
+ * @brief Thread-safe use of OpenCL from more host threads.
+ *
+ * @details
+ * Source file for classes @ref OCLThreadRuntime and @ref OCLSVMPool.
+ *
+ ***************************************************************************/
+
+#include <iostream>
+
+#include "ocl_utils.h"
+#include "ocl_threads.h"
+
+std::atomic< unsigned long > OCLThreadRuntime::s_next_id( 1 );
+
+/// @copydoc OCLThreadRuntime::OCLThreadRuntime
+OCLThreadRuntime::OCLThreadRuntime( const cl::Program &t_program ) :
+    m_program( t_program ), m_id( s_next_id++ )
+{
+}
+
+/// @copydoc OCLThreadRuntime::~OCLThreadRuntime
+OCLThreadRuntime::~OCLThreadRuntime()
+{
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+    for ( auto &l_state : m_states )
+    {
+        l_state->m_queue.finish();
+    }
+}
+
+/// @copydoc OCLThreadRuntime::state
+OCLThreadRuntime::ThreadState &OCLThreadRuntime::state()
+{
+    // states of calling thread for all runtimes, id of runtime is never reused
+    static thread_local std::unordered_map< unsigned long, ThreadState * > l_states;
+
+    auto l_found = l_states.find( m_id );
+    if ( l_found != l_states.end() )
+    {
+        return *l_found->second;
+    }
+
+    // the first use in this thread
+    cl_int l_err;
+    std::unique_ptr< ThreadState > l_state( new ThreadState );
+    l_state->m_queue = cl::CommandQueue( cl::Context::getDefault(), cl::Device::getDefault(), 0, &l_err );  CL_ERR_C( l_err );
+
+    ThreadState *l_ptr = l_state.get();
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+        m_states.push_back( std::move( l_state ) );
+    }
+    l_states[ m_id ] = l_ptr;
+
+    return *l_ptr;
+}
+
+/// @copydoc OCLThreadRuntime::queue
+cl::CommandQueue &OCLThreadRuntime::queue()
+{
+    return state().m_queue;
+}
+
+/// @copydoc OCLThreadRuntime::kernel
+cl::Kernel &OCLThreadRuntime::kernel( const std::string &t_name )
+{
+    ThreadState &l_state = state();
+
+    auto l_found = l_state.m_kernels.find( t_name );
+    if ( l_found != l_state.m_kernels.end() )
+    {
+        return l_found->second;
+    }
+
+    // clone of master kernel, master is created only once for all threads
+    cl::Kernel l_clone;
+    {
+        std::lock_guard< std::mutex > l_lock( m_mutex );
+
+        cl::Kernel &l_master = m_masters[ t_name ];
+        if ( l_master() == nullptr )
+        {
+            cl_int l_err;
+            l_master = cl::Kernel( m_program, t_name.c_str(), &l_err );         CL_ERR_C( l_err );
+        }
+        if ( l_master() != nullptr )
+        {
+            l_clone = l_master.clone();
+        }
+    }
+
+    return l_state.m_kernels[ t_name ] = l_clone;
+}
+
+/// @copydoc OCLThreadRuntime::threads
+int OCLThreadRuntime::threads()
+{
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+    return m_states.size();
+}
+
+/// @copydoc OCLSVMPool::~OCLSVMPool
+OCLSVMPool::~OCLSVMPool()
+{
+    for ( auto &l_list : m_free )
+    {
+        for ( void *l_ptr : l_list.second )
+        {
+            ocl_svm_free( l_ptr );
+        }
+    }
+    if ( m_used.size() > 0 )
+    {
+        std::cerr << "SVM pool destroyed with " << m_used.size() << " buffers in use." << std::endl;
+    }
+}
+
+/// @copydoc OCLSVMPool::alloc
+void *OCLSVMPool::alloc( size_t t_size )
+{
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+
+    void *l_ptr = nullptr;
+    auto &l_list = m_free[ t_size ];
+    if ( l_list.size() > 0 )
+    {
+        l_ptr = l_list.back();
+        l_list.pop_back();
+        m_reuses++;
+    }
+    else
+    {
+        // clSVMAlloc is thread-safe, but it is slow
+        l_ptr = ocl_svm_malloc< void >( t_size );
+        if ( l_ptr == nullptr ) return nullptr;
+        m_allocs++;
+    }
+
+    m_used[ l_ptr ] = t_size;
+    return l_ptr;
+}
+
+/// @copydoc OCLSVMPool::free
+void OCLSVMPool::free( void *t_ptr )
+{
+    if ( t_ptr == nullptr ) return;
+
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+
+    auto l_found = m_used.find( t_ptr );
+    if ( l_found == m_used.end() )
+    {
+        std::cerr << "SVM pointer " << t_ptr << " is not from pool!" << std::endl;
+        return;
+    }
+
+    m_free[ l_found->second ].push_back( t_ptr );
+    m_used.erase( l_found );
+}
@@ -0,0 +1,164 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_threads.h
+ * @brief Thread-safe use of OpenCL from more host threads.
+ *
+ * @details
+ * Header file for classes @ref OCLThreadRuntime and @ref OCLSVMPool.
+ *
+ * Context, device and program can be shared by threads, but
+ * cl::Kernel with its arguments can't, because setArg and enqueue
+ * of two threads would mix arguments. And one shared queue
+ * serializes all threads. So every thread gets its own command queue
+ * and its own clones of kernels (clCloneKernel) by @ref OCLThreadRuntime.
+ *
+ * SVM allocation for requests of threads is reused by @ref OCLSVMPool.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_THREADS_H
+#define __OCL_THREADS_H
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <CL/opencl.hpp>
+
+/**
+ * @anchor OCLThreadRuntime
+ * @brief Per-thread command queues and kernels for one shared program.
+ *
+ * @details
+ * Queue and kernels of thread are created at the first use in thread,
+ * later they are found without any lock.
+*/
+class OCLThreadRuntime
+{
+public:
+    /**
+     * @brief Runtime for program built in default context.
+     * @param t_program Program shared by all threads.
+    */
+    explicit OCLThreadRuntime( const cl::Program &t_program );
+
+    /**
+     * @brief All queues are finished.
+    */
+    ~OCLThreadRuntime();
+
+    OCLThreadRuntime( const OCLThreadRuntime & ) = delete;
+    OCLThreadRuntime &operator=( const OCLThreadRuntime & ) = delete;
+
+    /**
+     * @brief Command queue of calling thread on default device.
+    */
+    cl::CommandQueue &queue();
+
+    /**
+     * @brief Kernel of calling thread, its arguments are not shared with other threads.
+     * @param t_name Name of kernel in program.
+     * @return Kernel or empty kernel when not found.
+    */
+    cl::Kernel &kernel( const std::string &t_name );
+
+    /**
+     * @brief Number of threads which used this runtime.
+    */
+    int threads();
+
+protected:
+    /// @cond
+    struct ThreadState
+    {
+        cl::CommandQueue m_queue;
+        std::unordered_map< std::string, cl::Kernel > m_kernels;
+    };
+
+    cl::Program m_program;
+    unsigned long m_id;                                     // key for thread_local states
+    std::mutex m_mutex;
+    std::map< std::string, cl::Kernel > m_masters;          // kernels for cloning, arguments are never set
+    std::vector< std::unique_ptr< ThreadState > > m_states; // states of all threads, owned by runtime
+
+    ThreadState &state();
+
+    static std::atomic< unsigned long > s_next_id;
+    /// @endcond
+};
+
+/**
+ * @anchor OCLSVMPool
+ * @brief Thread-safe pool of SVM buffers in default context.
+ *
+ * @details
+ * Released buffers are kept in lists by their size and reused
+ * by the next allocation of the same size. So threads handling
+ * requests of the same kind do not call clSVMAlloc repeatedly.
+*/
+class OCLSVMPool
+{
+public:
+    OCLSVMPool() : m_allocs( 0 ), m_reuses( 0 ) {}
+
+    /**
+     * @brief Deallocation of all free buffers.
+    */
+    ~OCLSVMPool();
+
+    OCLSVMPool( const OCLSVMPool & ) = delete;
+    OCLSVMPool &operator=( const OCLSVMPool & ) = delete;
+
+    /**
+     * @brief Allocation of SVM buffer.
+     * @param t_size Size in bytes.
+     * @return Pointer to SVM memory or nullptr.
+    */
+    void *alloc( size_t t_size );
+
+    /**
+     * @brief Allocation of SVM buffer for t_count elements of T.
+    */
+    template< typename T >
+    T *alloc( size_t t_count = 1 ) { return ( T * ) alloc( t_count * sizeof( T ) ); }
+
+    /**
+     * @brief Buffer is returned into pool.
+     * @param t_ptr Pointer from @ref alloc or nullptr.
+    */
+    void free( void *t_ptr );
+
+    /// Number of new SVM allocations.
+    size_t allocs() const { return m_allocs.load( std::memory_order_relaxed ); }
+
+    /// Number of allocations served from pool.
+    size_t reuses() const { return m_reuses.load( std::memory_order_relaxed ); }
+
+protected:
+    /// @cond
+    std::mutex m_mutex;
+    std::unordered_map< void *, size_t > m_used;
+    std::unordered_map< size_t, std::vector< void * > > m_free;
+    // read without lock by allocs() and reuses()
+    std::atomic< size_t > m_allocs;
+    std::atomic< size_t > m_reuses;
+    /// @endcond
+};
+
+#endif // __OCL_THREADS_H
@@ -0,0 +1,184 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_tiled.h
+ * @brief Out-of-core processing of big images in tiles.
+ *
+ * @details
+ * Header file for classes @ref OCLMappedFile and @ref OCLTiledExec.
+ *
+ * Image larger than CL_DEVICE_MAX_MEM_ALLOC_SIZE (or than the whole
+ * device memory) is processed in tiles. Tile is a band of rows with
+ * full width of image, so every tile is continuous in memory.
+ * Tile is extended by halo rows above and below, which are
+ * necessary for neighbourhood kernels.
+ *
+ * Only a small number of SVM buffers is allocated. Every tile is
+ * uploaded, processed and downloaded in three queues, so upload of
+ * the next tile and download of the previous tile is overlapped
+ * with kernel execution.
+ *
+ ***************************************************************************/
+
+#ifndef __OCL_TILED_H
+#define __OCL_TILED_H
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <CL/opencl.hpp>
+
+#include "ocl_image.h"
+
+/**
+ * @anchor OCLMappedFile
+ * @brief File mapped into memory.
+ *
+ * @details
+ * Input file is mapped read-only, output file is created with
+ * required size. Pages already processed are released from memory
+ * by @ref release, so memory used by big files stays bounded.
+*/
+class OCLMappedFile
+{
+public:
+    /**
+     * @brief Mapping of existing file or creation of new file.
+     * @param t_filename Name of file.
+     * @param t_size Size of new file, 0 - existing file is mapped read-only.
+    */
+    OCLMappedFile( const std::string &t_filename, size_t t_size = 0 );
+
+    /**
+     * @brief Unmapping and closing of file.
+    */
+    ~OCLMappedFile();
+
+    OCLMappedFile( const OCLMappedFile & ) = delete;
+    OCLMappedFile &operator=( const OCLMappedFile & ) = delete;
+
+    /// Pointer to mapped file or nullptr when mapping failed.
+    unsigned char *data() const { return m_data; }
+
+    /// Size of mapped file.
+    size_t size() const { return m_size; }
+
+    /**
+     * @brief Pages of file in range are not necessary anymore.
+     * @param t_offset Start of range in bytes.
+     * @param t_len Length of range in bytes.
+    */
+    void release( size_t t_offset, size_t t_len );
+
+protected:
+    int m_fd;                       ///< File descriptor.
+    unsigned char *m_data;          ///< Mapped memory.
+    size_t m_size;                  ///< Size of mapping.
+};
+
+/**
+ * @brief Image in host memory (mapped file or cv::Mat), rows are continuous.
+*/
+struct OCLHostImage
+{
+    unsigned char *m_data;          ///< The first pixel.
+    int m_width;                    ///< Width of image.
+    int m_height;                   ///< Height of image.
+    int m_elem_size;                ///< Bytes per pixel, 4 for uchar4, 1 for uchar.
+    OCLMappedFile *m_file;          ///< Mapped file for release of pages or nullptr.
+
+    /// Bytes of one row.
+    size_t row_size() const { return ( size_t ) m_width * m_elem_size; }
+};
+
+/**
+ * @brief Function which sets arguments of kernel for one tile.
+ *
+ * @details
+ * Both descriptors have size of the whole tile including halo rows
+ * and use the same coordinates. Kernel must set also SVM pointers.
+ * Kernel object can be reused for all tiles, arguments are
+ * used at the time of enqueue.
+*/
+using OCLTileKernel = std::function< cl::Kernel &( OCLImage *t_ocl_in_img, OCLImage *t_ocl_out_img ) >;
+
+/**
+ * @anchor OCLTiledExec
+ * @brief Streaming of big image through a small set of SVM tile buffers.
+*/
+class OCLTiledExec
+{
+public:
+    /**
+     * @brief Allocation of queues, buffers are allocated in @ref run.
+     * @param t_tile_rows Number of rows in one tile without halo, 0 - derived from device limits.
+     * @param t_halo Number of halo rows above and below tile.
+     * @param t_buffers Number of tiles in progress at the same time.
+    */
+    OCLTiledExec( int t_tile_rows = 0, int t_halo = 0, int t_buffers = 3 );
+
+    /**
+     * @brief Deallocation of tile buffers.
+    */
+    ~OCLTiledExec();
+
+    OCLTiledExec( const OCLTiledExec & ) = delete;
+    OCLTiledExec &operator=( const OCLTiledExec & ) = delete;
+
+    /**
+     * @brief Processing of the whole image tile by tile.
+     * @param t_in Input image, size of output image must be the same.
+     * @param t_out Output image.
+     * @param t_kernel Kernel for one tile.
+     * @param t_verbose Print progress.
+     * @return cl_int error code or CL_SUCCESS.
+    */
+    cl_int run( const OCLHostImage &t_in, const OCLHostImage &t_out, OCLTileKernel t_kernel, int t_verbose = 0 );
+
+    /// Number of rows in one tile used by the last run.
+    int tile_rows() const { return m_tile_rows; }
+
+    /// Peak of SVM memory allocated for tile buffers in bytes.
+    size_t peak_bytes() const { return m_peak_bytes; }
+
+protected:
+    /// @cond
+    struct TileSlot
+    {
+        unsigned char *m_in_data;
+        unsigned char *m_out_data;
+        OCLImage *m_ocl_in_img;
+        OCLImage *m_ocl_out_img;
+        cl::Event m_done;           // download of the last tile finished
+        int m_row_first;            // tile in slot, for release of pages
+        int m_row_last;
+    };
+
+    cl::CommandQueue m_upload_queue;
+    cl::CommandQueue m_compute_queue;
+    cl::CommandQueue m_download_queue;
+    std::vector< TileSlot > m_slots;
+    int m_tile_rows_req;
+    int m_tile_rows;
+    int m_halo;
+    size_t m_peak_bytes;
+
+    cl_int allocate( const OCLHostImage &t_in, const OCLHostImage &t_out );
+    void deallocate();
+    void release( TileSlot &t_slot, const OCLHostImage &t_in, const OCLHostImage &t_out );
+    /// @endcond
+};
+
+#endif // __OCL_TILED_H
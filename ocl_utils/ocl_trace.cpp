@@ -0,0 +1,155 @@
+
+/** *************************************************************************
+ *
+ * @internal
+ *   Demo program for teaching the course
+ *   Computer Architectures and Parallel Systems.
+ *
+ *   GPU Programming using OpenCL
+ *
+ *   02/2026, Petr Olivka, Dep. of Computer Science, FEI, VSB-TU Ostrava
+ *   petr.olivka@vsb.cz
+ *   https:/poli.cs.vsb.cz/edu/apps
+ * @endinternal
+ *
+ * @file ocl_trace.cpp
+ * @brief Timeline of host calls and kernels in Chrome trace format.
+ *
+ * @details
+ * Source file for @ref OCL_TRACE_SCOPE and functions @ref ocl_trace_start,
+ * @ref ocl_trace_stop and @ref ocl_trace_event.
+ *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <climits>
+#include <algorithm>
+
+#include "ocl_trace.h"
+
+std::atomic< bool > g_ocl_trace_on{ false };
+
+// one span, device spans have device time until they are written
+struct TraceSpan
+{
+    const char *m_name;
+    long long m_start;
+    long long m_end;
+    int m_tid;
+    bool m_device;
+};
+
+static std::mutex g_trace_mutex;
+static std::vector< TraceSpan > g_trace_spans;
+static std::string g_trace_file;
+static long long g_trace_begin = 0;
+static long long g_trace_offset = LLONG_MIN;     // host time minus device time
+
+// small number of thread for trace viewer
+static int trace_tid()
+{
+    static std::atomic< int > s_next( 0 );
+    thread_local int l_tid = s_next++;
+    return l_tid;
+}
+
+/// @copydoc ocl_trace_start
+void ocl_trace_start( const std::string &t_file_name )
+{
+    std::lock_guard< std::mutex > l_lock( g_trace_mutex );
+    g_trace_spans.clear();
+    g_trace_spans.reserve( 1 << 16 );
+    g_trace_file = t_file_name;
+    g_trace_begin = ocl_trace_now();
+    g_trace_offset = LLONG_MIN;
+    g_ocl_trace_on.store( true, std::memory_order_relaxed );
+}
+
+// span of scope is stored
+void OCLTraceScope::record()
+{
+    long long l_end = ocl_trace_now();
+    int l_tid = trace_tid();
+    std::lock_guard< std::mutex > l_lock( g_trace_mutex );
+    g_trace_spans.push_back( { m_name, m_start, l_end, l_tid, false } );
+}
+
+/// @copydoc ocl_trace_event
+void ocl_trace_event( const char *t_name, const cl::Event &t_event, long long t_host_enqueue )
+{
+    if ( !ocl_trace_on() ) return;
+
+    // queue without profiling has no times
+    cl_int l_err;
+    cl_ulong l_queued = t_event.getProfilingInfo< CL_PROFILING_COMMAND_QUEUED >( &l_err );
+    if ( l_err != CL_SUCCESS ) return;
+    cl_ulong l_start = t_event.getProfilingInfo< CL_PROFILING_COMMAND_START >();
+    cl_ulong l_end = t_event.getProfilingInfo< CL_PROFILING_COMMAND_END >();
+
+    std::lock_guard< std::mutex > l_lock( g_trace_mutex );
+
+    // command is queued after host started enqueue, so the largest offset is the closest one
+    g_trace_offset = std::max( g_trace_offset, t_host_enqueue - ( long long ) l_queued );
+
+    g_trace_spans.push_back( { "queued", ( long long ) l_queued, ( long long ) l_start, 1, true } );
+    g_trace_spans.push_back( { t_name, ( long long ) l_start, ( long long ) l_end, 0, true } );
+}
+
+/// @copydoc ocl_trace_stop
+bool ocl_trace_stop()
+{
+    std::lock_guard< std::mutex > l_lock( g_trace_mutex );
+    if ( !ocl_trace_on() ) return true;
+    g_ocl_trace_on.store( false, std::memory_order_relaxed );
+
+    std::ofstream l_file( g_trace_file );
+    if ( !l_file )
+    {
+        std::cerr << "Unable to write trace '" << g_trace_file << "'!" << std::endl;
+        return false;
+    }
+
+    // process 0 - host threads, process 1 - device: kernels and waiting in queue
+    l_file << "{\"traceEvents\":[" << std::endl;
+    l_file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"host\"}}," << std::endl;
+    l_file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"device\"}}," << std::endl;
+    l_file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"kernels\"}}," << std::endl;
+    l_file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"queue\"}}";
+
+    l_file << std::fixed << std::setprecision( 3 );
+    for ( const TraceSpan &l_span : g_trace_spans )
+    {
+        long long l_shift = l_span.m_device ? g_trace_offset - g_trace_begin : -g_trace_begin;
+        l_file << "," << std::endl
+               << "{\"name\":\"" << l_span.m_name << "\",\"cat\":\"" << ( l_span.m_device ? "device" : "host" )
+               << "\",\"ph\":\"X\",\"pid\":" << ( l_span.m_device ? 1 : 0 ) << ",\"tid\":" << l_span.m_tid
+               << ",\"ts\":" << ( l_span.m_start + l_shift ) / 1000.0
+               << ",\"dur\":" << ( l_span.m_end - l_span.m_start ) / 1000.0 << "}";
+    }
+    l_file << std::endl << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+
+    std::cout << "Trace with " << g_trace_spans.size() << " spans written into '" << g_trace_file << "'." << std::endl;
+    g_trace_spans.clear();
+
+    return l_file.good();
+}
+
+// tracing from environment variable OCL_TRACE, trace is written at exit
+static struct TraceFromEnv
+{
+    TraceFromEnv()
+    {
+        const char *l_file_name = getenv( "OCL_TRACE" );
+        if ( l_file_name && *l_file_name ) ocl_trace_start( l_file_name );
+    }
+    ~TraceFromEnv()
+    {
+        ocl_trace_stop();
+    }
+} g_trace_from_env;